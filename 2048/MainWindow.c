@@ -32,10 +32,7 @@ PRIVATE void addRandomTile(MAKE_THIS(MainWindow)){ SELFREF_INIT;
 	while (x = rand() % 4, y = rand() % 4, this->tiles[y][x]);
 	this->tiles[y][x] = newTile(this->panel->moduleInstance, value, x, y);
 
-	$(this->panel)_addChild((GUIObject)(this->tiles[y][x]));
-	displayControl((Control)(this->tiles[y][x]));
-
-	SendMessageA(this->tiles[y][x]->handle, WM_PAINT, (WPARAM)NULL, (LPARAM)NULL); /* Force repaint after the object has been created */
+	$(this->panel)_addChild((GUIObject)(this->tiles[y][x])); /* Gets its window on the board if the board has one */
 }
 
 PRIVATE void slideTiles(MAKE_THIS(MainWindow), int xDirection, int yDirection){ SELFREF_INIT;
@@ -127,8 +124,7 @@ MainWindow newMainWindow(HINSTANCE hInstance){ SELFREF_INIT;
 	$(this->panel)_setResizable(FALSE);
 	$(this)_setEvent(WM_KEYDOWN, onKeyDown, NULL, SYNC);
 
-	this->panel->maxWidth = this->panel->width;
-	this->panel->maxHeight = this->panel->height;
+	$(this->panel)_setMaxSize(this->panel->width, this->panel->height);
 
 	this->panel->x = 10;
 	this->panel->y = 10;
@@ -10,7 +10,7 @@
 METHOD(Tile, void, moveTile, (MAKE_THIS(Tile), int row, int col)){ SELFREF_INIT;
 	Sleep(1);
 
-	$(this)_setPos(col * BOARD_SIZE / 4, row * BOARD_SIZE / 4);
+	$(this)_setPosAs(Control, col * BOARD_SIZE / 4, row * BOARD_SIZE / 4);
 	this->gridXPos = col;
 	this->gridYPos = row;
 }
@@ -109,6 +109,7 @@ Tile newTile(HINSTANCE hInstance, int number, int gridXPos, int gridYPos){ SELFR
 	this->gridYPos = gridYPos;
 
 	this->styles |= WS_BORDER | SS_CENTER | SS_CENTERIMAGE;
+	$(this)_setWindowless(TRUE); /* Tiles come and go on every move, the board draws them instead of giving each one a window */
 
 	$(this)_setEvent(WM_PAINT, onPaint, NULL, SYNC);
 	//$(this)_setEvent(WM_CTLCOLORSTATIC, onCtlColorStatic, NULL, SYNC);
@@ -120,7 +121,7 @@ void deleteTile(MAKE_THIS(Tile)){
 	this->className = NULL;
 	deleteBrush(this->bgBrush);
 	freeGUIObjectFields((GUIObject)this);
-	free(this);
+	releaseGUIObject((GUIObject)this);
 }
 
 #undef FIELD
@@ -5,20 +5,11 @@
 /* The number buttons' onClick event handler */
 void numBtnOnClick(Button sender, void *context, MouseEventArgs e){ SELFREF_INIT; 
 	TextBox textbox = (TextBox)context;
-	int newTextLen;
-	char *newText;
+	unsigned int textLength;
 
-	newTextLen = strlen(textbox->text) + 1;
-	newText = (char*)malloc(newTextLen + 1); /* Allocate memory for the new text */
-	if (!newText)
+	textLength = $(textbox)_getTextLength();
+	if (!$(textbox)_replaceText(textLength, 0, sender->text)) /* Append the pressed button's text to the textbox's text */
 		MessageBoxA(NULL, "Out of memory!", "Error!", MB_OK);
-	else {
-		strcpy_s(newText, newTextLen + 1, textbox->text);
-		strcat_s(newText, newTextLen + 1, sender->text); /* Concatenate the pressed button's text to the textbox's text */
-		newText[newTextLen] = '\0';
-		$(textbox)_setText(newText); /* Set the textbox's new text */
-		free(newText); /* Free the new text. This is perfectly safe, the textbox's text is now stored elsewhere in memory */
-	}
 }
 
  /* Sets a new random task in a label */
@@ -43,7 +34,7 @@ void checkAnsBtnOnClick(Button checkAnsButton, void **context, MouseEventArgs e)
 	TextBox textbox = (TextBox)context[2];
 	int *answer = (int*)context[3], answerInput = 0;
 
-	sscanf_s(textbox->text, "%d", &answerInput, 1); /* Get the numeric value of the answer input */
+	startSync(textbox); sscanf_s($(textbox)_getText(), "%d", &answerInput, 1); endSync(textbox); /* Get the numeric value of the answer input */
 
 	startSync(header); /* Synchronize access to the header object */
 	$(header)_setText((answerInput == *answer) ? "GOOD JOB!" : "WRONG ANSWER!"); /* Display the result */
@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tinyAlloc.h"
+
+/* The offset of the first block in a chunk, so that the blocks are aligned like their headers */
+#define CHUNK_HEADER_SIZE ((sizeof(struct _arenaChunk) + sizeof(struct _arenaHeader) - 1) / sizeof(struct _arenaHeader) * \
+							sizeof(struct _arenaHeader))
+
+/* Gets the size class of a block size, ARENA_LARGE if it's too large for the classes */
+static size_t getSizeClass(size_t size){
+	size_t sizeClass = 0, classSize = ARENA_MIN_BLOCK;
+
+	while (classSize < size && sizeClass < ARENA_LARGE){
+		classSize *= 2;
+		sizeClass++;
+	}
+
+	return sizeClass;
+}
+
+/* Carves a block of a size class from the newest chunk, adding a chunk if it's full */
+static struct _arenaHeader *carveBlock(Arena arena, size_t sizeClass){
+	struct _arenaChunk *chunk = arena->chunks;
+	struct _arenaHeader *header;
+	size_t blockSize = sizeof(struct _arenaHeader) + ((size_t)ARENA_MIN_BLOCK << sizeClass), chunkSize;
+
+	if (!chunk || chunk->size - chunk->used < blockSize){
+		chunkSize = arena->chunkSize > blockSize ? arena->chunkSize : blockSize;
+		chunk = (struct _arenaChunk*)malloc(CHUNK_HEADER_SIZE + chunkSize);
+		if (!chunk)
+			return NULL;
+
+		chunk->next = arena->chunks;
+		chunk->size = chunkSize;
+		chunk->used = 0;
+		arena->chunks = chunk;
+		arena->stats.reserved += CHUNK_HEADER_SIZE + chunkSize;
+		arena->stats.numChunks++;
+	}
+
+	header = (struct _arenaHeader*)((char*)chunk + CHUNK_HEADER_SIZE + chunk->used);
+	chunk->used += blockSize;
+	header->size = (size_t)ARENA_MIN_BLOCK << sizeClass;
+	header->sizeClass = sizeClass;
+	return header;
+}
+
+
+
+Arena newArena(size_t chunkSize){
+	Arena arena = (Arena)calloc(1, sizeof(struct _arena));
+
+	if (!arena)
+		return NULL;
+
+	arena->chunkSize = chunkSize ? chunkSize : ARENA_DEFAULT_CHUNK;
+	arena->refCount = 1;
+	return arena;
+}
+
+void deleteArena(Arena arena){
+	struct _arenaChunk *currChunk, *nextChunk;
+	struct _arenaLarge *currLarge, *nextLarge;
+
+	if (!arena)
+		return;
+
+	for (currChunk = arena->chunks; currChunk != NULL; currChunk = nextChunk){
+		nextChunk = currChunk->next;
+		free(currChunk);
+	}
+	for (currLarge = arena->large; currLarge != NULL; currLarge = nextLarge){
+		nextLarge = currLarge->next;
+		free(currLarge);
+	}
+	free(arena);
+}
+
+void *Arena_alloc(Arena arena, size_t size){
+	struct _arenaHeader *header;
+	struct _arenaLarge *large;
+	size_t sizeClass = getSizeClass(size);
+
+	if (sizeClass == ARENA_LARGE){
+		large = (struct _arenaLarge*)malloc(sizeof(struct _arenaLarge) + sizeof(struct _arenaHeader) + size);
+		if (!large)
+			return NULL;
+
+		large->prev = NULL;
+		large->next = arena->large;
+		if (arena->large)
+			arena->large->prev = large;
+		arena->large = large;
+		arena->stats.reserved += sizeof(struct _arenaLarge) + sizeof(struct _arenaHeader) + size;
+		arena->stats.numLarge++;
+
+		header = (struct _arenaHeader*)(large + 1);
+		header->size = size;
+		header->sizeClass = ARENA_LARGE;
+	} else if ((header = (arena->freeBlocks)[sizeClass]) != NULL)
+		(arena->freeBlocks)[sizeClass] = *(struct _arenaHeader**)(header + 1);
+	else if (!(header = carveBlock(arena, sizeClass)))
+		return NULL;
+
+	arena->stats.inUse += header->size;
+	if (arena->stats.inUse > arena->stats.peakInUse)
+		arena->stats.peakInUse = arena->stats.inUse;
+	arena->stats.numAllocs++;
+
+	return header + 1;
+}
+
+void *Arena_realloc(Arena arena, void *block, size_t size){
+	struct _arenaHeader *header;
+	struct _arenaLarge *large;
+	void *newBlock;
+
+	if (!block)
+		return Arena_alloc(arena, size);
+
+	header = (struct _arenaHeader*)block - 1;
+	if (size <= header->size)
+		return block;
+
+	/* A large block stays large, the heap may grow it in place */
+	if (header->sizeClass == ARENA_LARGE){
+		large = (struct _arenaLarge*)realloc((struct _arenaLarge*)header - 1, sizeof(struct _arenaLarge) +
+												sizeof(struct _arenaHeader) + size);
+		if (!large)
+			return NULL;
+
+		if (large->prev)
+			large->prev->next = large;
+		else
+			arena->large = large;
+		if (large->next)
+			large->next->prev = large;
+
+		header = (struct _arenaHeader*)(large + 1);
+		arena->stats.reserved += size - header->size;
+		arena->stats.inUse += size - header->size;
+		if (arena->stats.inUse > arena->stats.peakInUse)
+			arena->stats.peakInUse = arena->stats.inUse;
+		header->size = size;
+		return header + 1;
+	}
+
+	newBlock = Arena_alloc(arena, size);
+	if (!newBlock)
+		return NULL;
+
+	memcpy(newBlock, block, header->size);
+	Arena_free(arena, block);
+	return newBlock;
+}
+
+void Arena_free(Arena arena, void *block){
+	struct _arenaHeader *header;
+	struct _arenaLarge *large;
+
+	if (!block)
+		return;
+
+	header = (struct _arenaHeader*)block - 1;
+	arena->stats.inUse -= header->size;
+	arena->stats.numFrees++;
+
+	if (header->sizeClass == ARENA_LARGE){
+		large = (struct _arenaLarge*)header - 1;
+		if (large->prev)
+			large->prev->next = large->next;
+		else
+			arena->large = large->next;
+		if (large->next)
+			large->next->prev = large->prev;
+
+		arena->stats.reserved -= sizeof(struct _arenaLarge) + sizeof(struct _arenaHeader) + header->size;
+		arena->stats.numLarge--;
+		free(large);
+		return;
+	}
+
+	*(struct _arenaHeader**)block = (arena->freeBlocks)[header->sizeClass];
+	(arena->freeBlocks)[header->sizeClass] = header;
+}
+
+void Arena_getStats(Arena arena, struct _arenaStats *stats){
+	*stats = arena->stats;
+}
@@ -0,0 +1,69 @@
+#ifndef TINYALLOC_H
+#define TINYALLOC_H
+
+#include <stddef.h>
+
+/* tinyAlloc - an arena allocator, used by tinyGUI to build GUIObject trees without a heap allocation per object and per field. Blocks
+   are carved from large chunks and sorted into size classes: a freed block goes on its class's free list and is reused by the next
+   allocation of that class, and deleting the arena releases all its blocks at once. Like tinyLayout, it doesn't depend on WinAPI */
+
+#define ARENA_NUM_CLASSES 8 /* The number of size classes, 16 to 2048 bytes. Larger blocks are allocated on their own */
+#define ARENA_MIN_BLOCK 16 /* The size of the smallest class, bytes */
+#define ARENA_DEFAULT_CHUNK (64 * 1024) /* The size of the chunks blocks are carved from by default, bytes */
+#define ARENA_LARGE ARENA_NUM_CLASSES /* The size class of blocks allocated on their own */
+
+/* The header in front of every block */
+struct _arenaHeader {
+	size_t size; /* The usable size of the block */
+	size_t sizeClass; /* ARENA_LARGE for blocks allocated on their own */
+};
+
+/* The links in front of the header of a block allocated on its own */
+struct _arenaLarge {
+	struct _arenaLarge *prev;
+	struct _arenaLarge *next;
+};
+
+/* A chunk that blocks are carved from, the blocks follow its header */
+struct _arenaChunk {
+	struct _arenaChunk *next;
+	size_t size; /* The number of bytes for blocks */
+	size_t used;
+};
+
+/* Allocation statistics, to keep track of the memory footprint */
+struct _arenaStats {
+	size_t reserved; /* The bytes taken from the heap, for chunks and large blocks */
+	size_t inUse; /* The usable bytes of the allocated blocks */
+	size_t peakInUse;
+	unsigned long numAllocs; /* The number of blocks allocated and freed since the arena was created */
+	unsigned long numFrees;
+	unsigned long numChunks;
+	unsigned long numLarge; /* The number of blocks allocated on their own that are in use */
+};
+
+typedef struct _arena *Arena;
+
+struct _arena {
+	size_t chunkSize;
+	struct _arenaChunk *chunks; /* The newest chunk first, blocks are only carved from it */
+	struct _arenaLarge *large;
+	struct _arenaHeader *freeBlocks[ARENA_NUM_CLASSES]; /* The free lists, linked through the blocks' first bytes */
+	struct _arenaStats stats;
+	long refCount; /* The references its users hold to the arena, 1 for its creator. tinyAlloc leaves it to them, see releaseArena */
+};
+
+/* Constructor and destructor. A chunkSize of 0 uses ARENA_DEFAULT_CHUNK. Deleting an arena releases all the blocks allocated in it */
+Arena newArena(size_t chunkSize);
+void deleteArena(Arena arena);
+
+/* Allocates a block of at least size bytes. Returns NULL on failure */
+void *Arena_alloc(Arena arena, size_t size);
+/* Resizes a block like realloc, a NULL block is allocated. Returns NULL on failure, the block is left as it was */
+void *Arena_realloc(Arena arena, void *block, size_t size);
+/* Frees a block, it is reused by the next allocation of its size class. A NULL block is ignored */
+void Arena_free(Arena arena, void *block);
+/* Gets the allocation statistics */
+void Arena_getStats(Arena arena, struct _arenaStats *stats);
+
+#endif
@@ -27,28 +27,640 @@ static HANDLE getMutexOwnership(char *mutexName){
 /* The window proc prototype */
 static LRESULT CALLBACK windowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+/* Used by releaseGUIObject */
+static void deleteObjectLock(Object object);
 
-/* Register a window's WinAPI "class" */
-static BOOL registerClass(HINSTANCE hInstance, char *className, WNDPROC procName){
-	WNDCLASSEXA wc;
-	BOOL result;
+/* Used by GUIObject_setText */
+static BOOL setTextBoxText(TextBox textbox, const char *text, unsigned int length);
+static BOOL inWindowThread(HWND hwnd);
+static void requestTextBoxUpdate(TextBox textbox);
+
+/* Used by TabContainer_selectPage and displayChildren */
+static BOOL showTabPage(TabContainer tabcontainer, unsigned int page);
+/* Used by addListRows and displayControlTree */
+static BOOL realizeControl(Control control, BOOL paint);
+static void displayChildren(GUIObject object);
+static void scheduleHibernation(TabContainer tabcontainer);
+
+
+/* The arena the GUIObjects the thread constructs are allocated in, NULL for the heap. Each thread has its own, so a tree built on one
+   thread doesn't end up in the arena of a tree built on another */
+static __declspec(thread) Arena currentArena = NULL;
+
+/* Makes the GUIObjects the calling thread constructs from now on, and their fields, allocated in an arena. NULL goes back to the heap.
+   Returns the arena used before */
+Arena useArena(Arena arena){
+	Arena prevArena = currentArena;
+
+	currentArena = arena;
+	return prevArena;
+}
+
+/* Allocate, resize and free the memory of a GUIObject or of its fields in an arena, or on the heap for a NULL arena */
+static void *allocObjectMemory(Arena arena, size_t size){
+	return arena ? Arena_alloc(arena, size) : malloc(size);
+}
+
+static void *reallocObjectMemory(Arena arena, void *memory, size_t size){
+	return arena ? Arena_realloc(arena, memory, size) : realloc(memory, size);
+}
+
+static void freeObjectMemory(Arena arena, void *memory){
+	if (arena)
+		Arena_free(arena, memory);
+	else
+		free(memory);
+}
+
+/* Epoch-based reclamation: threads that read GUIObjects outside of the message loop, like the async event workers, do it inside an
+   epoch. The memory of GUIObjects and their fields freed meanwhile is retired instead, and released once every thread that entered an
+   epoch before it was retired has left. Entering and leaving only take interlocked operations on the thread's own slot */
+struct _retiredMemory {
+	struct _retiredMemory *next;
+	void *memory;
+	void (*release)(void*); /* Releases the memory: free for blocks, other functions for arenas and mapped UI files */
+	LONG epoch; /* The global epoch when the memory was retired */
+};
+
+static volatile LONG globalEpoch = 1;
+static volatile LONG epochSlots[OBJECT_EPOCH_SLOTS]; /* The epoch each thread entered, 0 for a free slot */
+static volatile LONG numEpochThreads = 0;
+static struct _retiredMemory *volatile retiredMemory = NULL; /* A lock-free stack */
+
+/* Pushes a list of retired memory, linked from first to last, on the retired memory stack */
+static void pushRetiredMemory(struct _retiredMemory *first, struct _retiredMemory *last){
+	do
+		last->next = retiredMemory;
+	while (InterlockedCompareExchangePointer((void* volatile*)&retiredMemory, first, last->next) != last->next);
+}
+
+/* Releases the retired memory that no thread inside an epoch can still read. The stack is taken before the slots are scanned, so
+   that a thread entering in between can't have seen the memory taken */
+static void reclaimRetiredMemory(){
+	struct _retiredMemory *curr, *next, *first = NULL, *last = NULL;
+	LONG oldestEpoch = MAXLONG, epoch;
+	unsigned int i;
+
+	curr = (struct _retiredMemory*)InterlockedExchangePointer((void* volatile*)&retiredMemory, NULL);
+	if (!curr)
+		return;
+
+	for (i = 0; i < OBJECT_EPOCH_SLOTS; i++)
+		if ((epoch = epochSlots[i]) != 0 && epoch < oldestEpoch)
+			oldestEpoch = epoch;
+
+	for (; curr != NULL; curr = next){
+		next = curr->next;
+		if (curr->epoch < oldestEpoch){
+			curr->release(curr->memory);
+			free(curr);
+		} else {
+			curr->next = first;
+			first = curr;
+			if (!last)
+				last = curr;
+		}
+	}
+
+	if (first)
+		pushRetiredMemory(first, last);
+}
+
+/* Releases memory with its release function, or retires it if a thread is inside an epoch */
+static void retireMemory(void *memory, void (*release)(void*)){
+	struct _retiredMemory *retired;
+
+	if (!numEpochThreads){
+		release(memory);
+		return;
+	}
+
+	retired = (struct _retiredMemory*)malloc(sizeof(struct _retiredMemory));
+	if (!retired)
+		return; /* Leaked rather than freed under a reading thread */
+
+	retired->memory = memory;
+	retired->release = release;
+	retired->epoch = InterlockedIncrement(&globalEpoch) - 1;
+	pushRetiredMemory(retired, retired);
+	reclaimRetiredMemory();
+}
+
+/* Frees the memory of a GUIObject or of its fields, or retires it if a thread is inside an epoch. Arena memory is left to its arena
+   then, the arena itself is retired once it is released (see releaseArena) */
+static void retireObjectMemory(Arena arena, void *memory){
+	if (!memory)
+		return;
+	if (!numEpochThreads)
+		freeObjectMemory(arena, memory);
+	else if (!arena)
+		retireMemory(memory, free);
+}
+
+static void releaseRetiredArena(void *arena){
+	deleteArena((Arena)arena);
+}
+
+/* Releases a reference to an arena. Each GUIObject allocated in it holds one until its memory is released, so that an arena deleted
+   along with its GUIObjects stays allocated while a thread still retains one of them. The arena is deleted when its creator and the
+   GUIObjects have released theirs, or retired until no thread inside an epoch can read it */
+void releaseArena(Arena arena){
+	if (arena && !InterlockedDecrement(&(arena->refCount)))
+		retireMemory(arena, releaseRetiredArena);
+}
+
+/* Enters an epoch, the GUIObjects the thread can reach stay readable until it leaves. Waits for a free slot if all of them are taken,
+   so it isn't meant for the UI thread. Returns the slot to pass to leaveObjectEpoch */
+int enterObjectEpoch(){
+	unsigned int i;
+
+	InterlockedIncrement(&numEpochThreads);
+	for (;;){
+		for (i = 0; i < OBJECT_EPOCH_SLOTS; i++)
+			if (!epochSlots[i] && !InterlockedCompareExchange(&(epochSlots[i]), globalEpoch, 0))
+				return (int)i;
+		Sleep(0); /* All the slots are taken */
+	}
+}
+
+/* Leaves an epoch, releasing the retired memory nothing reads anymore */
+void leaveObjectEpoch(int slot){
+	InterlockedExchange(&(epochSlots[slot]), 0);
+	InterlockedDecrement(&numEpochThreads);
+	reclaimRetiredMemory();
+}
+
+/* Takes a reference to a GUIObject, its memory stays valid until the reference is released. Returns the GUIObject */
+GUIObject retainGUIObject(GUIObject object){
+	if (object)
+		InterlockedIncrement(&(object->refCount));
+	return object;
+}
+
+/* Releases a reference to a GUIObject. The memory of a GUIObject is retired when its destructor and every other holder have
+   released theirs */
+void releaseGUIObject(GUIObject object){
+	Arena arena;
+
+	if (object && !InterlockedDecrement(&(object->refCount))){
+		arena = object->arena;
+		deleteObjectLock((Object)object);
+		retireObjectMemory(arena, object);
+		releaseArena(arena);
+	}
+}
+
+/* The limits of a GUIObject that has none set */
+static const struct _limits defaultLimits = { 0, 0, INT_MAX, INT_MAX, INT_MIN, INT_MIN, INT_MAX, INT_MAX };
+
+/* Gets a GUIObject's limits, the default ones if it has none set */
+static const struct _limits *getLimits(GUIObject object){
+	return object->limits ? object->limits : &defaultLimits;
+}
+
+/* Gets a GUIObject's limits to change them, creating them with the default values if it has none. Returns NULL on failure */
+static struct _limits *ensureLimits(GUIObject object){
+	if (!object->limits){
+		object->limits = (struct _limits*)allocObjectMemory(object->arena, sizeof(struct _limits));
+		if (object->limits)
+			*(object->limits) = defaultLimits;
+	}
+
+	return object->limits;
+}
+
+/* Gets a GUIObject's paint state, creating it if it has none. Returns NULL on failure */
+static struct _paintState *ensurePaintState(GUIObject object){
+	if (!object->paintState){
+		object->paintState = (struct _paintState*)allocObjectMemory(object->arena, sizeof(struct _paintState));
+		if (object->paintState)
+			object->paintState->offscreenBitmap = NULL;
+	}
+
+	return object->paintState;
+}
 
-	wc.cbSize = sizeof(WNDCLASSEXA);
-    wc.style = 0;
-	wc.lpfnWndProc = procName;
+/* Gets a GUIObject's text if it was allocated for the GUIObject, NULL if it's inline, borrowed or missing */
+static char *getOwnedText(GUIObject object){
+	return object->text != object->textInline && !object->textBorrowed ? object->text : NULL;
+}
+
+/* Makes room for a new text of length bytes in a GUIObject's text field, in textInline if it fits there. The caller fills it in,
+   with the terminating null. Returns NULL on failure, the text is left as it was. The texts that don't fit are on the heap even for
+   GUIObjects in an arena: they are set from any thread, and an arena is only used by the thread that builds its tree */
+static char *reserveText(GUIObject object, unsigned int length){
+	char *newText;
+
+	if (length < GUIOBJECT_INLINE_TEXT){
+		free(getOwnedText(object));
+		newText = object->textInline;
+	} else {
+		newText = (char*)realloc(getOwnedText(object), length + 1);
+		if (!newText)
+			return NULL;
+	}
+
+	object->text = newText;
+	object->textLength = length;
+	object->textBorrowed = FALSE;
+	object->wideTextStale = TRUE;
+	return newText;
+}
+
+/* Points a GUIObject's text to a null-terminated text of length bytes without copying it. The text must stay valid until the
+   GUIObject is deleted or gets a new text */
+static void borrowText(GUIObject object, const char *text, unsigned int length){
+	free(getOwnedText(object));
+
+	object->text = (char*)text;
+	object->textLength = length;
+	object->textBorrowed = TRUE;
+	object->wideTextStale = TRUE;
+}
+
+/* Copies a text of length bytes to a GUIObject's text field */
+static BOOL storeText(GUIObject object, const char *text, unsigned int length){
+	char *newText = reserveText(object, length);
+
+	if (!newText)
+		return FALSE;
+
+	memcpy(newText, text, length);
+	newText[length] = '\0';
+	return TRUE;
+}
+
+/* Gets a GUIObject's text in UTF-16, converting it if it changed since it was last converted. Like the text, it's on the heap. Returns
+   NULL on failure */
+static WCHAR *getWideText(GUIObject object){
+	int length;
+	WCHAR *newWideText;
+
+	if (!object->wideTextStale && object->wideText)
+		return object->wideText;
+
+	length = object->textLength ? MultiByteToWideChar(CP_UTF8, 0, object->text, (int)object->textLength, NULL, 0) : 0;
+	if (object->textLength && !length)
+		return NULL;
+
+	if ((unsigned int)length + 1 > object->wideTextCapacity || !object->wideText){
+		newWideText = (WCHAR*)realloc(object->wideText, ((unsigned int)length + 1) * sizeof(WCHAR));
+		if (!newWideText)
+			return NULL;
+		object->wideText = newWideText;
+		object->wideTextCapacity = (unsigned int)length + 1;
+	}
+
+	if (length)
+		MultiByteToWideChar(CP_UTF8, 0, object->text, (int)object->textLength, object->wideText, length);
+	(object->wideText)[length] = L'\0';
+	object->wideTextStale = FALSE;
+	return object->wideText;
+}
+
+
+/* A WinAPI window "class" registered for Windows, shared by all the Windows with the same configuration */
+struct _windowClass {
+	HINSTANCE instance;
+	UINT style;
+	WNDPROC proc;
+	HICON icon; /* NULL for the default icon */
+	HBRUSH background;
+	char name[16];
+	unsigned int numUsers; /* The number of Windows using the class. Classes without users stay registered, to be reused */
+	struct _windowClass *next;
+};
+
+/* The registered window classes. Windows can be initialized on any thread, so they are guarded by a spin lock */
+static struct _windowClass *windowClasses = NULL;
+static volatile LONG windowClassesLock = FALSE;
+static unsigned int numWindowClassNames = 0;
+
+static void lockWindowClasses(){
+	while (InterlockedExchange(&windowClassesLock, TRUE))
+		Sleep(0);
+}
+
+static void unlockWindowClasses(){
+	InterlockedExchange(&windowClassesLock, FALSE);
+}
+
+/* Registers a window class with a configuration. Its windows are Unicode ones */
+static BOOL registerWindowClass(struct _windowClass *windowClass){
+	WNDCLASSEXW wc;
+	WCHAR wideName[sizeof(windowClass->name)];
+
+	if (!MultiByteToWideChar(CP_UTF8, 0, windowClass->name, -1, wideName, sizeof(wideName) / sizeof(WCHAR)))
+		return FALSE;
+
+	wc.cbSize = sizeof(WNDCLASSEXW);
+	wc.style = windowClass->style;
+	wc.lpfnWndProc = windowClass->proc;
 	wc.cbClsExtra = 0;
-    wc.cbWndExtra = 0;
-    wc.hInstance = hInstance;
-    wc.hIcon = LoadIcon(GetModuleHandle(NULL), NULL);
-    wc.hCursor = LoadCursor(NULL, IDC_ARROW);
-    wc.hbrBackground = (HBRUSH)COLOR_WINDOW;
-    wc.lpszMenuName = NULL;
-    wc.lpszClassName = className;
-    wc.hIconSm = (HICON)LoadImage(GetModuleHandle(NULL), NULL, IMAGE_ICON, 16, 16, 0);
+	wc.cbWndExtra = 0;
+	wc.hInstance = windowClass->instance;
+	wc.hIcon = windowClass->icon ? windowClass->icon : LoadIcon(GetModuleHandle(NULL), NULL);
+	wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+	wc.hbrBackground = windowClass->background;
+	wc.lpszMenuName = NULL;
+	wc.lpszClassName = wideName;
+	wc.hIconSm = windowClass->icon ? windowClass->icon : (HICON)LoadImage(GetModuleHandle(NULL), NULL, IMAGE_ICON, 16, 16, 0);
+
+	return RegisterClassExW(&wc) != 0;
+}
 
-	result = RegisterClassExA(&wc);
+/* Gets the window class with a configuration for a new user, registering it if there is none yet. Returns NULL on failure */
+static struct _windowClass *acquireWindowClass(HINSTANCE instance, UINT style, WNDPROC proc, HICON icon, HBRUSH background){
+	struct _windowClass *windowClass;
 
-	return result;
+	lockWindowClasses();
+
+	for (windowClass = windowClasses; windowClass != NULL; windowClass = windowClass->next)
+		if (windowClass->instance == instance && windowClass->style == style && windowClass->proc == proc &&
+				windowClass->icon == icon && windowClass->background == background)
+			break;
+
+	if (!windowClass){
+		windowClass = (struct _windowClass*)malloc(sizeof(struct _windowClass));
+		if (windowClass){
+			windowClass->instance = instance; windowClass->style = style; windowClass->proc = proc;
+			windowClass->icon = icon; windowClass->background = background;
+			windowClass->numUsers = 0;
+			sprintf_s(windowClass->name, sizeof(windowClass->name), "tinyGUI%u", numWindowClassNames++);
+
+			if (registerWindowClass(windowClass)){
+				windowClass->next = windowClasses;
+				windowClasses = windowClass;
+			} else {
+				free(windowClass);
+				windowClass = NULL;
+			}
+		}
+	}
+
+	if (windowClass)
+		windowClass->numUsers++;
+
+	unlockWindowClasses();
+	return windowClass;
+}
+
+/* Lets go of a window class when a Window using it is deleted */
+static void releaseWindowClass(struct _windowClass *windowClass){
+	if (!windowClass)
+		return;
+
+	lockWindowClasses();
+	windowClass->numUsers--;
+	unlockWindowClasses();
+}
+
+/* Unregisters the window classes that no Window uses anymore */
+void unregisterWindowClasses(){
+	struct _windowClass **link, *windowClass;
+
+	lockWindowClasses();
+
+	link = &windowClasses;
+	while (*link != NULL){
+		windowClass = *link;
+		if (!windowClass->numUsers && UnregisterClassA(windowClass->name, windowClass->instance)){
+			*link = windowClass->next;
+			free(windowClass);
+		} else
+			link = &(windowClass->next);
+	}
+
+	unlockWindowClasses();
+}
+
+/* Check if a GUIObject is a control (and thus has the Control fields, like anchor) */
+static BOOL isControl(GUIObject object){
+	return object->type >= CONTROL && object->type < EVENTARGS;
+}
+
+/* Creates a GUIObject's layout node if it has none, with the GUIObject's size and size limits, and attaches it to its parent's node */
+static BOOL ensureLayoutNode(GUIObject object){
+	if (!object->layoutNode){
+		object->layoutNode = newLayoutNode(object);
+		if (!object->layoutNode)
+			return FALSE;
+
+		LayoutNode_setSize(object->layoutNode, (float)object->realWidth, (float)object->realHeight);
+		LayoutNode_setMinSize(object->layoutNode, (float)getLimits(object)->minWidth, (float)getLimits(object)->minHeight);
+		LayoutNode_setMaxSize(object->layoutNode, (float)getLimits(object)->maxWidth, (float)getLimits(object)->maxHeight);
+	}
+
+	if (object->parent && object->parent->layoutNode && object->layoutNode->parent != object->parent->layoutNode)
+		return LayoutNode_addChild(object->parent->layoutNode, object->layoutNode);
+
+	return TRUE;
+}
+
+/* The geometry of a GUIObject's children in structure-of-arrays form, indexed by the children's slots in the children array.
+   It persists between layout passes and holds the values the anchor pass works on, so a pass that only resizes the parent reads
+   contiguous arrays instead of every child's structure, resolves the anchors four children at a time (with SSE2) and only writes
+   back the children that changed. The GUIObject fields stay the public values: the table is gathered from them again once any child
+   is invalidated (all the methods that change a child's geometry do that) */
+struct _geometryTable {
+	unsigned int capacity; /* The number of slots, a multiple of GEOMETRY_BLOCK */
+	unsigned int numSlots; /* The number of children the table was gathered for */
+	BOOL stale; /* The fields of a child may have changed since the table was gathered */
+	int *block; /* The memory of all the arrays */
+
+	int *slotFlags; /* A combination of the SLOT_ values */
+	int *anchor;
+	int *realX, *realY, *realWidth, *realHeight;
+	int *x, *y, *width, *height;
+	int *minX, *maxX, *minY, *maxY;
+	int *minWidth, *maxWidth, *minHeight, *maxHeight;
+
+	unsigned int *movedSlots; /* The slots of the children moved by the current layout pass */
+	unsigned int numMovedSlots;
+};
+
+#define GEOMETRY_BLOCK 4 /* The number of slots resolved at once */
+#define GEOMETRY_NUM_ARRAYS 19
+
+#define SLOT_CONTROL 0x1 /* The child is a control, and has anchors */
+#define SLOT_HAS_CHILDREN 0x2 /* The child has children of its own */
+
+/* Makes a geometry table big enough for a number of children. A table that grows has to be gathered again */
+static struct _geometryTable *reserveGeometryTable(struct _geometryTable *table, unsigned int numSlots){
+	unsigned int capacity;
+	int *newBlock, **arrays[GEOMETRY_NUM_ARRAYS - 1];
+	int i;
+
+	if (table && table->capacity >= numSlots + GEOMETRY_BLOCK)
+		return table;
+
+	if (!table){
+		table = (struct _geometryTable*)calloc(1, sizeof(struct _geometryTable));
+		if (!table)
+			return NULL;
+	}
+
+	/* Grow geometrically, keeping room to pad the last block */
+	capacity = table->capacity ? table->capacity : GEOMETRY_BLOCK * 2;
+	while (capacity < numSlots + GEOMETRY_BLOCK)
+		capacity *= 2;
+
+	newBlock = (int*)malloc(capacity * GEOMETRY_NUM_ARRAYS * sizeof(int));
+	if (!newBlock){
+		if (!table->capacity)
+			free(table);
+		return NULL;
+	}
+
+	free(table->block);
+	table->block = newBlock;
+	table->capacity = capacity;
+	table->stale = TRUE;
+
+	arrays[0] = &(table->slotFlags); arrays[1] = &(table->anchor);
+	arrays[2] = &(table->realX); arrays[3] = &(table->realY); arrays[4] = &(table->realWidth); arrays[5] = &(table->realHeight);
+	arrays[6] = &(table->x); arrays[7] = &(table->y); arrays[8] = &(table->width); arrays[9] = &(table->height);
+	arrays[10] = &(table->minX); arrays[11] = &(table->maxX); arrays[12] = &(table->minY); arrays[13] = &(table->maxY);
+	arrays[14] = &(table->minWidth); arrays[15] = &(table->maxWidth); arrays[16] = &(table->minHeight); arrays[17] = &(table->maxHeight);
+	for (i = 0; i < GEOMETRY_NUM_ARRAYS - 1; i++)
+		*(arrays[i]) = newBlock + i * capacity;
+	table->movedSlots = (unsigned int*)(newBlock + (GEOMETRY_NUM_ARRAYS - 1) * capacity);
+
+	return table;
+}
+
+static void deleteGeometryTable(struct _geometryTable *table){
+	if (!table)
+		return;
+
+	free(table->block);
+	free(table);
+}
+
+/* Gets how far the children of a GUIObject are scrolled in its client area: the scroll position of a ScrollPanel, none for the other
+   GUIObjects. The children's x and y fields are in the scrolled content, their windows are placed that much up and to the left */
+static void getScrollOffset(GUIObject object, int *x, int *y){
+	if (object && object->type == SCROLLPANEL){
+		*x = ((ScrollPanel)object)->scrollX;
+		*y = ((ScrollPanel)object)->scrollY;
+	} else
+		*x = *y = 0;
+}
+
+/* Gets the host of a windowless GUIObject: its closest ancestor that has a window. Gets the offset of the GUIObject in the host's client
+   area through x and y */
+static GUIObject getWindowlessHost(GUIObject object, int *x, int *y){
+	int scrollX, scrollY;
+
+	*x = *y = 0;
+
+	for (; object != NULL && object->windowless; object = object->parent){
+		*x += object->x;
+		*y += object->y;
+	}
+
+	/* Only a host can be scrolled, a ScrollPanel can't be windowless */
+	getScrollOffset(object, &scrollX, &scrollY);
+	*x -= scrollX;
+	*y -= scrollY;
+
+	return object;
+}
+
+/* Schedules a repaint of a windowless GUIObject's host where the GUIObject was last painted and where it is now */
+static BOOL invalidateWindowless(GUIObject object){
+	GUIObject host;
+	RECT currRect, paintedRect;
+	int x, y, scrollX, scrollY;
+
+	host = getWindowlessHost(object, &x, &y);
+	if (!host || !host->handle)
+		return TRUE; /* It will be painted when its host is displayed */
+
+	SetRect(&currRect, x, y, x + object->width, y + object->height);
+
+	/* The painted rectangle is kept in the host's content, so that scrolling the host doesn't make it stale */
+	if (!IsRectEmpty(&(object->paintedRect))){
+		getScrollOffset(host, &scrollX, &scrollY);
+		paintedRect = object->paintedRect;
+		OffsetRect(&paintedRect, -scrollX, -scrollY);
+		InvalidateRect(host->handle, &paintedRect, TRUE);
+	}
+	return InvalidateRect(host->handle, &currRect, TRUE);
+}
+
+/* Inserts or updates a GUIObject's rectangle in its parent's spatial index, if the parent has one */
+static void updateSpatialItem(GUIObject object){
+	SpatialIndex index;
+
+	if (!object->parent || !(index = object->parent->childrenIndex) || object->x == CW_USEDEFAULT || object->y == CW_USEDEFAULT)
+		return;
+
+	if (object->spatialItem < 0)
+		object->spatialItem = SpatialIndex_insert(index, object, object->x, object->y, object->x + object->width,
+													object->y + object->height);
+	else
+		SpatialIndex_update(index, object->spatialItem, object->x, object->y, object->x + object->width, object->y + object->height);
+}
+
+/* Internal tinyGUI messages. They are all posted as one message registered for tinyGUI, so they don't collide with the application's
+   WM_APP and WM_USER messages, and told apart by their wParam */
+enum _internalMessage {
+	UPDATE_LAYOUT, /* Posted to the root of a GUIObject tree to run a layout pass over its dirty subtrees */
+	UPDATE_LOG, /* Posted to a LogView when lines were appended or dropped */
+	TILES_LOADED, /* Posted to an ImageView when tiles were decoded */
+	TREE_LOADED, /* Posted to a TreeView when children of its nodes were fetched */
+	UPDATE_TEXTBOX /* Posted to a TextBox when its text was changed on another thread */
+};
+#define INTERNAL_MESSAGE_NAME "tinyGUI.internal"
+#define INTERNAL_MESSAGE_FALLBACK (WM_APP + 0x3FFF) /* Used if the message can't be registered, the last of the WM_APP range */
+
+static volatile UINT internalMessage = 0; /* 0 until the first internal message is posted */
+
+/* Posts an internal message to a window, registering the message on first use. Threads that register it at the same time get
+   the same value */
+static BOOL postInternalMessage(HWND hwnd, enum _internalMessage type){
+	UINT message = internalMessage;
+
+	if (!message){
+		message = RegisterWindowMessageA(INTERNAL_MESSAGE_NAME);
+		if (!message)
+			message = INTERNAL_MESSAGE_FALLBACK;
+		internalMessage = message;
+	}
+
+	return PostMessageA(hwnd, message, (WPARAM)type, (LPARAM)NULL);
+}
+
+/* Internal tinyGUI timers */
+#define TABCONTAINER_TIMER 1 /* Goes off when a TabContainer's hidden page is due to be hibernated */
+
+/* Marks a GUIObject's layout as dirty and the subtrees of all its ancestors as containing dirty layouts. When a tree gets its
+   first dirty layout, a layout pass is scheduled on its root's window */
+void invalidateLayout(GUIObject object){
+	GUIObject currObject;
+	UINT prevFlags;
+
+	if (!object)
+		return;
+
+	if (object->parent && object->parent->childrenGeometry)
+		object->parent->childrenGeometry->stale = TRUE;
+
+	prevFlags = object->layoutFlags;
+	object->layoutFlags |= LAYOUT_DIRTY;
+
+	for (currObject = object; currObject->parent != NULL; currObject = currObject->parent){
+		if ((currObject->parent)->layoutFlags & LAYOUT_SUBTREE_DIRTY)
+			return; /* A layout pass is already pending for this tree */
+		(currObject->parent)->layoutFlags |= LAYOUT_SUBTREE_DIRTY;
+	}
+
+	if (currObject == object && (prevFlags & (LAYOUT_DIRTY | LAYOUT_SUBTREE_DIRTY)))
+		return;
+
+	if (currObject->handle)
+		postInternalMessage(currObject->handle, UPDATE_LAYOUT);
 }
 
 
@@ -61,19 +673,90 @@ static BOOL registerClass(HINSTANCE hInstance, char *className, WNDPROC procName
 
 
 /* Class Object */
+/* The lock of the objects whose own lock couldn't be allocated */
+static CRITICAL_SECTION fallbackLock;
+static volatile LONG fallbackLockState = 0; /* 0 before the lock is initialized, 1 while it is and 2 after */
+
+static CRITICAL_SECTION *getFallbackLock(){
+	if (fallbackLockState != 2){
+		if (!InterlockedCompareExchange(&fallbackLockState, 1, 0)){
+			InitializeCriticalSection(&fallbackLock);
+			InterlockedExchange(&fallbackLockState, 2);
+		} else
+			while (fallbackLockState != 2)
+				Sleep(0);
+	}
+
+	return &fallbackLock;
+}
+
+static volatile LONG numObjectLocks = 0; /* The objects' own locks that exist */
+
+/* Gets the lock of an object, creating it on first use. The threads that race to create it agree on the first one set. It is set
+   under the fallback lock, which enterExistingLock holds for the objects that have no lock yet */
+CRITICAL_SECTION *getObjectLock(Object object){
+	CRITICAL_SECTION *lock = object->lock;
+
+	if (lock)
+		return lock;
+
+	lock = (CRITICAL_SECTION*)malloc(sizeof(CRITICAL_SECTION)); /* Not in an arena, arenas aren't shared between threads */
+	if (!lock)
+		return getFallbackLock();
+	InitializeCriticalSection(lock);
+
+	EnterCriticalSection(getFallbackLock());
+	if (InterlockedCompareExchangePointer((void* volatile*)&(object->lock), lock, NULL) != NULL){
+		DeleteCriticalSection(lock);
+		free(lock);
+	} else
+		InterlockedIncrement(&numObjectLocks);
+	LeaveCriticalSection(&fallbackLock);
+
+	return object->lock;
+}
+
+/* Enters the lock of an object without creating it. An object that was never synchronized is held through the fallback lock
+   instead, until another thread gives it a lock. The layout pass moves every control of a window, so it doesn't give each one a
+   lock. Returns the lock to leave */
+static CRITICAL_SECTION *enterExistingLock(Object object){
+	CRITICAL_SECTION *lock = object->lock;
+
+	if (!lock){
+		EnterCriticalSection(getFallbackLock());
+		lock = object->lock;
+		if (!lock)
+			return &fallbackLock;
+		LeaveCriticalSection(&fallbackLock);
+	}
+
+	EnterCriticalSection(lock);
+	return lock;
+}
+
+LONG getNumObjectLocks(){
+	return numObjectLocks;
+}
+
+static void releaseObjectLock(void *lock){
+	DeleteCriticalSection((CRITICAL_SECTION*)lock);
+	free(lock);
+	InterlockedDecrement(&numObjectLocks);
+}
+
+/* Deletes the lock of an object that is being deleted, once no thread inside an epoch can be holding it */
+static void deleteObjectLock(Object object){
+	if (object->lock && object->lock != &fallbackLock)
+		retireMemory(object->lock, releaseObjectLock);
+	object->lock = NULL;
+}
+
 /* The Constructor*/
 void initObject(Object thisObject){
 	if (!thisObject)
 		return;
 	
 	CLASS_Object;
-	
-	/* Try to delete critical section just in case */
-	if (thisObject->criticalSectionInitialized)
-		DeleteCriticalSection(&(thisObject->criticalSection));
-
-	InitializeCriticalSection(&(thisObject->criticalSection));
-	thisObject->criticalSectionInitialized = TRUE;
 }
 
 Object newObject(){
@@ -88,7 +771,7 @@ Object newObject(){
 }
 
 void deleteObject(Object thisObject){
-	DeleteCriticalSection(&(thisObject->criticalSection));
+	deleteObjectLock(thisObject);
 	free(thisObject);
 }
 
@@ -97,92 +780,211 @@ void deleteObject(Object thisObject){
 
 
 /* Class GUIObject */
+/* The vtable shared by all GUIObjects */
+MAKE_VTABLE_INSTANCE(GUIObject, GUIObject);
 
-BOOL GUIObject_addChild(GUIObject object, GUIObject child){
-	GUIObject *newChildrenPointer;
-	unsigned int i;
-	
-	if (!object)
-		return FALSE;
-	
-	child->parent = object;
-	
-	if (object->children != NULL)
+/* Makes room for count more children at the end of a GUIObject's children. When the array is full, the slots of removed children
+   are compacted away if they take at least a quarter of it, otherwise it's doubled (until the children fit), so adding children takes
+   amortized constant time whatever the children removed in between */
+static BOOL reserveChildSlots(GUIObject object, unsigned int count){
+	GUIObject *newChildren;
+	unsigned int i, numSlots = 0, newCapacity;
+
+	if (object->numChildren + count <= object->childrenCapacity)
+		return TRUE;
+
+	if (object->numRemovedChildren && object->numRemovedChildren >= object->childrenCapacity / 4){
+		/* Keep the z-order of the remaining children */
 		for (i = 0; i < object->numChildren; i++)
-			if ((object->children)[i] == NULL){
-				(object->children)[i] = child;
-				return TRUE;
+			if ((object->children)[i] != NULL){
+				(object->children)[numSlots] = (object->children)[i];
+				(object->children)[numSlots]->childIndex = numSlots;
+				numSlots++;
 			}
-	
-	
-	(object->numChildren)++;
-	newChildrenPointer = (GUIObject*)realloc(object->children, object->numChildren * sizeof(GUIObject));
-	
-	if (!newChildrenPointer)
+		object->numChildren = numSlots;
+		object->numRemovedChildren = 0;
+		if (object->childrenGeometry)
+			object->childrenGeometry->stale = TRUE; /* Its slots follow the children's */
+		if (object->numChildren + count <= object->childrenCapacity)
+			return TRUE;
+	}
+
+	newCapacity = object->childrenCapacity ? object->childrenCapacity * 2 : 4;
+	while (newCapacity < object->numChildren + count)
+		newCapacity *= 2;
+	newChildren = (GUIObject*)reallocObjectMemory(object->arena, object->children, newCapacity * sizeof(GUIObject));
+	if (!newChildren)
+		return FALSE;
+
+	object->children = newChildren;
+	object->childrenCapacity = newCapacity;
+	return TRUE;
+}
+
+/* Puts a child in the slot reserved for it at the end of a GUIObject's children */
+static void attachChild(GUIObject object, GUIObject child){
+	child->parent = object;
+	child->childIndex = object->numChildren;
+	(object->children)[(object->numChildren)++] = child;
+	if (child->windowless)
+		(object->numWindowless)++;
+	if (object->layoutNode && object->layoutNode->type != LAYOUT_NONE)
+		ensureLayoutNode(child);
+	else if (child->layoutNode && object->layoutNode)
+		LayoutNode_addChild(object->layoutNode, child->layoutNode);
+	if (object->childrenGeometry)
+		object->childrenGeometry->stale = TRUE;
+	updateSpatialItem(child);
+}
+
+/* Realizes a child added to a GUIObject that was already realized, along with the child's descendants. It isn't painted right away,
+   the message loop paints it with the rest of the window. The children of a GUIObject that is still being realized are realized by
+   that traversal, and the pages of a TabContainer when they are shown */
+static void realizeAddedChild(GUIObject object, GUIObject child){
+	if (object->realizeState != REALIZED || object->type == TABCONTAINER || child->realizeState != UNREALIZED)
+		return;
+
+	if (realizeControl((Control)child, FALSE))
+		displayChildren(child);
+}
+
+/* Adds a child object to a GUIObject, on top of its other children */
+BOOL GUIObject_addChild(GUIObject object, GUIObject child){
+	if (!object || !reserveChildSlots(object, 1))
 		return FALSE;
 	
-	object->children = newChildrenPointer;
-	(object->children)[object->numChildren - 1] = child;
+	attachChild(object, child);
+	invalidateLayout(object);
+	realizeAddedChild(object, child);
 	
 	return TRUE;
 }
+
+/* Adds children to a GUIObject, on top of its other children in the order given. The children array grows once and the layout is
+   invalidated once, for all of them */
+BOOL GUIObject_addChildren(GUIObject object, GUIObject *children, unsigned int numChildren){
+	unsigned int i;
+
+	if (!object || !children || !reserveChildSlots(object, numChildren))
+		return FALSE;
+
+	for (i = 0; i < numChildren; i++)
+		attachChild(object, children[i]);
+	if (numChildren)
+		invalidateLayout(object);
+	for (i = 0; i < numChildren; i++)
+		realizeAddedChild(object, children[i]);
+
+	return TRUE;
+}
 	
-/* Removes a child object from a GUIObject */
+/* Removes a child object from a GUIObject. Its slot is found through its childIndex and left NULL, so the other children keep theirs */
 BOOL GUIObject_removeChild(GUIObject object, GUIObject child){
-	unsigned int i;
+	GUIObject host;
+	int x, y;
 	
-	if (!object)
+	if (!object || child->childIndex >= object->numChildren || (object->children)[child->childIndex] != child)
 		return FALSE;
 	
+	if (child->windowless){
+		/* Repaint the host where the child was, and make sure the host doesn't keep routing input to it */
+		invalidateWindowless(child);
+		host = getWindowlessHost(child, &x, &y);
+		if (host && (host->windowlessCapture == child || host->windowlessFocus == child)){
+			if (host->windowlessCapture == child)
+				ReleaseCapture();
+			host->windowlessCapture = host->windowlessFocus = NULL;
+		}
+		(object->numWindowless)--;
+	}
 	child->parent = NULL;
+	if (child->spatialItem >= 0){
+		SpatialIndex_remove(object->childrenIndex, child->spatialItem);
+		child->spatialItem = -1;
+	}
+	if (child->layoutNode && child->layoutNode->parent)
+		LayoutNode_removeChild(child->layoutNode->parent, child->layoutNode);
+	if (object->childrenGeometry)
+		object->childrenGeometry->stale = TRUE;
+	invalidateLayout(object);
 	
-	if (object->children != NULL)
-		for (i = 0; i < object->numChildren; i++)
-			if ((object->children)[i] == child){
-				(object->children)[i] = NULL;
-				return TRUE;
-			}
+	(object->children)[child->childIndex] = NULL;
+	(object->numRemovedChildren)++;
+
+	/* Removed slots at the end are dropped right away */
+	while (object->numChildren && (object->children)[object->numChildren - 1] == NULL){
+		(object->numChildren)--;
+		(object->numRemovedChildren)--;
+	}
 	
-	return FALSE;
+	return TRUE;
 }
 	
-/* Sets an event for a GUIObject by a Windows message */
-int GUIObject_setEvent(GUIObject object, DWORD message, void(*callback)(GUIObject, void*, EventArgs),
+/* Creates the args of a GUIObject's event in the GUIObject's arena, mouse event args for mouse messages */
+static EventArgs newObjectEventArgs(GUIObject object, UINT message, BOOL mouse){
+	EventArgs args = (EventArgs)allocObjectMemory(object->arena, mouse ? sizeof(val_MouseEventArgs) : sizeof(val_EventArgs));
+
+	if (!args)
+		return NULL;
+
+	if (mouse)
+		initMouseEventArgs((MouseEventArgs)args, message, 0, 0);
+	else
+		initEventArgs(args, message, 0, 0);
+
+	return args;
+}
+
+/* Deletes the args of a GUIObject's event */
+static void deleteObjectEventArgs(GUIObject object, EventArgs args){
+	deleteObjectLock((Object)args);
+	retireObjectMemory(object->arena, args);
+}
+
+/* Sets an event for a GUIObject by a Windows message */
+int GUIObject_setEvent(GUIObject object, DWORD message, void(*callback)(GUIObject, void*, EventArgs),
 						void *context, enum _syncMode mode){
-	struct _event *tempReallocPointer;
+	struct _event **tempReallocPointer, *event;
 	unsigned int i;
 	
 	if (!object)
 		return -1;
 	
 	for (i = 0; i < object->numEvents; i++)
-		if  ((object->events)[i].message == message){
-			(object->events)[i].eventFunction = callback; (object->events)[i].mode = mode;
-			(object->events)[i].sender = object; (object->events)[i].context = context;
-			(object->events)[i].condition = NULL; (object->events)[i].interrupt = FALSE;
-			(object->events)[i].enabled = TRUE;
+		if  ((object->events)[i]->message == message){
+			(object->events)[i]->eventFunction = callback; (object->events)[i]->mode = mode;
+			(object->events)[i]->sender = object; (object->events)[i]->context = context;
+			(object->events)[i]->condition = NULL; (object->events)[i]->interrupt = FALSE;
+			(object->events)[i]->enabled = TRUE;
 			return (int)i;
 		}
 	
-	(object->numEvents)++;
-	tempReallocPointer = (struct _event*)realloc(object->events, object->numEvents * sizeof(struct _event));
-	if (!tempReallocPointer)
+	event = (struct _event*)allocObjectMemory(object->arena, sizeof(struct _event));
+	if (!event)
 		return -1;
+
+	tempReallocPointer = (struct _event**)reallocObjectMemory(object->arena, object->events, (object->numEvents + 1) * sizeof(struct _event*));
+	if (!tempReallocPointer){
+		freeObjectMemory(object->arena, event);
+		return -1;
+	}
 	
 	object->events = tempReallocPointer;
+	(object->events)[object->numEvents] = event;
+	(object->numEvents)++;
 	switch(message){
 	case WM_MOUSEMOVE: case WM_MOUSEHOVER: case WM_MOUSELEAVE: case WM_LBUTTONDOWN: case WM_LBUTTONDBLCLK: case WM_LBUTTONUP: 
 	case WM_RBUTTONDOWN: case WM_RBUTTONUP: case WM_RBUTTONDBLCLK:
-			(object->events)[i].args = (EventArgs)newMouseEventArgs(message, 0, 0);
+			event->args = newObjectEventArgs(object, message, TRUE);
 			break;
 		default:
-			(object->events)[i].args = newEventArgs(message, 0, 0);
+			event->args = newObjectEventArgs(object, message, FALSE);
 	}
 	
-	(object->events)[object->numEvents - 1].eventFunction = callback; (object->events)[object->numEvents - 1].mode = mode;
-	(object->events)[object->numEvents - 1].message = message; (object->events)[object->numEvents - 1].sender = object;
-	(object->events)[object->numEvents - 1].context = context; (object->events)[object->numEvents - 1].condition = NULL;
-	(object->events)[object->numEvents - 1].interrupt = FALSE; (object->events)[object->numEvents - 1].enabled = TRUE;
+	event->eventFunction = callback; event->mode = mode;
+	event->message = message; event->sender = object;
+	event->context = context; event->condition = NULL;
+	event->interrupt = FALSE; event->enabled = TRUE;
 	
 	return (int)(object->numEvents - 1);
 }
@@ -192,7 +994,7 @@ BOOL GUIObject_setEventCondition(GUIObject object, int eventID, BOOL *condition)
 	if (!object || eventID < 0 || (UINT)eventID >= object->numEvents)
 		return FALSE;
 	
-	(object->events)[eventID].condition = condition;
+	(object->events)[eventID]->condition = condition;
 	return TRUE;
 }
 	
@@ -201,7 +1003,7 @@ BOOL GUIObject_setEventInterrupt(GUIObject object, int eventID, BOOL interrupt){
 	if (!object || eventID < 0 || (UINT)eventID >= object->numEvents)
 		return FALSE;
 	
-	(object->events)[eventID].interrupt = interrupt;
+	(object->events)[eventID]->interrupt = interrupt;
 	return TRUE;
 }
 	
@@ -210,7 +1012,7 @@ BOOL GUIObject_setEventEnabled(GUIObject object, int eventID, BOOL enabled){
 	if (!object || eventID < 0 || (UINT)eventID >= object->numEvents)
 		return FALSE;
 	
-	(object->events)[eventID].enabled = enabled;
+	(object->events)[eventID]->enabled = enabled;
 	return TRUE;
 }
 	
@@ -222,12 +1024,19 @@ int GUIObject_setOnClick(GUIObject object, void(*callback)(GUIObject, void*, Eve
 	
 /* Moves a GUIObject to a new location specified by x and y */
 BOOL GUIObject_setPos(GUIObject object, int x, int y){
+	int scrollX, scrollY;
+
 	if (!object)
 		return FALSE;
 	
 	object->x = x; object->realX = x;
 	object->y = y; object->realY = y;
-	if (!SetWindowPos(object->handle, NULL, x, y, object->width, object->height, SWP_NOSIZE | SWP_ASYNCWINDOWPOS | 
+	updateSpatialItem(object);
+	invalidateLayout(object);
+	if (object->windowless)
+		return invalidateWindowless(object);
+	getScrollOffset(object->parent, &scrollX, &scrollY);
+	if (!SetWindowPos(object->handle, NULL, x - scrollX, y - scrollY, object->width, object->height, SWP_NOSIZE | SWP_ASYNCWINDOWPOS | 
 																					SWP_DRAWFRAME))
 		return FALSE;
 	
@@ -237,19 +1046,32 @@ BOOL GUIObject_setPos(GUIObject object, int x, int y){
 	return TRUE;
 }
 	
-/* Resizes a GUIObject to a new size specified by width and height */
-BOOL GUIObject_setSize(GUIObject object, int width, int height){
-	if (!object)
-		return FALSE;
-	
+/* Updates a GUIObject's size fields to a new size specified by width and height without touching its window. The width and height
+   fields are left unchanged if the new values break the min and max settings */
+PRIVATE void GUIObject_updateSize(GUIObject object, int width, int height){
+	const struct _limits *limits = getLimits(object);
+
 	object->realWidth = width;
 	object->realHeight = height;
-	
-	if (width >= object->minWidth && width <= object->maxWidth)
+
+	if (width >= limits->minWidth && width <= limits->maxWidth)
 		object->width = width;
-	if (height >= object->minHeight && height <= object->maxHeight)
+	if (height >= limits->minHeight && height <= limits->maxHeight)
 		object->height = height;
-	
+}
+
+/* Resizes a GUIObject to a new size specified by width and height */
+BOOL GUIObject_setSize(GUIObject object, int width, int height){
+	if (!object)
+		return FALSE;
+
+	GUIObject_updateSize(object, width, height);
+	LayoutNode_setSize(object->layoutNode, (float)object->realWidth, (float)object->realHeight);
+	updateSpatialItem(object);
+	invalidateLayout(object);
+	if (object->windowless)
+		return invalidateWindowless(object);
+
 	if (!SetWindowPos(object->handle, NULL, object->x, object->y, object->width, object->height, SWP_NOMOVE | SWP_ASYNCWINDOWPOS | 
 																					SWP_DRAWFRAME))
 		return FALSE;
@@ -262,11 +1084,17 @@ BOOL GUIObject_setSize(GUIObject object, int width, int height){
 	
 /* Sets a GUIObject's minimum size to a new value specified by minWidth and minHeight */
 BOOL GUIObject_setMinSize(GUIObject object, int minWidth, int minHeight){
+	struct _limits *limits;
+
 	if (!object)
 		return FALSE;
 	
-	object->minWidth = minWidth;
-	object->minHeight = minHeight;
+	limits = ensureLimits(object);
+	if (!limits)
+		return FALSE;
+
+	limits->minWidth = minWidth;
+	limits->minHeight = minHeight;
 	
 	if (minWidth > object->width){
 		object->width = minWidth;
@@ -277,6 +1105,12 @@ BOOL GUIObject_setMinSize(GUIObject object, int minWidth, int minHeight){
 		object->height = minHeight;
 		object->realHeight = minHeight;
 	}
+	LayoutNode_setMinSize(object->layoutNode, (float)minWidth, (float)minHeight);
+	LayoutNode_setSize(object->layoutNode, (float)object->realWidth, (float)object->realHeight);
+	updateSpatialItem(object);
+	invalidateLayout(object);
+	if (object->windowless)
+		return invalidateWindowless(object);
 	
 	if (!SetWindowPos(object->handle, NULL, object->x, object->y, object->width, object->height, SWP_NOMOVE | SWP_ASYNCWINDOWPOS | 
 																					SWP_DRAWFRAME))
@@ -290,11 +1124,17 @@ BOOL GUIObject_setMinSize(GUIObject object, int minWidth, int minHeight){
 	
 /* Sets a GUIObject's maximum size to a new value specified by maxWidth and maxHeight */
 BOOL GUIObject_setMaxSize(GUIObject object, int maxWidth, int maxHeight){
+	struct _limits *limits;
+
 	if (!object)
 		return FALSE;
 	
-	object->maxWidth = maxWidth;
-	object->maxHeight = maxHeight;
+	limits = ensureLimits(object);
+	if (!limits)
+		return FALSE;
+
+	limits->maxWidth = maxWidth;
+	limits->maxHeight = maxHeight;
 	
 	if (maxWidth < object->width){
 		object->width = maxWidth;
@@ -305,6 +1145,12 @@ BOOL GUIObject_setMaxSize(GUIObject object, int maxWidth, int maxHeight){
 		object->height = maxHeight;
 		object->realHeight = maxHeight;
 	}
+	LayoutNode_setMaxSize(object->layoutNode, (float)maxWidth, (float)maxHeight);
+	LayoutNode_setSize(object->layoutNode, (float)object->realWidth, (float)object->realHeight);
+	updateSpatialItem(object);
+	invalidateLayout(object);
+	if (object->windowless)
+		return invalidateWindowless(object);
 	
 	if (!SetWindowPos(object->handle, NULL, object->x, object->y, object->width, object->height, SWP_NOMOVE | SWP_ASYNCWINDOWPOS | 
 																					SWP_DRAWFRAME))
@@ -316,23 +1162,61 @@ BOOL GUIObject_setMaxSize(GUIObject object, int maxWidth, int maxHeight){
 	return TRUE;
 }
 	
+/* Gets a GUIObject's minimum size. A GUIObject without limits gets 0, 0. Either pointer can be NULL */
+BOOL GUIObject_getMinSize(GUIObject object, int *minWidth, int *minHeight){
+	if (!object)
+		return FALSE;
+
+	if (minWidth)
+		*minWidth = getLimits(object)->minWidth;
+	if (minHeight)
+		*minHeight = getLimits(object)->minHeight;
+	return TRUE;
+}
+
+/* Gets a GUIObject's maximum size. A GUIObject without limits gets INT_MAX, INT_MAX. Either pointer can be NULL */
+BOOL GUIObject_getMaxSize(GUIObject object, int *maxWidth, int *maxHeight){
+	if (!object)
+		return FALSE;
+
+	if (maxWidth)
+		*maxWidth = getLimits(object)->maxWidth;
+	if (maxHeight)
+		*maxHeight = getLimits(object)->maxHeight;
+	return TRUE;
+}
+	
 /* Sets a new text for a GUIObject */
 BOOL GUIObject_setText(GUIObject object, char *text){
-	int textLength = strlen(text);
-	char *tempReallocPointer;
+	unsigned int textLength;
+	WCHAR *wideText;
 		
 	if (!object)
 		return FALSE;
 	
-	tempReallocPointer = (char*)realloc(object->text, textLength + 1);
-	
-	if (!tempReallocPointer)
+	/* Nothing is touched when the text doesn't change, like a label updated with the same value */
+	textLength = (unsigned int)strlen(text);
+	if (object->text && object->textLength == textLength && !memcmp(object->text, text, textLength) &&
+			(object->type != TEXTBOX || !((TextBox)object)->textStale))
+		return TRUE;
+
+	if (!storeText(object, text, textLength))
 		return FALSE;
-	strcpy_s(tempReallocPointer, textLength + 1, text);
-	object->text = tempReallocPointer;
-	if (object->handle)
-		return SetWindowTextA(object->handle, text);
-	else
+	if (object->type == TEXTBOX){
+		((TextBox)object)->textStale = FALSE;
+		if (!setTextBoxText((TextBox)object, text, textLength))
+			return FALSE;
+		if (object->handle && !inWindowThread(object->handle)){
+			requestTextBoxUpdate((TextBox)object);
+			return TRUE;
+		}
+	}
+	if (object->windowless)
+		return invalidateWindowless(object);
+	if (object->handle){
+		wideText = getWideText(object);
+		return wideText ? SetWindowTextW(object->handle, wideText) : FALSE;
+	} else
 		return TRUE;
 }
 	
@@ -342,27 +1226,51 @@ BOOL GUIObject_setEnabled(GUIObject object, BOOL enabled){
 		return FALSE;
 	object->enabled = enabled;
 	
-	if (object->handle)
+	if (object->windowless)
+		invalidateWindowless(object);
+	else if (object->handle)
 		EnableWindow(object->handle, enabled);
 	return TRUE;
 }
 
 PRIVATE HBITMAP GUIObject_updateOffscreenPaintContext(GUIObject object, BOOL eraseBG, BOOL transparent){
+	struct _paintState *paintState;
 	HBITMAP prevBitmap;
 	RECT clientRect;
 	HBRUSH backgroundBrush;
 
+	/* Windowless GUIObjects draw straight into their host's offscreen buffer, set up by the host's paint pass. Outside of it, they get
+	   repainted by the next one */
+	if (object->windowless){
+		if (!object->offscreenPaintContext){
+			invalidateWindowless(object);
+			return NULL;
+		}
+
+		if (eraseBG){
+			SetRect(&clientRect, 0, 0, object->width, object->height);
+			FillRect(object->offscreenPaintContext, &clientRect, GetSysColorBrush(COLOR_WINDOW));
+		}
+		if (transparent)
+			SetBkMode(object->offscreenPaintContext, TRANSPARENT);
+		return NULL;
+	}
+
+	paintState = ensurePaintState(object);
+	if (!paintState)
+		return NULL;
+
 	GetClientRect(object->handle, &clientRect);
 
-	if (!object->offscreenBitmap){
+	if (!paintState->offscreenBitmap){
 		if (object->offscreenPaintContext)
 			DeleteObject(object->offscreenPaintContext);
 
 		object->offscreenPaintContext = CreateCompatibleDC(object->paintContext);
-		object->offscreenBitmap = CreateCompatibleBitmap(object->paintContext, clientRect.right - clientRect.left, clientRect.bottom - clientRect.top);
+		paintState->offscreenBitmap = CreateCompatibleBitmap(object->paintContext, clientRect.right - clientRect.left, clientRect.bottom - clientRect.top);
 	}
 
-	prevBitmap = SelectBitmap(object->offscreenPaintContext, object->offscreenBitmap);
+	prevBitmap = SelectBitmap(object->offscreenPaintContext, paintState->offscreenBitmap);
 
 	if (eraseBG){
 		backgroundBrush = CreateSolidBrush(GetSysColor(COLOR_WINDOW));
@@ -379,6 +1287,9 @@ PRIVATE HBITMAP GUIObject_updateOffscreenPaintContext(GUIObject object, BOOL era
 PRIVATE void GUIObject_updatePaintContext(GUIObject object, HBITMAP prevBitmap){
 	RECT clientRect;
 	
+	if (object->windowless)
+		return; /* The host's paint pass copies its buffer to the screen */
+
 	GetClientRect(object->handle, &clientRect);
 
 	BitBlt(object->paintContext, clientRect.left, clientRect.top, clientRect.right - clientRect.left, clientRect.bottom - clientRect.top,
@@ -716,857 +1627,5226 @@ BOOL GUIObject_drawPolygon(GUIObject object, Pen pen, Brush brush, int numPoints
 	return FALSE;
 }
 
-/* Get the number of symbols in the decimal representation of a number. */
-PRIVATE unsigned int getNumLength(unsigned int num){
-    unsigned int numLength = 1;
-    while ((num /= 10) > 0)
-        numLength++;
-    return numLength;
+/* Creates the layout nodes of a flex or grid GUIObject's children, so that they are laid out by it instead of by their anchors */
+PRIVATE BOOL ensureChildrenLayoutNodes(GUIObject object){
+	unsigned int i;
+
+	for (i = 0; i < object->numChildren; i++)
+		if ((object->children)[i] != NULL && !ensureLayoutNode((object->children)[i]))
+			return FALSE;
+
+	return TRUE;
+}
+
+/* Lays out a GUIObject's children in a row or a column, instead of by their anchors */
+BOOL GUIObject_setFlexLayout(GUIObject object, enum _flexDirection direction, enum _justify justify, enum _align alignItems, int gap){
+	if (!object || !ensureLayoutNode(object))
+		return FALSE;
+
+	LayoutNode_setFlex(object->layoutNode, direction, justify, alignItems, (float)gap);
+	if (!ensureChildrenLayoutNodes(object))
+		return FALSE;
+
+	invalidateLayout(object);
+	return TRUE;
+}
+
+/* Lays out a GUIObject's children in the cells of a grid, instead of by their anchors */
+BOOL GUIObject_setGridLayout(GUIObject object, unsigned int numColumns, const struct _layoutTrack *columns,
+								unsigned int numRows, const struct _layoutTrack *rows, int gap){
+	if (!object || !ensureLayoutNode(object))
+		return FALSE;
+
+	if (!LayoutNode_setGrid(object->layoutNode, numColumns, columns, numRows, rows, (float)gap, (float)gap))
+		return FALSE;
+	if (!ensureChildrenLayoutNodes(object))
+		return FALSE;
+
+	invalidateLayout(object);
+	return TRUE;
+}
+
+/* Sets the space between a flex or grid GUIObject's borders and its children */
+BOOL GUIObject_setLayoutPadding(GUIObject object, int left, int top, int right, int bottom){
+	if (!object || !ensureLayoutNode(object))
+		return FALSE;
+
+	LayoutNode_setPadding(object->layoutNode, (float)left, (float)top, (float)right, (float)bottom);
+	invalidateLayout(object);
+	return TRUE;
+}
+
+/* Sets how a GUIObject grows and shrinks in its parent's flex layout. A negative basis (FLEX_BASIS_AUTO) starts the GUIObject
+   at its own size */
+BOOL GUIObject_setFlexItem(GUIObject object, float grow, float shrink, int basis){
+	if (!object || !ensureLayoutNode(object))
+		return FALSE;
+
+	LayoutNode_setFlexItem(object->layoutNode, grow, shrink, (float)basis);
+	invalidateLayout(object);
+	return TRUE;
+}
+
+/* Places a GUIObject in a cell of its parent's grid layout. A negative column or row places it in the next free cell */
+BOOL GUIObject_setGridCell(GUIObject object, int column, int row, int columnSpan, int rowSpan){
+	if (!object || !ensureLayoutNode(object))
+		return FALSE;
+
+	LayoutNode_setGridCell(object->layoutNode, column, row, columnSpan, rowSpan);
+	invalidateLayout(object);
+	return TRUE;
+}
+
+/* Makes a GUIObject windowless (drawn and hit-tested by its host instead of having a window) or not, before it is displayed */
+BOOL GUIObject_setWindowless(GUIObject object, BOOL windowless){
+	if (!object || object->handle)
+		return FALSE;
+
+	/* Windows, textboxes, list views, log views, image views, tree views, tab containers and scroll panels need their own windows */
+	if (windowless && (object->type == WINDOW || object->type == DIALOG || object->type == TEXTBOX || object->type == LISTVIEW ||
+						object->type == LOGVIEW || object->type == IMAGEVIEW || object->type == TREEVIEW ||
+						object->type == TABCONTAINER || object->type == SCROLLPANEL))
+		return FALSE;
+
+	if (object->windowless == windowless)
+		return TRUE;
+
+	if (object->parent){
+		if (windowless)
+			(object->parent->numWindowless)++;
+		else {
+			invalidateWindowless(object);
+			(object->parent->numWindowless)--;
+		}
+	}
+	object->windowless = windowless;
+	if (windowless)
+		invalidateWindowless(object);
+
+	return TRUE;
+}
+
+/* Keeps a spatial index of a GUIObject's children, for fast hit-tests and rectangle queries over large numbers of children */
+BOOL GUIObject_enableSpatialIndex(GUIObject object, int cellSize){
+	unsigned int i;
+
+	if (!object)
+		return FALSE;
+
+	if (object->childrenIndex){
+		/* Rebuild the index with the new cell size */
+		for (i = 0; i < object->numChildren; i++)
+			if ((object->children)[i] != NULL)
+				(object->children)[i]->spatialItem = -1;
+		deleteSpatialIndex(object->childrenIndex);
+	}
+
+	object->childrenIndex = newSpatialIndex(cellSize);
+	if (!object->childrenIndex)
+		return FALSE;
+
+	/* The children are inserted in order, so that the later ones are on top */
+	for (i = 0; i < object->numChildren; i++)
+		if ((object->children)[i] != NULL)
+			updateSpatialItem((object->children)[i]);
+
+	return TRUE;
+}
+
+/* Gets a GUIObject's topmost child at the point specified by x and y, NULL if there is none */
+GUIObject GUIObject_getChildAt(GUIObject object, int x, int y){
+	GUIObject currChild;
+	unsigned int i;
+
+	if (!object)
+		return NULL;
+
+	if (object->childrenIndex)
+		return (GUIObject)SpatialIndex_hitTest(object->childrenIndex, x, y);
+
+	/* Without an index, walk the children from the top */
+	for (i = object->numChildren; i > 0; i--){
+		currChild = (object->children)[i - 1];
+		if (currChild != NULL && currChild->x != CW_USEDEFAULT && x >= currChild->x && x < currChild->x + currChild->width &&
+				y >= currChild->y && y < currChild->y + currChild->height)
+			return currChild;
+	}
+
+	return NULL;
+}
+
+/* Calls callback for each of a GUIObject's children that intersect a rectangle. Returns the number of children found */
+unsigned int GUIObject_getChildrenInRect(GUIObject object, int left, int top, int right, int bottom, SpatialQueryFunc callback,
+											void *context){
+	GUIObject currChild;
+	unsigned int i, numFound = 0;
+
+	if (!object)
+		return 0;
+
+	if (object->childrenIndex)
+		return SpatialIndex_queryRect(object->childrenIndex, left, top, right, bottom, callback, context);
+
+	for (i = 0; i < object->numChildren; i++){
+		currChild = (object->children)[i];
+		if (currChild != NULL && currChild->x != CW_USEDEFAULT && currChild->x < right && currChild->x + currChild->width > left &&
+				currChild->y < bottom && currChild->y + currChild->height > top){
+			numFound++;
+			if (callback && !callback(currChild, context))
+				break;
+		}
+	}
+
+	return numFound;
+}
+
+PRIVATE void setGUIObjectFields(GUIObject thisObject, HINSTANCE instance, char *text, int width, int height){
+	static volatile LONG numIDs = 0;
+	unsigned int textLength;
+	
+	/* Set the fields */
+
+	thisObject->moduleInstance = instance;
+	thisObject->arena = currentArena;
+	if (currentArena)
+		InterlockedIncrement(&(currentArena->refCount)); /* Released along with the GUIObject's memory */
+
+	initObject((Object)thisObject);
+
+	thisObject->ID = (HMENU)(LONG_PTR)(InterlockedIncrement(&numIDs) - 1);
+
+	/* The className, the events, the paint state and the limits are left NULL until they are needed: windows get the className of
+	   their window class when they are initialized, setEvent creates the events and their args */
+
+	if (text){
+		textLength = strlen(text);
+		if (!storeText(thisObject, text, textLength)) /* Copy the object text, inline if it's short */
+			return;
+	} else
+		thisObject->text = NULL;
+
+	thisObject->width = width; thisObject->height = height;
+	thisObject->realWidth = width; thisObject->realHeight = height;
+	thisObject->layoutWidth = width; thisObject->layoutHeight = height;
+	SetRectEmpty(&(thisObject->paintedRect));
+}
+
+/* The Constructors*/
+void initGUIObject(GUIObject thisObject, HINSTANCE instance, char *text, int width, int height){
+
+	if (!thisObject)
+		return;
+
+	/* Initialize the fields to the default values */
+	CLASS_GUIObject;
+
+	setGUIObjectFields(thisObject, instance, text, width, height);
+	
+	thisObject->type = GUIOBJECT;
+
+	return;
+}
+
+GUIObject newGUIObject(HINSTANCE instance, char *text, int width, int height){
+	GUIObject thisObject = (GUIObject)allocObjectMemory(currentArena, sizeof(val_GUIObject));
+	if (!thisObject)
+		return NULL;
+
+	initGUIObject(thisObject, instance, text, width, height);
+	return thisObject;
+}
+
+void freeGUIObjectFields(GUIObject object){
+	unsigned int i;
+	if (!DestroyWindow(object->handle))
+		SendMessageA(object->handle, WM_CLOSE, (WPARAM)NULL, (WPARAM)NULL);
+
+	if (object->parent)
+		GUIObject_removeChild(object->parent, object);
+	deleteLayoutNode(object->layoutNode);
+	deleteGeometryTable(object->childrenGeometry);
+	for (i = 0; i < object->numChildren; i++)
+		if ((object->children)[i] != NULL)
+			(object->children)[i]->spatialItem = -1;
+	deleteSpatialIndex(object->childrenIndex);
+
+	/* The fields are retired, and left empty for the holders of references to the GUIObject */
+	retireObjectMemory(object->arena, object->className);
+	object->className = NULL;
+	if (object->events){
+		for (i = 0; i < object->numEvents; i++){
+			if ((object->events)[i]->args)
+				deleteObjectEventArgs(object, (object->events)[i]->args);
+			retireObjectMemory(object->arena, (object->events)[i]);
+		}
+		retireObjectMemory(object->arena, object->events);
+		object->events = NULL;
+		object->numEvents = 0;
+	}
+	retireObjectMemory(NULL, getOwnedText(object));
+	object->text = object->textInline;
+	object->textBorrowed = FALSE;
+	object->textInline[0] = '\0';
+	object->textLength = 0;
+	retireObjectMemory(NULL, object->wideText);
+	object->wideText = NULL;
+	object->wideTextCapacity = 0;
+	retireObjectMemory(object->arena, object->children);
+	object->children = NULL;
+	object->numChildren = 0; object->childrenCapacity = 0; object->numRemovedChildren = 0;
+
+	if (object->paintState){
+		if (object->paintState->offscreenBitmap)
+			DeleteObject(object->paintState->offscreenBitmap);
+		retireObjectMemory(object->arena, object->paintState);
+		object->paintState = NULL;
+	}
+	if (object->offscreenPaintContext && !object->windowless)
+		DeleteDC(object->offscreenPaintContext);
+	object->offscreenPaintContext = NULL;
+	retireObjectMemory(object->arena, object->limits);
+	object->limits = NULL;
+	object->handle = NULL;
+	object->realizeState = UNREALIZED;
+}
+
+/* The Destructor*/
+void deleteGUIObject(GUIObject object){
+	freeGUIObjectFields(object);
+	releaseGUIObject(object);
+}
+
+
+
+
+
+/* Class Window */
+/* The Methods*/
+/* Changes a window's resizable style */
+BOOL Window_setResizable(Window window, BOOL resizable){
+	if (!window)
+		return FALSE;
+	window->resizable = resizable;
+	window->styles = resizable ? (window->styles) | WS_THICKFRAME : (window->styles) ^ WS_THICKFRAME;
+		
+	if (window->handle)
+		return SetWindowLongPtrA(window->handle, GWL_STYLE, (LONG)(window->styles)) ? TRUE : FALSE;
+	else
+		return TRUE;
+}
+	
+/* Enables or disables a window's maximize box */
+BOOL Window_enableMaximize(Window window, BOOL maximize){
+	if (!window)
+		return FALSE;
+	window->maximizeEnabled = maximize;
+	window->styles = maximize ? window->styles | WS_MAXIMIZEBOX : window->styles ^ WS_MAXIMIZEBOX;
+		
+	if (window->handle)
+		return SetWindowLongPtrA(window->handle, GWL_STYLE, (LONG)(window->styles)) ? TRUE : FALSE;
+	else
+		return TRUE;
+}
+
+
+/* The Constructors*/
+void initWindow(Window thisObject, HINSTANCE instance, char *text, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_Window;
+
+	setGUIObjectFields((GUIObject)thisObject, instance, text, width, height);
+
+	/* Get the window class, it is only registered for the first Window with its configuration */
+	thisObject->windowClass = acquireWindowClass(thisObject->moduleInstance, 0, (WNDPROC)windowProc, NULL, (HBRUSH)COLOR_WINDOW);
+	if (!thisObject->windowClass)
+		return;
+	thisObject->className = thisObject->windowClass->name;
+
+	/* Set the fields */
+	thisObject->type = WINDOW;
+	thisObject->styles = WS_OVERLAPPEDWINDOW;
+	thisObject->exStyles = WS_EX_WINDOWEDGE;
+}
+
+Window newWindow(HINSTANCE instance, char *text, int width, int height){
+	Window thisObject = (Window)allocObjectMemory(currentArena, sizeof(val_Window));
+
+	if (!thisObject)
+		return NULL;
+
+	initWindow(thisObject, instance, text, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteWindow(Window window){
+	window->className = NULL; /* Owned by the window class */
+	freeGUIObjectFields((GUIObject)window);
+	releaseWindowClass(window->windowClass);
+	releaseGUIObject((GUIObject)window);
+}
+
+
+
+
+
+/* Class Control */
+/* The vtable shared by all Controls */
+MAKE_VTABLE_INSTANCE(Control, GUIObject);
+
+/* The Methods*/
+/* Updates a control's position fields to a new location specified by x and y without touching its window. The x and y fields
+   are left unchanged if the new values break the min and max settings */
+PRIVATE void Control_updatePos(Control object, int x, int y){
+	const struct _limits *limits = getLimits((GUIObject)object);
+
+	object->realX = x;
+	object->realY = y;
+
+	if (x >= limits->minX && x <= limits->maxX)
+		object->x = x;
+	if (y >= limits->minY && y <= limits->maxY)
+		object->y = y;
+}
+
+/* Moves a GUIObject to a new location specified by x and y */
+/* Overrides setPosT in GUIObject */
+BOOL Control_setPos(GUIObject object, int x, int y){
+	int scrollX, scrollY;
+
+	if (!object)
+		return FALSE;
+
+	Control_updatePos((Control)object, x, y);
+	updateSpatialItem(object);
+	invalidateLayout(object);
+	if (object->windowless)
+		return invalidateWindowless(object);
+
+	getScrollOffset(object->parent, &scrollX, &scrollY);
+	if (!SetWindowPos(object->handle, NULL, object->x - scrollX, object->y - scrollY, object->width, object->height, SWP_NOSIZE |
+																					SWP_ASYNCWINDOWPOS | SWP_DRAWFRAME))
+		return FALSE;
+
+	if (!InvalidateRect(object->handle, NULL, FALSE))
+		return FALSE;
+
+	return TRUE;
+}
+
+/* Sets a control's anchor settings. The control isn't moved until its parent is resized */
+BOOL Control_setAnchor(Control object, short anchor){
+	if (!object)
+		return FALSE;
+
+	object->anchor = anchor;
+	/* The anchor pass works on copies of the children's anchors, they are gathered again */
+	if (object->parent && object->parent->childrenGeometry)
+		object->parent->childrenGeometry->stale = TRUE;
+
+	return TRUE;
+}
+
+/* Sets a control's minimum position to a new value specified by minX and minY */
+BOOL Control_setMinPos(Control object, int minX, int minY){
+	struct _limits *limits;
+
+	if (!object)
+		return FALSE;
+	
+	limits = ensureLimits((GUIObject)object);
+	if (!limits)
+		return FALSE;
+
+	limits->minX = minX;
+	limits->minY = minY;
+	
+	if (minX > object->x){
+		object->x = minX;
+		object->realX = minX;
+	}
+	
+	if (minY > object->y){
+		object->y = minY;
+		object->realY = minY;
+	}
+	updateSpatialItem((GUIObject)object);
+	invalidateLayout((GUIObject)object);
+	if (object->windowless)
+		return invalidateWindowless((GUIObject)object);
+	
+	if (!SetWindowPos(object->handle, NULL, object->x, object->y, object->width, object->height, SWP_NOMOVE | SWP_ASYNCWINDOWPOS |
+																					SWP_DRAWFRAME))
+		return FALSE;
+	
+	if (!InvalidateRect(object->handle, NULL, FALSE))
+		return FALSE;
+	
+	return TRUE;
+}
+
+/* Sets a control's maximum position to a new value specified by maxX and maxY */
+BOOL Control_setMaxPos(Control object, int maxX, int maxY){
+	struct _limits *limits;
+
+	if (!object)
+		return FALSE;
+	
+	limits = ensureLimits((GUIObject)object);
+	if (!limits)
+		return FALSE;
+
+	limits->maxX = maxX;
+	limits->maxY = maxY;
+	
+	if (maxX < object->x){
+		object->x = maxX;
+		object->realX = maxX;
+	}
+	
+	if (maxY < object->y){
+		object->y = maxY;
+		object->realY = maxY;
+	}
+	updateSpatialItem((GUIObject)object);
+	invalidateLayout((GUIObject)object);
+	if (object->windowless)
+		return invalidateWindowless((GUIObject)object);
+	
+	if (!SetWindowPos(object->handle, NULL, object->x, object->y, object->width, object->height, SWP_NOMOVE | SWP_ASYNCWINDOWPOS |
+																					SWP_DRAWFRAME))
+		return FALSE;
+	
+	if (!InvalidateRect(object->handle, NULL, FALSE))
+		return FALSE;
+	
+	return TRUE;
+}
+
+/* Gets a control's minimum position. A control without limits gets INT_MIN, INT_MIN. Either pointer can be NULL */
+BOOL Control_getMinPos(Control object, int *minX, int *minY){
+	if (!object)
+		return FALSE;
+
+	if (minX)
+		*minX = getLimits((GUIObject)object)->minX;
+	if (minY)
+		*minY = getLimits((GUIObject)object)->minY;
+	return TRUE;
+}
+
+/* Gets a control's maximum position. A control without limits gets INT_MAX, INT_MAX. Either pointer can be NULL */
+BOOL Control_getMaxPos(Control object, int *maxX, int *maxY){
+	if (!object)
+		return FALSE;
+
+	if (maxX)
+		*maxX = getLimits((GUIObject)object)->maxX;
+	if (maxY)
+		*maxY = getLimits((GUIObject)object)->maxY;
+	return TRUE;
+}
+
+
+PRIVATE void setControlFields(Control thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	setGUIObjectFields((GUIObject)thisObject, instance, text, width, height);
+
+	/* Set the fields */
+	thisObject->x = x; thisObject->realX = x;
+	thisObject->y = y; thisObject->realY = y;
+	thisObject->exStyles = WS_EX_WINDOWEDGE;
+
+	/* Override virtual methods */
+	thisObject->vtable = &Control_vtable;
+}
+
+
+/* The Constructors*/
+void initControl(Control thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_Control;
+
+	setControlFields(thisObject, instance, text, x, y, width, height);
+
+	thisObject->type = CONTROL;
+}
+
+Control newControl(HINSTANCE instance, char *text, int x, int y, int width, int height){
+	Control thisObject = (Control)allocObjectMemory(currentArena, sizeof(val_Control));
+
+	if (!thisObject)
+		return NULL;
+	
+	initControl(thisObject, instance, text, width, x, y, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteControl(Control control){
+	freeGUIObjectFields((GUIObject)control);
+	releaseGUIObject((GUIObject)control);
+}
+
+
+
+
+
+/* Class Button */
+/* The Constructors*/
+void initButton(Button thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_Button;
+
+	setControlFields((Control)thisObject, instance, text, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = BUTTON;
+	thisObject->className = "Button";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | BS_TEXT | BS_PUSHBUTTON;
+}
+
+Button newButton(HINSTANCE instance, char *text, int x, int y, int width, int height){
+	Button thisObject = (Button)allocObjectMemory(currentArena, sizeof(val_Button));
+
+	if (!thisObject)
+		return NULL;
+
+	initButton(thisObject, instance, text, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteButton(Button button){
+	button->className = NULL;
+	freeGUIObjectFields((GUIObject)button);
+	releaseGUIObject((GUIObject)button);
+}
+
+
+
+
+
+/* Class TextBox */
+/* A TextBox keeps its text in UTF-8, its window in UTF-16. The offsets of the window's edits are converted through the buffer, which
+   knows the UTF-16 length of each of its pieces, unless the text has no multibyte characters and the offsets are the same */
+
+/* Converts an offset in a TextBox's buffer, in bytes, to one in its window, in UTF-16 characters, if toWindow is set, and the other
+   way round if it isn't. Offsets past the end of the text are converted to the end of the text */
+static unsigned int convertTextBoxOffset(TextBox textbox, unsigned int offset, BOOL toWindow){
+	if (TextBuffer_getWideLength(textbox->textBuffer) == TextBuffer_getLength(textbox->textBuffer))
+		return offset;
+	return toWindow ? TextBuffer_toWideOffset(textbox->textBuffer, offset) : TextBuffer_fromWideOffset(textbox->textBuffer, offset);
+}
+
+/* Converts length UTF-16 characters to a new zero-terminated UTF-8 text and stores its length in bytes. Returns NULL on failure */
+static char *newUTF8Text(const WCHAR *wideText, unsigned int wideLength, unsigned int *length){
+	int size = wideLength ? WideCharToMultiByte(CP_UTF8, 0, wideText, (int)wideLength, NULL, 0, NULL, NULL) : 0;
+	char *text;
+
+	if (wideLength && !size)
+		return NULL;
+	text = (char*)malloc((unsigned int)size + 1);
+	if (!text)
+		return NULL;
+
+	if (size)
+		WideCharToMultiByte(CP_UTF8, 0, wideText, (int)wideLength, text, size, NULL, NULL);
+	text[size] = '\0';
+	*length = (unsigned int)size;
+	return text;
+}
+
+/* Converts length bytes of UTF-8 to a new zero-terminated UTF-16 text. Returns NULL on failure */
+static WCHAR *newWideText(const char *text, unsigned int length){
+	int size = length ? MultiByteToWideChar(CP_UTF8, 0, text, (int)length, NULL, 0) : 0;
+	WCHAR *wideText;
+
+	if (length && !size)
+		return NULL;
+	wideText = (WCHAR*)malloc(((unsigned int)size + 1) * sizeof(WCHAR));
+	if (!wideText)
+		return NULL;
+
+	if (size)
+		MultiByteToWideChar(CP_UTF8, 0, text, (int)length, wideText, size);
+	wideText[size] = L'\0';
+	return wideText;
+}
+
+/* Replaces the whole text of a TextBox's buffer and reports the change. The buffer is changed under the TextBox's lock, as other
+   threads may be reading it */
+PRIVATE BOOL setTextBoxText(TextBox textbox, const char *text, unsigned int length){
+	unsigned int prevLength;
+
+	if (!textbox->textBuffer)
+		return FALSE;
+	startSync(textbox);
+	prevLength = TextBuffer_getLength(textbox->textBuffer);
+	if (!TextBuffer_setText(textbox->textBuffer, text, length)){
+		endSync(textbox);
+		return FALSE;
+	}
+
+	if (textbox->onTextChange)
+		textbox->onTextChange(textbox, textbox->textChangeContext, 0, prevLength, text, length);
+	endSync(textbox);
+	return TRUE;
+}
+
+/* Applies an edit to a TextBox's buffer, under its lock, and reports it. The text field is only brought up to date when it's asked
+   for */
+PRIVATE BOOL replaceTextBoxText(TextBox textbox, unsigned int offset, unsigned int removed, const char *inserted,
+								unsigned int insertedLength){
+	if (!removed && !insertedLength)
+		return TRUE;
+	if (!textbox->textBuffer)
+		return FALSE;
+	startSync(textbox);
+	if (!TextBuffer_replace(textbox->textBuffer, offset, removed, inserted, insertedLength)){
+		endSync(textbox);
+		return FALSE;
+	}
+
+	textbox->textStale = TRUE;
+	if (textbox->onTextChange)
+		textbox->onTextChange(textbox, textbox->textChangeContext, offset, removed, inserted, insertedLength);
+	endSync(textbox);
+	return TRUE;
+}
+
+/* Tells whether the calling thread is a window's thread. Other threads don't send messages to a TextBox's window: they may hold the
+   TextBox's lock, which the window's thread takes to apply the window's edits */
+static BOOL inWindowThread(HWND hwnd){
+	return GetWindowThreadProcessId(hwnd, NULL) == GetCurrentThreadId();
+}
+
+/* Posts an update message to a TextBox's window after its text was changed on another thread, unless one is already pending */
+PRIVATE void requestTextBoxUpdate(TextBox textbox){
+	if (!InterlockedExchange(&(textbox->windowBehind), TRUE))
+		postInternalMessage(textbox->handle, UPDATE_TEXTBOX);
+}
+
+/* Sets a TextBox's window to its text, in the thread of its window. The window reports no change, as its text is the buffer's */
+PRIVATE void updateTextBoxWindow(TextBox textbox){
+	WCHAR *wideText;
+
+	startSync(textbox);
+	InterlockedExchange(&(textbox->windowBehind), FALSE);
+	if (TextBox_getText(textbox) && (wideText = getWideText((GUIObject)textbox)) != NULL)
+		SetWindowTextW(textbox->handle, wideText);
+	endSync(textbox);
+}
+
+/* Reads count UTF-16 characters at offset from a TextBox's window, reading only the lines they are on. The characters between lines
+   are taken to be line breaks. Returns FALSE if the range can't be read that way */
+PRIVATE BOOL readTextBoxRange(TextBox textbox, unsigned int offset, unsigned int count, WCHAR *dest){
+	WCHAR *lineText = NULL, *newLineText;
+	unsigned int copied = 0, lineCapacity = 0, from, to;
+	LRESULT line, lineStart, lineLength, nextStart;
+
+	line = SendMessageW(textbox->handle, EM_LINEFROMCHAR, (WPARAM)offset, (LPARAM)NULL);
+	while (copied < count){
+		lineStart = SendMessageW(textbox->handle, EM_LINEINDEX, (WPARAM)line, (LPARAM)NULL);
+		if (lineStart < 0 || (unsigned int)lineStart > offset + copied)
+			break;
+		lineLength = SendMessageW(textbox->handle, EM_LINELENGTH, (WPARAM)lineStart, (LPARAM)NULL);
+		nextStart = SendMessageW(textbox->handle, EM_LINEINDEX, (WPARAM)(line + 1), (LPARAM)NULL);
+		if (nextStart < 0)
+			nextStart = lineStart + lineLength;
+		if (lineLength >= 0xFFFF || nextStart - (lineStart + lineLength) > 2)
+			break; /* EM_GETLINE takes a 16-bit size, and more than a line break between lines is a soft break marker */
+
+		/* The part of the line in the range */
+		from = offset + copied - (unsigned int)lineStart;
+		if (from < (unsigned int)lineLength){
+			if ((unsigned int)lineLength + 1 > lineCapacity){
+				newLineText = (WCHAR*)realloc(lineText, ((unsigned int)lineLength + 1) * sizeof(WCHAR));
+				if (!newLineText)
+					break;
+				lineText = newLineText;
+				lineCapacity = (unsigned int)lineLength + 1;
+			}
+			*(WORD*)lineText = (WORD)(lineLength + 1); /* EM_GETLINE gets the buffer size, in characters, in its first word */
+			if (SendMessageW(textbox->handle, EM_GETLINE, (WPARAM)line, (LPARAM)lineText) != lineLength)
+				break;
+
+			to = (unsigned int)lineLength - from < count - copied ? (unsigned int)lineLength : from + (count - copied);
+			memcpy(dest + copied, lineText + from, (to - from) * sizeof(WCHAR));
+			copied += to - from;
+		}
+
+		/* Then the line break after it */
+		for (from = offset + copied - (unsigned int)lineStart; from < (unsigned int)(nextStart - lineStart) && copied < count; from++)
+			dest[copied++] = (nextStart - (lineStart + lineLength) == 2 && from == (unsigned int)lineLength) ? L'\r' : L'\n';
+
+		line++;
+	}
+
+	free(lineText);
+	return copied == count;
+}
+
+/* Brings a TextBox's buffer up to date after its window's text changed. If the selection was recorded before the edit, the edit
+   is worked out from the selection and the length before and after it: the text between the start of the change and the new caret
+   was inserted, and only that is read from the window. Otherwise (an undo, for example), the whole text is read and compared to the
+   buffer. The window counts in UTF-16 characters, the buffer in UTF-8 bytes */
+PRIVATE BOOL readTextBoxEdit(TextBox textbox){
+	DWORD selStart = 0, selEnd = 0;
+	unsigned int prevLength, prevWideLength, wideLength, length, offset, inserted, removed, suffix;
+	WCHAR *wideText;
+	char *text, *prevText;
+	BOOL result;
+
+	if (!textbox->textBuffer)
+		return FALSE;
+	prevLength = TextBuffer_getLength(textbox->textBuffer);
+	wideLength = (unsigned int)GetWindowTextLengthW(textbox->handle);
+
+	if (textbox->snapshotValid){
+		textbox->snapshotValid = FALSE;
+		SendMessageW(textbox->handle, EM_GETSEL, (WPARAM)&selStart, (LPARAM)&selEnd);
+		prevWideLength = TextBuffer_getWideLength(textbox->textBuffer);
+
+		offset = selStart < textbox->snapshotStart ? selStart : textbox->snapshotStart;
+		inserted = selStart - offset;
+		if (inserted <= wideLength && prevWideLength + inserted >= wideLength &&
+				offset + (prevWideLength + inserted - wideLength) <= prevWideLength){
+			removed = prevWideLength + inserted - wideLength;
+			wideText = (WCHAR*)malloc((inserted + 1) * sizeof(WCHAR));
+			text = wideText && readTextBoxRange(textbox, offset, inserted, wideText) ? newUTF8Text(wideText, inserted, &length) : NULL;
+			free(wideText);
+			if (text){
+				removed = convertTextBoxOffset(textbox, offset + removed, FALSE);
+				offset = convertTextBoxOffset(textbox, offset, FALSE);
+				result = replaceTextBoxText(textbox, offset, removed - offset, text, length);
+				free(text);
+				return result;
+			}
+		}
+	}
+
+	/* Compare the whole text, the change is what's left after the common prefix and suffix */
+	wideText = (WCHAR*)malloc((wideLength + 1) * sizeof(WCHAR));
+	text = NULL;
+	if (wideText && (!wideLength || (wideLength = (unsigned int)GetWindowTextW(textbox->handle, wideText, wideLength + 1)) != 0))
+		text = newUTF8Text(wideText, wideLength, &length);
+	free(wideText);
+	prevText = (char*)malloc(prevLength + 1);
+	if (!text || !prevText){
+		free(text);
+		free(prevText);
+		return FALSE;
+	}
+	TextBuffer_copy(textbox->textBuffer, 0, prevLength, prevText);
+
+	for (offset = 0; offset < length && offset < prevLength && text[offset] == prevText[offset]; offset++);
+	for (suffix = 0; suffix < length - offset && suffix < prevLength - offset &&
+						text[length - suffix - 1] == prevText[prevLength - suffix - 1]; suffix++);
+	/* The change starts and ends on whole characters */
+	while (offset && ((offset < length && ((unsigned char)text[offset] & 0xC0) == 0x80) ||
+						(offset < prevLength && ((unsigned char)prevText[offset] & 0xC0) == 0x80)))
+		offset--;
+	while (suffix && ((unsigned char)text[length - suffix] & 0xC0) == 0x80)
+		suffix--;
+	result = replaceTextBoxText(textbox, offset, prevLength - offset - suffix, text + offset, length - offset - suffix);
+
+	free(text);
+	free(prevText);
+	return result;
+}
+
+/* Brings a TextBox's buffer up to date after its window's text changed, under its lock. While a text set on another thread is on
+   its way to the window, the window's edits are dropped: that text replaces them */
+PRIVATE BOOL syncTextBox(TextBox textbox){
+	BOOL result = TRUE;
+
+	startSync(textbox);
+	if (textbox->windowBehind)
+		textbox->snapshotValid = FALSE;
+	else
+		result = readTextBoxEdit(textbox);
+	endSync(textbox);
+
+	return result;
+}
+
+/* The Methods*/
+/* Sets the text input mode for a textbox to number-only or to not number-only */
+BOOL TextBox_setNumOnly(TextBox textbox, BOOL numOnly){
+	textbox->numOnly = numOnly;
+	textbox->styles = numOnly ? textbox->styles | ES_NUMBER : textbox->styles ^ ES_NUMBER;
+	
+	if (textbox->handle)
+		return SetWindowLongPtrA(textbox->handle, GWL_STYLE, (LONG)textbox->styles) ? TRUE : FALSE;
+	else
+		return TRUE;
+}
+
+/* Gets a TextBox's text, bringing its text field up to date with the edits made since it was last asked for */
+char *TextBox_getText(TextBox textbox){
+	unsigned int length;
+	char *newText;
+
+	if (textbox->textStale && textbox->textBuffer){
+		length = TextBuffer_getLength(textbox->textBuffer);
+		newText = reserveText((GUIObject)textbox, length);
+		if (!newText)
+			return NULL;
+		TextBuffer_copy(textbox->textBuffer, 0, length, newText);
+		newText[length] = '\0';
+		textbox->textStale = FALSE;
+	}
+
+	return textbox->text;
+}
+
+/* Gets the length of a TextBox's text */
+unsigned int TextBox_getTextLength(TextBox textbox){
+	return textbox->textBuffer ? TextBuffer_getLength(textbox->textBuffer) : 0;
+}
+
+/* Replaces removed characters at offset in a TextBox's text with another text. The TextBox's window only redraws the changed part,
+   and the selection is moved to the end of the new text */
+BOOL TextBox_replaceText(TextBox textbox, unsigned int offset, unsigned int removed, char *text){
+	unsigned int length = TextBox_getTextLength(textbox);
+	WCHAR *wideText;
+
+	if (!textbox->textBuffer || offset > length || removed > length - offset)
+		return FALSE;
+
+	/* The window reports the edit like a typed one. On other threads, the edit is made to the buffer and the window is updated in
+	   its own thread */
+	if (textbox->handle && inWindowThread(textbox->handle)){
+		wideText = newWideText(text, text ? (unsigned int)strlen(text) : 0);
+		if (!wideText)
+			return FALSE;
+		SendMessageW(textbox->handle, EM_SETSEL, (WPARAM)convertTextBoxOffset(textbox, offset, TRUE),
+						(LPARAM)convertTextBoxOffset(textbox, offset + removed, TRUE));
+		SendMessageW(textbox->handle, EM_REPLACESEL, (WPARAM)TRUE, (LPARAM)wideText);
+		free(wideText);
+		return TRUE;
+	}
+
+	if (!replaceTextBoxText(textbox, offset, removed, text, text ? (unsigned int)strlen(text) : 0))
+		return FALSE;
+	if (textbox->handle)
+		requestTextBoxUpdate(textbox);
+	return TRUE;
+}
+
+/* Sets a callback that is called with every change of a TextBox's text */
+BOOL TextBox_setOnTextChange(TextBox textbox, TextChangeCallback callback, void *context){
+	textbox->onTextChange = callback;
+	textbox->textChangeContext = context;
+
+	return TRUE;
+}
+
+
+
+/* The Constructors*/
+void initTextBox(TextBox thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height, enum _textboxtype multiline){
+	if (!thisObject)
+		return;
+
+	CLASS_TextBox;
+
+	setControlFields((Control)thisObject, instance, text, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = TEXTBOX;
+	thisObject->className = "Edit";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | WS_BORDER;
+
+	thisObject->multiline = (BOOL)multiline;
+	if (thisObject->multiline)
+		thisObject->styles |= ES_MULTILINE | ES_WANTRETURN;
+
+	thisObject->textBuffer = newTextBuffer(text, text ? (unsigned int)strlen(text) : 0);
+}
+
+TextBox newTextBox(HINSTANCE instance, char *text, int x, int y, int width, int height, enum _textboxtype multiline){
+	TextBox thisObject = (TextBox)allocObjectMemory(currentArena, sizeof(val_TextBox));
+
+	if (!thisObject)
+		return NULL;
+
+	initTextBox(thisObject, instance, text, x, y, width, height, multiline);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteTextBox(TextBox textbox){
+	deleteTextBuffer(textbox->textBuffer);
+
+	textbox->className = NULL;
+	freeGUIObjectFields((GUIObject)textbox);
+	releaseGUIObject((GUIObject)textbox);
+}
+
+
+
+
+
+/* Class Label */
+/* The Constructors*/
+void initLabel(Label thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_Button;
+
+	setControlFields((Control)thisObject, instance, text, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = LABEL;
+	thisObject->className = "Static";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | SS_NOTIFY;
+}
+
+Label newLabel(HINSTANCE instance, char *text, int x, int y, int width, int height){
+	Label thisObject = (Label)allocObjectMemory(currentArena, sizeof(val_Label));
+
+	if (!thisObject)
+		return NULL;
+
+	initLabel(thisObject, instance, text, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteLabel(Label label){
+	label->className = NULL;
+	freeGUIObjectFields((GUIObject)label);
+	releaseGUIObject((GUIObject)label);
+}
+
+
+
+
+
+/* Class ListView */
+/* Gets the height of a ListView's viewport */
+PRIVATE int getListViewHeight(ListView listview){
+	RECT clientRect;
+
+	if (listview->handle && GetClientRect(listview->handle, &clientRect))
+		return clientRect.bottom - clientRect.top;
+
+	return listview->realHeight;
+}
+
+/* Gets the height of a ListView's items, pixels. The height is cut at INT_MAX, the furthest an int scroll position reaches */
+PRIVATE int getListContentHeight(ListView listview){
+	long long height = (long long)listview->numItems * listview->rowHeight;
+
+	return height < INT_MAX ? (int)height : INT_MAX;
+}
+
+/* Drops all of a ListView's fetched pages */
+PRIVATE void clearListPages(ListView listview){
+	unsigned int i;
+
+	if (!listview->pages)
+		return;
+
+	for (i = 0; i < LISTVIEW_NUM_PAGES; i++){
+		free((listview->pages)[i].text);
+		(listview->pages)[i].text = NULL;
+		(listview->pages)[i].first = LISTVIEW_NO_ITEM;
+		(listview->pages)[i].count = 0;
+	}
+}
+
+/* Gets the text of an item from the page cache, fetching its page from the data source (in place of the least recently used page) if
+   it isn't cached. Returns an empty string if the item could not be fetched */
+PRIVATE char *getListItemText(ListView listview, unsigned int item){
+	char *fetched[LISTVIEW_PAGE_SIZE], *text;
+	struct _listPage *page = NULL;
+	unsigned int first = item - item % LISTVIEW_PAGE_SIZE, count, i;
+	size_t textLength = 0, length;
+
+	if (!listview->pages || !listview->fetchItems || item >= listview->numItems)
+		return "";
+
+	for (i = 0; i < LISTVIEW_NUM_PAGES; i++){
+		if ((listview->pages)[i].first == first){
+			(listview->pages)[i].lastUse = ++(listview->pageClock);
+			return (listview->pages)[i].items[item - first];
+		}
+		if (!page || (listview->pages)[i].lastUse < page->lastUse)
+			page = &(listview->pages)[i];
+	}
+
+	/* Fetch the page */
+	count = listview->numItems - first < LISTVIEW_PAGE_SIZE ? listview->numItems - first : LISTVIEW_PAGE_SIZE;
+	memset(fetched, 0, sizeof(fetched));
+	if (!listview->fetchItems(listview->dataContext, first, count, fetched))
+		return "";
+
+	for (i = 0; i < count; i++)
+		textLength += (fetched[i] ? strlen(fetched[i]) : 0) + 1;
+
+	text = (char*)malloc(textLength);
+	if (!text)
+		return "";
+
+	/* Copy the texts into a single block */
+	free(page->text);
+	page->text = text;
+	page->first = first;
+	page->count = count;
+	page->lastUse = ++(listview->pageClock);
+	for (i = 0; i < count; i++){
+		length = fetched[i] ? strlen(fetched[i]) : 0;
+		memcpy(text, fetched[i] ? fetched[i] : "", length);
+		text[length] = '\0';
+		page->items[i] = text;
+		text += length + 1;
+	}
+
+	return page->items[item - first];
+}
+
+/* Calls the ListView's item click callback for a clicked row */
+PRIVATE void listRowClicked(GUIObject sender, void *context, EventArgs args){
+	ListView listview = (ListView)context;
+	unsigned int i;
+
+	UNREFERENCED_PARAMETER(args);
+
+	for (i = 0; i < listview->numRows; i++)
+		if ((GUIObject)(listview->rows)[i] == sender){
+			if ((listview->rowItems)[i] != LISTVIEW_NO_ITEM && listview->onItemClick)
+				listview->onItemClick(listview, listview->itemClickContext, (listview->rowItems)[i]);
+			return;
+		}
+}
+
+/* Adds rows to a ListView until it has numRows rows. Rows only get windows if the ListView already has one, otherwise they are displayed
+   with it. The rows are remapped to items afterwards */
+PRIVATE BOOL addListRows(ListView listview, unsigned int numRows){
+	Label *newRows, newRow;
+	unsigned int *newRowItems, i;
+	Arena prevArena;
+	int width;
+
+	newRows = (Label*)realloc(listview->rows, numRows * sizeof(Label));
+	if (!newRows)
+		return FALSE;
+	listview->rows = newRows;
+
+	newRowItems = (unsigned int*)realloc(listview->rowItems, numRows * sizeof(unsigned int));
+	if (!newRowItems)
+		return FALSE;
+	listview->rowItems = newRowItems;
+
+	width = listview->realWidth;
+	for (i = listview->numRows; i < numRows; i++){
+		/* The rows are allocated with the ListView, whichever arena the thread uses meanwhile */
+		prevArena = useArena(listview->arena);
+		newRow = newLabel(listview->moduleInstance, "", 0, -listview->rowHeight, width, listview->rowHeight);
+		useArena(prevArena);
+		if (!newRow)
+			return FALSE;
+
+		newRow->anchor = ANCHOR_LEFT | ANCHOR_RIGHT | ANCHOR_TOP;
+		GUIObject_setOnClick((GUIObject)newRow, listRowClicked, listview, SYNC);
+		GUIObject_addChild((GUIObject)listview, (GUIObject)newRow); /* Realized if the ListView is, painted by the message loop */
+
+		(listview->rows)[i] = newRow;
+		listview->numRows = i + 1;
+	}
+
+	/* The rows are assigned to the items by their index modulo numRows, which just changed */
+	for (i = 0; i < listview->numRows; i++)
+		(listview->rowItems)[i] = LISTVIEW_NO_ITEM;
+
+	return TRUE;
+}
+
+/* Realizes the rows of a ListView for its viewport plus overscan, fetching the items lazily. Rows that already show an item in the new
+   range keep it and are only moved, the others are recycled for the items that scrolled in. Rows without items are parked above the
+   viewport. All the windows are moved in a single DeferWindowPos batch, and the scroll bar is updated */
+PRIVATE BOOL updateListRows(ListView listview){
+	unsigned int numNeeded, first, item, i;
+	int viewHeight, maxScrollPos, y;
+	SCROLLINFO scrollInfo;
+	HDWP deferredPos = NULL;
+	Label currRow;
+	BOOL result = TRUE;
+
+	viewHeight = getListViewHeight(listview);
+	if (listview->rowHeight <= 0 || viewHeight < 0)
+		return FALSE;
+
+	/* Clamp the scroll position to the content */
+	maxScrollPos = getListContentHeight(listview) - viewHeight;
+	if (listview->scrollPos > maxScrollPos)
+		listview->scrollPos = maxScrollPos;
+	if (listview->scrollPos < 0)
+		listview->scrollPos = 0;
+
+	/* Rows are only ever added, so that scrolling and resizing never create and destroy windows back and forth */
+	numNeeded = (unsigned int)(viewHeight / listview->rowHeight) + 2 + 2 * listview->overscan;
+	if (numNeeded > listview->numItems)
+		numNeeded = listview->numItems;
+	if (numNeeded > listview->numRows && !addListRows(listview, numNeeded))
+		result = FALSE;
+
+	if (listview->numRows){
+		first = (unsigned int)(listview->scrollPos / listview->rowHeight);
+		first = first > listview->overscan ? first - listview->overscan : 0;
+
+		if (listview->handle)
+			deferredPos = BeginDeferWindowPos(listview->numRows);
+
+		for (i = 0; i < listview->numRows; i++){
+			/* The item in [first, first + numRows) that maps to this row */
+			item = first + (i + listview->numRows - first % listview->numRows) % listview->numRows;
+			if (item >= listview->numItems)
+				item = LISTVIEW_NO_ITEM;
+
+			currRow = (listview->rows)[i];
+			if ((listview->rowItems)[i] != item){
+				GUIObject_setText((GUIObject)currRow, item != LISTVIEW_NO_ITEM ? getListItemText(listview, item) : "");
+				(listview->rowItems)[i] = item;
+			}
+
+			y = (item != LISTVIEW_NO_ITEM) ? (int)((long long)item * listview->rowHeight - listview->scrollPos) : -listview->rowHeight;
+			if (currRow->y == y && currRow->realY == y)
+				continue;
+
+			Control_updatePos((Control)currRow, 0, y);
+			updateSpatialItem((GUIObject)currRow);
+			if (currRow->handle){
+				if (deferredPos)
+					deferredPos = DeferWindowPos(deferredPos, currRow->handle, NULL, currRow->x, currRow->y, currRow->width, currRow->height,
+													SWP_NOZORDER | SWP_NOACTIVATE);
+				else if (!SetWindowPos(currRow->handle, NULL, currRow->x, currRow->y, currRow->width, currRow->height,
+													SWP_NOZORDER | SWP_NOACTIVATE))
+					result = FALSE;
+			}
+		}
+
+		if (deferredPos && !EndDeferWindowPos(deferredPos))
+			result = FALSE;
+	}
+
+	if (listview->handle){
+		scrollInfo.cbSize = sizeof(SCROLLINFO);
+		scrollInfo.fMask = SIF_RANGE | SIF_PAGE | SIF_POS;
+		scrollInfo.nMin = 0;
+		scrollInfo.nMax = getListContentHeight(listview) - 1;
+		scrollInfo.nPage = (UINT)viewHeight;
+		scrollInfo.nPos = listview->scrollPos;
+		SetScrollInfo(listview->handle, SB_VERT, &scrollInfo, TRUE);
+	}
+
+	return result;
+}
+
+/* The Methods*/
+/* Sets the data source of a ListView and shows its items from the top */
+BOOL ListView_setDataSource(ListView listview, ListCountFunc getItemCount, ListFetchFunc fetchItems, void *context){
+	if (!listview)
+		return FALSE;
+
+	listview->getItemCount = getItemCount;
+	listview->fetchItems = fetchItems;
+	listview->dataContext = context;
+	listview->scrollPos = 0;
+
+	return ListView_refreshItems(listview);
+}
+
+/* Gets the number of items from a ListView's data source again and refetches the visible items */
+BOOL ListView_refreshItems(ListView listview){
+	unsigned int i;
+
+	if (!listview)
+		return FALSE;
+
+	clearListPages(listview);
+	listview->numItems = listview->getItemCount ? listview->getItemCount(listview->dataContext) : 0;
+	for (i = 0; i < listview->numRows; i++)
+		(listview->rowItems)[i] = LISTVIEW_NO_ITEM;
+
+	return updateListRows(listview);
+}
+
+/* Sets the height of a ListView's rows */
+BOOL ListView_setRowHeight(ListView listview, int rowHeight){
+	unsigned int i;
+
+	if (!listview || rowHeight <= 0)
+		return FALSE;
+
+	listview->scrollPos = (int)((long long)listview->scrollPos * rowHeight / listview->rowHeight);
+	listview->rowHeight = rowHeight;
+	for (i = 0; i < listview->numRows; i++)
+		GUIObject_setSize((GUIObject)(listview->rows)[i], (listview->rows)[i]->realWidth, rowHeight);
+
+	return updateListRows(listview);
+}
+
+/* Scrolls a ListView to a position specified in pixels from the top of its first item */
+BOOL ListView_scrollTo(ListView listview, int scrollPos){
+	if (!listview)
+		return FALSE;
+
+	if (scrollPos == listview->scrollPos)
+		return TRUE;
+
+	listview->scrollPos = scrollPos;
+	return updateListRows(listview);
+}
+
+/* Sets the callback called when an item of a ListView is clicked */
+BOOL ListView_setOnItemClick(ListView listview, ListItemCallback callback, void *context){
+	if (!listview)
+		return FALSE;
+
+	listview->onItemClick = callback;
+	listview->itemClickContext = context;
+	return TRUE;
+}
+
+
+
+/* The Constructors*/
+void initListView(ListView thisObject, HINSTANCE instance, int x, int y, int width, int height){
+	unsigned int i;
+
+	if (!thisObject)
+		return;
+
+	CLASS_ListView;
+
+	setControlFields((Control)thisObject, instance, NULL, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = LISTVIEW;
+	thisObject->className = "Static";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | WS_BORDER | WS_VSCROLL | WS_CLIPCHILDREN | SS_NOTIFY;
+
+	thisObject->pages = (struct _listPage*)malloc(LISTVIEW_NUM_PAGES * sizeof(struct _listPage));
+	if (thisObject->pages)
+		for (i = 0; i < LISTVIEW_NUM_PAGES; i++){
+			(thisObject->pages)[i].first = LISTVIEW_NO_ITEM;
+			(thisObject->pages)[i].count = 0;
+			(thisObject->pages)[i].text = NULL;
+			(thisObject->pages)[i].lastUse = 0;
+		}
+}
+
+ListView newListView(HINSTANCE instance, int x, int y, int width, int height){
+	ListView thisObject = (ListView)allocObjectMemory(currentArena, sizeof(val_ListView));
+
+	if (!thisObject)
+		return NULL;
+
+	initListView(thisObject, instance, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteListView(ListView listview){
+	unsigned int i;
+
+	/* The rows belong to the ListView */
+	for (i = 0; i < listview->numRows; i++)
+		deleteLabel((listview->rows)[i]);
+	free(listview->rows);
+	free(listview->rowItems);
+
+	clearListPages(listview);
+	free(listview->pages);
+
+	listview->className = NULL;
+	freeGUIObjectFields((GUIObject)listview);
+	releaseGUIObject((GUIObject)listview);
+}
+
+
+
+
+
+/* Class Plot */
+/* Gets the length of a pyramid level's blocks in samples, level 0 being the first level above the samples */
+PRIVATE unsigned int getPlotBlockSize(unsigned int level){
+	unsigned int blockSize = PLOT_LEVEL_FACTOR;
+
+	while (level--)
+		blockSize *= PLOT_LEVEL_FACTOR;
+
+	return blockSize;
+}
+
+/* Folds the samples that completed new blocks into the min/max pyramid. Only the blocks past each level's last complete one are
+   computed, each from PLOT_LEVEL_FACTOR entries of the level below, so appending n samples costs O(n) */
+PRIVATE BOOL updatePlotLevels(Plot plot){
+	struct _plotLevel *currLevel, *lowerLevel;
+	unsigned int level, numBlocks, block, i, first, newCapacity;
+	float *newMin, *newMax, min, max;
+
+	if (!plot->levels){
+		plot->levels = (struct _plotLevel*)calloc(PLOT_MAX_LEVELS, sizeof(struct _plotLevel));
+		if (!plot->levels)
+			return FALSE;
+	}
+
+	plot->numLevels = 0;
+	for (level = 0; level < PLOT_MAX_LEVELS; level++){
+		currLevel = plot->levels + level;
+		lowerLevel = level ? currLevel - 1 : NULL;
+		numBlocks = (level ? lowerLevel->numBlocks : plot->numSamples) / PLOT_LEVEL_FACTOR;
+		if (!numBlocks)
+			break;
+
+		if (numBlocks > currLevel->capacity){
+			newCapacity = currLevel->capacity ? currLevel->capacity : 64;
+			while (newCapacity < numBlocks)
+				newCapacity *= 2;
+
+			newMin = (float*)realloc(currLevel->min, newCapacity * sizeof(float));
+			if (newMin)
+				currLevel->min = newMin;
+			newMax = (float*)realloc(currLevel->max, newCapacity * sizeof(float));
+			if (newMax)
+				currLevel->max = newMax;
+			if (!newMin || !newMax)
+				return FALSE;
+			currLevel->capacity = newCapacity;
+		}
+
+		for (block = currLevel->numBlocks; block < numBlocks; block++){
+			first = block * PLOT_LEVEL_FACTOR;
+			if (level){
+				min = (lowerLevel->min)[first];
+				max = (lowerLevel->max)[first];
+				for (i = first + 1; i < first + PLOT_LEVEL_FACTOR; i++){
+					if ((lowerLevel->min)[i] < min)
+						min = (lowerLevel->min)[i];
+					if ((lowerLevel->max)[i] > max)
+						max = (lowerLevel->max)[i];
+				}
+			} else {
+				min = max = (plot->samples)[first];
+				for (i = first + 1; i < first + PLOT_LEVEL_FACTOR; i++){
+					if ((plot->samples)[i] < min)
+						min = (plot->samples)[i];
+					if ((plot->samples)[i] > max)
+						max = (plot->samples)[i];
+				}
+			}
+			(currLevel->min)[block] = min;
+			(currLevel->max)[block] = max;
+		}
+		currLevel->numBlocks = numBlocks;
+		plot->numLevels = level + 1;
+	}
+
+	return TRUE;
+}
+
+/* Gets the minimum and maximum of the samples in [first, last). The range is covered greedily by the largest aligned complete
+   blocks of the pyramid, so it costs at most about 2 * PLOT_LEVEL_FACTOR steps per level, whatever its length */
+PRIVATE void getPlotRange(Plot plot, unsigned int first, unsigned int last, float *min, float *max){
+	unsigned int level, blockSize;
+	float currMin, currMax;
+	BOOL found = FALSE;
+
+	while (first < last){
+		level = 0;
+		blockSize = 1;
+		while (level < plot->numLevels && first % (blockSize * PLOT_LEVEL_FACTOR) == 0 &&
+				last - first >= blockSize * PLOT_LEVEL_FACTOR &&
+				first / (blockSize * PLOT_LEVEL_FACTOR) < (plot->levels)[level].numBlocks){
+			blockSize *= PLOT_LEVEL_FACTOR;
+			level++;
+		}
+
+		if (level){
+			currMin = ((plot->levels)[level - 1].min)[first / blockSize];
+			currMax = ((plot->levels)[level - 1].max)[first / blockSize];
+		} else
+			currMin = currMax = (plot->samples)[first];
+
+		if (!found || currMin < *min)
+			*min = currMin;
+		if (!found || currMax > *max)
+			*max = currMax;
+		found = TRUE;
+		first += blockSize;
+	}
+}
+
+/* Gets the column of samples shown at the left edge of a Plot */
+PRIVATE unsigned int getPlotFirstColumn(Plot plot){
+	unsigned int numColumns;
+
+	if (!plot->following)
+		return plot->firstColumn;
+
+	numColumns = plot->numSamples ? (plot->numSamples - 1) / plot->samplesPerPixel + 1 : 0;
+	return (plot->width > 0 && numColumns > (unsigned int)plot->width) ? numColumns - plot->width : 0;
+}
+
+/* Maps a value to a Plot's y coordinate, clamped just outside of its edges */
+PRIVATE int getPlotY(Plot plot, float value){
+	float y = (plot->maxValue - value) * (plot->height - 1) / (plot->maxValue - plot->minValue);
+
+	if (y < -1)
+		return -1;
+	if (y > plot->height)
+		return plot->height;
+	return (int)y;
+}
+
+/* Draws the pixel columns [left, right) of a Plot at the origin of a device context. Each column is one vertical line from the
+   minimum to the maximum of its samples, taken from the pyramid, stretched to touch the previous column's line so the trace stays
+   connected. All the lines are drawn with a single PolyPolyline call, so the cost depends on the width and not on the samples */
+PRIVATE void drawPlotColumns(Plot plot, HDC dc, int left, int right){
+	RECT rect;
+	HBRUSH brush;
+	HPEN pen, prevPen;
+	POINT *newPoints;
+	DWORD *newCounts;
+	unsigned int firstColumn = getPlotFirstColumn(plot), numLines = 0;
+	unsigned long long first;
+	float min, max, prevMin = 0, prevMax = 0;
+	int x, top, bottom;
+	BOOL hasPrev = FALSE;
+
+	if (left < 0)
+		left = 0;
+	if (right > plot->width)
+		right = plot->width;
+	if (left >= right)
+		return;
+
+	SetRect(&rect, left, 0, right, plot->height);
+	brush = CreateSolidBrush(plot->backgroundColor);
+	FillRect(dc, &rect, brush);
+	DeleteObject(brush);
+
+	if (!plot->samples || plot->maxValue == plot->minValue)
+		return;
+
+	if ((unsigned int)(right - left) > plot->pointsCapacity){
+		newPoints = (POINT*)realloc(plot->points, 2 * (right - left) * sizeof(POINT));
+		if (newPoints)
+			plot->points = newPoints;
+		newCounts = (DWORD*)realloc(plot->pointCounts, (right - left) * sizeof(DWORD));
+		if (newCounts)
+			plot->pointCounts = newCounts;
+		if (!newPoints || !newCounts)
+			return;
+		plot->pointsCapacity = right - left;
+	}
+
+	/* The column before the first drawn one, so that strips drawn separately join up */
+	first = ((unsigned long long)firstColumn + left) * plot->samplesPerPixel;
+	if (first && first <= plot->numSamples){
+		getPlotRange(plot, (unsigned int)(first - 1), (unsigned int)(first - 1) + 1, &prevMin, &prevMax);
+		hasPrev = TRUE;
+	}
+
+	for (x = left; x < right; x++){
+		first = ((unsigned long long)firstColumn + x) * plot->samplesPerPixel;
+		if (first >= plot->numSamples)
+			break;
+
+		getPlotRange(plot, (unsigned int)first, first + plot->samplesPerPixel < plot->numSamples ?
+						(unsigned int)first + plot->samplesPerPixel : plot->numSamples, &min, &max);
+		top = getPlotY(plot, hasPrev && prevMin > max ? prevMin : max);
+		bottom = getPlotY(plot, hasPrev && prevMax < min ? prevMax : min);
+		prevMin = min;
+		prevMax = max;
+		hasPrev = TRUE;
+
+		(plot->points)[2 * numLines].x = x;
+		(plot->points)[2 * numLines].y = top;
+		(plot->points)[2 * numLines + 1].x = x;
+		(plot->points)[2 * numLines + 1].y = bottom + 1; /* The last point of a line isn't drawn */
+		(plot->pointCounts)[numLines] = 2;
+		numLines++;
+	}
+
+	if (numLines){
+		pen = CreatePen(PS_SOLID, 1, plot->lineColor);
+		prevPen = (HPEN)SelectObject(dc, pen);
+		PolyPolyline(dc, plot->points, plot->pointCounts, numLines);
+		SelectObject(dc, prevPen);
+		DeleteObject(pen);
+	}
+}
+
+/* Redraws a Plot, or the pixel columns [left, right) of it if it has a window */
+PRIVATE BOOL invalidatePlot(Plot plot, int left, int right){
+	RECT rect;
+
+	if (plot->windowless)
+		return invalidateWindowless((GUIObject)plot);
+	if (!plot->handle)
+		return TRUE;
+
+	SetRect(&rect, left, 0, right, plot->height);
+	return InvalidateRect(plot->handle, &rect, FALSE);
+}
+
+
+
+/* The methods */
+/* Sets the samples shown by a Plot. The buffer isn't copied and must stay valid until it is replaced, and the pyramid over it is
+   rebuilt */
+BOOL Plot_setSamples(Plot plot, const float *samples, unsigned int numSamples){
+	unsigned int i;
+
+	plot->samples = samples;
+	plot->numSamples = samples ? numSamples : 0;
+	if (plot->levels)
+		for (i = 0; i < PLOT_MAX_LEVELS; i++)
+			(plot->levels)[i].numBlocks = 0;
+
+	if (!updatePlotLevels(plot))
+		return FALSE;
+
+	return invalidatePlot(plot, 0, plot->width);
+}
+
+/* Tells a Plot that samples were appended to its buffer. The buffer may have been moved (for example, by realloc), but the samples
+   already shown must be unchanged. Only the new samples are folded into the pyramid, and a following Plot scrolls its window by
+   the number of new columns and only redraws the columns that changed */
+BOOL Plot_appendSamples(Plot plot, const float *samples, unsigned int numSamples){
+	unsigned int prevNumSamples = plot->numSamples, prevFirstColumn = getPlotFirstColumn(plot), firstColumn, changedColumn,
+				lastColumn;
+
+	if (!samples || numSamples < prevNumSamples)
+		return FALSE;
+
+	plot->samples = samples;
+	plot->numSamples = numSamples;
+	if (!updatePlotLevels(plot))
+		return FALSE;
+
+	if (numSamples == prevNumSamples)
+		return TRUE;
+	if (plot->windowless || !plot->handle)
+		return invalidatePlot(plot, 0, plot->width);
+
+	firstColumn = getPlotFirstColumn(plot);
+	changedColumn = prevNumSamples ? (prevNumSamples - 1) / plot->samplesPerPixel : 0; /* The last column may have been partial */
+	lastColumn = (numSamples - 1) / plot->samplesPerPixel;
+
+	/* A pending update region wouldn't be scrolled along with the pixels */
+	if (firstColumn - prevFirstColumn >= (unsigned int)plot->width || GetUpdateRect(plot->handle, NULL, FALSE))
+		return invalidatePlot(plot, 0, plot->width);
+	if (firstColumn != prevFirstColumn)
+		ScrollWindowEx(plot->handle, -(int)(firstColumn - prevFirstColumn), 0, NULL, NULL, NULL, NULL, SW_INVALIDATE);
+
+	if (lastColumn < firstColumn || changedColumn >= firstColumn + plot->width)
+		return TRUE;
+	return invalidatePlot(plot, changedColumn > firstColumn ? changedColumn - firstColumn : 0, lastColumn - firstColumn + 1);
+}
+
+/* Shows a Plot's samples from firstSample on, with samplesPerPixel samples in each pixel column. This stops following the newest
+   samples */
+BOOL Plot_setView(Plot plot, unsigned int firstSample, unsigned int samplesPerPixel){
+	if (!samplesPerPixel)
+		return FALSE;
+
+	plot->samplesPerPixel = samplesPerPixel;
+	plot->firstColumn = firstSample / samplesPerPixel;
+	plot->following = FALSE;
+
+	return invalidatePlot(plot, 0, plot->width);
+}
+
+/* Sets whether a Plot keeps its newest samples at its right edge */
+BOOL Plot_setFollowing(Plot plot, BOOL following){
+	if (!following)
+		plot->firstColumn = getPlotFirstColumn(plot);
+	plot->following = following;
+
+	return invalidatePlot(plot, 0, plot->width);
+}
+
+/* Sets the values shown at the bottom and the top of a Plot */
+BOOL Plot_setRange(Plot plot, float minValue, float maxValue){
+	if (minValue == maxValue)
+		return FALSE;
+
+	plot->minValue = minValue;
+	plot->maxValue = maxValue;
+
+	return invalidatePlot(plot, 0, plot->width);
+}
+
+/* Sets the colors of a Plot's trace and background */
+BOOL Plot_setColors(Plot plot, COLORREF lineColor, COLORREF backgroundColor){
+	plot->lineColor = lineColor;
+	plot->backgroundColor = backgroundColor;
+
+	return invalidatePlot(plot, 0, plot->width);
+}
+
+
+
+/* The Constructors*/
+void initPlot(Plot thisObject, HINSTANCE instance, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_Plot;
+
+	setControlFields((Control)thisObject, instance, NULL, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = PLOT;
+	thisObject->className = "Static";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | SS_NOTIFY;
+	thisObject->customEraseBG = TRUE; /* The Plot paints its whole background */
+}
+
+Plot newPlot(HINSTANCE instance, int x, int y, int width, int height){
+	Plot thisObject = (Plot)allocObjectMemory(currentArena, sizeof(val_Plot));
+
+	if (!thisObject)
+		return NULL;
+
+	initPlot(thisObject, instance, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deletePlot(Plot plot){
+	unsigned int i;
+
+	/* The samples belong to the caller */
+	if (plot->levels)
+		for (i = 0; i < PLOT_MAX_LEVELS; i++){
+			free((plot->levels)[i].min);
+			free((plot->levels)[i].max);
+		}
+	free(plot->levels);
+	free(plot->points);
+	free(plot->pointCounts);
+
+	plot->className = NULL;
+	freeGUIObjectFields((GUIObject)plot);
+	releaseGUIObject((GUIObject)plot);
+}
+
+
+
+
+
+/* Class LogView */
+/* Gets the number of lines that fit in a LogView's viewport */
+PRIVATE unsigned int getLogViewRows(LogView logview){
+	RECT clientRect;
+	int height = logview->height;
+
+	if (logview->handle && GetClientRect(logview->handle, &clientRect))
+		height = clientRect.bottom - clientRect.top;
+
+	return height > logview->lineHeight ? (unsigned int)(height / logview->lineHeight) : 1;
+}
+
+/* Gets the number of the top line of a LogView scrolled to the bottom */
+PRIVATE unsigned long long getLogViewLastTop(LogView logview, unsigned long long firstLine, unsigned long long numLines){
+	unsigned int numRows = getLogViewRows(logview);
+
+	return numLines - firstLine > numRows ? numLines - numRows : firstLine;
+}
+
+/* Posts an update message to a LogView's window, unless one is already pending. A burst of appends from any number of threads
+   results in a single update */
+PRIVATE void requestLogViewUpdate(LogView logview){
+	if (logview->handle && !InterlockedExchange(&(logview->updatePending), TRUE))
+		postInternalMessage(logview->handle, UPDATE_LOG);
+}
+
+/* Brings a LogView's viewport and scroll bar up to date with its lines, in the thread of its window. When the lines shown before
+   are still in place, the window is scrolled by the number of new lines and only the lines appended since the last update are
+   repainted; prevTop is the top line of the viewport as last painted */
+PRIVATE void updateLogView(LogView logview, unsigned long long prevTop){
+	SCROLLINFO scrollInfo;
+	RECT clientRect, rect;
+	unsigned long long firstLine, numLines, lastTop;
+	unsigned int numRows = getLogViewRows(logview);
+
+	InterlockedExchange(&(logview->updatePending), FALSE);
+
+	startSync(logview);
+	firstLine = logview->firstLine;
+	numLines = logview->numLines;
+	endSync(logview);
+
+	lastTop = getLogViewLastTop(logview, firstLine, numLines);
+	if (logview->autoScroll || logview->topLine > lastTop)
+		logview->topLine = lastTop;
+	else if (logview->topLine < firstLine)
+		logview->topLine = firstLine;
+
+	if (logview->handle){
+		scrollInfo.cbSize = sizeof(SCROLLINFO);
+		scrollInfo.fMask = SIF_RANGE | SIF_PAGE | SIF_POS;
+		scrollInfo.nMin = 0;
+		scrollInfo.nMax = numLines > firstLine ? (int)(numLines - firstLine - 1) : 0;
+		scrollInfo.nPage = numRows;
+		scrollInfo.nPos = (int)(logview->topLine - firstLine);
+		SetScrollInfo(logview->handle, SB_VERT, &scrollInfo, TRUE);
+
+		/* Lines dropped from the viewport, scrolling back or a pending update region (which wouldn't be scrolled along) need a full
+		   repaint */
+		if (firstLine > prevTop || logview->topLine < prevTop || logview->topLine - prevTop >= numRows ||
+				GetUpdateRect(logview->handle, NULL, FALSE))
+			InvalidateRect(logview->handle, NULL, FALSE);
+		else {
+			if (logview->topLine != prevTop)
+				ScrollWindowEx(logview->handle, 0, -(int)(logview->topLine - prevTop) * logview->lineHeight, NULL, NULL, NULL, NULL,
+								SW_INVALIDATE);
+			if (numLines > logview->shownLines && logview->shownLines < logview->topLine + numRows && GetClientRect(logview->handle,
+																												&clientRect)){
+				SetRect(&rect, 0, logview->shownLines > logview->topLine ?
+							(int)(logview->shownLines - logview->topLine) * logview->lineHeight : 0,
+						clientRect.right, clientRect.bottom);
+				InvalidateRect(logview->handle, &rect, FALSE);
+			}
+		}
+	}
+
+	logview->shownLines = numLines;
+}
+
+
+
+/* The methods */
+/* Appends a line to a LogView, dropping its oldest line if it's full. The text is copied. This takes constant time whatever the
+   number of lines, and can be called from any thread: the LogView's window is updated asynchronously, once per burst of appends */
+BOOL LogView_appendLine(LogView logview, const char *text){
+	char *line, *droppedLine = NULL;
+	size_t length = text ? strlen(text) : 0;
+
+	line = (char*)malloc(length + 1);
+	if (!line)
+		return FALSE;
+	if (length)
+		memcpy(line, text, length);
+	line[length] = '\0';
+
+	startSync(logview);
+	if (!logview->lines) /* The ring buffer is allocated on the first append */
+		logview->lines = (char**)calloc(logview->maxLines, sizeof(char*));
+	if (!logview->lines){
+		endSync(logview);
+		free(line);
+		return FALSE;
+	}
+
+	if (logview->numLines - logview->firstLine == logview->maxLines){
+		droppedLine = (logview->lines)[logview->firstLine % logview->maxLines];
+		logview->firstLine++;
+	}
+	(logview->lines)[logview->numLines % logview->maxLines] = line;
+	logview->numLines++;
+	endSync(logview);
+
+	free(droppedLine);
+	requestLogViewUpdate(logview);
+
+	return TRUE;
+}
+
+/* Drops all the lines of a LogView. Can be called from any thread */
+BOOL LogView_clear(LogView logview){
+	unsigned long long i;
+
+	startSync(logview);
+	for (i = logview->firstLine; i < logview->numLines; i++){
+		free((logview->lines)[i % logview->maxLines]);
+		(logview->lines)[i % logview->maxLines] = NULL;
+	}
+	logview->firstLine = logview->numLines;
+	endSync(logview);
+
+	requestLogViewUpdate(logview);
+
+	return TRUE;
+}
+
+/* Sets the number of lines a LogView keeps, dropping its oldest lines if it has more. Can be called from any thread */
+BOOL LogView_setMaxLines(LogView logview, unsigned int maxLines){
+	char **newLines;
+	unsigned long long i;
+
+	if (!maxLines)
+		return FALSE;
+
+	startSync(logview);
+	if (logview->lines){
+		newLines = (char**)calloc(maxLines, sizeof(char*));
+		if (!newLines){
+			endSync(logview);
+			return FALSE;
+		}
+
+		for (; logview->numLines - logview->firstLine > maxLines; logview->firstLine++)
+			free((logview->lines)[logview->firstLine % logview->maxLines]);
+		for (i = logview->firstLine; i < logview->numLines; i++)
+			newLines[i % maxLines] = (logview->lines)[i % logview->maxLines];
+
+		free(logview->lines);
+		logview->lines = newLines;
+	}
+	logview->maxLines = maxLines;
+	endSync(logview);
+
+	requestLogViewUpdate(logview);
+
+	return TRUE;
+}
+
+/* Sets the height of a LogView's lines, pixels */
+BOOL LogView_setLineHeight(LogView logview, int lineHeight){
+	if (lineHeight <= 0)
+		return FALSE;
+
+	logview->lineHeight = lineHeight;
+	updateLogView(logview, logview->topLine);
+
+	return logview->handle ? InvalidateRect(logview->handle, NULL, FALSE) : TRUE;
+}
+
+/* Scrolls a LogView so that a line is at the top of its viewport. Scrolling to the bottom turns autoScroll on, scrolling anywhere
+   else turns it off */
+BOOL LogView_scrollToLine(LogView logview, unsigned long long line){
+	unsigned long long firstLine, lastTop, prevTop = logview->topLine;
+
+	startSync(logview);
+	firstLine = logview->firstLine;
+	lastTop = getLogViewLastTop(logview, firstLine, logview->numLines);
+	endSync(logview);
+
+	if (line < firstLine)
+		line = firstLine;
+	if (line > lastTop)
+		line = lastTop;
+
+	logview->topLine = line;
+	logview->autoScroll = (line == lastTop);
+	updateLogView(logview, prevTop);
+
+	return TRUE;
+}
+
+/* Sets whether a LogView keeps its newest line in view */
+BOOL LogView_setAutoScroll(LogView logview, BOOL autoScroll){
+	logview->autoScroll = autoScroll;
+	updateLogView(logview, logview->topLine);
+
+	return TRUE;
+}
+
+
+
+/* The Constructors*/
+void initLogView(LogView thisObject, HINSTANCE instance, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_LogView;
+
+	setControlFields((Control)thisObject, instance, NULL, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = LOGVIEW;
+	thisObject->className = "Static";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | WS_BORDER | WS_VSCROLL | SS_NOTIFY;
+	thisObject->customEraseBG = TRUE; /* The LogView paints its whole background */
+}
+
+LogView newLogView(HINSTANCE instance, int x, int y, int width, int height){
+	LogView thisObject = (LogView)allocObjectMemory(currentArena, sizeof(val_LogView));
+
+	if (!thisObject)
+		return NULL;
+
+	initLogView(thisObject, instance, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteLogView(LogView logview){
+	unsigned long long i;
+
+	if (logview->lines)
+		for (i = logview->firstLine; i < logview->numLines; i++)
+			free((logview->lines)[i % logview->maxLines]);
+	free(logview->lines);
+
+	logview->className = NULL;
+	freeGUIObjectFields((GUIObject)logview);
+	releaseGUIObject((GUIObject)logview);
+}
+
+
+
+
+
+/* Class ImageView */
+/* The states of an ImageView's tiles */
+#define TILE_LOADING 0
+#define TILE_READY 1
+#define TILE_FAILED 2
+
+/* Gets the size of an ImageView's client area */
+PRIVATE void getImageViewSize(ImageView imageview, int *width, int *height){
+	RECT clientRect;
+
+	if (imageview->handle && GetClientRect(imageview->handle, &clientRect)){
+		*width = clientRect.right - clientRect.left;
+		*height = clientRect.bottom - clientRect.top;
+	} else {
+		*width = imageview->width;
+		*height = imageview->height;
+	}
+}
+
+/* Reads pixels from a memory-mapped bitmap file. The rows the pixels cover are mapped in one band. A pixel of a reduced level is the
+   average of the step x step block of the image it stands for (or of the part of it inside the image), which is what a 2x2 box
+   filter applied level after level gives, without rounding at each level */
+PRIVATE BOOL readBitmapFile(void *context, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+							unsigned int step, DWORD *pixels){
+	struct _bitmapFile *file = (struct _bitmapFile*)context;
+	unsigned int i, j, r, c, firstRow, numRows, fileRow, sx, sy, blockWidth, blockHeight, count;
+	unsigned long long offset, base, *sums;
+	const BYTE *band, *row, *pixel;
+	void *view;
+
+	firstRow = y;
+	numRows = (unsigned long long)height * step < file->height - y ? height * step : file->height - y;
+	fileRow = file->bottomUp ? file->height - firstRow - numRows : firstRow;
+	offset = file->dataOffset + (unsigned long long)fileRow * file->stride;
+	base = offset - offset % file->granularity;
+	view = MapViewOfFile(file->mapping, FILE_MAP_READ, (DWORD)(base >> 32), (DWORD)base,
+						(SIZE_T)(offset - base + (unsigned long long)numRows * file->stride));
+	if (!view)
+		return FALSE;
+	band = (const BYTE*)view + (offset - base);
+
+	/* The rows of a block are added up column by column, 3 sums per pixel */
+	sums = step == 1 ? NULL : (unsigned long long*)malloc((size_t)width * 3 * sizeof(unsigned long long));
+	if (step != 1 && !sums){
+		UnmapViewOfFile(view);
+		return FALSE;
+	}
+
+	for (j = 0; j < height; j++){
+		sy = y + j * step;
+		blockHeight = sy + step <= file->height ? step : file->height - sy;
+		if (sums)
+			memset(sums, 0, (size_t)width * 3 * sizeof(unsigned long long));
+
+		for (r = 0; r < blockHeight; r++){
+			fileRow = file->bottomUp ? firstRow + numRows - 1 - (sy + r) : sy + r - firstRow; /* In file order within the band */
+			row = band + (size_t)fileRow * file->stride;
+
+			for (i = 0; i < width; i++){
+				sx = x + i * step;
+				if (step == 1){
+					pixel = row + (size_t)sx * file->bytesPerPixel;
+					pixels[j * width + i] = (pixel[2] << 16) | (pixel[1] << 8) | pixel[0];
+					continue;
+				}
+
+				blockWidth = sx + step <= file->width ? step : file->width - sx;
+				for (c = 0, pixel = row + (size_t)sx * file->bytesPerPixel; c < blockWidth; c++, pixel += file->bytesPerPixel){
+					sums[i * 3] += pixel[0];
+					sums[i * 3 + 1] += pixel[1];
+					sums[i * 3 + 2] += pixel[2];
+				}
+			}
+		}
+
+		if (sums)
+			for (i = 0; i < width; i++){
+				sx = x + i * step;
+				count = blockHeight * (sx + step <= file->width ? step : file->width - sx);
+				pixels[j * width + i] = (DWORD)(((sums[i * 3 + 2] / count) << 16) | ((sums[i * 3 + 1] / count) << 8) |
+												(sums[i * 3] / count));
+			}
+	}
+
+	free(sums);
+	UnmapViewOfFile(view);
+	return TRUE;
+}
+
+/* Closes an ImageView's bitmap file */
+PRIVATE void closeBitmapFile(ImageView imageview){
+	if (!imageview->bitmapFile)
+		return;
+
+	CloseHandle(imageview->bitmapFile->mapping);
+	CloseHandle(imageview->bitmapFile->file);
+	free(imageview->bitmapFile);
+	imageview->bitmapFile = NULL;
+}
+
+/* Decodes a tile on a thread pool thread, then has the ImageView repaint. The repaint requests of tiles finishing together are
+   merged */
+static DWORD WINAPI loadTileProc(LPVOID param){
+	struct _imageTile *tile = (struct _imageTile*)param;
+	ImageView imageview = tile->owner;
+	unsigned int step = 1 << tile->level;
+
+	InterlockedExchange(&(tile->state), imageview->readPixels(imageview->readContext, tile->column * IMAGEVIEW_TILE_SIZE * step,
+											tile->row * IMAGEVIEW_TILE_SIZE * step, tile->width, tile->height, step, tile->pixels) ?
+											TILE_READY : TILE_FAILED);
+
+	if (imageview->handle && !InterlockedExchange(&(imageview->updatePending), TRUE))
+		postInternalMessage(imageview->handle, TILES_LOADED);
+	InterlockedDecrement(&(imageview->numLoading));
+
+	return 0;
+}
+
+/* Waits until an ImageView's tiles are decoded, before its cache or pixel source are changed */
+PRIVATE void waitForTiles(ImageView imageview){
+	while (imageview->numLoading > 0)
+		Sleep(1);
+}
+
+PRIVATE unsigned int getTileBucket(unsigned int level, unsigned int column, unsigned int row){
+	return ((level * 73856093u) ^ (column * 19349663u) ^ (row * 83492791u)) % IMAGEVIEW_HASH_SIZE;
+}
+
+/* Removes a tile from the recently used list */
+PRIVATE void unlinkTile(ImageView imageview, struct _imageTile *tile){
+	if (tile->prevUsed)
+		tile->prevUsed->nextUsed = tile->nextUsed;
+	else
+		imageview->firstUsed = tile->nextUsed;
+	if (tile->nextUsed)
+		tile->nextUsed->prevUsed = tile->prevUsed;
+	else
+		imageview->lastUsed = tile->prevUsed;
+}
+
+/* Puts a tile at the front of the recently used list */
+PRIVATE void linkTile(ImageView imageview, struct _imageTile *tile){
+	tile->prevUsed = NULL;
+	tile->nextUsed = imageview->firstUsed;
+	if (imageview->firstUsed)
+		imageview->firstUsed->prevUsed = tile;
+	else
+		imageview->lastUsed = tile;
+	imageview->firstUsed = tile;
+}
+
+/* Drops a tile that isn't being decoded from the cache */
+PRIVATE void dropTile(ImageView imageview, struct _imageTile *tile){
+	struct _imageTile **currLink = imageview->tiles + getTileBucket(tile->level, tile->column, tile->row);
+
+	while (*currLink != tile)
+		currLink = &((*currLink)->nextInBucket);
+	*currLink = tile->nextInBucket;
+
+	unlinkTile(imageview, tile);
+	imageview->cacheSize -= (size_t)tile->width * tile->height * sizeof(DWORD);
+	free(tile->pixels);
+	free(tile);
+}
+
+/* Drops the least recently used tiles until the cache fits its budget. Tiles being decoded or drawn by the current paint stay */
+PRIVATE void trimTiles(ImageView imageview){
+	struct _imageTile *currTile = imageview->lastUsed, *prevTile;
+
+	while (currTile && imageview->cacheSize > imageview->cacheBudget){
+		prevTile = currTile->prevUsed;
+		if (currTile->state != TILE_LOADING && currTile->lastPaint != imageview->paintClock)
+			dropTile(imageview, currTile);
+		currTile = prevTile;
+	}
+}
+
+/* Drops all the tiles of an ImageView */
+PRIVATE void clearTiles(ImageView imageview){
+	waitForTiles(imageview);
+	while (imageview->firstUsed)
+		dropTile(imageview, imageview->firstUsed);
+}
+
+/* Gets a tile from an ImageView's cache. A missing tile is queued for decoding if load is TRUE and not too many tiles are being
+   decoded already, otherwise NULL is returned */
+PRIVATE struct _imageTile *getTile(ImageView imageview, unsigned int level, unsigned int column, unsigned int row, BOOL load){
+	struct _imageTile *tile;
+	unsigned int bucket = getTileBucket(level, column, row), step = 1 << level;
+
+	if (!imageview->tiles)
+		return NULL;
+
+	for (tile = (imageview->tiles)[bucket]; tile; tile = tile->nextInBucket)
+		if (tile->level == level && tile->column == column && tile->row == row){
+			unlinkTile(imageview, tile);
+			linkTile(imageview, tile);
+			return tile;
+		}
+
+	if (!load || !imageview->readPixels || imageview->numLoading >= IMAGEVIEW_MAX_LOADING)
+		return NULL;
+
+	tile = (struct _imageTile*)calloc(1, sizeof(struct _imageTile));
+	if (!tile)
+		return NULL;
+	tile->level = level;
+	tile->column = column;
+	tile->row = row;
+	tile->width = (imageview->imageWidth - column * IMAGEVIEW_TILE_SIZE * step + step - 1) / step;
+	if (tile->width > IMAGEVIEW_TILE_SIZE)
+		tile->width = IMAGEVIEW_TILE_SIZE;
+	tile->height = (imageview->imageHeight - row * IMAGEVIEW_TILE_SIZE * step + step - 1) / step;
+	if (tile->height > IMAGEVIEW_TILE_SIZE)
+		tile->height = IMAGEVIEW_TILE_SIZE;
+	tile->pixels = (DWORD*)malloc((size_t)tile->width * tile->height * sizeof(DWORD));
+	if (!tile->pixels){
+		free(tile);
+		return NULL;
+	}
+	tile->owner = imageview;
+	tile->state = TILE_LOADING;
+
+	tile->nextInBucket = (imageview->tiles)[bucket];
+	(imageview->tiles)[bucket] = tile;
+	linkTile(imageview, tile);
+	imageview->cacheSize += (size_t)tile->width * tile->height * sizeof(DWORD);
+
+	InterlockedIncrement(&(imageview->numLoading));
+	if (!QueueUserWorkItem(loadTileProc, (LPVOID)tile, WT_EXECUTEDEFAULT)){
+		InterlockedDecrement(&(imageview->numLoading));
+		tile->state = TILE_FAILED;
+	}
+
+	trimTiles(imageview);
+	return tile;
+}
+
+/* Gets the mip level an ImageView is drawn from at its zoom, the finest one that isn't shrunk by more than half */
+PRIVATE unsigned int getImageLevel(ImageView imageview){
+	unsigned int level = 0;
+
+	while (level + 1 < imageview->numLevels && imageview->zoom * (float)(1 << (level + 1)) <= 1.0f)
+		level++;
+
+	return level;
+}
+
+/* Draws a tile of an ImageView stretched to its place, clipped to a rectangle */
+PRIVATE void drawTile(ImageView imageview, HDC dc, struct _imageTile *tile, const RECT *clipRect){
+	BITMAPINFO bitmapInfo;
+	float tileSpan = (float)(IMAGEVIEW_TILE_SIZE << tile->level) * imageview->zoom, scale = (float)(1 << tile->level) * imageview->zoom;
+	int left = (int)(tile->column * tileSpan) - imageview->scrollX, top = (int)(tile->row * tileSpan) - imageview->scrollY;
+	int right = (int)(tile->column * tileSpan + tile->width * scale) - imageview->scrollX;
+	int bottom = (int)(tile->row * tileSpan + tile->height * scale) - imageview->scrollY;
+
+	memset(&bitmapInfo, 0, sizeof(BITMAPINFO));
+	bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bitmapInfo.bmiHeader.biWidth = tile->width;
+	bitmapInfo.bmiHeader.biHeight = -(LONG)tile->height; /* Top-down */
+	bitmapInfo.bmiHeader.biPlanes = 1;
+	bitmapInfo.bmiHeader.biBitCount = 32;
+	bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+	SaveDC(dc);
+	IntersectClipRect(dc, clipRect->left, clipRect->top, clipRect->right, clipRect->bottom);
+	StretchDIBits(dc, left, top, right - left, bottom - top, 0, 0, tile->width, tile->height, tile->pixels, &bitmapInfo,
+					DIB_RGB_COLORS, SRCCOPY);
+	RestoreDC(dc, -1);
+}
+
+/* Draws the tiles of an ImageView that intersect a rectangle of its client area. Tiles that aren't decoded yet are queued and
+   drawn from the finest coarser level that is, so panning and zooming never wait for the decoder */
+PRIVATE void drawImageTiles(ImageView imageview, HDC dc, const RECT *rect){
+	struct _imageTile *tile;
+	RECT tileRect;
+	unsigned int level = getImageLevel(imageview), coarserLevel, column, row, firstColumn, lastColumn, firstRow, lastRow;
+	float tileSpan;
+
+	imageview->paintClock++;
+	FillRect(dc, rect, GetSysColorBrush(COLOR_APPWORKSPACE));
+	if (!imageview->imageWidth || !imageview->imageHeight)
+		return;
+
+	tileSpan = (float)(IMAGEVIEW_TILE_SIZE << level) * imageview->zoom;
+	firstColumn = (rect->left + imageview->scrollX > 0) ? (unsigned int)((rect->left + imageview->scrollX) / tileSpan) : 0;
+	firstRow = (rect->top + imageview->scrollY > 0) ? (unsigned int)((rect->top + imageview->scrollY) / tileSpan) : 0;
+	if (rect->right + imageview->scrollX <= 0 || rect->bottom + imageview->scrollY <= 0)
+		return;
+	lastColumn = (unsigned int)((rect->right + imageview->scrollX - 1) / tileSpan);
+	lastRow = (unsigned int)((rect->bottom + imageview->scrollY - 1) / tileSpan);
+	if (lastColumn > (imageview->imageWidth - 1) / (IMAGEVIEW_TILE_SIZE << level))
+		lastColumn = (imageview->imageWidth - 1) / (IMAGEVIEW_TILE_SIZE << level);
+	if (lastRow > (imageview->imageHeight - 1) / (IMAGEVIEW_TILE_SIZE << level))
+		lastRow = (imageview->imageHeight - 1) / (IMAGEVIEW_TILE_SIZE << level);
+
+	for (row = firstRow; row <= lastRow; row++)
+		for (column = firstColumn; column <= lastColumn; column++){
+			SetRect(&tileRect, (int)(column * tileSpan) - imageview->scrollX, (int)(row * tileSpan) - imageview->scrollY,
+					(int)((column + 1) * tileSpan) - imageview->scrollX, (int)((row + 1) * tileSpan) - imageview->scrollY);
+			IntersectRect(&tileRect, &tileRect, rect);
+
+			tile = getTile(imageview, level, column, row, TRUE);
+			for (coarserLevel = level + 1; (!tile || tile->state != TILE_READY) && coarserLevel < imageview->numLevels; coarserLevel++)
+				tile = getTile(imageview, coarserLevel, column >> (coarserLevel - level), row >> (coarserLevel - level), FALSE);
+
+			if (tile && tile->state == TILE_READY){
+				tile->lastPaint = imageview->paintClock;
+				drawTile(imageview, dc, tile, &tileRect);
+			}
+		}
+}
+
+/* Keeps an ImageView's viewport over its image */
+PRIVATE void clampImageScroll(ImageView imageview, int *scrollX, int *scrollY){
+	int width, height, maxX, maxY;
+
+	getImageViewSize(imageview, &width, &height);
+	maxX = (int)(imageview->imageWidth * imageview->zoom) - width;
+	maxY = (int)(imageview->imageHeight * imageview->zoom) - height;
+
+	*scrollX = (*scrollX > maxX) ? maxX : *scrollX;
+	*scrollX = (*scrollX < 0) ? 0 : *scrollX;
+	*scrollY = (*scrollY > maxY) ? maxY : *scrollY;
+	*scrollY = (*scrollY < 0) ? 0 : *scrollY;
+}
+
+/* Redraws a whole ImageView */
+PRIVATE BOOL invalidateImageView(ImageView imageview){
+	return imageview->handle ? InvalidateRect(imageview->handle, NULL, FALSE) : TRUE;
+}
+
+
+
+/* The methods */
+/* Opens an uncompressed 24 or 32 bits per pixel bitmap file for an ImageView. The file is memory-mapped and its tiles are read
+   from it as they are shown, so it can be much larger than the memory available */
+BOOL ImageView_openBitmapFile(ImageView imageview, char *path){
+	BITMAPFILEHEADER fileHeader;
+	BITMAPINFOHEADER infoHeader;
+	SYSTEM_INFO systemInfo;
+	LARGE_INTEGER fileSize;
+	struct _bitmapFile *file;
+	DWORD bytesRead;
+
+	file = (struct _bitmapFile*)calloc(1, sizeof(struct _bitmapFile));
+	if (!file)
+		return FALSE;
+
+	file->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file->file == INVALID_HANDLE_VALUE)
+		goto open_failed;
+
+	/* Check the headers */
+	if (!ReadFile(file->file, &fileHeader, sizeof(BITMAPFILEHEADER), &bytesRead, NULL) || bytesRead != sizeof(BITMAPFILEHEADER) ||
+			!ReadFile(file->file, &infoHeader, sizeof(BITMAPINFOHEADER), &bytesRead, NULL) || bytesRead != sizeof(BITMAPINFOHEADER))
+		goto read_failed;
+	if (fileHeader.bfType != 0x4D42 || infoHeader.biWidth <= 0 || infoHeader.biHeight == 0 ||
+			(infoHeader.biBitCount != 24 && infoHeader.biBitCount != 32) ||
+			(infoHeader.biCompression != BI_RGB && (infoHeader.biCompression != BI_BITFIELDS || infoHeader.biBitCount != 32)))
+		goto read_failed;
+
+	file->width = (unsigned int)infoHeader.biWidth;
+	file->bottomUp = infoHeader.biHeight > 0;
+	file->height = (unsigned int)(file->bottomUp ? infoHeader.biHeight : -infoHeader.biHeight);
+	file->bytesPerPixel = infoHeader.biBitCount / 8;
+	file->stride = ((file->width * infoHeader.biBitCount + 31) / 32) * 4;
+	file->dataOffset = fileHeader.bfOffBits;
+	if (!GetFileSizeEx(file->file, &fileSize) ||
+			(unsigned long long)fileSize.QuadPart < file->dataOffset + (unsigned long long)file->stride * file->height)
+		goto read_failed;
+
+	GetSystemInfo(&systemInfo);
+	file->granularity = systemInfo.dwAllocationGranularity;
+
+	file->mapping = CreateFileMappingA(file->file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!file->mapping)
+		goto read_failed;
+
+	if (!ImageView_setImageSource(imageview, file->width, file->height, readBitmapFile, (void*)file)){
+		CloseHandle(file->mapping);
+		goto read_failed;
+	}
+	imageview->bitmapFile = file;
+	return TRUE;
+
+	read_failed: CloseHandle(file->file);
+	open_failed: free(file);
+	return FALSE;
+}
+
+/* Sets the pixel source of an ImageView, and shows the image from its top left corner at full size */
+BOOL ImageView_setImageSource(ImageView imageview, unsigned int width, unsigned int height, ImageReadFunc readPixels, void *context){
+	unsigned int span = IMAGEVIEW_TILE_SIZE;
+
+	clearTiles(imageview);
+	closeBitmapFile(imageview);
+
+	if (!imageview->tiles){
+		imageview->tiles = (struct _imageTile**)calloc(IMAGEVIEW_HASH_SIZE, sizeof(struct _imageTile*));
+		if (!imageview->tiles)
+			return FALSE;
+	}
+
+	imageview->readPixels = readPixels;
+	imageview->readContext = context;
+	imageview->imageWidth = readPixels ? width : 0;
+	imageview->imageHeight = readPixels ? height : 0;
+
+	/* Levels are added until one fits in a single tile */
+	for (imageview->numLevels = 1; span < imageview->imageWidth || span < imageview->imageHeight; imageview->numLevels++)
+		span *= 2;
+
+	imageview->zoom = 1;
+	imageview->scrollX = 0;
+	imageview->scrollY = 0;
+
+	return invalidateImageView(imageview);
+}
+
+/* Sets the zoom of an ImageView, keeping the image point under the client area point x, y in place */
+BOOL ImageView_setZoom(ImageView imageview, float zoom, int x, int y){
+	float minZoom = 1.0f / (float)(1 << imageview->numLevels);
+	int scrollX, scrollY;
+
+	if (zoom < minZoom)
+		zoom = minZoom;
+	if (zoom > 64)
+		zoom = 64;
+
+	scrollX = (int)((imageview->scrollX + x) / imageview->zoom * zoom) - x;
+	scrollY = (int)((imageview->scrollY + y) / imageview->zoom * zoom) - y;
+	imageview->zoom = zoom;
+	clampImageScroll(imageview, &scrollX, &scrollY);
+	imageview->scrollX = scrollX;
+	imageview->scrollY = scrollY;
+
+	return invalidateImageView(imageview);
+}
+
+/* Moves an ImageView's viewport to a position in the zoomed image. The window's pixels are scrolled, so only the newly shown strips
+   are painted */
+BOOL ImageView_panTo(ImageView imageview, int scrollX, int scrollY){
+	int width, height, deltaX, deltaY;
+
+	clampImageScroll(imageview, &scrollX, &scrollY);
+	deltaX = imageview->scrollX - scrollX;
+	deltaY = imageview->scrollY - scrollY;
+	imageview->scrollX = scrollX;
+	imageview->scrollY = scrollY;
+
+	if (!imageview->handle || (!deltaX && !deltaY))
+		return TRUE;
+
+	/* A pending update region wouldn't be scrolled along with the pixels */
+	getImageViewSize(imageview, &width, &height);
+	if (abs(deltaX) >= width || abs(deltaY) >= height || GetUpdateRect(imageview->handle, NULL, FALSE))
+		return invalidateImageView(imageview);
+
+	ScrollWindowEx(imageview->handle, deltaX, deltaY, NULL, NULL, NULL, NULL, SW_INVALIDATE);
+	return TRUE;
+}
+
+/* Sets the memory an ImageView's tile cache may use, bytes */
+BOOL ImageView_setCacheBudget(ImageView imageview, size_t cacheBudget){
+	imageview->cacheBudget = cacheBudget;
+	trimTiles(imageview);
+
+	return TRUE;
+}
+
+
+
+/* The Constructors*/
+void initImageView(ImageView thisObject, HINSTANCE instance, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_ImageView;
+
+	setControlFields((Control)thisObject, instance, NULL, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = IMAGEVIEW;
+	thisObject->className = "Static";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | SS_NOTIFY;
+	thisObject->customEraseBG = TRUE; /* The ImageView paints its whole background */
+}
+
+ImageView newImageView(HINSTANCE instance, int x, int y, int width, int height){
+	ImageView thisObject = (ImageView)allocObjectMemory(currentArena, sizeof(val_ImageView));
+
+	if (!thisObject)
+		return NULL;
+
+	initImageView(thisObject, instance, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteImageView(ImageView imageview){
+	/* The tiles being decoded refer to the ImageView */
+	clearTiles(imageview);
+	free(imageview->tiles);
+	closeBitmapFile(imageview);
+
+	imageview->className = NULL;
+	freeGUIObjectFields((GUIObject)imageview);
+	releaseGUIObject((GUIObject)imageview);
+}
+
+
+
+
+
+/* Class TreeView */
+/* The flags of a TreeView's nodes */
+#define TREENODE_HAS_CHILDREN 0x1 /* The node may have children, it has an expand box */
+#define TREENODE_EXPANDED 0x2
+#define TREENODE_LOADED 0x4 /* The node's children were fetched */
+#define TREENODE_LOADING 0x8 /* The node's children are being fetched */
+
+/* Gets the number of rows that fit in a TreeView's viewport */
+PRIVATE unsigned int getTreeViewRows(TreeView treeview){
+	RECT clientRect;
+	int height = treeview->height;
+
+	if (treeview->handle && GetClientRect(treeview->handle, &clientRect))
+		height = clientRect.bottom - clientRect.top;
+
+	return height > treeview->nodeHeight ? (unsigned int)(height / treeview->nodeHeight) : 1;
+}
+
+/* Gets the number of rows of a TreeView, the nodes shown under its expanded nodes */
+PRIVATE unsigned int getTreeRowCount(TreeView treeview){
+	return treeview->nodes ? (treeview->nodes)[TREEVIEW_ROOT].numVisible : 0;
+}
+
+/* Gets the node shown in the row after a node's, or TREEVIEW_NO_NODE after the last row */
+PRIVATE unsigned int getNextTreeRow(TreeView treeview, unsigned int node){
+	struct _treeNode *nodes = treeview->nodes;
+	unsigned int parent;
+
+	if ((nodes[node].flags & TREENODE_EXPANDED) && nodes[node].numChildren)
+		return nodes[node].firstChild;
+
+	for (; node != TREEVIEW_ROOT; node = parent){
+		parent = nodes[node].parent;
+		if (node + 1 < nodes[parent].firstChild + nodes[parent].numChildren)
+			return node + 1;
+	}
+
+	return TREEVIEW_NO_NODE;
+}
+
+/* Gets the node shown in the row before a node's, or TREEVIEW_NO_NODE before the first row */
+PRIVATE unsigned int getPrevTreeRow(TreeView treeview, unsigned int node){
+	struct _treeNode *nodes = treeview->nodes;
+	unsigned int parent = nodes[node].parent;
+
+	if (node == nodes[parent].firstChild)
+		return parent != TREEVIEW_ROOT ? parent : TREEVIEW_NO_NODE;
+
+	/* The last row of the previous sibling's subtree */
+	for (node--; (nodes[node].flags & TREENODE_EXPANDED) && nodes[node].numChildren; )
+		node = nodes[node].firstChild + nodes[node].numChildren - 1;
+
+	return node;
+}
+
+/* Finds the node shown in a row by descending from the root, skipping the subtrees of the siblings before it whole. Children that
+   show no rows below them are indexed directly */
+PRIVATE unsigned int findTreeRow(TreeView treeview, unsigned int row){
+	struct _treeNode *nodes = treeview->nodes;
+	unsigned int node = TREEVIEW_ROOT, child, rows;
+
+	if (row >= getTreeRowCount(treeview))
+		return TREEVIEW_NO_NODE;
+
+	for (;;){
+		if (nodes[node].numVisible == nodes[node].numChildren)
+			return nodes[node].firstChild + row;
+
+		for (child = nodes[node].firstChild; ; child++){
+			if (!row)
+				return child;
+			row--;
+
+			rows = (nodes[child].flags & TREENODE_EXPANDED) ? nodes[child].numVisible : 0;
+			if (row < rows)
+				break;
+			row -= rows;
+		}
+		node = child;
+	}
+}
+
+/* Gets the row of a node, which has to be shown */
+PRIVATE unsigned int getTreeNodeRow(TreeView treeview, unsigned int node){
+	struct _treeNode *nodes = treeview->nodes;
+	unsigned int row = nodes[node].depth - 1, parent, sibling;
+
+	for (; node != TREEVIEW_ROOT; node = parent){
+		parent = nodes[node].parent;
+		if (nodes[parent].numVisible == nodes[parent].numChildren)
+			row += node - nodes[parent].firstChild;
+		else
+			for (sibling = nodes[parent].firstChild; sibling < node; sibling++)
+				row += 1 + ((nodes[sibling].flags & TREENODE_EXPANDED) ? nodes[sibling].numVisible : 0);
+	}
+
+	return row;
+}
+
+/* Adds rows below a node, and below those of its ancestors it is shown under */
+PRIVATE void addTreeRows(TreeView treeview, unsigned int node, int numRows){
+	struct _treeNode *nodes = treeview->nodes;
+
+	for (;;){
+		nodes[node].numVisible += numRows;
+		if (node == TREEVIEW_ROOT || !(nodes[node].flags & TREENODE_EXPANDED))
+			break;
+		node = nodes[node].parent;
+	}
+}
+
+/* Moves the top of a TreeView's viewport to a row. Short scrolls step from the current top node, long ones search from the root */
+PRIVATE void setTreeTop(TreeView treeview, unsigned int row){
+	unsigned int distance;
+
+	if (!getTreeRowCount(treeview)){
+		treeview->topRow = 0;
+		treeview->topNode = TREEVIEW_NO_NODE;
+		return;
+	}
+
+	distance = row > treeview->topRow ? row - treeview->topRow : treeview->topRow - row;
+	if (treeview->topNode == TREEVIEW_NO_NODE || distance > 4 * getTreeViewRows(treeview)){
+		treeview->topNode = findTreeRow(treeview, row);
+		treeview->topRow = row;
+		return;
+	}
+
+	for (; treeview->topRow < row; treeview->topRow++)
+		treeview->topNode = getNextTreeRow(treeview, treeview->topNode);
+	for (; treeview->topRow > row; treeview->topRow--)
+		treeview->topNode = getPrevTreeRow(treeview, treeview->topNode);
+}
+
+/* Keeps a TreeView's top node in place after nodes were expanded or collapsed, or moves it up to the collapsed node it got hidden
+   under. Its row is counted anew, since the rows above it may have changed */
+PRIVATE void anchorTreeTop(TreeView treeview){
+	unsigned int node, shown;
+
+	if (treeview->topNode == TREEVIEW_NO_NODE)
+		return;
+
+	shown = treeview->topNode;
+	for (node = (treeview->nodes)[shown].parent; node != TREEVIEW_ROOT; node = (treeview->nodes)[node].parent)
+		if (!((treeview->nodes)[node].flags & TREENODE_EXPANDED))
+			shown = node;
+
+	treeview->topNode = shown;
+	treeview->topRow = getTreeNodeRow(treeview, shown);
+}
+
+/* Brings a TreeView's viewport and scroll bar up to date with its rows. When the rows shown before are still in place, the window
+   is scrolled and only the rows that scrolled in are repainted; prevTop is the top row of the viewport as last painted, repaint
+   forces a full repaint */
+PRIVATE void updateTreeView(TreeView treeview, unsigned int prevTop, BOOL repaint){
+	SCROLLINFO scrollInfo;
+	unsigned int numRows = getTreeViewRows(treeview), rowCount = getTreeRowCount(treeview);
+
+	if (treeview->topRow > (rowCount > numRows ? rowCount - numRows : 0))
+		setTreeTop(treeview, rowCount > numRows ? rowCount - numRows : 0);
+	else if (treeview->topNode == TREEVIEW_NO_NODE)
+		setTreeTop(treeview, treeview->topRow);
+
+	if (!treeview->handle)
+		return;
+
+	scrollInfo.cbSize = sizeof(SCROLLINFO);
+	scrollInfo.fMask = SIF_RANGE | SIF_PAGE | SIF_POS;
+	scrollInfo.nMin = 0;
+	scrollInfo.nMax = rowCount ? (int)rowCount - 1 : 0;
+	scrollInfo.nPage = numRows;
+	scrollInfo.nPos = (int)treeview->topRow;
+	SetScrollInfo(treeview->handle, SB_VERT, &scrollInfo, TRUE);
+
+	/* A pending update region wouldn't be scrolled along */
+	if (repaint || (treeview->topRow > prevTop ? treeview->topRow - prevTop : prevTop - treeview->topRow) >= numRows ||
+			GetUpdateRect(treeview->handle, NULL, FALSE))
+		InvalidateRect(treeview->handle, NULL, FALSE);
+	else if (treeview->topRow != prevTop)
+		ScrollWindowEx(treeview->handle, 0, ((int)prevTop - (int)treeview->topRow) * treeview->nodeHeight, NULL, NULL, NULL, NULL,
+						SW_INVALIDATE);
+}
+
+/* Fetches the children of a node on a thread pool thread, then has the TreeView add them. The update requests of fetches finishing
+   together are merged */
+static DWORD WINAPI fetchTreeChildrenProc(LPVOID param){
+	struct _treeFetch *fetch = (struct _treeFetch*)param;
+	TreeView treeview = fetch->owner;
+
+	fetch->succeeded = treeview->fetchChildren(treeview->dataContext, fetch->data, fetch);
+
+	startSync(treeview);
+	fetch->next = treeview->fetched;
+	treeview->fetched = fetch;
+	endSync(treeview);
+
+	if (treeview->handle && !InterlockedExchange(&(treeview->updatePending), TRUE))
+		postInternalMessage(treeview->handle, TREE_LOADED);
+	InterlockedDecrement(&(treeview->numLoading));
+
+	return 0;
+}
+
+/* Waits until a TreeView's fetches are done, before its nodes or data source are changed */
+PRIVATE void waitForTreeFetches(TreeView treeview){
+	while (treeview->numLoading > 0)
+		Sleep(1);
+}
+
+PRIVATE void deleteTreeFetch(struct _treeFetch *fetch){
+	free(fetch->children);
+	free(fetch->text);
+	free(fetch);
+}
+
+/* Starts fetching the children of a node */
+PRIVATE BOOL requestTreeChildren(TreeView treeview, unsigned int node){
+	struct _treeFetch *fetch;
+
+	if (!treeview->fetchChildren || ((treeview->nodes)[node].flags & (TREENODE_LOADED | TREENODE_LOADING)))
+		return TRUE;
+
+	fetch = (struct _treeFetch*)calloc(1, sizeof(struct _treeFetch));
+	if (!fetch)
+		return FALSE;
+	fetch->owner = treeview;
+	fetch->node = node;
+	fetch->data = (treeview->nodes)[node].data;
+
+	(treeview->nodes)[node].flags |= TREENODE_LOADING;
+	InterlockedIncrement(&(treeview->numLoading));
+	if (!QueueUserWorkItem(fetchTreeChildrenProc, (LPVOID)fetch, WT_EXECUTEDEFAULT)){
+		InterlockedDecrement(&(treeview->numLoading));
+		(treeview->nodes)[node].flags &= ~TREENODE_LOADING;
+		free(fetch);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Adds fetched children to their node. The nodes array only grows, so nodes keep their indices */
+PRIVATE BOOL addFetchedChildren(TreeView treeview, struct _treeFetch *fetch){
+	struct _treeNode *newNodes, *child, *node = treeview->nodes + fetch->node;
+	char **newTextBlocks;
+	unsigned int newCapacity, i;
+
+	node->flags &= ~TREENODE_LOADING;
+	if (!fetch->succeeded){
+		node->flags &= ~TREENODE_EXPANDED; /* It shows no rows yet, so nothing moves */
+		return FALSE;
+	}
+
+	if (treeview->numNodes + fetch->numChildren > treeview->nodesCapacity){
+		for (newCapacity = treeview->nodesCapacity; newCapacity < treeview->numNodes + fetch->numChildren; newCapacity *= 2);
+		newNodes = (struct _treeNode*)realloc(treeview->nodes, newCapacity * sizeof(struct _treeNode));
+		if (!newNodes)
+			return FALSE;
+		treeview->nodes = newNodes;
+		treeview->nodesCapacity = newCapacity;
+		node = treeview->nodes + fetch->node;
+	}
+	if (fetch->numChildren && treeview->numTextBlocks == treeview->textBlocksCapacity){
+		newCapacity = treeview->textBlocksCapacity ? treeview->textBlocksCapacity * 2 : 16;
+		newTextBlocks = (char**)realloc(treeview->textBlocks, newCapacity * sizeof(char*));
+		if (!newTextBlocks)
+			return FALSE;
+		treeview->textBlocks = newTextBlocks;
+		treeview->textBlocksCapacity = newCapacity;
+	}
+
+	node->firstChild = treeview->numNodes;
+	node->numChildren = fetch->numChildren;
+	node->flags |= TREENODE_LOADED;
+	if (!fetch->numChildren)
+		node->flags &= ~TREENODE_HAS_CHILDREN;
+
+	for (i = 0; i < fetch->numChildren; i++){
+		child = treeview->nodes + treeview->numNodes++;
+		child->text = fetch->text + (fetch->children)[i].textOffset;
+		child->data = (fetch->children)[i].data;
+		child->parent = fetch->node;
+		child->firstChild = 0;
+		child->numChildren = 0;
+		child->numVisible = 0;
+		child->depth = node->depth + 1;
+		child->flags = (fetch->children)[i].hasChildren ? TREENODE_HAS_CHILDREN : 0;
+	}
+
+	/* The texts now belong to the TreeView */
+	if (fetch->numChildren){
+		(treeview->textBlocks)[treeview->numTextBlocks++] = fetch->text;
+		fetch->text = NULL;
+	}
+
+	addTreeRows(treeview, fetch->node, (int)fetch->numChildren);
+	return TRUE;
+}
+
+/* Adds the children fetched for a TreeView since the last call, in the thread of its window */
+PRIVATE void addTreeFetches(TreeView treeview){
+	struct _treeFetch *fetch, *next;
+	unsigned int prevTop = treeview->topRow;
+
+	InterlockedExchange(&(treeview->updatePending), FALSE);
+
+	startSync(treeview);
+	fetch = treeview->fetched;
+	treeview->fetched = NULL;
+	endSync(treeview);
+
+	if (!fetch)
+		return;
+
+	for (; fetch; fetch = next){
+		next = fetch->next;
+		addFetchedChildren(treeview, fetch);
+		deleteTreeFetch(fetch);
+	}
+
+	anchorTreeTop(treeview);
+	updateTreeView(treeview, prevTop, TRUE);
+}
+
+/* Drops all of a TreeView's nodes */
+PRIVATE void clearTreeNodes(TreeView treeview){
+	struct _treeFetch *fetch, *next;
+	unsigned int i;
+
+	waitForTreeFetches(treeview);
+	for (fetch = treeview->fetched; fetch; fetch = next){
+		next = fetch->next;
+		deleteTreeFetch(fetch);
+	}
+	treeview->fetched = NULL;
+
+	for (i = 0; i < treeview->numTextBlocks; i++)
+		free((treeview->textBlocks)[i]);
+	free(treeview->textBlocks);
+	treeview->textBlocks = NULL;
+	treeview->numTextBlocks = 0;
+	treeview->textBlocksCapacity = 0;
+
+	free(treeview->nodes);
+	treeview->nodes = NULL;
+	treeview->numNodes = 0;
+	treeview->nodesCapacity = 0;
+
+	treeview->topRow = 0;
+	treeview->topNode = TREEVIEW_NO_NODE;
+	treeview->selectedNode = TREEVIEW_NO_NODE;
+}
+
+/* Adds a child to the children of a node being fetched, called by a TreeView's data source. The text is copied */
+BOOL addTreeChild(struct _treeFetch *fetch, const char *text, void *data, BOOL hasChildren){
+	struct _treeFetchChild *newChildren;
+	char *newText;
+	unsigned int newCapacity;
+	size_t length = text ? strlen(text) : 0, newTextCapacity;
+
+	if (!fetch || fetch->numChildren == TREEVIEW_NO_NODE - 1)
+		return FALSE;
+
+	if (fetch->numChildren == fetch->childrenCapacity){
+		newCapacity = fetch->childrenCapacity ? fetch->childrenCapacity * 2 : 64;
+		newChildren = (struct _treeFetchChild*)realloc(fetch->children, newCapacity * sizeof(struct _treeFetchChild));
+		if (!newChildren)
+			return FALSE;
+		fetch->children = newChildren;
+		fetch->childrenCapacity = newCapacity;
+	}
+
+	if (fetch->textLength + length + 1 > fetch->textCapacity){
+		for (newTextCapacity = fetch->textCapacity ? fetch->textCapacity : 1024; newTextCapacity < fetch->textLength + length + 1; )
+			newTextCapacity *= 2;
+		newText = (char*)realloc(fetch->text, newTextCapacity);
+		if (!newText)
+			return FALSE;
+		fetch->text = newText;
+		fetch->textCapacity = newTextCapacity;
+	}
+
+	if (length)
+		memcpy(fetch->text + fetch->textLength, text, length);
+	(fetch->text)[fetch->textLength + length] = '\0';
+
+	(fetch->children)[fetch->numChildren].textOffset = fetch->textLength;
+	(fetch->children)[fetch->numChildren].data = data;
+	(fetch->children)[fetch->numChildren].hasChildren = hasChildren;
+	fetch->numChildren++;
+	fetch->textLength += length + 1;
+
+	return TRUE;
+}
+
+
+
+/* The methods */
+/* Sets the data source of a TreeView. All the nodes are dropped, and the top level nodes are fetched */
+BOOL TreeView_setTreeSource(TreeView treeview, TreeFetchFunc fetchChildren, void *context){
+	if (!treeview)
+		return FALSE;
+
+	clearTreeNodes(treeview);
+	treeview->fetchChildren = fetchChildren;
+	treeview->dataContext = context;
+
+	treeview->nodes = (struct _treeNode*)malloc(64 * sizeof(struct _treeNode));
+	if (!treeview->nodes)
+		return FALSE;
+	treeview->nodesCapacity = 64;
+	treeview->numNodes = 1;
+	memset(treeview->nodes, 0, sizeof(struct _treeNode));
+	(treeview->nodes)[TREEVIEW_ROOT].parent = TREEVIEW_NO_NODE;
+	(treeview->nodes)[TREEVIEW_ROOT].flags = TREENODE_HAS_CHILDREN | TREENODE_EXPANDED;
+
+	updateTreeView(treeview, 0, TRUE);
+	return requestTreeChildren(treeview, TREEVIEW_ROOT);
+}
+
+/* Expands or collapses a node of a TreeView. The children of a node are fetched the first time it's expanded, they are shown when
+   they arrive */
+BOOL TreeView_expandNode(TreeView treeview, unsigned int node, BOOL expand){
+	struct _treeNode *currNode;
+	unsigned int prevTop = treeview->topRow;
+
+	if (node == TREEVIEW_ROOT || node >= treeview->numNodes)
+		return FALSE;
+
+	currNode = treeview->nodes + node;
+	if (!(currNode->flags & TREENODE_HAS_CHILDREN) || !expand == !(currNode->flags & TREENODE_EXPANDED))
+		return TRUE;
+
+	if (expand){
+		currNode->flags |= TREENODE_EXPANDED;
+		addTreeRows(treeview, currNode->parent, (int)currNode->numVisible);
+		if (!requestTreeChildren(treeview, node))
+			return FALSE;
+	} else {
+		addTreeRows(treeview, currNode->parent, -(int)currNode->numVisible);
+		currNode->flags &= ~TREENODE_EXPANDED;
+	}
+
+	anchorTreeTop(treeview);
+	updateTreeView(treeview, prevTop, TRUE);
+	return TRUE;
+}
+
+/* Scrolls a TreeView so that a row is at the top of its viewport */
+BOOL TreeView_scrollToRow(TreeView treeview, unsigned int row){
+	unsigned int prevTop = treeview->topRow, numRows = getTreeViewRows(treeview), rowCount = getTreeRowCount(treeview);
+
+	if (row > (rowCount > numRows ? rowCount - numRows : 0))
+		row = rowCount > numRows ? rowCount - numRows : 0;
+
+	setTreeTop(treeview, row);
+	updateTreeView(treeview, prevTop, FALSE);
+	return TRUE;
+}
+
+/* Sets the height of a TreeView's rows, pixels */
+BOOL TreeView_setNodeHeight(TreeView treeview, int nodeHeight){
+	if (nodeHeight <= 0)
+		return FALSE;
+
+	treeview->nodeHeight = nodeHeight;
+	updateTreeView(treeview, treeview->topRow, TRUE);
+	return TRUE;
+}
+
+/* Sets the callback called when a node of a TreeView is clicked */
+BOOL TreeView_setOnNodeClick(TreeView treeview, TreeNodeCallback callback, void *context){
+	if (!treeview)
+		return FALSE;
+
+	treeview->onNodeClick = callback;
+	treeview->nodeClickContext = context;
+	return TRUE;
+}
+
+/* Gets the text of a node of a TreeView */
+char *TreeView_getNodeText(TreeView treeview, unsigned int node){
+	if (node == TREEVIEW_ROOT || node >= treeview->numNodes)
+		return NULL;
+
+	return (treeview->nodes)[node].text;
+}
+
+/* Gets the data source's pointer for a node of a TreeView */
+void *TreeView_getNodeData(TreeView treeview, unsigned int node){
+	if (node >= treeview->numNodes)
+		return NULL;
+
+	return (treeview->nodes)[node].data;
+}
+
+
+
+/* The Constructors*/
+void initTreeView(TreeView thisObject, HINSTANCE instance, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_TreeView;
+
+	setControlFields((Control)thisObject, instance, NULL, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = TREEVIEW;
+	thisObject->className = "Static";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | WS_BORDER | WS_VSCROLL | SS_NOTIFY;
+	thisObject->customEraseBG = TRUE; /* The TreeView paints its whole background */
+}
+
+TreeView newTreeView(HINSTANCE instance, int x, int y, int width, int height){
+	TreeView thisObject = (TreeView)allocObjectMemory(currentArena, sizeof(val_TreeView));
+
+	if (!thisObject)
+		return NULL;
+
+	initTreeView(thisObject, instance, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteTreeView(TreeView treeview){
+	/* The fetches running refer to the TreeView */
+	clearTreeNodes(treeview);
+
+	treeview->className = NULL;
+	freeGUIObjectFields((GUIObject)treeview);
+	releaseGUIObject((GUIObject)treeview);
+}
+
+
+
+
+
+/* Class TabContainer */
+/* The methods */
+/* Adds a page to a TabContainer and returns it. The controls shown on the page are added to it as its children, they only get their
+   windows when the page is first shown. The first page added is shown */
+Control TabContainer_addPage(TabContainer tabcontainer, char *title){
+	struct _tabPage *newPages;
+	Arena prevArena;
+	Control page;
+	char *pageTitle;
+	size_t length = title ? strlen(title) : 0;
+
+	if (!tabcontainer)
+		return NULL;
+
+	newPages = (struct _tabPage*)realloc(tabcontainer->pages, (tabcontainer->numPages + 1) * sizeof(struct _tabPage));
+	if (!newPages)
+		return NULL;
+	tabcontainer->pages = newPages;
+
+	pageTitle = (char*)malloc(length + 1);
+	page = (Control)allocObjectMemory(tabcontainer->arena, sizeof(val_Control));
+	if (!pageTitle || !page){
+		free(pageTitle);
+		freeObjectMemory(tabcontainer->arena, page);
+		return NULL;
+	}
+	if (length)
+		memcpy(pageTitle, title, length);
+	pageTitle[length] = '\0';
+
+	/* The page is allocated with the TabContainer, whichever arena the thread uses meanwhile */
+	prevArena = useArena(tabcontainer->arena);
+	initControl(page, tabcontainer->moduleInstance, NULL, 0, tabcontainer->tabHeight, tabcontainer->width,
+				tabcontainer->height > tabcontainer->tabHeight ? tabcontainer->height - tabcontainer->tabHeight : 0);
+	useArena(prevArena);
+	page->className = "Static";
+	page->styles = WS_CHILD | WS_VISIBLE | WS_CLIPCHILDREN | SS_NOTIFY;
+	page->anchor = ANCHOR_LEFT | ANCHOR_RIGHT | ANCHOR_TOP | ANCHOR_BOTTOM;
+	GUIObject_addChild((GUIObject)tabcontainer, (GUIObject)page);
+
+	(tabcontainer->pages)[tabcontainer->numPages].control = page;
+	(tabcontainer->pages)[tabcontainer->numPages].title = pageTitle;
+	(tabcontainer->pages)[tabcontainer->numPages].hiddenSince = 0;
+	tabcontainer->numPages++;
+
+	if (tabcontainer->handle)
+		InvalidateRect(tabcontainer->handle, NULL, FALSE);
+	if (tabcontainer->activePage == TABCONTAINER_NO_PAGE)
+		TabContainer_selectPage(tabcontainer, tabcontainer->numPages - 1);
+
+	return page;
+}
+
+/* Shows a page of a TabContainer and hides the one shown before. The page gets its windows if it has none, because it's shown for
+   the first time or was hibernated */
+BOOL TabContainer_selectPage(TabContainer tabcontainer, unsigned int page){
+	unsigned int prevPage = tabcontainer->activePage;
+	Control prevControl;
+	BOOL result;
+
+	if (page >= tabcontainer->numPages)
+		return FALSE;
+	if (page == prevPage)
+		return TRUE;
+
+	tabcontainer->activePage = page;
+	if (!tabcontainer->handle)
+		return TRUE; /* The page is shown when the TabContainer is displayed */
+
+	if (prevPage != TABCONTAINER_NO_PAGE){
+		prevControl = (tabcontainer->pages)[prevPage].control;
+		if (prevControl->handle){
+			ShowWindow(prevControl->handle, SW_HIDE);
+			(tabcontainer->pages)[prevPage].hiddenSince = GetTickCount();
+		}
+	}
+
+	result = showTabPage(tabcontainer, page);
+	scheduleHibernation(tabcontainer);
+	InvalidateRect(tabcontainer->handle, NULL, FALSE);
+
+	return result;
+}
+
+/* Sets how long a TabContainer's pages stay hidden before their windows are released, ms. INFINITE keeps them */
+BOOL TabContainer_setHibernateDelay(TabContainer tabcontainer, DWORD hibernateDelay){
+	if (!tabcontainer)
+		return FALSE;
+
+	tabcontainer->hibernateDelay = hibernateDelay;
+	if (tabcontainer->handle)
+		scheduleHibernation(tabcontainer);
+
+	return TRUE;
+}
+
+
+
+/* The Constructors*/
+void initTabContainer(TabContainer thisObject, HINSTANCE instance, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_TabContainer;
+
+	setControlFields((Control)thisObject, instance, NULL, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = TABCONTAINER;
+	thisObject->className = "Static";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | WS_CLIPCHILDREN | SS_NOTIFY;
+	thisObject->customEraseBG = TRUE; /* The TabContainer paints its whole background */
+}
+
+TabContainer newTabContainer(HINSTANCE instance, int x, int y, int width, int height){
+	TabContainer thisObject = (TabContainer)allocObjectMemory(currentArena, sizeof(val_TabContainer));
+
+	if (!thisObject)
+		return NULL;
+
+	initTabContainer(thisObject, instance, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteTabContainer(TabContainer tabcontainer){
+	unsigned int i;
+
+	/* The pages belong to the TabContainer, the controls on them don't */
+	for (i = 0; i < tabcontainer->numPages; i++){
+		free((tabcontainer->pages)[i].title);
+		(tabcontainer->pages)[i].control->className = NULL;
+		deleteControl((tabcontainer->pages)[i].control);
+	}
+	free(tabcontainer->pages);
+
+	tabcontainer->className = NULL;
+	freeGUIObjectFields((GUIObject)tabcontainer);
+	releaseGUIObject((GUIObject)tabcontainer);
+}
+
+
+
+
+
+/* Class ScrollPanel */
+/* Sets up a ScrollPanel's scroll bars for its content, its client area and its scroll position */
+static void updateScrollPanel(ScrollPanel scrollpanel, int clientWidth, int clientHeight){
+	SCROLLINFO scrollInfo;
+
+	scrollInfo.cbSize = sizeof(SCROLLINFO);
+	scrollInfo.fMask = SIF_RANGE | SIF_PAGE | SIF_POS;
+	scrollInfo.nMin = 0;
+
+	scrollInfo.nMax = scrollpanel->contentWidth > 0 ? scrollpanel->contentWidth - 1 : 0;
+	scrollInfo.nPage = clientWidth > 0 ? clientWidth : 0;
+	scrollInfo.nPos = scrollpanel->scrollX;
+	SetScrollInfo(scrollpanel->handle, SB_HORZ, &scrollInfo, TRUE);
+
+	scrollInfo.nMax = scrollpanel->contentHeight > 0 ? scrollpanel->contentHeight - 1 : 0;
+	scrollInfo.nPage = clientHeight > 0 ? clientHeight : 0;
+	scrollInfo.nPos = scrollpanel->scrollY;
+	SetScrollInfo(scrollpanel->handle, SB_VERT, &scrollInfo, TRUE);
+}
+
+/* The methods */
+/* Sets the size of the area a ScrollPanel's children are placed in. The panel scrolls over it */
+BOOL ScrollPanel_setContentSize(ScrollPanel scrollpanel, int contentWidth, int contentHeight){
+	if (!scrollpanel || contentWidth < 0 || contentHeight < 0)
+		return FALSE;
+
+	scrollpanel->contentWidth = contentWidth;
+	scrollpanel->contentHeight = contentHeight;
+
+	return ScrollPanel_scrollContentTo(scrollpanel, scrollpanel->scrollX, scrollpanel->scrollY);
+}
+
+/* Scrolls a ScrollPanel so that a point of its content is at its top left corner. The panel's pixels and its children's windows are
+   moved in one go, only the strip scrolled into view is repainted */
+BOOL ScrollPanel_scrollContentTo(ScrollPanel scrollpanel, int x, int y){
+	RECT clientRect;
+	int dx, dy;
+
+	if (!scrollpanel)
+		return FALSE;
+
+	if (!scrollpanel->handle || !GetClientRect(scrollpanel->handle, &clientRect))
+		SetRect(&clientRect, 0, 0, scrollpanel->width, scrollpanel->height);
+
+	if (x > scrollpanel->contentWidth - clientRect.right)
+		x = scrollpanel->contentWidth - clientRect.right;
+	if (x < 0)
+		x = 0;
+	if (y > scrollpanel->contentHeight - clientRect.bottom)
+		y = scrollpanel->contentHeight - clientRect.bottom;
+	if (y < 0)
+		y = 0;
+
+	dx = x - scrollpanel->scrollX;
+	dy = y - scrollpanel->scrollY;
+	scrollpanel->scrollX = x;
+	scrollpanel->scrollY = y;
+
+	if (!scrollpanel->handle)
+		return TRUE; /* The children's windows are placed for the scroll position when they are created */
+
+	updateScrollPanel(scrollpanel, clientRect.right, clientRect.bottom);
+	if (dx || dy)
+		ScrollWindowEx(scrollpanel->handle, -dx, -dy, NULL, NULL, NULL, NULL, SW_INVALIDATE | SW_ERASE | SW_SCROLLCHILDREN);
+
+	return TRUE;
+}
+
+
+
+/* The Constructors*/
+void initScrollPanel(ScrollPanel thisObject, HINSTANCE instance, int x, int y, int width, int height){
+	if (!thisObject)
+		return;
+
+	CLASS_ScrollPanel;
+
+	setControlFields((Control)thisObject, instance, NULL, x, y, width, height);
+
+	/* Set the fields */
+	thisObject->type = SCROLLPANEL;
+	thisObject->className = "Static";
+	thisObject->styles = WS_CHILD | WS_VISIBLE | WS_CLIPCHILDREN | WS_HSCROLL | WS_VSCROLL | SS_NOTIFY;
+}
+
+ScrollPanel newScrollPanel(HINSTANCE instance, int x, int y, int width, int height){
+	ScrollPanel thisObject = (ScrollPanel)allocObjectMemory(currentArena, sizeof(val_ScrollPanel));
+
+	if (!thisObject)
+		return NULL;
+
+	initScrollPanel(thisObject, instance, x, y, width, height);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deleteScrollPanel(ScrollPanel scrollpanel){
+	scrollpanel->className = NULL;
+	freeGUIObjectFields((GUIObject)scrollpanel);
+	releaseGUIObject((GUIObject)scrollpanel);
+}
+
+
+
+
+
+/* Class EventArgs */
+/* Only the message fields change, the object keeps its lock if it has one */
+void EventArgs_updateValue(EventArgs thisObject, UINT message, WPARAM wParam, LPARAM lParam){
+	thisObject->message = message;
+	thisObject->wParam = wParam;
+	thisObject->lParam = lParam;
+}
+
+/* The vtable shared by all EventArgs */
+MAKE_VTABLE_INSTANCE(EventArgs, EventArgs);
+
+/* The Constructors*/
+void initEventArgs(EventArgs thisObject, UINT message, WPARAM wParam, LPARAM lParam){
+	if (!thisObject)
+		return;
+
+	CLASS_EventArgs;
+
+	thisObject->type = EVENTARGS;
+
+	thisObject->message = message;
+	thisObject->wParam = wParam;
+	thisObject->lParam = lParam;
 }
 
-PRIVATE void setGUIObjectFields(GUIObject thisObject, HINSTANCE instance, char *text, int width, int height){
-	static HMENU ID = NULL;
-	unsigned int IDLength, textLength;
-	
-	/* Set the fields */
+EventArgs newEventArgs(UINT message, WPARAM wParam, LPARAM lParam){
+	EventArgs thisObject = (EventArgs)malloc(sizeof(val_EventArgs));
 
-	thisObject->moduleInstance = instance;
+	if (!thisObject)
+		return NULL;
 
-	initObject((Object)thisObject);
+	initEventArgs(thisObject, message, wParam, lParam);
 
+	return thisObject;
+}
 
-	EnterCriticalSection(&(thisObject->criticalSection));
-	thisObject->ID = ID;
-	ID++;
-	LeaveCriticalSection(&(thisObject->criticalSection));
+/* The Destructor*/
+void deleteEventArgs(EventArgs eventargs){
+	deleteObjectLock((Object)eventargs);
+	free(eventargs);
+}
 
-	IDLength = getNumLength((unsigned int)(thisObject->ID));
-	thisObject->className = (char*)malloc(IDLength + 1);
-	if (!thisObject->className)
-		goto alloc_className_failed;
-	sprintf_s(thisObject->className, IDLength + 1, "%d", thisObject->ID);
 
-	thisObject->numEvents = 1;
-	thisObject->events = (struct _event*)malloc(thisObject->numEvents * sizeof(struct _event)); //TODO: add more events
-	if (!thisObject->events)
-		goto alloc_events_failed;
-	(thisObject->events)[0].eventFunction = NULL; (thisObject->events)[0].mode = SYNC; (thisObject->events)[0].message = WM_LBUTTONUP;
-	(thisObject->events)[0].sender = thisObject; (thisObject->events)[0].context = NULL;
-	(thisObject->events)[0].args = newEventArgs(WM_LBUTTONUP, 0, 0); (thisObject->events)[0].condition = NULL;
-	(thisObject->events)[0].interrupt = FALSE; (thisObject->events)[0].enabled = FALSE;
 
-	if (text){
-		textLength = strlen(text);
-		thisObject->text = (char*)malloc(textLength + 1);
-		if (!thisObject->text)
-			goto alloc_text_failed;
-		strcpy_s(thisObject->text, textLength + 1, text); /* Copy the object text to the heap */
-	} else
-		thisObject->text = NULL;
 
-	thisObject->width = width; thisObject->height = height;
-	thisObject->realWidth = width; thisObject->realHeight = height;
 
-	return;
+/* Class MouseEventArgs */
 
-	/* Cleanup in case of malloc failures. That's where goto's come in handy */
-	alloc_text_failed: free(thisObject->events);
-	alloc_events_failed: free(thisObject->className);
-	alloc_className_failed: DeleteCriticalSection(&(thisObject->criticalSection));
+void MouseEventArgs_updateValue(EventArgs thisObject, UINT message, WPARAM wParam, LPARAM lParam){
+	EventArgs_updateValue(thisObject, message, wParam, lParam);
+	((MouseEventArgs)thisObject)->cursorX = GET_X_LPARAM(lParam);
+	((MouseEventArgs)thisObject)->cursorY = GET_Y_LPARAM(lParam);
 }
 
-/* The Constructors*/
-void initGUIObject(GUIObject thisObject, HINSTANCE instance, char *text, int width, int height){
+/* The vtable shared by all MouseEventArgs */
+MAKE_VTABLE_INSTANCE(MouseEventArgs, EventArgs);
 
+/* The Constructors*/
+void initMouseEventArgs(MouseEventArgs thisObject, UINT message, WPARAM wParam, LPARAM lParam){
 	if (!thisObject)
 		return;
 
-	/* Initialize the fields to the default values */
-	CLASS_GUIObject;
+	initEventArgs((EventArgs)thisObject, message, wParam, lParam);
 
-	setGUIObjectFields(thisObject, instance, text, width, height);
-	
-	thisObject->type = GUIOBJECT;
+	thisObject->type = MOUSEEVENTARGS;
 
-	return;
+	thisObject->cursorX = GET_X_LPARAM(lParam);
+	thisObject->cursorY = GET_Y_LPARAM(lParam);
+
+	thisObject->vtable = &MouseEventArgs_vtable;
 }
 
-GUIObject newGUIObject(HINSTANCE instance, char *text, int width, int height){
-	GUIObject thisObject = (GUIObject)malloc(sizeof(val_GUIObject));
+MouseEventArgs newMouseEventArgs(UINT message, WPARAM wParam, LPARAM lParam){
+	MouseEventArgs thisObject = (MouseEventArgs)malloc(sizeof(val_MouseEventArgs));
 	if (!thisObject)
 		return NULL;
 
-	initGUIObject(thisObject, instance, text, width, height);
+	initMouseEventArgs(thisObject, message, wParam, lParam);
+
 	return thisObject;
 }
 
-void freeGUIObjectFields(GUIObject object){
-	unsigned int i;
-	EndPaint(object->handle, &(object->paintData));
-	if (!DestroyWindow(object->handle))
-		SendMessageA(object->handle, WM_CLOSE, (WPARAM)NULL, (WPARAM)NULL);
-	
-	DeleteCriticalSection(&(object->criticalSection));
+/* The Destructor*/
+void deleteMouseEventArgs(MouseEventArgs mouseeventargs){
+	deleteObjectLock((Object)mouseeventargs);
+	free(mouseeventargs);
+}
 
-	if (object->parent)
-		GUIObject_removeChild(object->parent, object);
 
-	free(object->className);
-	if (object->events){
-		for (i = 0; i < object->numEvents; i++)
-			if ((object->events)[i].args)
-				if ((object->events)[i].args->type == EVENTARGS)
-					deleteEventArgs((object->events)[i].args);
-				else if ((object->events)[i].args->type == MOUSEEVENTARGS)
-					deleteMouseEventArgs((MouseEventArgs)(object->events)[i].args);
-		free(object->events);
-	}
-	free(object->text);
-}
 
-/* The Destructor*/
-void deleteGUIObject(GUIObject object){
-	freeGUIObjectFields(object);
-	free(object);
-}
 
 
+/* Class Pen */
 
+/* The Constructors*/
+void initPen(Pen thisObject, int penStyle, int width, COLORREF color){
+	if (!thisObject)
+		return;
 
+	initObject((Object)thisObject);
 
-/* Class Window */
-/* The Methods*/
-/* Changes a window's resizable style */
-BOOL Window_setResizable(Window window, BOOL resizable){
-	if (!window)
-		return FALSE;
-	window->resizable = resizable;
-	window->styles = resizable ? (window->styles) | WS_THICKFRAME : (window->styles) ^ WS_THICKFRAME;
-		
-	if (window->handle)
-		return SetWindowLongPtrA(window->handle, GWL_STYLE, (LONG)(window->styles)) ? TRUE : FALSE;
-	else
-		return TRUE;
+	thisObject->type = PEN;
+
+	thisObject->penStyle = penStyle;
+	thisObject->width = width;
+	thisObject->color = color;
+
+	if (thisObject->handle)
+		DeleteObject(thisObject->handle);
+	thisObject->handle = CreatePen(penStyle, width, color);
 }
-	
-/* Enables or disables a window's maximize box */
-BOOL Window_enableMaximize(Window window, BOOL maximize){
-	if (!window)
-		return FALSE;
-	window->maximizeEnabled = maximize;
-	window->styles = maximize ? window->styles | WS_MAXIMIZEBOX : window->styles ^ WS_MAXIMIZEBOX;
-		
-	if (window->handle)
-		return SetWindowLongPtrA(window->handle, GWL_STYLE, (LONG)(window->styles)) ? TRUE : FALSE;
-	else
-		return TRUE;
+
+Pen newPen(int penStyle, int width, COLORREF color){
+	Pen thisObject = (Pen)malloc(sizeof(val_Pen));
+
+	if (!thisObject)
+		return NULL;
+
+	initPen(thisObject, penStyle, width, color);
+
+	return thisObject;
+}
+
+/* The Destructor*/
+void deletePen(Pen pen){
+	DeleteObject(pen->handle);
+	deleteObjectLock((Object)pen);
+	free(pen);
 }
 
 
+
+
+
+/* Class Brush */
+
 /* The Constructors*/
-void initWindow(Window thisObject, HINSTANCE instance, char *text, int width, int height){
+void initBrush(Brush thisObject, UINT brushStyle, COLORREF color, ULONG_PTR hatch){
+	LOGBRUSH brushInfo;
+
 	if (!thisObject)
 		return;
 
-	CLASS_Window;
+	initObject((Object)thisObject);
 
-	setGUIObjectFields((GUIObject)thisObject, instance, text, width, height);
+	thisObject->type = BRUSH;
 
-	/* Register the window class */
-    if (!registerClass(thisObject->moduleInstance, thisObject->className, (WNDPROC)windowProc))
-    	return;
+	thisObject->brushStyle = brushStyle; brushInfo.lbStyle = brushStyle;
+	thisObject->color = color; brushInfo.lbColor = color;
+	thisObject->hatch = hatch; brushInfo.lbHatch = hatch;
 
-	/* Set the fields */
-	thisObject->type = WINDOW;
-	thisObject->styles = WS_OVERLAPPEDWINDOW;
-	thisObject->exStyles = WS_EX_WINDOWEDGE;
+	if (thisObject->handle)
+		DeleteObject(thisObject->handle);
+
+	thisObject->handle = CreateBrushIndirect(&brushInfo);
 }
 
-Window newWindow(HINSTANCE instance, char *text, int width, int height){
-	Window thisObject = (Window)malloc(sizeof(val_Window));
+Brush newBrush(UINT brushStyle, COLORREF color, ULONG_PTR hatch){
+	Brush thisObject = (Brush)malloc(sizeof(val_Brush));
 
 	if (!thisObject)
 		return NULL;
 
-	initWindow(thisObject, instance, text, width, height);
+	initBrush(thisObject, brushStyle, color, hatch);
 
 	return thisObject;
 }
 
 /* The Destructor*/
-void deleteWindow(Window window){
-	freeGUIObjectFields((GUIObject)window);
-	free(window);
+void deleteBrush(Brush brush){
+	DeleteObject(brush->handle);
+	deleteObjectLock((Object)brush);
+	free(brush);
 }
 
 
 
 
 
-/* Class Control */
-/* The Methods*/
-/* Moves a GUIObject to a new location specified by x and y */
-/* Overrides setPosT in GUIObject */
-BOOL Control_setPos(GUIObject object, int x, int y){
-	if (!object)
-		return FALSE;
-	
-	object->realX = x;
-	object->realY = y;
-
-	if (x >= ((Control)object)->minX && x <= ((Control)object)->maxX)
-		object->x = x;
-	if (y >= ((Control)object)->minY && y <= ((Control)object)->maxY)
-		object->y = y;
+/* WinAPI Call Functions */
 
-	if (!SetWindowPos(object->handle, NULL, object->x, object->y, object->width, object->height, SWP_NOSIZE | SWP_ASYNCWINDOWPOS | 
-																					SWP_DRAWFRAME))
-		return FALSE;
+/* Event handling */
+/* An asynchronous event fired off to a worker thread. The worker gets a copy of the event args, so the UI thread can update the
+   event's own args for the next message without waiting for it */
+struct _asyncEvent {
+	void (*eventFunction)(GUIObject, void*, EventArgs);
+	GUIObject sender; /* Retained until the callback returns */
+	void *context;
+	EventArgs args; /* Points to the copy that follows the struct */
+};
+
+/* Ends an asynchronous event */
+static void finishAsyncEvent(struct _asyncEvent *asyncEvent){
+	deleteObjectLock((Object)(asyncEvent->args));
+	releaseGUIObject(asyncEvent->sender);
+	free(asyncEvent);
+}
 
-	if (!InvalidateRect(object->handle, NULL, FALSE))
-		return FALSE;
+/* The common asynchronous event callback function. The worker enters its epoch itself: when all the slots are taken it waits for one
+   to be freed, and the UI thread must not, since the workers holding them may be waiting on its message loop. The sender is retained,
+   so it stays readable until then, and it is released inside the epoch, so its memory is retired rather than freed by the worker */
+static DWORD WINAPI asyncEventProc(LPVOID event){
+	struct _asyncEvent *asyncEvent = (struct _asyncEvent*)event;
+	int epochSlot = enterObjectEpoch();
 
+	asyncEvent->eventFunction(asyncEvent->sender, asyncEvent->context, asyncEvent->args);
+	finishAsyncEvent(asyncEvent);
+	leaveObjectEpoch(epochSlot);
 	return TRUE;
 }
 
-/* Sets a control's minimum position to a new value specified by minX and minY */
-BOOL Control_setMinPos(Control object, int minX, int minY){
-	if (!object)
-		return FALSE;
-	
-	object->minX = minX;
-	object->minY = minY;
-	
-	if (minX > object->x){
-		object->x = minX;
-		object->realX = minX;
-	}
-	
-	if (minY > object->y){
-		object->y = minY;
-		object->realY = minY;
-	}
-	
-	if (!SetWindowPos(object->handle, NULL, object->x, object->y, object->width, object->height, SWP_NOMOVE | SWP_ASYNCWINDOWPOS |
-																					SWP_DRAWFRAME))
-		return FALSE;
-	
-	if (!InvalidateRect(object->handle, NULL, FALSE))
-		return FALSE;
-	
-	return TRUE;
+/* Fires off an event in a worker thread */
+static void fireAsyncEvent(struct _event *event){
+	struct _asyncEvent *asyncEvent;
+	size_t argsSize = event->args->type == MOUSEEVENTARGS ? sizeof(val_MouseEventArgs) : sizeof(val_EventArgs);
+	HANDLE thread;
+
+	asyncEvent = (struct _asyncEvent*)malloc(sizeof(struct _asyncEvent) + argsSize);
+	if (!asyncEvent)
+		return;
+
+	asyncEvent->eventFunction = event->eventFunction;
+	asyncEvent->sender = retainGUIObject(event->sender);
+	asyncEvent->context = event->context;
+	asyncEvent->args = (EventArgs)(asyncEvent + 1);
+	memcpy(asyncEvent->args, event->args, argsSize);
+	asyncEvent->args->lock = NULL; /* The copy gets a lock of its own */
+
+	thread = CreateThread(NULL, 0, asyncEventProc, (LPVOID)asyncEvent, 0, NULL);
+	if (thread)
+		CloseHandle(thread);
+	else
+		finishAsyncEvent(asyncEvent);
 }
 
-/* Sets a control's maximum position to a new value specified by maxX and maxY */
-BOOL Control_setMaxPos(Control object, int maxX, int maxY){
-	if (!object)
-		return FALSE;
-	
-	object->maxX = maxX;
-	object->maxY = maxY;
-	
-	if (maxX < object->x){
-		object->x = maxX;
-		object->realX = maxX;
+/* Find and fire off an event for a GUIObject */
+static int handleEvents(GUIObject currObject, UINT messageID, WPARAM wParam, LPARAM lParam){
+	unsigned int i;
+	BOOL condition = TRUE;
+	struct _event *event;
+
+	for (i = 0; i < currObject->numEvents; i++){
+		event = (currObject->events)[i];
+		if  (event->message == messageID && event->eventFunction != NULL){
+			if (event->condition)
+				condition = *(event->condition);
+
+			if (event->enabled && condition && event->eventFunction){
+				/* Only the UI thread touches the event's args, the workers get copies */
+				event->args->vtable->updateValue(event->args, messageID, wParam, lParam); /* Update the event args */
+
+				if (event->mode == SYNC)
+					(event->eventFunction)(event->sender, event->context, event->args);
+				else
+					fireAsyncEvent(event);
+			}
+
+			return (int)i;
+		}
 	}
+
+	return -1;
+}
+
+/* The event handling routine for WM_COMMAND type events for window controls */
+static int commandEventHandler(HWND hwnd, WPARAM wParam, LPARAM lParam){
+	UINT itemID = LOWORD(wParam), messageID = HIWORD(wParam);
+	GUIObject currObject = (GUIObject)GetWindowLongPtrA((HWND)lParam, GWLP_USERDATA);
 	
-	if (maxY < object->y){
-		object->y = maxY;
-		object->realY = maxY;
+	if (currObject){
+		if (messageID == EN_CHANGE && currObject->type == TEXTBOX) /* Text in a textbox was changed */
+			syncTextBox((TextBox)currObject);
+
+		return handleEvents(currObject, messageID, wParam, lParam);
+	} else
+		return -1;
+}
+
+/*FIELD VALUES CONSISTENCY SUPPORT ON REFRESH*/
+/* Gets the size a GUIObject's children are aligned to: the client area for windows, the size unaffected by min and max settings
+   for the rest */
+static void getLayoutSize(GUIObject object, int *layoutWidth, int *layoutHeight){
+	if (object->type == WINDOW){
+		*layoutWidth = ((Window)object)->clientWidth;
+		*layoutHeight = ((Window)object)->clientHeight;
+	} else {
+		*layoutWidth = object->realWidth;
+		*layoutHeight = object->realHeight;
 	}
-	
-	if (!SetWindowPos(object->handle, NULL, object->x, object->y, object->width, object->height, SWP_NOMOVE | SWP_ASYNCWINDOWPOS |
-																					SWP_DRAWFRAME))
-		return FALSE;
-	
-	if (!InvalidateRect(object->handle, NULL, FALSE))
-		return FALSE;
-	
-	return TRUE;
 }
 
-
-PRIVATE void setControlFields(Control thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height){
-	if (!thisObject)
+/* Copies a child's fields into a slot of a geometry table. Empty slots and children without anchors get neutral values that never
+   move or resize */
+static void gatherGeometry(struct _geometryTable *table, unsigned int slot, GUIObject child){
+	Control control = (child != NULL && isControl(child)) ? (Control)child : NULL;
+	const struct _limits *limits;
+
+	if (!control){
+		table->slotFlags[slot] = (child != NULL && child->numChildren) ? SLOT_HAS_CHILDREN : 0;
+		table->anchor[slot] = ANCHOR_LEFT | ANCHOR_TOP;
+		table->realX[slot] = table->realY[slot] = table->realWidth[slot] = table->realHeight[slot] = 0;
+		table->x[slot] = table->y[slot] = table->width[slot] = table->height[slot] = 0;
+		table->minX[slot] = table->minY[slot] = table->minWidth[slot] = table->minHeight[slot] = INT_MIN;
+		table->maxX[slot] = table->maxY[slot] = table->maxWidth[slot] = table->maxHeight[slot] = INT_MAX;
 		return;
+	}
 
-	setGUIObjectFields((GUIObject)thisObject, instance, text, width, height);
-
-	/* Set the fields */
-	thisObject->x = x; thisObject->realX = x;
-	thisObject->y = y; thisObject->realY = y;
-	thisObject->exStyles = WS_EX_WINDOWEDGE;
-
-	free(thisObject->className);
-	thisObject->className = NULL;
-
-	/* Override virtual methods */
-	thisObject->setPos = &Control_setPos;
+	table->slotFlags[slot] = SLOT_CONTROL | (control->numChildren ? SLOT_HAS_CHILDREN : 0);
+	table->anchor[slot] = control->anchor;
+	table->realX[slot] = control->realX; table->realY[slot] = control->realY;
+	table->realWidth[slot] = control->realWidth; table->realHeight[slot] = control->realHeight;
+	table->x[slot] = control->x; table->y[slot] = control->y;
+	table->width[slot] = control->width; table->height[slot] = control->height;
+	limits = getLimits(child);
+	table->minX[slot] = limits->minX; table->maxX[slot] = limits->maxX;
+	table->minY[slot] = limits->minY; table->maxY[slot] = limits->maxY;
+	table->minWidth[slot] = limits->minWidth; table->maxWidth[slot] = limits->maxWidth;
+	table->minHeight[slot] = limits->minHeight; table->maxHeight[slot] = limits->maxHeight;
 }
 
+/* Gathers the fields of a GUIObject's children into its geometry table, if they may have changed since it was last gathered */
+static void syncGeometryTable(GUIObject object, struct _geometryTable *table){
+	unsigned int i;
+	GUIObject currChild;
+	CRITICAL_SECTION *lock;
 
-/* The Constructors*/
-void initControl(Control thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height){
-	if (!thisObject)
+	if (!table->stale && table->numSlots == object->numChildren)
 		return;
 
-	CLASS_Control;
+	for (i = 0; i < object->numChildren; i++){
+		currChild = (object->children)[i];
+		if (currChild){
+			lock = enterExistingLock((Object)currChild);
+			gatherGeometry(table, i, currChild);
+			LeaveCriticalSection(lock);
+		} else
+			gatherGeometry(table, i, NULL);
+	}
+	for (; i % GEOMETRY_BLOCK; i++)
+		gatherGeometry(table, i, NULL);
 
-	setControlFields(thisObject, instance, text, x, y, width, height);
+	table->numSlots = object->numChildren;
+	table->stale = FALSE;
+}
 
-	thisObject->type = CONTROL;
+/* Resolves the anchors of a block of slots, starting at first, for a parent size change of widthChange and heightChange. The centered
+   children are moved by centerX and centerY. Children anchored on both sides of an orientation are stretched, the ones anchored only
+   right or bottom are moved with that border, the ones anchored on neither side stay centered. As with setPos and setSize, the x, y,
+   width and height values only follow the real ones while they stay within the min and max settings.
+   Returns a mask of the slots that changed in the low GEOMETRY_BLOCK bits, and of the ones that moved or got resized above them */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+/* Selects the lanes of a where mask is set and the lanes of b elsewhere */
+#define SELECT_EPI32(mask, a, b) _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b))
+/* Sets the lanes where the value is within [minValue, maxValue] */
+#define IN_RANGE_EPI32(value, minValue, maxValue) _mm_andnot_si128(_mm_or_si128(_mm_cmplt_epi32(value, minValue), \
+																		_mm_cmpgt_epi32(value, maxValue)), _mm_set1_epi32(-1))
+/* Sets the lanes where a and b differ */
+#define DIFFERENT_EPI32(a, b) _mm_andnot_si128(_mm_cmpeq_epi32(a, b), _mm_set1_epi32(-1))
+#define LOAD_EPI32(array, first) _mm_loadu_si128((const __m128i*)((array) + (first)))
+#define STORE_EPI32(array, first, value) _mm_storeu_si128((__m128i*)((array) + (first)), value)
+
+/* Applies a real value change to one of the arrays pairs (like realX and x), accumulating the lanes that changed */
+#define UPDATE_EPI32(table, first, realArray, array, minArray, maxArray, delta, touched, changed, moved) { \
+	__m128i realValue = LOAD_EPI32(table->realArray, first), value = LOAD_EPI32(table->array, first); \
+	__m128i newRealValue = _mm_add_epi32(realValue, delta); \
+	__m128i newValue = SELECT_EPI32(_mm_and_si128(touched, IN_RANGE_EPI32(newRealValue, LOAD_EPI32(table->minArray, first), \
+														LOAD_EPI32(table->maxArray, first))), newRealValue, value); \
+	changed = _mm_or_si128(changed, DIFFERENT_EPI32(newRealValue, realValue)); \
+	moved = _mm_or_si128(moved, DIFFERENT_EPI32(newValue, value)); \
+	STORE_EPI32(table->realArray, first, newRealValue); \
+	STORE_EPI32(table->array, first, newValue); \
 }
 
-Control newControl(HINSTANCE instance, char *text, int x, int y, int width, int height){
-	Control thisObject = (Control)malloc(sizeof(val_Control));
+static int resolveAnchorBlock(struct _geometryTable *table, unsigned int first, int widthChange, int heightChange,
+								int centerX, int centerY){
+	const __m128i zero = _mm_setzero_si128();
+	__m128i anchor = LOAD_EPI32(table->anchor, first);
+	__m128i notLeft = _mm_cmpeq_epi32(_mm_and_si128(anchor, _mm_set1_epi32(ANCHOR_LEFT)), zero);
+	__m128i notRight = _mm_cmpeq_epi32(_mm_and_si128(anchor, _mm_set1_epi32(ANCHOR_RIGHT)), zero);
+	__m128i notTop = _mm_cmpeq_epi32(_mm_and_si128(anchor, _mm_set1_epi32(ANCHOR_TOP)), zero);
+	__m128i notBottom = _mm_cmpeq_epi32(_mm_and_si128(anchor, _mm_set1_epi32(ANCHOR_BOTTOM)), zero);
+	__m128i stretchX = _mm_andnot_si128(_mm_or_si128(notLeft, notRight), _mm_set1_epi32(widthChange ? -1 : 0));
+	__m128i stretchY = _mm_andnot_si128(_mm_or_si128(notTop, notBottom), _mm_set1_epi32(heightChange ? -1 : 0));
+	__m128i resized = _mm_or_si128(stretchX, stretchY);
+	__m128i deltaX, deltaY, shifted, changed = zero, moved = zero;
+
+	deltaX = SELECT_EPI32(notLeft, SELECT_EPI32(notRight, _mm_set1_epi32(centerX), _mm_set1_epi32(widthChange)), zero);
+	deltaY = SELECT_EPI32(notTop, SELECT_EPI32(notBottom, _mm_set1_epi32(centerY), _mm_set1_epi32(heightChange)), zero);
+	shifted = DIFFERENT_EPI32(_mm_or_si128(deltaX, deltaY), zero);
+
+	/* Most children are usually anchored top left, skip the blocks where none are affected without touching the other arrays */
+	if (!_mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(resized, shifted))))
+		return 0;
 
-	if (!thisObject)
-		return NULL;
-	
-	initControl(thisObject, instance, text, width, x, y, height);
+	/* Sizes */
+	UPDATE_EPI32(table, first, realWidth, width, minWidth, maxWidth, _mm_and_si128(stretchX, _mm_set1_epi32(widthChange)),
+					resized, changed, moved);
+	UPDATE_EPI32(table, first, realHeight, height, minHeight, maxHeight, _mm_and_si128(stretchY, _mm_set1_epi32(heightChange)),
+					resized, changed, moved);
 
-	return thisObject;
+	/* Positions */
+	UPDATE_EPI32(table, first, realX, x, minX, maxX, deltaX, shifted, changed, moved);
+	UPDATE_EPI32(table, first, realY, y, minY, maxY, deltaY, shifted, changed, moved);
+
+	changed = _mm_or_si128(changed, moved);
+	return _mm_movemask_ps(_mm_castsi128_ps(changed)) | (_mm_movemask_ps(_mm_castsi128_ps(moved)) << GEOMETRY_BLOCK);
+}
+#else
+/* Applies a real value change to one of the arrays pairs (like realX and x), accumulating the slots that changed */
+static void updateGeometryValue(int *realValue, int *value, int minValue, int maxValue, int delta, BOOL touched,
+								BOOL *changed, BOOL *moved){
+	int newValue = *value;
+
+	if (touched && *realValue + delta >= minValue && *realValue + delta <= maxValue)
+		newValue = *realValue + delta;
+
+	*changed = *changed || delta;
+	*moved = *moved || newValue != *value;
+	*realValue += delta;
+	*value = newValue;
 }
 
-/* The Destructor*/
-void deleteControl(Control control){
-	freeGUIObjectFields((GUIObject)control);
-	free(control);
+static int resolveAnchorBlock(struct _geometryTable *table, unsigned int first, int widthChange, int heightChange,
+								int centerX, int centerY){
+	unsigned int i;
+	int anchor, deltaX, deltaY, result = 0;
+	BOOL stretchX, stretchY, changed, moved;
+
+	for (i = first; i < first + GEOMETRY_BLOCK; i++){
+		anchor = table->anchor[i];
+		stretchX = (anchor & ANCHOR_LEFT) && (anchor & ANCHOR_RIGHT) && widthChange;
+		stretchY = (anchor & ANCHOR_TOP) && (anchor & ANCHOR_BOTTOM) && heightChange;
+		deltaX = (anchor & ANCHOR_LEFT) ? 0 : (anchor & ANCHOR_RIGHT) ? widthChange : centerX;
+		deltaY = (anchor & ANCHOR_TOP) ? 0 : (anchor & ANCHOR_BOTTOM) ? heightChange : centerY;
+		changed = FALSE; moved = FALSE;
+		if (!stretchX && !stretchY && !deltaX && !deltaY)
+			continue;
+
+		updateGeometryValue(&(table->realWidth[i]), &(table->width[i]), table->minWidth[i], table->maxWidth[i],
+							stretchX ? widthChange : 0, stretchX || stretchY, &changed, &moved);
+		updateGeometryValue(&(table->realHeight[i]), &(table->height[i]), table->minHeight[i], table->maxHeight[i],
+							stretchY ? heightChange : 0, stretchX || stretchY, &changed, &moved);
+		updateGeometryValue(&(table->realX[i]), &(table->x[i]), table->minX[i], table->maxX[i], deltaX, deltaX || deltaY,
+							&changed, &moved);
+		updateGeometryValue(&(table->realY[i]), &(table->y[i]), table->minY[i], table->maxY[i], deltaY, deltaX || deltaY,
+							&changed, &moved);
+
+		if (changed || moved)
+			result |= 1 << (i - first);
+		if (moved)
+			result |= 1 << (i - first + GEOMETRY_BLOCK);
+	}
+
+	return result;
 }
+#endif
+
+/* Moves and resizes the children of a GUIObject according to their anchor settings and the GUIObject's size change. The children's
+   fields are updated, the slots of the ones that moved are listed in the geometry table to be committed later in a batch. Returns the
+   number of windows to move, or -1 if the geometry table could not be allocated */
+static int updateAnchoredChildren(GUIObject object, int widthChange, int heightChange){
+	struct _geometryTable *table;
+	unsigned int i, slot;
+	int centerX, centerY, mask, numChildrenMoved = 0;
+	Control currChild;
+	CRITICAL_SECTION *lock;
 
+	table = reserveGeometryTable(object->childrenGeometry, object->numChildren);
+	if (!table)
+		return -1;
+	object->childrenGeometry = table;
+	table->numMovedSlots = 0;
+
+	lock = enterExistingLock((Object)object);
+	centerX = object->width / 2 - (object->width - widthChange) / 2;
+	centerY = object->height / 2 - (object->height - heightChange) / 2;
+	LeaveCriticalSection(lock);
+
+	syncGeometryTable(object, table);
+
+	for (i = 0; i < object->numChildren; i += GEOMETRY_BLOCK){
+		mask = resolveAnchorBlock(table, i, widthChange, heightChange, centerX, centerY);
+
+		/* Write back the children that changed, the rest of the block's children aren't touched */
+		for (slot = i; slot < i + GEOMETRY_BLOCK && slot < object->numChildren; slot++){
+			if (!(mask & (1 << (slot - i))) || !(table->slotFlags[slot] & SLOT_CONTROL))
+				continue;
+
+			currChild = (Control)(object->children)[slot];
+			lock = enterExistingLock((Object)currChild);
+			currChild->realX = table->realX[slot]; currChild->realY = table->realY[slot];
+			currChild->realWidth = table->realWidth[slot]; currChild->realHeight = table->realHeight[slot];
+			currChild->x = table->x[slot]; currChild->y = table->y[slot];
+			currChild->width = table->width[slot]; currChild->height = table->height[slot];
+			LeaveCriticalSection(lock);
+
+			if (mask & (1 << (slot - i + GEOMETRY_BLOCK))){
+				table->movedSlots[(table->numMovedSlots)++] = slot;
+				if (currChild->handle)
+					numChildrenMoved++;
+			}
+		}
+	}
 
+	return numChildrenMoved;
+}
 
+/* Moves and resizes the windows of a GUIObject's children listed in its geometry table to the positions and sizes in their fields.
+   All the windows are moved in a single DeferWindowPos batch (they share the same parent window) without being redrawn. The children's
+   items in the GUIObject's spatial index are updated as well */
+static BOOL commitChildrenPos(GUIObject object, int numMoved){
+	struct _geometryTable *table = object->childrenGeometry;
+	HDWP deferredPos;
+	GUIObject currChild;
+	unsigned int i;
+	int scrollX, scrollY;
+	BOOL result = TRUE;
+
+	for (i = 0; i < table->numMovedSlots; i++){
+		currChild = (object->children)[(table->movedSlots)[i]];
+		if (object->childrenIndex)
+			updateSpatialItem(currChild);
+		if (currChild->windowless)
+			invalidateWindowless(currChild);
+	}
 
+	if (!numMoved){
+		table->numMovedSlots = 0;
+		return TRUE;
+	}
 
-/* Class Button */
-/* The Constructors*/
-void initButton(Button thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height){
-	if (!thisObject)
-		return;
+	getScrollOffset(object, &scrollX, &scrollY);
+	deferredPos = BeginDeferWindowPos(numMoved);
+	for (i = 0; i < table->numMovedSlots && deferredPos; i++){
+		currChild = (object->children)[(table->movedSlots)[i]];
+		if (currChild->handle)
+			deferredPos = DeferWindowPos(deferredPos, currChild->handle, NULL, currChild->x - scrollX, currChild->y - scrollY,
+											currChild->width, currChild->height, SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOREDRAW);
+	}
 
-	CLASS_Button;
+	if (!deferredPos || !EndDeferWindowPos(deferredPos)){
+		/* The batch could not be allocated or applied, fall back to moving the windows one by one */
+		for (i = 0; i < table->numMovedSlots; i++){
+			currChild = (object->children)[(table->movedSlots)[i]];
+			if (currChild->handle)
+				if (!SetWindowPos(currChild->handle, NULL, currChild->x - scrollX, currChild->y - scrollY, currChild->width,
+												currChild->height, SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOREDRAW))
+					result = FALSE;
+		}
+	}
 
-	setControlFields((Control)thisObject, instance, text, x, y, width, height);
+	table->numMovedSlots = 0;
+	return result;
+}
 
-	/* Set the fields */
-	thisObject->type = BUTTON;
-	thisObject->className = "Button";
-	thisObject->styles = WS_CHILD | WS_VISIBLE | BS_TEXT | BS_PUSHBUTTON;
+/* Rounds a layout coordinate to the nearest pixel */
+static int roundToPixel(float value){
+	return (int)(value < 0.0f ? value - 0.5f : value + 0.5f);
 }
 
-Button newButton(HINSTANCE instance, char *text, int x, int y, int width, int height){
-	Button thisObject = (Button)malloc(sizeof(val_Button));
+/* Lays out the children of a flex or grid GUIObject with the layout engine and updates the fields of the ones that got new rectangles.
+   The edges are snapped to pixels, so adjacent children don't get gaps or overlaps from rounding. The slots of the children that moved
+   are listed in the geometry table. Returns the number of windows to move, or -1 if the geometry table could not be allocated */
+static int updateLayoutChildren(GUIObject object, int layoutWidth, int layoutHeight){
+	LayoutNode node = object->layoutNode, childNode;
+	struct _geometryTable *table;
+	GUIObject currChild;
+	unsigned int i;
+	int x, y, width, height, numChildrenMoved = 0;
+	CRITICAL_SECTION *lock;
 
-	if (!thisObject)
-		return NULL;
+	table = reserveGeometryTable(object->childrenGeometry, object->numChildren);
+	if (!table)
+		return -1;
+	object->childrenGeometry = table;
+	table->numMovedSlots = 0;
+	table->stale = TRUE; /* The children's fields are written directly */
 
-	initButton(thisObject, instance, text, x, y, width, height);
+	/* A GUIObject that is itself an item of a flex or grid layout has already been laid out with its parent, at its unsnapped size */
+	if (node->parent && node->hasLayout)
+		LayoutNode_calculate(node, node->width, node->height);
+	else
+		LayoutNode_calculate(node, (float)layoutWidth, (float)layoutHeight);
 
-	return thisObject;
-}
+	for (i = 0; i < object->numChildren; i++){
+		currChild = (object->children)[i];
+		if (currChild == NULL || !currChild->layoutNode || currChild->layoutNode->parent != node)
+			continue;
+
+		childNode = currChild->layoutNode;
+		x = roundToPixel(childNode->x);
+		y = roundToPixel(childNode->y);
+		width = roundToPixel(childNode->x + childNode->width) - x;
+		height = roundToPixel(childNode->y + childNode->height) - y;
+
+		lock = enterExistingLock((Object)currChild);
+		if (currChild->realX != x || currChild->realY != y || currChild->realWidth != width || currChild->realHeight != height){
+			GUIObject_updateSize(currChild, width, height);
+			if (isControl(currChild))
+				Control_updatePos((Control)currChild, x, y);
+			else {
+				currChild->x = x; currChild->realX = x;
+				currChild->y = y; currChild->realY = y;
+			}
+			table->movedSlots[(table->numMovedSlots)++] = i;
+			if (currChild->handle)
+				numChildrenMoved++;
+		}
+		LeaveCriticalSection(lock);
+	}
 
-/* The Destructor*/
-void deleteButton(Button button){
-	button->className = NULL;
-	freeGUIObjectFields((GUIObject)button);
-	free(button);
+	return numChildrenMoved;
 }
 
+/* Realigns the children of a GUIObject if its size changed since they were last aligned, commits the ones that actually moved in one
+   batch, then descends into the children that were resized or have dirty layouts themselves. Clean subtrees are skipped */
+static BOOL layoutSubtree(GUIObject object, unsigned int *numMoved){
+	unsigned int i, flags;
+	int layoutWidth, layoutHeight, widthChange, heightChange, childWidth, childHeight, numChildrenMoved = 0;
+	struct _geometryTable *table;
+	Control currChild;
+	BOOL result = TRUE, hasLayoutEngine = object->layoutNode && object->layoutNode->type != LAYOUT_NONE;
+	CRITICAL_SECTION *lock;
+
+	lock = enterExistingLock((Object)object);
+	flags = object->layoutFlags;
+	object->layoutFlags &= ~(LAYOUT_DIRTY | LAYOUT_SUBTREE_DIRTY);
+
+	getLayoutSize(object, &layoutWidth, &layoutHeight);
+	widthChange = layoutWidth - object->layoutWidth;
+	heightChange = layoutHeight - object->layoutHeight;
+	object->layoutWidth = layoutWidth;
+	object->layoutHeight = layoutHeight;
+	LeaveCriticalSection(lock);
+
+	if (!widthChange && !heightChange && !(flags & LAYOUT_SUBTREE_DIRTY) && !(hasLayoutEngine && object->layoutNode->dirty))
+		return TRUE; /* Nothing the children depend on has changed */
+
+	/* Compute all the new rectangles first */
+	if (hasLayoutEngine){
+		/* Flex and grid GUIObjects place all their children, their anchors are ignored */
+		if (widthChange || heightChange || (flags & (LAYOUT_DIRTY | LAYOUT_SUBTREE_DIRTY)) || object->layoutNode->dirty ||
+				!object->layoutNode->hasLayout)
+			numChildrenMoved = updateLayoutChildren(object, layoutWidth, layoutHeight);
+	} else if (widthChange || heightChange)
+		numChildrenMoved = updateAnchoredChildren(object, widthChange, heightChange);
+
+	if (numChildrenMoved < 0){
+		numChildrenMoved = 0;
+		result = FALSE;
+	}
 
+	/* Then move all the windows at once */
+	if (object->childrenGeometry && object->childrenGeometry->numMovedSlots){
+		if (!commitChildrenPos(object, numChildrenMoved))
+			result = FALSE;
+		*numMoved += numChildrenMoved;
+	}
 
+	/* A resized ListView realizes rows for its new viewport */
+	if (object->type == LISTVIEW && (widthChange || heightChange))
+		if (!updateListRows((ListView)object))
+			result = FALSE;
 
+	/* A resized LogView shows a different number of lines */
+	if (object->type == LOGVIEW && (widthChange || heightChange)){
+		updateLogView((LogView)object, ((LogView)object)->topLine);
+		if (object->handle)
+			InvalidateRect(object->handle, NULL, FALSE);
+	}
 
-/* Class TextBox */
-/* The Methods*/
-/* Sets the text input mode for a textbox to number-only or to not number-only */
-BOOL TextBox_setNumOnly(TextBox textbox, BOOL numOnly){
-	textbox->numOnly = numOnly;
-	textbox->styles = numOnly ? textbox->styles | ES_NUMBER : textbox->styles ^ ES_NUMBER;
-	
-	if (textbox->handle)
-		return SetWindowLongPtrA(textbox->handle, GWL_STYLE, (LONG)textbox->styles) ? TRUE : FALSE;
-	else
-		return TRUE;
-}
+	/* A resized TreeView shows a different number of rows */
+	if (object->type == TREEVIEW && (widthChange || heightChange))
+		updateTreeView((TreeView)object, ((TreeView)object)->topRow, TRUE);
 
+	/* A resized ScrollPanel shows a different part of its content */
+	if (object->type == SCROLLPANEL && (widthChange || heightChange))
+		ScrollPanel_scrollContentTo((ScrollPanel)object, ((ScrollPanel)object)->scrollX, ((ScrollPanel)object)->scrollY);
 
+	/* A resized ImageView keeps its viewport over the image */
+	if (object->type == IMAGEVIEW && (widthChange || heightChange))
+		ImageView_panTo((ImageView)object, ((ImageView)object)->scrollX, ((ImageView)object)->scrollY);
 
-/* The Constructors*/
-void initTextBox(TextBox thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height, enum _textboxtype multiline){
-	if (!thisObject)
-		return;
+	/* A resized Plot maps its columns anew, a following one keeps its newest samples at its right edge */
+	if (object->type == PLOT && (widthChange || heightChange))
+		invalidatePlot((Plot)object, 0, object->width);
 
-	CLASS_TextBox;
+	/* Descend into the children that got resized or have dirty layouts. An up to date geometry table tells which children have
+	   children of their own without touching the rest */
+	table = object->childrenGeometry;
+	if (table && (table->stale || table->numSlots != object->numChildren))
+		table = NULL;
+	for (i = 0; i < object->numChildren; i++){
+		if (table && !(table->slotFlags[i] & SLOT_HAS_CHILDREN))
+			continue;
+		if ((object->children)[i] == NULL || (object->children)[i]->numChildren == 0)
+			continue;
+
+		currChild = (Control)(object->children)[i];
+		getLayoutSize((GUIObject)currChild, &childWidth, &childHeight);
+		if (childWidth != currChild->layoutWidth || childHeight != currChild->layoutHeight ||
+				(currChild->layoutFlags & (LAYOUT_DIRTY | LAYOUT_SUBTREE_DIRTY)))
+			if (!layoutSubtree((GUIObject)currChild, numMoved))
+				result = FALSE;
+	}
 
-	setControlFields((Control)thisObject, instance, text, x, y, width, height);
+	return result;
+}
 
-	/* Set the fields */
-	thisObject->type = TEXTBOX;
-	thisObject->className = "Edit";
-	thisObject->styles = WS_CHILD | WS_VISIBLE | WS_BORDER;
+/* Runs a layout pass over the dirty parts of a GUIObject's subtree: the children of the GUIObjects that were resized since the last
+   pass are moved and/or resized according to their anchor settings, or by the layout engine for flex and grid GUIObjects. The windows that moved are repainted once at the end */
+BOOL updateLayout(GUIObject object){
+	unsigned int numMoved = 0;
+	BOOL result;
 
-	thisObject->multiline = (BOOL)multiline;
-	if (thisObject->multiline)
-		thisObject->styles |= ES_MULTILINE | ES_WANTRETURN;
+	if (!object)
+		return FALSE;
+
+	if (!(object->layoutFlags & (LAYOUT_DIRTY | LAYOUT_SUBTREE_DIRTY)))
+		return TRUE;
+
+	result = layoutSubtree(object, &numMoved);
+
+	if (numMoved && object->handle)
+		RedrawWindow(object->handle, NULL, NULL, RDW_ERASE | RDW_FRAME | RDW_INVALIDATE | RDW_ALLCHILDREN);
+
+	return result;
 }
 
-TextBox newTextBox(HINSTANCE instance, char *text, int x, int y, int width, int height, enum _textboxtype multiline){
-	TextBox thisObject = (TextBox)malloc(sizeof(val_TextBox));
+/* Sets the current window's width, height and clientWidth and clientHeight on user resize. Thread-safe */
+static void refreshWindowSize(Window window, LPARAM lParam){
+	RECT clientSize;
+	WINDOWPOS *windowPos;
 
-	if (!thisObject)
-		return NULL;
+	startSync(window);
 
-	initTextBox(thisObject, instance, text, x, y, width, height, multiline);
+	windowPos = (WINDOWPOS*)lParam;
+	window->width = windowPos->cx;
+	window->height = windowPos->cy;
+	window->x = windowPos->x;
+	window->y = windowPos->y;
 
-	return thisObject;
+	if (GetClientRect(window->handle, &clientSize)){
+		/* The offscreen buffer is recreated at the new size when it is next used */
+		if (window->paintState && window->paintState->offscreenBitmap && (window->clientWidth != clientSize.right - clientSize.left ||
+				window->clientHeight != clientSize.bottom - clientSize.top)){
+			DeleteObject(window->paintState->offscreenBitmap);
+			window->paintState->offscreenBitmap = NULL;
+		}
+		window->clientWidth = clientSize.right - clientSize.left;
+		window->clientHeight = clientSize.bottom - clientSize.top;
+	}
+
+	InvalidateRect(window->handle, NULL, FALSE);
+	window->layoutFlags |= LAYOUT_DIRTY;
+
+	endSync(window);
+
+	updateLayout((GUIObject)window);
 }
 
-/* The Destructor*/
-void deleteTextBox(TextBox textbox){
-	textbox->className = NULL;
-	freeGUIObjectFields((GUIObject)textbox);
-	free(textbox);
+/* Windowless controls */
+/* Draws a windowless GUIObject at the origin of a device context: the built-in look of labels and buttons, then its WM_PAINT events
+   (with its paint contexts set to the device context, so the drawing methods work as usual), then its border */
+static void paintWindowlessObject(GUIObject object, GUIObject host, HDC dc){
+	RECT rect;
+	UINT format = DT_NOPREFIX;
+
+	SetRect(&rect, 0, 0, object->width, object->height);
+	SelectObject(dc, GetStockObject(DEFAULT_GUI_FONT));
+	SetBkMode(dc, TRANSPARENT);
+	SetTextColor(dc, GetSysColor(object->enabled ? COLOR_WINDOWTEXT : COLOR_GRAYTEXT));
+
+	if (object->type == LABEL){
+		FillRect(dc, &rect, GetSysColorBrush(COLOR_BTNFACE));
+		if (object->styles & SS_CENTERIMAGE)
+			format |= DT_VCENTER | DT_SINGLELINE;
+		else
+			format |= DT_WORDBREAK;
+		if ((object->styles & 0x3) == SS_CENTER)
+			format |= DT_CENTER;
+		else if ((object->styles & 0x3) == SS_RIGHT)
+			format |= DT_RIGHT;
+		if (object->text && getWideText(object))
+			DrawTextW(dc, object->wideText, -1, &rect, format);
+	} else if (object->type == BUTTON){
+		DrawFrameControl(dc, &rect, DFC_BUTTON, DFCS_BUTTONPUSH | (host->windowlessCapture == object ? DFCS_PUSHED : 0) |
+												(object->enabled ? 0 : DFCS_INACTIVE));
+		if (object->text && getWideText(object))
+			DrawTextW(dc, object->wideText, -1, &rect, format | DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+		if (host->windowlessFocus == object){
+			InflateRect(&rect, -3, -3);
+			DrawFocusRect(dc, &rect);
+			InflateRect(&rect, 3, 3);
+		}
+	} else if (object->type == PLOT)
+		drawPlotColumns((Plot)object, dc, 0, object->width);
+
+	object->paintContext = dc;
+	object->offscreenPaintContext = dc;
+	handleEvents(object, WM_PAINT, (WPARAM)NULL, (LPARAM)NULL);
+	object->paintContext = NULL;
+	object->offscreenPaintContext = NULL;
+
+	if (object->styles & WS_BORDER)
+		FrameRect(dc, &rect, (HBRUSH)GetStockObject(BLACK_BRUSH));
 }
 
+/* Paints the windowless children of a GUIObject that intersect the update rectangle into its host's offscreen buffer, over the host's
+   background painted there by paintWindowless. The host's own children are then copied to the screen, with their descendants drawn
+   over them. The offsets are the GUIObject's position in the host. The rectangles the children are painted in are recorded in the
+   host's content */
+static void paintWindowlessChildren(GUIObject object, GUIObject host, int offsetX, int offsetY, const RECT *updateRect){
+	GUIObject currChild;
+	RECT childRect, clipRect;
+	unsigned int i;
+	int savedState, scrollX, scrollY;
 
+	getScrollOffset(host, &scrollX, &scrollY);
 
+	for (i = 0; i < object->numChildren; i++){
+		currChild = (object->children)[i];
+		if (currChild == NULL || !currChild->windowless)
+			continue;
+
+		SetRect(&childRect, offsetX + currChild->x, offsetY + currChild->y, offsetX + currChild->x + currChild->width,
+					offsetY + currChild->y + currChild->height);
+		currChild->paintedRect = childRect;
+		OffsetRect(&(currChild->paintedRect), scrollX, scrollY);
+		if (!IntersectRect(&clipRect, &childRect, updateRect))
+			continue;
+
+		savedState = SaveDC(host->offscreenPaintContext);
+		IntersectClipRect(host->offscreenPaintContext, clipRect.left, clipRect.top, clipRect.right, clipRect.bottom);
+		SetViewportOrgEx(host->offscreenPaintContext, childRect.left, childRect.top, NULL);
+		paintWindowlessObject(currChild, host, host->offscreenPaintContext);
+		RestoreDC(host->offscreenPaintContext, savedState);
+
+		if (currChild->numWindowless)
+			paintWindowlessChildren(currChild, host, childRect.left, childRect.top, &clipRect);
+
+		if (object == host)
+			BitBlt(host->paintContext, clipRect.left, clipRect.top, clipRect.right - clipRect.left, clipRect.bottom - clipRect.top,
+					host->offscreenPaintContext, clipRect.left, clipRect.top, SRCCOPY);
+	}
+}
 
+/* Runs the windowless paint pass of a host over the update rectangle of its WM_PAINT. The host paints its background and its default
+   content into the offscreen buffer, the screen is never read back: the children are drawn over that, not over what the host's
+   paint events drew. A host that paints itself through a buffer of its own passes that buffer as the background instead */
+static void paintWindowless(GUIObject host, const RECT *updateRect, HDC background){
+	HBITMAP prevBitmap;
+	int scrollX, scrollY, savedState;
 
-/* Class Label */
-/* The Constructors*/
-void initLabel(Label thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height){
-	if (!thisObject)
+	if (!host->paintContext)
 		return;
 
-	CLASS_Button;
-
-	setControlFields((Control)thisObject, instance, text, x, y, width, height);
+	getScrollOffset(host, &scrollX, &scrollY);
+	prevBitmap = GUIObject_updateOffscreenPaintContext(host, FALSE, FALSE);
+
+	if (background)
+		BitBlt(host->offscreenPaintContext, updateRect->left, updateRect->top, updateRect->right - updateRect->left,
+				updateRect->bottom - updateRect->top, background, updateRect->left, updateRect->top, SRCCOPY);
+	else {
+		savedState = SaveDC(host->offscreenPaintContext);
+		IntersectClipRect(host->offscreenPaintContext, updateRect->left, updateRect->top, updateRect->right, updateRect->bottom);
+		SendMessageW(host->handle, WM_ERASEBKGND, (WPARAM)host->offscreenPaintContext, (LPARAM)NULL);
+		SendMessageW(host->handle, WM_PRINTCLIENT, (WPARAM)host->offscreenPaintContext, (LPARAM)PRF_CLIENT);
+		RestoreDC(host->offscreenPaintContext, savedState);
+	}
 
-	/* Set the fields */
-	thisObject->type = LABEL;
-	thisObject->className = "Static";
-	thisObject->styles = WS_CHILD | WS_VISIBLE | SS_NOTIFY;
+	paintWindowlessChildren(host, host, -scrollX, -scrollY, updateRect);
+	SelectObject(host->offscreenPaintContext, prevBitmap);
 }
 
-Label newLabel(HINSTANCE instance, char *text, int x, int y, int width, int height){
-	Label thisObject = (Label)malloc(sizeof(val_Label));
+/* Finds the deepest windowless GUIObject under a point of a host's client area. The point is converted to its client coordinates */
+static GUIObject getWindowlessAt(GUIObject host, int *x, int *y){
+	GUIObject currObject = host, result = NULL, currChild;
+	int scrollX, scrollY;
 
-	if (!thisObject)
-		return NULL;
+	/* The children of a scrolled host are hit-tested in its content */
+	getScrollOffset(host, &scrollX, &scrollY);
+	*x += scrollX;
+	*y += scrollY;
 
-	initLabel(thisObject, instance, text, x, y, width, height);
+	while (currObject->numWindowless){
+		currChild = GUIObject_getChildAt(currObject, *x, *y);
+		if (!currChild || !currChild->windowless)
+			break;
 
-	return thisObject;
+		*x -= currChild->x;
+		*y -= currChild->y;
+		currObject = result = currChild;
+	}
+
+	return result;
 }
 
-/* The Destructor*/
-void deleteLabel(Label label){
-	label->className = NULL;
-	freeGUIObjectFields((GUIObject)label);
-	free(label);
+/* Routes a host's mouse and keyboard messages to its windowless descendants: mouse messages go to the one under the cursor (or the one
+   a button was pressed on, until it is released), keyboard messages go to the focused one. A button press focuses the windowless
+   descendant and captures the mouse, its release only reaches it (as a click) if the cursor is still over it. Returns the event ID like
+   handleEvents, -1 if the message was not handled by a windowless GUIObject */
+static int routeWindowlessInput(GUIObject host, UINT msg, WPARAM wParam, LPARAM lParam){
+	GUIObject target = NULL, prevFocus;
+	int x, y, hostX, hostY;
+
+	switch (msg){
+		case WM_KEYDOWN: case WM_KEYUP: case WM_CHAR:
+			target = host->windowlessFocus;
+			if (!target)
+				return -1;
+
+			/* The space and enter keys click a focused button */
+			if (target->type == BUTTON && msg == WM_KEYUP && (wParam == VK_SPACE || wParam == VK_RETURN))
+				return handleEvents(target, WM_LBUTTONUP, (WPARAM)NULL, MAKELPARAM(0, 0));
+			return handleEvents(target, msg, wParam, lParam);
+
+		case WM_MOUSEMOVE: case WM_LBUTTONDOWN: case WM_LBUTTONUP: case WM_LBUTTONDBLCLK:
+		case WM_RBUTTONDOWN: case WM_RBUTTONUP: case WM_RBUTTONDBLCLK:
+			x = GET_X_LPARAM(lParam);
+			y = GET_Y_LPARAM(lParam);
+
+			if (host->windowlessCapture){
+				target = host->windowlessCapture;
+				getWindowlessHost(target, &hostX, &hostY);
+				x -= hostX;
+				y -= hostY;
+			} else
+				target = getWindowlessAt(host, &x, &y);
+			if (!target)
+				return -1;
+
+			if (msg == WM_LBUTTONDOWN || msg == WM_RBUTTONDOWN){
+				prevFocus = host->windowlessFocus;
+				host->windowlessFocus = host->windowlessCapture = target;
+				if (prevFocus && prevFocus != target)
+					invalidateWindowless(prevFocus);
+				invalidateWindowless(target);
+				SetCapture(host->handle);
+			} else if ((msg == WM_LBUTTONUP || msg == WM_RBUTTONUP) && host->windowlessCapture){
+				host->windowlessCapture = NULL;
+				ReleaseCapture();
+				invalidateWindowless(target);
+				if (x < 0 || y < 0 || x >= target->width || y >= target->height)
+					return 0; /* Released outside of it, not a click */
+			}
+
+			return handleEvents(target, msg, wParam, MAKELPARAM(x, y));
+	}
+
+	return -1;
 }
 
+/* Paints the update region of a windowed Plot through a buffer the size of the region, then its WM_PAINT events over it (with its
+   paint context set to the buffer) and its windowless children */
+static void paintPlot(Plot plot){
+	PAINTSTRUCT paintData;
+	HDC dc, bufferDC;
+	HBITMAP buffer, prevBuffer;
+	int width;
+
+	dc = BeginPaint(plot->handle, &paintData);
+	width = paintData.rcPaint.right - paintData.rcPaint.left;
+
+	if (width > 0 && plot->height > 0){
+		bufferDC = CreateCompatibleDC(dc);
+		buffer = CreateCompatibleBitmap(dc, width, plot->height);
+		prevBuffer = (HBITMAP)SelectObject(bufferDC, buffer);
+		SetViewportOrgEx(bufferDC, -paintData.rcPaint.left, 0, NULL);
+
+		drawPlotColumns(plot, bufferDC, paintData.rcPaint.left, paintData.rcPaint.right);
+		plot->paintContext = bufferDC;
+		handleEvents((GUIObject)plot, WM_PAINT, (WPARAM)NULL, (LPARAM)NULL);
+		/* The buffer is in client coordinates through its viewport origin, the windowless children are blitted into it like into the
+		   window's own DC */
+		if (plot->numWindowless)
+			paintWindowless((GUIObject)plot, &(paintData.rcPaint), bufferDC);
+		plot->paintContext = NULL;
+
+		SetViewportOrgEx(bufferDC, 0, 0, NULL);
+		BitBlt(dc, paintData.rcPaint.left, 0, width, plot->height, bufferDC, 0, 0, SRCCOPY);
+		SelectObject(bufferDC, prevBuffer);
+		DeleteObject(buffer);
+		DeleteDC(bufferDC);
+	}
 
+	EndPaint(plot->handle, &paintData);
+}
 
+/* Paints the visible tiles of an ImageView in its update region through a buffer the size of the region, then its WM_PAINT events
+   over them (with its paint context set to the buffer) */
+static void paintImageView(ImageView imageview){
+	PAINTSTRUCT paintData;
+	HDC dc, bufferDC;
+	HBITMAP buffer, prevBuffer;
+	int width, height;
+
+	dc = BeginPaint(imageview->handle, &paintData);
+	width = paintData.rcPaint.right - paintData.rcPaint.left;
+	height = paintData.rcPaint.bottom - paintData.rcPaint.top;
+
+	if (width > 0 && height > 0){
+		bufferDC = CreateCompatibleDC(dc);
+		buffer = CreateCompatibleBitmap(dc, width, height);
+		prevBuffer = (HBITMAP)SelectObject(bufferDC, buffer);
+		SetViewportOrgEx(bufferDC, -paintData.rcPaint.left, -paintData.rcPaint.top, NULL);
+		SetStretchBltMode(bufferDC, COLORONCOLOR);
+
+		drawImageTiles(imageview, bufferDC, &(paintData.rcPaint));
+		imageview->paintContext = bufferDC;
+		handleEvents((GUIObject)imageview, WM_PAINT, (WPARAM)NULL, (LPARAM)NULL);
+		imageview->paintContext = NULL;
+
+		SetViewportOrgEx(bufferDC, 0, 0, NULL);
+		BitBlt(dc, paintData.rcPaint.left, paintData.rcPaint.top, width, height, bufferDC, 0, 0, SRCCOPY);
+		SelectObject(bufferDC, prevBuffer);
+		DeleteObject(buffer);
+		DeleteDC(bufferDC);
+	}
 
+	EndPaint(imageview->handle, &paintData);
+}
 
-/* Class EventArgs */
+/* Pans an ImageView dragged with the mouse, and zooms it with the wheel around the mouse pointer */
+static void handleImageViewMouse(ImageView imageview, UINT msg, WPARAM wParam, LPARAM lParam){
+	POINT point;
 
-/* The Constructors*/
-void initEventArgs(EventArgs thisObject, UINT message, WPARAM wParam, LPARAM lParam){
-	if (!thisObject)
-		return;
+	point.x = GET_X_LPARAM(lParam);
+	point.y = GET_Y_LPARAM(lParam);
 
-	initObject((Object)thisObject);
+	switch (msg){
+		case WM_LBUTTONDOWN:
+			imageview->dragging = TRUE;
+			imageview->dragX = point.x;
+			imageview->dragY = point.y;
+			SetCapture(imageview->handle);
+			break;
 
-	thisObject->type = EVENTARGS;
+		case WM_MOUSEMOVE:
+			if (imageview->dragging){
+				ImageView_panTo(imageview, imageview->scrollX - (point.x - imageview->dragX), imageview->scrollY - (point.y - imageview->dragY));
+				imageview->dragX = point.x;
+				imageview->dragY = point.y;
+			}
+			break;
 
-	thisObject->message = message;
-	thisObject->wParam = wParam;
-	thisObject->lParam = lParam;
+		case WM_LBUTTONUP:
+			if (imageview->dragging){
+				imageview->dragging = FALSE;
+				ReleaseCapture();
+			}
+			break;
 
-	thisObject->updateValue = &initEventArgs;
+		case WM_MOUSEWHEEL: /* The wheel position is in screen coordinates */
+			ScreenToClient(imageview->handle, &point);
+			ImageView_setZoom(imageview, imageview->zoom * (GET_WHEEL_DELTA_WPARAM(wParam) > 0 ? 1.25f : 0.8f), point.x, point.y);
+			break;
+	}
 }
 
-EventArgs newEventArgs(UINT message, WPARAM wParam, LPARAM lParam){
-	EventArgs thisObject = (EventArgs)malloc(sizeof(val_EventArgs));
+/* Paints the lines of a LogView in its update region, then its WM_PAINT events. Each row is drawn with its background in one call,
+   so there is no flicker without a buffer */
+static void paintLogView(LogView logview){
+	PAINTSTRUCT paintData;
+	RECT clientRect, rowRect;
+	HDC dc;
+	unsigned long long line;
+	int row, lastRow;
+	char *text;
+
+	dc = BeginPaint(logview->handle, &paintData);
+	GetClientRect(logview->handle, &clientRect);
+	SelectObject(dc, GetStockObject(DEFAULT_GUI_FONT));
+	SetTextColor(dc, GetSysColor(COLOR_WINDOWTEXT));
+	SetBkColor(dc, GetSysColor(COLOR_WINDOW));
+
+	row = paintData.rcPaint.top / logview->lineHeight;
+	lastRow = (paintData.rcPaint.bottom - 1) / logview->lineHeight;
+
+	startSync(logview);
+	for (; row <= lastRow; row++){
+		line = logview->topLine + row;
+		text = (line >= logview->firstLine && line < logview->numLines) ? (logview->lines)[line % logview->maxLines] : "";
+		SetRect(&rowRect, 0, row * logview->lineHeight, clientRect.right, (row + 1) * logview->lineHeight);
+		ExtTextOutA(dc, 2, rowRect.top + 1, ETO_OPAQUE | ETO_CLIPPED, &rowRect, text, (UINT)strlen(text), NULL);
+	}
+	endSync(logview);
 
-	if (!thisObject)
-		return NULL;
+	logview->paintContext = dc;
+	handleEvents((GUIObject)logview, WM_PAINT, (WPARAM)NULL, (LPARAM)NULL);
+	logview->paintContext = NULL;
 
-	initEventArgs(thisObject, message, wParam, lParam);
+	EndPaint(logview->handle, &paintData);
+}
 
-	return thisObject;
+/* Scrolls a LogView on a scroll bar request */
+static void scrollLogView(LogView logview, WORD request){
+	SCROLLINFO scrollInfo;
+	long long topLine = (long long)logview->topLine, numRows = getLogViewRows(logview);
+
+	switch (request){
+		case SB_LINEUP: topLine--; break;
+		case SB_LINEDOWN: topLine++; break;
+		case SB_PAGEUP: topLine -= numRows; break;
+		case SB_PAGEDOWN: topLine += numRows; break;
+		case SB_TOP: topLine = 0; break;
+		case SB_BOTTOM: topLine = LLONG_MAX; break;
+		case SB_THUMBTRACK: case SB_THUMBPOSITION:
+			/* The 32-bit track position, relative to the oldest line */
+			scrollInfo.cbSize = sizeof(SCROLLINFO);
+			scrollInfo.fMask = SIF_TRACKPOS;
+			if (GetScrollInfo(logview->handle, SB_VERT, &scrollInfo))
+				topLine = (long long)logview->firstLine + scrollInfo.nTrackPos;
+			break;
+		default:
+			return;
+	}
+
+	LogView_scrollToLine(logview, topLine > 0 ? (unsigned long long)topLine : 0);
 }
 
-/* The Destructor*/
-void deleteEventArgs(EventArgs eventargs){
-	DeleteCriticalSection(&(eventargs->criticalSection));
-	free(eventargs);
+/* Scrolls a ListView by delta pixels. The scroll position stops at 0 and INT_MAX rather than overflow, updateListRows clamps it to
+   the content */
+static void scrollListViewBy(ListView listview, long long delta){
+	long long scrollPos = listview->scrollPos + delta;
+
+	ListView_scrollTo(listview, scrollPos < 0 ? 0 : (scrollPos > INT_MAX ? INT_MAX : (int)scrollPos));
 }
 
+/* Scrolls a ListView on a scroll bar request */
+static void scrollListView(ListView listview, WORD request){
+	SCROLLINFO scrollInfo;
+
+	switch (request){
+		case SB_LINEUP: scrollListViewBy(listview, -listview->rowHeight); break;
+		case SB_LINEDOWN: scrollListViewBy(listview, listview->rowHeight); break;
+		case SB_PAGEUP: scrollListViewBy(listview, -getListViewHeight(listview)); break;
+		case SB_PAGEDOWN: scrollListViewBy(listview, getListViewHeight(listview)); break;
+		case SB_TOP: ListView_scrollTo(listview, 0); break;
+		case SB_BOTTOM: ListView_scrollTo(listview, INT_MAX); break;
+		case SB_THUMBTRACK: case SB_THUMBPOSITION:
+			/* The 32-bit track position, the message only carries 16 bits */
+			scrollInfo.cbSize = sizeof(SCROLLINFO);
+			scrollInfo.fMask = SIF_TRACKPOS;
+			if (GetScrollInfo(listview->handle, SB_VERT, &scrollInfo))
+				ListView_scrollTo(listview, scrollInfo.nTrackPos);
+			break;
+	}
+}
 
+/* Paints the rows of a TreeView in its update region, then its WM_PAINT events. Each row is drawn with its background in one call,
+   then its expand box if it has one */
+static void paintTreeView(TreeView treeview){
+	PAINTSTRUCT paintData;
+	RECT clientRect, rowRect;
+	HDC dc;
+	struct _treeNode *currNode;
+	unsigned int node = treeview->topNode;
+	int row, lastRow, x, boxTop;
+
+	dc = BeginPaint(treeview->handle, &paintData);
+	GetClientRect(treeview->handle, &clientRect);
+	SelectObject(dc, GetStockObject(DEFAULT_GUI_FONT));
+	SelectObject(dc, GetStockObject(HOLLOW_BRUSH));
+
+	row = paintData.rcPaint.top / treeview->nodeHeight;
+	lastRow = (paintData.rcPaint.bottom - 1) / treeview->nodeHeight;
+	for (x = 0; x < row && node != TREEVIEW_NO_NODE; x++)
+		node = getNextTreeRow(treeview, node);
+
+	for (; row <= lastRow; row++){
+		SetRect(&rowRect, 0, row * treeview->nodeHeight, clientRect.right, (row + 1) * treeview->nodeHeight);
+		if (node == TREEVIEW_NO_NODE){
+			SetBkColor(dc, GetSysColor(COLOR_WINDOW));
+			ExtTextOutA(dc, 0, rowRect.top, ETO_OPAQUE, &rowRect, "", 0, NULL);
+			continue;
+		}
 
+		currNode = treeview->nodes + node;
+		SetTextColor(dc, GetSysColor(node == treeview->selectedNode ? COLOR_HIGHLIGHTTEXT : COLOR_WINDOWTEXT));
+		SetBkColor(dc, GetSysColor(node == treeview->selectedNode ? COLOR_HIGHLIGHT : COLOR_WINDOW));
+		x = (currNode->depth - 1) * TREEVIEW_INDENT;
+		ExtTextOutA(dc, x + TREEVIEW_INDENT + 2, rowRect.top + 1, ETO_OPAQUE | ETO_CLIPPED, &rowRect, currNode->text,
+					(UINT)strlen(currNode->text), NULL);
+
+		/* The expand box shows a minus when expanded and a plus when collapsed, and stays empty while the children are fetched */
+		if (currNode->flags & TREENODE_HAS_CHILDREN){
+			boxTop = rowRect.top + (treeview->nodeHeight - 9) / 2;
+			Rectangle(dc, x + 4, boxTop, x + 13, boxTop + 9);
+			if (!(currNode->flags & TREENODE_LOADING)){
+				MoveToEx(dc, x + 6, boxTop + 4, NULL);
+				LineTo(dc, x + 11, boxTop + 4);
+				if (!(currNode->flags & TREENODE_EXPANDED)){
+					MoveToEx(dc, x + 8, boxTop + 2, NULL);
+					LineTo(dc, x + 8, boxTop + 7);
+				}
+			}
+		}
 
+		node = getNextTreeRow(treeview, node);
+	}
 
-/* Class MouseEventArgs */
+	treeview->paintContext = dc;
+	handleEvents((GUIObject)treeview, WM_PAINT, (WPARAM)NULL, (LPARAM)NULL);
+	treeview->paintContext = NULL;
 
-void MouseEventArgs_updateValue(EventArgs thisObject, UINT message, WPARAM wParam, LPARAM lParam){
-	initMouseEventArgs((MouseEventArgs)thisObject, message, wParam, lParam);
+	EndPaint(treeview->handle, &paintData);
 }
 
-/* The Constructors*/
-void initMouseEventArgs(MouseEventArgs thisObject, UINT message, WPARAM wParam, LPARAM lParam){
-	if (!thisObject)
-		return;
-
-	initEventArgs((EventArgs)thisObject, message, wParam, lParam);
+/* Scrolls a TreeView on a scroll bar request */
+static void scrollTreeView(TreeView treeview, WORD request){
+	SCROLLINFO scrollInfo;
+	long long topRow = (long long)treeview->topRow, numRows = getTreeViewRows(treeview);
+
+	switch (request){
+		case SB_LINEUP: topRow--; break;
+		case SB_LINEDOWN: topRow++; break;
+		case SB_PAGEUP: topRow -= numRows; break;
+		case SB_PAGEDOWN: topRow += numRows; break;
+		case SB_TOP: topRow = 0; break;
+		case SB_BOTTOM: topRow = UINT_MAX; break;
+		case SB_THUMBTRACK: case SB_THUMBPOSITION:
+			/* The 32-bit track position, the message only carries 16 bits */
+			scrollInfo.cbSize = sizeof(SCROLLINFO);
+			scrollInfo.fMask = SIF_TRACKPOS;
+			if (GetScrollInfo(treeview->handle, SB_VERT, &scrollInfo))
+				topRow = scrollInfo.nTrackPos;
+			break;
+		default:
+			return;
+	}
 
-	thisObject->type = MOUSEEVENTARGS;
+	TreeView_scrollToRow(treeview, topRow > 0 ? (unsigned int)topRow : 0);
+}
 
-	thisObject->cursorX = GET_X_LPARAM(lParam);
-	thisObject->cursorY = GET_Y_LPARAM(lParam);
+/* Expands or collapses the node of a TreeView whose expand box was clicked, or selects the clicked node and calls the node click
+   callback */
+static void clickTreeView(TreeView treeview, LPARAM lParam){
+	unsigned int node = treeview->topNode, prevSelected = treeview->selectedNode;
+	int row, x = GET_X_LPARAM(lParam);
+	RECT rowRect;
 
-	thisObject->updateValue = &MouseEventArgs_updateValue;
-}
+	for (row = GET_Y_LPARAM(lParam) / treeview->nodeHeight; row > 0 && node != TREEVIEW_NO_NODE; row--)
+		node = getNextTreeRow(treeview, node);
+	if (node == TREEVIEW_NO_NODE)
+		return;
 
-MouseEventArgs newMouseEventArgs(UINT message, WPARAM wParam, LPARAM lParam){
-	MouseEventArgs thisObject = (MouseEventArgs)malloc(sizeof(val_MouseEventArgs));
-	if (!thisObject)
-		return NULL;
+	x -= ((treeview->nodes)[node].depth - 1) * TREEVIEW_INDENT;
+	if (x >= 0 && x < TREEVIEW_INDENT && ((treeview->nodes)[node].flags & TREENODE_HAS_CHILDREN)){
+		TreeView_expandNode(treeview, node, !((treeview->nodes)[node].flags & TREENODE_EXPANDED));
+		return;
+	}
 
-	initMouseEventArgs(thisObject, message, wParam, lParam);
+	/* Repaint the rows of the old and the new selection */
+	treeview->selectedNode = node;
+	GetClientRect(treeview->handle, &rowRect);
+	rowRect.top = (GET_Y_LPARAM(lParam) / treeview->nodeHeight) * treeview->nodeHeight;
+	rowRect.bottom = rowRect.top + treeview->nodeHeight;
+	InvalidateRect(treeview->handle, &rowRect, FALSE);
+	if (prevSelected != node)
+		for (node = treeview->topNode, row = 0; node != TREEVIEW_NO_NODE && row <= (int)getTreeViewRows(treeview); row++){
+			if (node == prevSelected){
+				rowRect.top = row * treeview->nodeHeight;
+				rowRect.bottom = rowRect.top + treeview->nodeHeight;
+				InvalidateRect(treeview->handle, &rowRect, FALSE);
+				break;
+			}
+			node = getNextTreeRow(treeview, node);
+		}
 
-	return thisObject;
+	if (treeview->onNodeClick)
+		treeview->onNodeClick(treeview, treeview->nodeClickContext, treeview->selectedNode);
 }
 
-/* The Destructor*/
-void deleteMouseEventArgs(MouseEventArgs mouseeventargs){
-	DeleteCriticalSection(&(mouseeventargs->criticalSection));
-	free(mouseeventargs);
-}
+/* Scrolls a ScrollPanel on a request from one of its scroll bars */
+static void scrollScrollPanel(ScrollPanel scrollpanel, int bar, WORD request){
+	SCROLLINFO scrollInfo;
+	RECT clientRect;
+	int pos = bar == SB_HORZ ? scrollpanel->scrollX : scrollpanel->scrollY, page;
+
+	GetClientRect(scrollpanel->handle, &clientRect);
+	page = bar == SB_HORZ ? clientRect.right : clientRect.bottom;
+
+	switch (request){
+		case SB_LINEUP: pos -= SCROLLPANEL_LINE; break;
+		case SB_LINEDOWN: pos += SCROLLPANEL_LINE; break;
+		case SB_PAGEUP: pos -= page; break;
+		case SB_PAGEDOWN: pos += page; break;
+		case SB_TOP: pos = 0; break;
+		case SB_BOTTOM: pos = INT_MAX; break;
+		case SB_THUMBTRACK: case SB_THUMBPOSITION:
+			/* The 32-bit track position, the message only carries 16 bits */
+			scrollInfo.cbSize = sizeof(SCROLLINFO);
+			scrollInfo.fMask = SIF_TRACKPOS;
+			if (GetScrollInfo(scrollpanel->handle, bar, &scrollInfo))
+				pos = scrollInfo.nTrackPos;
+			break;
+		default:
+			return;
+	}
 
+	if (bar == SB_HORZ)
+		ScrollPanel_scrollContentTo(scrollpanel, pos, scrollpanel->scrollY);
+	else
+		ScrollPanel_scrollContentTo(scrollpanel, scrollpanel->scrollX, pos);
+}
 
+/* The number of windows created for GUIObjects since the program started */
+static volatile LONG numRealizations = 0;
 
+/* Creates the Unicode window of a GUIObject, which takes the GUIObject's text in UTF-16 */
+static HWND createObjectWindow(GUIObject object, int x, int y, HWND parent, HMENU ID){
+	WCHAR wideClassName[32], *wideText;
 
+	wideText = getWideText(object);
+	if (!wideText || !MultiByteToWideChar(CP_UTF8, 0, object->className, -1, wideClassName, sizeof(wideClassName) / sizeof(WCHAR)))
+		return NULL;
 
-/* Class Pen */
+	return CreateWindowExW(object->exStyles, wideClassName, object->text ? wideText : NULL, object->styles, x, y, object->width,
+							object->height, parent, ID, object->moduleInstance, NULL);
+}
 
-/* The Constructors*/
-void initPen(Pen thisObject, int penStyle, int width, COLORREF color){
-	if (!thisObject)
-		return;
+/* Creates a control's window on its parent's. Unless paint is set, the control is not painted right away, nor is its parent: the
+   caller paints them all once it has created the windows of a whole subtree. A control that was already realized, or is being
+   realized, keeps its window */
+static BOOL realizeControl(Control control, BOOL paint){
+	RECT clientRect;
+	int scrollX, scrollY;
+
+	/* Windowless controls are only painted by their host. The children of windowless controls are windowless too */
+	if (control->windowless || (control->parent && control->parent->windowless)){
+		if (!control->windowless && !GUIObject_setWindowless((GUIObject)control, TRUE))
+			return FALSE;
+		getLayoutSize((GUIObject)control, &(control->layoutWidth), &(control->layoutHeight));
+		control->realizeState = REALIZED;
+		return invalidateWindowless((GUIObject)control);
+	}
 
-	initObject((Object)thisObject);
+	if (control->realizeState != UNREALIZED)
+		return TRUE;
 
-	thisObject->type = PEN;
+	/* A child control whose parent has no window yet, like a control on a TabContainer page that wasn't shown yet, gets its window
+	   along with its parent's */
+	if ((control->styles & WS_CHILD) && control->parent && !control->parent->handle)
+		return TRUE;
+	control->realizeState = REALIZING;
 
-	thisObject->penStyle = penStyle;
-	thisObject->width = width;
-	thisObject->color = color;
+	/* Add the control */
+	if (control->type == TEXTBOX)
+		TextBox_getText((TextBox)control); /* The text field may be behind the edits made before the TextBox got a window */
+	getScrollOffset(control->parent, &scrollX, &scrollY);
+	control->handle = createObjectWindow((GUIObject)control, control->x - scrollX, control->y - scrollY,
+		(control->parent) ? (control->parent)->handle : NULL, control->ID);
+
+	if (!control->handle){
+		control->realizeState = UNREALIZED;
+		return FALSE;
+	}
+	InterlockedIncrement(&numRealizations);
 
-	if (thisObject->handle)
-		DeleteObject(thisObject->handle);
-	thisObject->handle = CreatePen(penStyle, width, color);
-}
+	/* The children are aligned relative to the size the control has when it is displayed */
+	if (control->type == WINDOW && GetClientRect(control->handle, &clientRect)){
+		((Window)control)->clientWidth = clientRect.right - clientRect.left;
+		((Window)control)->clientHeight = clientRect.bottom - clientRect.top;
+	}
+	getLayoutSize((GUIObject)control, &(control->layoutWidth), &(control->layoutHeight));
+
+	/* A ListView's rows are displayed with its other children, it only needs its scroll bar set up for its viewport */
+	if (control->type == LISTVIEW)
+		updateListRows((ListView)control);
+	/* A LogView's scroll bar is set up for the lines appended before it was displayed */
+	if (control->type == LOGVIEW)
+		updateLogView((LogView)control, ((LogView)control)->topLine);
+	/* So is a TreeView's, for the nodes fetched before it was displayed */
+	if (control->type == TREEVIEW){
+		addTreeFetches((TreeView)control);
+		updateTreeView((TreeView)control, ((TreeView)control)->topRow, TRUE);
+	}
+	/* And a ScrollPanel's scroll bars, for its content size */
+	if (control->type == SCROLLPANEL)
+		ScrollPanel_scrollContentTo((ScrollPanel)control, ((ScrollPanel)control)->scrollX, ((ScrollPanel)control)->scrollY);
 
-Pen newPen(int penStyle, int width, COLORREF color){
-	Pen thisObject = (Pen)malloc(sizeof(val_Pen));
+	/* Change its font */
+	//TODO: make the font a property of the Object type!
+	SendMessageA(control->handle, WM_SETFONT, (WPARAM)GetStockObject(DEFAULT_GUI_FONT), paint);
+		
+	/* Set the control handle's additional data to a pointer to its object */
+	SetWindowLongPtrA(control->handle, GWLP_USERDATA, (LONG)control);
 
-	if (!thisObject)
-		return NULL;
+	/* Subclass the control to make it send its messages through the main window proc, keeping its window Unicode */
+	control->origProcPtr = SetWindowLongPtrW(control->handle, GWLP_WNDPROC, (LONG_PTR)windowProc);
+	control->realizeState = REALIZED; /* The window is there even if it couldn't be subclassed, it isn't created again */
+	if (!control->origProcPtr)
+		return FALSE;
 
-	initPen(thisObject, penStyle, width, color);
+	ShowWindow(control->handle, SW_SHOWDEFAULT);
+	EnableWindow(control->handle, control->enabled);
+	if (paint){
+		UpdateWindow(control->handle);
+		if (control->parent)
+			UpdateWindow(control->parent->handle);
+	}
 
-	return thisObject;
+	return TRUE;
 }
 
-/* The Destructor*/
-void deletePen(Pen pen){
-	DeleteObject(pen->handle);
-	DeleteCriticalSection(&(pen->criticalSection));
-	free(pen);
+/* Display a control on a window */
+BOOL displayControl(Control control){
+	return realizeControl(control, TRUE);
 }
 
+/* Displays a control along with all its descendants. Its parent's redrawing is turned off while their windows are created, then
+   the parent is painted once with all of them, instead of once per control */
+BOOL displayControlTree(Control control){
+	HWND parentHandle;
+	BOOL result;
 
+	if (!control)
+		return FALSE;
 
+	parentHandle = control->parent && !control->windowless ? control->parent->handle : NULL;
+	if (parentHandle)
+		SendMessageA(parentHandle, WM_SETREDRAW, FALSE, 0);
 
+	result = realizeControl(control, FALSE);
+	if (result)
+		displayChildren((GUIObject)control);
 
-/* Class Brush */
+	if (parentHandle){
+		SendMessageA(parentHandle, WM_SETREDRAW, TRUE, 0);
+		RedrawWindow(parentHandle, NULL, NULL, RDW_ERASE | RDW_FRAME | RDW_INVALIDATE | RDW_ALLCHILDREN | RDW_UPDATENOW);
+	} else if (control->handle)
+		RedrawWindow(control->handle, NULL, NULL, RDW_ERASE | RDW_FRAME | RDW_INVALIDATE | RDW_ALLCHILDREN | RDW_UPDATENOW);
 
-/* The Constructors*/
-void initBrush(Brush thisObject, UINT brushStyle, COLORREF color, ULONG_PTR hatch){
-	LOGBRUSH brushInfo;
+	return result;
+}
 
-	if (!thisObject)
-		return;
+/* Go through a GUIObject's list of children and add all of them to the window, then call itself on each of the children. The
+   windows aren't painted one by one, the caller paints the whole subtree once. The subtrees of children that were already realized
+   are skipped, the children added to them since were realized as they were added */
+static void displayChildren(GUIObject object){
+	unsigned int i;
 
-	initObject((Object)thisObject);
+	/* Only the shown page of a TabContainer gets its windows, the other pages when they are first shown */
+	if (object && object->type == TABCONTAINER){
+		if (((TabContainer)object)->activePage != TABCONTAINER_NO_PAGE)
+			showTabPage((TabContainer)object, ((TabContainer)object)->activePage);
+		return;
+	}
 
-	thisObject->type = BRUSH;
+	if (object)
+		for (i = 0; i < object->numChildren; i++)
+			if ((object->children)[i] != NULL && (object->children)[i]->realizeState == UNREALIZED){
+				realizeControl((Control)(object->children)[i], FALSE);
+				displayChildren((object->children)[i]);
+			}
+}
 
-	thisObject->brushStyle = brushStyle; brushInfo.lbStyle = brushStyle;
-	thisObject->color = color; brushInfo.lbColor = color;
-	thisObject->hatch = hatch; brushInfo.lbHatch = hatch;
+/* Returns the number of windows created for GUIObjects so far. Each GUIObject's window is created once, when it is realized, and
+   again only after it was destroyed, like the windows of a hibernated TabContainer page */
+LONG getRealizationCount(){
+	return numRealizations;
+}
 
-	if (thisObject->handle)
-		DeleteObject(thisObject->handle);
 
-	thisObject->handle = CreateBrushIndirect(&brushInfo);
-}
+/* Forgets the windows of a GUIObject and its descendants after they were destroyed, along with their offscreen buffers. The
+   GUIObjects keep their state, and get new windows when they are displayed again */
+static void forgetWindows(GUIObject object){
+	unsigned int i;
 
-Brush newBrush(UINT brushStyle, COLORREF color, ULONG_PTR hatch){
-	Brush thisObject = (Brush)malloc(sizeof(val_Brush));
+	for (i = 0; i < object->numChildren; i++)
+		if ((object->children)[i] != NULL)
+			forgetWindows((object->children)[i]);
 
-	if (!thisObject)
-		return NULL;
+	object->realizeState = UNREALIZED;
+	if (object->windowless)
+		return; /* Only ever drawn into its host's buffer */
 
-	initBrush(thisObject, brushStyle, color, hatch);
+	if (object->paintState && object->paintState->offscreenBitmap){
+		DeleteObject(object->paintState->offscreenBitmap);
+		object->paintState->offscreenBitmap = NULL;
+	}
+	if (object->offscreenPaintContext){
+		DeleteDC(object->offscreenPaintContext);
+		object->offscreenPaintContext = NULL;
+	}
 
-	return thisObject;
-}
+	object->handle = NULL;
+	object->origProcPtr = 0;
+	object->windowlessCapture = object->windowlessFocus = NULL;
 
-/* The Destructor*/
-void deleteBrush(Brush brush){
-	DeleteObject(brush->handle);
-	DeleteCriticalSection(&(brush->criticalSection));
-	free(brush);
+	/* A repaint message posted to the old window never arrives */
+	if (object->type == IMAGEVIEW){
+		InterlockedExchange(&(((ImageView)object)->updatePending), FALSE);
+		((ImageView)object)->dragging = FALSE;
+	}
 }
 
+/* Shows a page of a TabContainer, creating its windows if it has none */
+static BOOL showTabPage(TabContainer tabcontainer, unsigned int page){
+	Control control = (tabcontainer->pages)[page].control;
 
+	if (control->handle){
+		ShowWindow(control->handle, SW_SHOW);
+		return TRUE;
+	}
 
+	/* A TabContainer that isn't visible yet, like one being displayed with its window, is painted along with it */
+	if (IsWindowVisible(tabcontainer->handle))
+		return displayControlTree(control);
 
+	if (!realizeControl(control, FALSE))
+		return FALSE;
+	displayChildren((GUIObject)control);
 
-/* WinAPI Call Functions */
-
-/* Event handling */
-/* The common asynchronous event callback function */
-static DWORD WINAPI asyncEventProc(LPVOID event){
-	struct _event *eventPointer = (struct _event*)event;
-	eventPointer->eventFunction(eventPointer->sender, eventPointer->context, eventPointer->args);
 	return TRUE;
 }
 
-/* Find and fire off an event for a GUIObject */
-static int handleEvents(GUIObject currObject, UINT messageID, WPARAM wParam, LPARAM lParam){
+/* Sets a TabContainer's timer to go off when its next hidden page is due to be hibernated, or stops it if none is */
+static void scheduleHibernation(TabContainer tabcontainer){
+	DWORD now = GetTickCount(), elapsed, wait = INFINITE;
 	unsigned int i;
-	BOOL condition = TRUE;
 
-	for (i = 0; i < currObject->numEvents; i++){
-		if  ((currObject->events)[i].message == messageID && (currObject->events)[i].eventFunction != NULL){
-			if ((currObject->events)[i].condition)
-				condition = *((currObject->events)[i].condition);
-
-			if ((currObject->events)[i].enabled && condition && (currObject->events)[i].eventFunction){
-				EnterCriticalSection(&((currObject->events)[i].args->criticalSection));
-				(currObject->events)[i].args->updateValue((currObject->events)[i].args, messageID, wParam, lParam); /* Update the event args */
-				LeaveCriticalSection(&((currObject->events)[i].args->criticalSection));
-
-				if ((currObject->events)[i].mode == SYNC){
-					((currObject->events)[i].eventFunction)((currObject->events)[i].sender,
-															(currObject->events)[i].context, (currObject->events)[i].args);
-				} else
-					CreateThread(NULL, 0, asyncEventProc, (LPVOID)&(currObject->events)[i], 0, NULL);
+	if (tabcontainer->hibernateDelay != INFINITE)
+		for (i = 0; i < tabcontainer->numPages; i++)
+			if (i != tabcontainer->activePage && (tabcontainer->pages)[i].control->handle){
+				elapsed = now - (tabcontainer->pages)[i].hiddenSince;
+				if (elapsed >= tabcontainer->hibernateDelay)
+					wait = 0;
+				else if (tabcontainer->hibernateDelay - elapsed < wait)
+					wait = tabcontainer->hibernateDelay - elapsed;
 			}
 
-			return (int)i;
+	if (wait == INFINITE)
+		KillTimer(tabcontainer->handle, TABCONTAINER_TIMER);
+	else
+		SetTimer(tabcontainer->handle, TABCONTAINER_TIMER, wait ? wait : 1, NULL);
+}
+
+/* Hibernates the pages of a TabContainer that were hidden for longer than its hibernateDelay: their windows are destroyed, and
+   created again when they are shown */
+static void hibernateTabPages(TabContainer tabcontainer){
+	DWORD now = GetTickCount();
+	Control control;
+	unsigned int i;
+
+	for (i = 0; i < tabcontainer->numPages; i++){
+		control = (tabcontainer->pages)[i].control;
+		if (i != tabcontainer->activePage && control->handle && tabcontainer->hibernateDelay != INFINITE &&
+				now - (tabcontainer->pages)[i].hiddenSince >= tabcontainer->hibernateDelay){
+			DestroyWindow(control->handle); /* Along with the windows of the controls on the page */
+			forgetWindows((GUIObject)control);
 		}
 	}
 
-	return -1;
+	scheduleHibernation(tabcontainer);
 }
 
-/* The event handling routine for WM_COMMAND type events for window controls */
-static int commandEventHandler(HWND hwnd, WPARAM wParam, LPARAM lParam){
-	UINT itemID = LOWORD(wParam), messageID = HIWORD(wParam);
-	GUIObject currObject = (GUIObject)GetWindowLongPtrA((HWND)lParam, GWLP_USERDATA);
-	char *controlText = NULL;
-	int textLength = 0;
-	
-	if (currObject){
-		if (messageID == EN_CHANGE){ /* Text in a textbox was changed by the user */
-			textLength = GetWindowTextLengthA(currObject->handle);
-			if (textLength > 0 && (controlText = (char*)malloc(textLength + 1))){
-				if (GetWindowTextA(currObject->handle, controlText, textLength + 1) > 0){
-					free(currObject->text);
-					currObject->text = controlText;
-				}
-			}
-		}
-
-		return handleEvents(currObject, messageID, wParam, lParam);
-	} else
-		return -1;
+/* Deletes a GUIObject with the destructor of its class */
+static void deleteGUIObjectOfType(GUIObject object){
+	switch (object->type){
+		case WINDOW: case DIALOG: deleteWindow((Window)object); break;
+		case CONTROL: deleteControl((Control)object); break;
+		case BUTTON: deleteButton((Button)object); break;
+		case LABEL: deleteLabel((Label)object); break;
+		case TEXTBOX: deleteTextBox((TextBox)object); break;
+		case LISTVIEW: deleteListView((ListView)object); break;
+		case PLOT: deletePlot((Plot)object); break;
+		case LOGVIEW: deleteLogView((LogView)object); break;
+		case IMAGEVIEW: deleteImageView((ImageView)object); break;
+		case TREEVIEW: deleteTreeView((TreeView)object); break;
+		case TABCONTAINER: deleteTabContainer((TabContainer)object); break;
+		case SCROLLPANEL: deleteScrollPanel((ScrollPanel)object); break;
+		default: deleteGUIObject(object);
+	}
 }
 
-/*FIELD VALUES CONSISTENCY SUPPORT ON REFRESH*/
-/* Resizes and/or moves the children of a window or a control according to their anchor settings */
-BOOL alignChildren(GUIObject object, int widthChange, int heightChange){
+/* Deletes the descendants of a GUIObject that is being deleted, deepest first. They aren't detached from their parents one by one */
+static void deleteDescendants(GUIObject object){
+	GUIObject currChild;
 	unsigned int i;
-	Control currChild;
-	int controlWidthChange = 0, controlHeightChange = 0;
-
-	if (!object)
-		return FALSE;
 
 	for (i = 0; i < object->numChildren; i++){
-		if ((object->children)[i] != NULL){
-			currChild = (Control)(object->children)[i];
-			InvalidateRect(currChild->handle, NULL, FALSE);
-
-			if (((currChild->anchor & 0xF000) && (currChild->anchor & 0x000F)) ||
-					((currChild->anchor & 0x0F00) && (currChild->anchor & 0x00F0))){ /* Anchored top and bottom and/or left and right */
-				if ((currChild->anchor & 0xF000) && (currChild->anchor & 0x000F)) /* Anchored left and right */
-					controlWidthChange = widthChange;
-
-				if ((currChild->anchor & 0x0F00) && (currChild->anchor & 0x00F0)) /* Anchored top and bottom */
-					controlHeightChange = heightChange;
-
-				EnterCriticalSection(&(currChild->criticalSection));
-				GUIObject_setSize((object->children)[i], currChild->realWidth + controlWidthChange, currChild->realHeight + controlHeightChange);
-				LeaveCriticalSection(&(currChild->criticalSection));
-
-				if (currChild->numChildren != 0)
-					if (!alignChildren((object->children)[i], controlWidthChange, controlHeightChange))
-						return FALSE;
-			} 
-			
-			if ((!(currChild->anchor & 0xF000) && (currChild->anchor & 0x000F)) || 
-						(!(currChild->anchor & 0x0F00) && (currChild->anchor & 0x00F0))){ /* Anchored right but not left and/or bottom but not top */
-				EnterCriticalSection(&(currChild->criticalSection));
-				Control_setPos((object->children)[i], currChild->realX + widthChange, currChild->realY + heightChange);
-				LeaveCriticalSection(&(currChild->criticalSection)); 
-			}
+		currChild = (object->children)[i];
+		if (currChild == NULL)
+			continue;
 
-			/* Not anchored left or right */
-			if (!(currChild->anchor & 0xF000) && !(currChild->anchor & 0x000F)){
-				EnterCriticalSection(&(currChild->criticalSection)); EnterCriticalSection(&((currChild->parent)->criticalSection));
-				Control_setPos((object->children)[i], currChild->realX + (currChild->parent)->width / 2 - ((currChild->parent)->width - widthChange) / 2, 
-							currChild->realY);
-				LeaveCriticalSection(&(currChild->criticalSection)); LeaveCriticalSection(&((currChild->parent)->criticalSection));
-			}
+		deleteDescendants(currChild);
+		if (object->type == LISTVIEW || object->type == TABCONTAINER)
+			continue; /* Its rows and pages are deleted with it */
 
-			/* Not anchored top or bottom */
-			if  (!(currChild->anchor & 0x0F00) && !(currChild->anchor & 0x00F0)) {
-				EnterCriticalSection(&(currChild->criticalSection)); EnterCriticalSection(&((currChild->parent)->criticalSection));
-				Control_setPos((object->children)[i], currChild->realX, 
-							currChild->realY + (currChild->parent)->height / 2 - ((currChild->parent)->height - heightChange) / 2);
-				LeaveCriticalSection(&(currChild->criticalSection)); LeaveCriticalSection(&((currChild->parent)->criticalSection));
-			}
-		}
+		(object->children)[i] = NULL;
+		currChild->parent = NULL;
+		deleteGUIObjectOfType(currChild);
 	}
-
-	return TRUE;
 }
 
-/* Sets the current window's width, height and clientWidth and clientHeight on user resize. Thread-safe */
-static void refreshWindowSize(Window window, LPARAM lParam){
-	RECT clientSize;
-	WINDOWPOS *windowPos;
-	int widthChange = 0, heightChange = 0;
+/* Deletes a GUIObject along with all its descendants. Their windows are destroyed with the GUIObject's own window, in one call. When
+   the tree was built in an arena of its own (see useArena), deleting the arena afterwards releases all its memory at once */
+void deleteGUIObjectTree(GUIObject root){
+	if (!root)
+		return;
 
-	EnterCriticalSection(&(window->criticalSection));
+	if (root->handle){
+		DestroyWindow(root->handle); /* Along with the windows of its descendants */
+		forgetWindows(root);
+	}
 
-	windowPos = (WINDOWPOS*)lParam;
-	window->width = windowPos->cx;
-	window->height = windowPos->cy;
-	window->x = windowPos->x;
-	window->y = windowPos->y;
+	deleteDescendants(root);
+	deleteGUIObjectOfType(root);
+}
 
-	if (GetClientRect(window->handle, &clientSize)){
-		widthChange = clientSize.right - clientSize.left - window->clientWidth;
-		heightChange = clientSize.bottom - clientSize.top - window->clientHeight;
+/* UI files */
+/* Builds the GUIObject of a UI file's object record. The text is only copied for TextBoxes, which edit it, the caller points the
+   other GUIObjects' texts into the file. Returns NULL on failure */
+static GUIObject newUIObject(HINSTANCE instance, const struct _uiObjectRecord *record, const char *text){
+	switch (record->type){
+		case UI_WINDOW: return (GUIObject)newWindow(instance, NULL, record->width, record->height);
+		case UI_BUTTON: return (GUIObject)newButton(instance, NULL, record->x, record->y, record->width, record->height);
+		case UI_LABEL: return (GUIObject)newLabel(instance, NULL, record->x, record->y, record->width, record->height);
+		case UI_TEXTBOX:
+			return (GUIObject)newTextBox(instance, (char*)text, record->x, record->y, record->width, record->height,
+										(record->flags & UI_FLAG_MULTILINE) ? MULTILINE : SINGLELINE);
+		case UI_LISTVIEW: return (GUIObject)newListView(instance, record->x, record->y, record->width, record->height);
+		case UI_PLOT: return (GUIObject)newPlot(instance, record->x, record->y, record->width, record->height);
+		case UI_LOGVIEW: return (GUIObject)newLogView(instance, record->x, record->y, record->width, record->height);
+		case UI_IMAGEVIEW: return (GUIObject)newImageView(instance, record->x, record->y, record->width, record->height);
+		case UI_TREEVIEW: return (GUIObject)newTreeView(instance, record->x, record->y, record->width, record->height);
+		case UI_SCROLLPANEL: return (GUIObject)newScrollPanel(instance, record->x, record->y, record->width, record->height);
+		default: return NULL;
+	}
+}
 
-		window->clientWidth = clientSize.right - clientSize.left;
-		window->clientHeight = clientSize.bottom - clientSize.top;
+/* Applies the anchor and the flags of a UI file's object record to its GUIObject */
+static void applyUIRecord(GUIObject object, const struct _uiObjectRecord *record){
+	if (record->anchor && object->type != WINDOW)
+		((Control)object)->anchor = (short)(((record->anchor & UI_ANCHOR_LEFT) ? ANCHOR_LEFT : 0) |
+											((record->anchor & UI_ANCHOR_TOP) ? ANCHOR_TOP : 0) |
+											((record->anchor & UI_ANCHOR_RIGHT) ? ANCHOR_RIGHT : 0) |
+											((record->anchor & UI_ANCHOR_BOTTOM) ? ANCHOR_BOTTOM : 0));
+
+	if (record->flags & UI_FLAG_DISABLED)
+		GUIObject_setEnabled(object, FALSE);
+	if (object->type == TEXTBOX && (record->flags & UI_FLAG_NUMONLY))
+		TextBox_setNumOnly((TextBox)object, TRUE);
+	if (object->type == WINDOW && (record->flags & UI_FLAG_FIXEDSIZE)){
+		Window_setResizable((Window)object, FALSE);
+		Window_enableMaximize((Window)object, FALSE);
 	}
+}
 
-	InvalidateRect(window->handle, NULL, FALSE);
+/* Loads a UI file compiled by uic. The file is memory-mapped and its GUIObject trees are built in one pass, in an arena of their own,
+   with the texts pointing into the mapped file. The events are bound to the handlers of the same names. Returns NULL if the file can't
+   be read, is invalid or names a handler that isn't given */
+UIFile loadUIFile(HINSTANCE instance, const char *path, const struct _uiHandler *handlers, unsigned int numHandlers){
+	const struct _uiFileHeader *header;
+	const struct _uiObjectRecord *record;
+	const struct _uiEventRecord *events;
+	LARGE_INTEGER fileSize;
+	UIFile uiFile;
+	GUIObject object;
+	Arena prevArena;
+	unsigned int i, j;
+
+	uiFile = (UIFile)calloc(1, sizeof(struct _uiFile));
+	if (!uiFile)
+		return NULL;
+
+	uiFile->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (uiFile->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(uiFile->file, &fileSize) ||
+			(unsigned long long)fileSize.QuadPart < sizeof(struct _uiFileHeader))
+		goto load_failed;
+
+	uiFile->mapping = CreateFileMappingA(uiFile->file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!uiFile->mapping)
+		goto load_failed;
+	uiFile->view = (const char*)MapViewOfFile(uiFile->mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!uiFile->view)
+		goto load_failed;
+
+	/* Check the header against the file size, so that the records and the strings they refer to can be trusted to be in the file */
+	header = (const struct _uiFileHeader*)uiFile->view;
+	if (header->magic != UI_MAGIC || header->version != UI_VERSION || !header->stringsSize ||
+			(unsigned long long)fileSize.QuadPart != sizeof(struct _uiFileHeader) +
+			(unsigned long long)header->numObjects * sizeof(struct _uiObjectRecord) +
+			(unsigned long long)header->numEvents * sizeof(struct _uiEventRecord) + header->stringsSize)
+		goto load_failed;
+
+	uiFile->records = (const struct _uiObjectRecord*)(header + 1);
+	events = (const struct _uiEventRecord*)(uiFile->records + header->numObjects);
+	uiFile->strings = (const char*)(events + header->numEvents);
+	if (uiFile->strings[header->stringsSize - 1] != '\0') /* Every string ends inside the pool */
+		goto load_failed;
+
+	uiFile->objects = (GUIObject*)malloc((header->numObjects ? header->numObjects : 1) * sizeof(GUIObject));
+	uiFile->arena = newArena(0);
+	if (!uiFile->objects || !uiFile->arena)
+		goto load_failed;
+
+	/* Build the objects, each one is added to its parent, which comes before it */
+	prevArena = useArena(uiFile->arena);
+	for (i = 0; i < header->numObjects; i++){
+		record = &((uiFile->records)[i]);
+		if ((record->parent != UI_NO_PARENT && record->parent >= i) || record->text >= header->stringsSize ||
+				record->name >= header->stringsSize)
+			break;
+
+		object = newUIObject(instance, record, uiFile->strings + record->text);
+		if (!object)
+			break;
+		(uiFile->objects)[i] = object;
+		uiFile->numObjects = i + 1;
+
+		if (record->type == UI_WINDOW || record->type == UI_BUTTON || record->type == UI_LABEL)
+			borrowText(object, uiFile->strings + record->text, (unsigned int)strlen(uiFile->strings + record->text));
+		applyUIRecord(object, record);
 
-	LeaveCriticalSection(&(window->criticalSection));
+		if (record->parent != UI_NO_PARENT && !GUIObject_addChild((uiFile->objects)[record->parent], object))
+			break;
+	}
+	useArena(prevArena);
+	if (i < header->numObjects)
+		goto load_failed;
+
+	/* Bind the events */
+	for (i = 0; i < header->numEvents; i++){
+		if (events[i].object >= header->numObjects || events[i].handler >= header->stringsSize)
+			goto load_failed;
+
+		for (j = 0; j < numHandlers && strcmp(handlers[j].name, uiFile->strings + events[i].handler); j++);
+		if (j == numHandlers || GUIObject_setEvent((uiFile->objects)[events[i].object], events[i].message, handlers[j].callback,
+													handlers[j].context, handlers[j].mode) < 0)
+			goto load_failed;
+	}
+
+	return uiFile;
 
-	alignChildren((GUIObject)window, widthChange, heightChange);
+	load_failed: deleteUIFile(uiFile);
+	return NULL;
 }
 
-/* Display a control on a window */
-BOOL displayControl(Control control){
-	HFONT hFont;
-	LOGFONT lf;
+/* Gets the GUIObject of a loaded UI file by its name, NULL if there is none */
+GUIObject UIFile_getObject(UIFile uiFile, const char *name){
+	unsigned int i;
 
-	/* Add the control */
-	control->handle = CreateWindowExA(control->exStyles, control->className, control->text, control->styles, control->x, control->y,
-		control->width, control->height, (control->parent) ? (control->parent)->handle : NULL, control->ID, control->moduleInstance, NULL);
+	for (i = 0; i < uiFile->numObjects; i++)
+		if ((uiFile->records)[i].name && !strcmp(uiFile->strings + (uiFile->records)[i].name, name))
+			return (uiFile->objects)[i];
 
-	if (!control->handle)
-		return FALSE;
+	return NULL;
+}
 
-	/* Change its font */
-	GetObject(GetStockObject(DEFAULT_GUI_FONT), sizeof(LOGFONT), &lf); 
-	hFont = (HFONT)GetStockObject(DEFAULT_GUI_FONT);//CreateFontW(0, 0, 0, 0, 400, 0, 0, lf.lfStrikeOut, lf.lfCharSet, lf.lfOutPrecision, 
-							//lf.lfClipPrecision, lf.lfQuality, lf.lfPitchAndFamily, lf.lfFaceName);
-	//TODO: make the font a property of the Object type!
-	SendMessageA(control->handle, WM_SETFONT, (WPARAM)hFont, TRUE);
-		
-	/* Set the control handle's additional data to a pointer to its object */
-	SetWindowLongPtrA(control->handle, GWLP_USERDATA, (LONG)control);
+/* Unmaps a deleted UI file and closes it */
+static void releaseUIFileView(void *memory){
+	UIFile uiFile = (UIFile)memory;
+
+	if (uiFile->view)
+		UnmapViewOfFile(uiFile->view);
+	if (uiFile->mapping)
+		CloseHandle(uiFile->mapping);
+	if (uiFile->file && uiFile->file != INVALID_HANDLE_VALUE)
+		CloseHandle(uiFile->file);
+	free(uiFile);
+}
 
-	/* Subclass the control to make it send its messages through the main window proc */
-	control->origProcPtr = SetWindowLongPtrA(control->handle, GWLP_WNDPROC, (LONG_PTR)windowProc);
-	if (!control->origProcPtr)
-		return FALSE;
+/* Deletes the GUIObjects of a loaded UI file, then unmaps the file. The memory of the GUIObjects is released with their arena, once
+   no thread retains them */
+void deleteUIFile(UIFile uiFile){
+	unsigned int i;
 
-	ShowWindow(control->handle, SW_SHOWDEFAULT);
-	
-    UpdateWindow(control->handle);
-	EnableWindow(control->handle, control->enabled);
-	if (control->parent)
-		UpdateWindow(control->parent->handle);
+	if (!uiFile)
+		return;
 
-	return TRUE;
+	/* Only the roots are deleted, along with their descendants. They are picked before any of the GUIObjects is deleted */
+	for (i = 0; i < uiFile->numObjects; i++)
+		if ((uiFile->objects)[i]->parent)
+			(uiFile->objects)[i] = NULL;
+	for (i = 0; i < uiFile->numObjects; i++)
+		if ((uiFile->objects)[i])
+			deleteGUIObjectTree((uiFile->objects)[i]);
+	releaseArena(uiFile->arena);
+	free(uiFile->objects);
+
+	/* A thread inside an epoch may still read a text that pointed into the file */
+	retireMemory(uiFile, releaseUIFileView);
 }
 
-/* Go through a GUIObject's list of children and add all of them to the window, then call itself on each of the children */
-static void displayChildren(GUIObject object){
+/* Paints the tabs of a TabContainer, then its WM_PAINT events. The shown page covers the rest */
+static void paintTabContainer(TabContainer tabcontainer){
+	PAINTSTRUCT paintData;
+	RECT clientRect, rect;
+	HDC dc;
 	unsigned int i;
 
-	if (object)
-		for (i = 0; i < object->numChildren; i++)
-			if ((object->children)[i] != NULL){
-				displayControl((Control)(object->children)[i]);
-				displayChildren((object->children)[i]);
-			}
+	dc = BeginPaint(tabcontainer->handle, &paintData);
+	GetClientRect(tabcontainer->handle, &clientRect);
+	SelectObject(dc, GetStockObject(DEFAULT_GUI_FONT));
+	SetTextColor(dc, GetSysColor(COLOR_BTNTEXT));
+
+	for (i = 0; i < tabcontainer->numPages; i++){
+		SetRect(&rect, (int)i * tabcontainer->tabWidth, 0, (int)(i + 1) * tabcontainer->tabWidth, tabcontainer->tabHeight);
+		SetBkColor(dc, GetSysColor(i == tabcontainer->activePage ? COLOR_WINDOW : COLOR_BTNFACE));
+		ExtTextOutA(dc, rect.left + 6, rect.top + (tabcontainer->tabHeight - 13) / 2, ETO_OPAQUE | ETO_CLIPPED, &rect,
+					(tabcontainer->pages)[i].title, (UINT)strlen((tabcontainer->pages)[i].title), NULL);
+		FrameRect(dc, &rect, GetSysColorBrush(COLOR_BTNSHADOW));
+	}
+
+	/* The rest of the tab strip, and the page area while no page is shown */
+	SetBkColor(dc, GetSysColor(COLOR_BTNFACE));
+	SetRect(&rect, (int)tabcontainer->numPages * tabcontainer->tabWidth, 0, clientRect.right, tabcontainer->tabHeight);
+	ExtTextOutA(dc, 0, 0, ETO_OPAQUE, &rect, "", 0, NULL);
+	SetRect(&rect, 0, tabcontainer->tabHeight, clientRect.right, clientRect.bottom);
+	ExtTextOutA(dc, 0, 0, ETO_OPAQUE, &rect, "", 0, NULL);
+
+	tabcontainer->paintContext = dc;
+	handleEvents((GUIObject)tabcontainer, WM_PAINT, (WPARAM)NULL, (LPARAM)NULL);
+	tabcontainer->paintContext = NULL;
+
+	EndPaint(tabcontainer->handle, &paintData);
 }
 
 
+/* Passes a message on to the default processing of a GUIObject's window: DefWindowProc for windows (and for windows that have no
+   GUIObject yet), the original window procedure for subclassed controls. The W or A version is called for Unicode or ANSI windows */
+static LRESULT callDefaultProc(GUIObject object, HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam){
+	if (!object || object->type == WINDOW)
+		return IsWindowUnicode(hwnd) ? DefWindowProcW(hwnd, msg, wParam, lParam) : DefWindowProcA(hwnd, msg, wParam, lParam);
+
+	return IsWindowUnicode(hwnd) ? CallWindowProcW((WNDPROC)(object->origProcPtr), hwnd, msg, wParam, lParam) :
+									CallWindowProcA((WNDPROC)(object->origProcPtr), hwnd, msg, wParam, lParam);
+}
+
 /* The Window Procedure callback function */
 static LRESULT CALLBACK windowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam){
 	GUIObject currObject = NULL;
 	int eventID = -1;
 	BOOL interrupt = FALSE;
 	LRESULT defCallResult = (LRESULT)NULL;
+	RECT updateRect;
 
 	if (hwnd != NULL)
 		currObject = (GUIObject)GetWindowLongPtrA(hwnd, GWLP_USERDATA); /* Get the object that this handle belongs to */
 
+	/* A TextBox's selection is recorded before the messages that may edit its text, so that the edit can be worked out when the
+	   TextBox reports it */
+	if (currObject && currObject->type == TEXTBOX && currObject->handle && (msg == WM_CHAR || msg == WM_KEYDOWN || msg == WM_PASTE ||
+			msg == WM_CUT || msg == WM_CLEAR || msg == EM_REPLACESEL || msg == WM_IME_CHAR || msg == WM_IME_COMPOSITION)){
+		SendMessageW(hwnd, EM_GETSEL, (WPARAM)&(((TextBox)currObject)->snapshotStart), (LPARAM)NULL);
+		((TextBox)currObject)->snapshotValid = TRUE;
+	}
+
+	/* Input over windowless children goes to them first, the host's own events only get the messages they don't handle */
+	if (currObject && (currObject->numWindowless || currObject->windowlessFocus || currObject->windowlessCapture) &&
+			routeWindowlessInput(currObject, msg, wParam, lParam) >= 0)
+		return 0;
+
+	/* Internal tinyGUI messages, the registered message can't be a case label */
+	if (internalMessage && msg == internalMessage){
+		switch (wParam){
+			case TILES_LOADED: /* Tiles of an ImageView were decoded on the thread pool */
+				if (currObject && currObject->type == IMAGEVIEW){
+					InterlockedExchange(&(((ImageView)currObject)->updatePending), FALSE);
+					InvalidateRect(hwnd, NULL, FALSE);
+				}
+				break;
+
+			case TREE_LOADED: /* Children of a TreeView's nodes were fetched on the thread pool */
+				if (currObject && currObject->type == TREEVIEW)
+					addTreeFetches((TreeView)currObject);
+				break;
+
+			case UPDATE_TEXTBOX: /* The text of a TextBox was changed on another thread */
+				if (currObject && currObject->type == TEXTBOX)
+					updateTextBoxWindow((TextBox)currObject);
+				break;
+
+			case UPDATE_LOG: /* Lines were appended to a LogView, possibly from another thread */
+				if (currObject && currObject->type == LOGVIEW)
+					updateLogView((LogView)currObject, ((LogView)currObject)->topLine);
+				break;
+
+			case UPDATE_LAYOUT: /* Some layouts in the tree were invalidated */
+				if (currObject)
+					updateLayout(currObject);
+				break;
+		}
+		return 0;
+	}
+
 	/* Default event handling */
 	switch(msg){
-		case WM_CREATE:
-			if (currObject)
-				displayChildren(currObject);
-			break;
-
 		case WM_PAINT:
+			if (currObject && currObject->type == PLOT && currObject->handle){ /* A Plot paints itself completely */
+				paintPlot((Plot)currObject);
+				return 0;
+			}
+			if (currObject && currObject->type == LOGVIEW && currObject->handle){ /* So does a LogView */
+				paintLogView((LogView)currObject);
+				return 0;
+			}
+			if (currObject && currObject->type == IMAGEVIEW && currObject->handle){ /* And an ImageView */
+				paintImageView((ImageView)currObject);
+				return 0;
+			}
+			if (currObject && currObject->type == TREEVIEW && currObject->handle){ /* And a TreeView */
+				paintTreeView((TreeView)currObject);
+				return 0;
+			}
+			if (currObject && currObject->type == TABCONTAINER && currObject->handle){ /* And a TabContainer */
+				paintTabContainer((TabContainer)currObject);
+				return 0;
+			}
 			if (currObject){ /* Begin or end painting the object */
+				if (!currObject->numWindowless || !GetUpdateRect(hwnd, &updateRect, FALSE))
+					SetRectEmpty(&updateRect);
+
 				/* We need default paint processing for the control to occur BEFORE we begin painting */
-				if (currObject->type == WINDOW)
-					defCallResult = DefWindowProcA(hwnd, msg, wParam, lParam);
-				else
-					defCallResult = CallWindowProcA((WNDPROC)(currObject->origProcPtr), hwnd, msg, wParam, lParam);
+				defCallResult = callDefaultProc(currObject, hwnd, msg, wParam, lParam);
 
 				if (!currObject->paintContext && currObject->handle)
 					currObject->paintContext = GetDC(currObject->handle);
-				if (!currObject->paintContext)
-					currObject->paintContext = BeginPaint(currObject->handle, &(currObject->paintData));
+				if (!currObject->paintContext && ensurePaintState(currObject))
+					currObject->paintContext = BeginPaint(currObject->handle, &(currObject->paintState->paintData));
 			}
 			break;
 
@@ -1587,20 +6867,85 @@ static LRESULT CALLBACK windowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lP
 
 		case WM_GETMINMAXINFO: /* The window size or position limits are queried */
 			if (currObject){
-				((MINMAXINFO*)lParam)->ptMaxSize.x = currObject->maxWidth;
-				((MINMAXINFO*)lParam)->ptMaxSize.y = currObject->maxHeight;
-				((MINMAXINFO*)lParam)->ptMaxTrackSize.x = currObject->maxWidth;
-				((MINMAXINFO*)lParam)->ptMaxTrackSize.y = currObject->maxHeight;
-				((MINMAXINFO*)lParam)->ptMinTrackSize.x = currObject->minWidth;
-				((MINMAXINFO*)lParam)->ptMinTrackSize.y = currObject->minHeight;
+				((MINMAXINFO*)lParam)->ptMaxSize.x = getLimits(currObject)->maxWidth;
+				((MINMAXINFO*)lParam)->ptMaxSize.y = getLimits(currObject)->maxHeight;
+				((MINMAXINFO*)lParam)->ptMaxTrackSize.x = getLimits(currObject)->maxWidth;
+				((MINMAXINFO*)lParam)->ptMaxTrackSize.y = getLimits(currObject)->maxHeight;
+				((MINMAXINFO*)lParam)->ptMinTrackSize.x = getLimits(currObject)->minWidth;
+				((MINMAXINFO*)lParam)->ptMinTrackSize.y = getLimits(currObject)->minHeight;
 			}
 			break;
 
 		case WM_WINDOWPOSCHANGED: /* The window size or position have just been changed */
-			if (currObject->type == WINDOW)
+			if (currObject && currObject->type == WINDOW)
 				refreshWindowSize((Window)currObject, lParam);
 			break;
 
+		case WM_VSCROLL: /* A ListView's, a LogView's, a TreeView's or a ScrollPanel's scroll bar was used */
+			if (currObject && currObject->type == LISTVIEW)
+				scrollListView((ListView)currObject, LOWORD(wParam));
+			else if (currObject && currObject->type == LOGVIEW)
+				scrollLogView((LogView)currObject, LOWORD(wParam));
+			else if (currObject && currObject->type == TREEVIEW)
+				scrollTreeView((TreeView)currObject, LOWORD(wParam));
+			else if (currObject && currObject->type == SCROLLPANEL)
+				scrollScrollPanel((ScrollPanel)currObject, SB_VERT, LOWORD(wParam));
+			break;
+
+		case WM_HSCROLL: /* A ScrollPanel's horizontal scroll bar was used */
+			if (currObject && currObject->type == SCROLLPANEL)
+				scrollScrollPanel((ScrollPanel)currObject, SB_HORZ, LOWORD(wParam));
+			break;
+
+		case WM_MOUSEWHEEL: /* The mouse wheel was turned over a ListView or one of its rows, a LogView, a TreeView, an ImageView or a
+							   ScrollPanel */
+			if (currObject && currObject->type == LISTVIEW){
+				scrollListViewBy((ListView)currObject,
+									-(long long)GET_WHEEL_DELTA_WPARAM(wParam) * 3 * ((ListView)currObject)->rowHeight / WHEEL_DELTA);
+				return 0;
+			}
+			if (currObject && currObject->type == LOGVIEW){
+				if (GET_WHEEL_DELTA_WPARAM(wParam) > 0)
+					LogView_scrollToLine((LogView)currObject, ((LogView)currObject)->topLine > 3 ? ((LogView)currObject)->topLine - 3 : 0);
+				else
+					LogView_scrollToLine((LogView)currObject, ((LogView)currObject)->topLine + 3);
+				return 0;
+			}
+			if (currObject && currObject->type == TREEVIEW){
+				if (GET_WHEEL_DELTA_WPARAM(wParam) > 0)
+					TreeView_scrollToRow((TreeView)currObject, ((TreeView)currObject)->topRow > 3 ? ((TreeView)currObject)->topRow - 3 : 0);
+				else
+					TreeView_scrollToRow((TreeView)currObject, ((TreeView)currObject)->topRow + 3);
+				return 0;
+			}
+			if (currObject && currObject->type == IMAGEVIEW){
+				handleImageViewMouse((ImageView)currObject, msg, wParam, lParam);
+				return 0;
+			}
+			if (currObject && currObject->type == SCROLLPANEL){
+				ScrollPanel_scrollContentTo((ScrollPanel)currObject, ((ScrollPanel)currObject)->scrollX, ((ScrollPanel)currObject)->scrollY -
+											GET_WHEEL_DELTA_WPARAM(wParam) * 3 * SCROLLPANEL_LINE / WHEEL_DELTA);
+				return 0;
+			}
+			break;
+
+		case WM_LBUTTONDOWN: case WM_MOUSEMOVE: case WM_LBUTTONUP: /* An ImageView is dragged around, a TreeView's node or a tab is clicked */
+			if (currObject && currObject->type == IMAGEVIEW)
+				handleImageViewMouse((ImageView)currObject, msg, wParam, lParam);
+			else if (currObject && currObject->type == TREEVIEW && msg == WM_LBUTTONDOWN)
+				clickTreeView((TreeView)currObject, lParam);
+			else if (currObject && currObject->type == TABCONTAINER && msg == WM_LBUTTONDOWN && GET_X_LPARAM(lParam) >= 0 &&
+						GET_Y_LPARAM(lParam) < ((TabContainer)currObject)->tabHeight) /* A tab is clicked */
+				TabContainer_selectPage((TabContainer)currObject, (unsigned int)(GET_X_LPARAM(lParam) / ((TabContainer)currObject)->tabWidth));
+			break;
+
+		case WM_TIMER: /* Hidden pages of a TabContainer are due to be hibernated */
+			if (currObject && currObject->type == TABCONTAINER && wParam == TABCONTAINER_TIMER){
+				hibernateTabPages((TabContainer)currObject);
+				return 0;
+			}
+			break;
+
         case WM_CLOSE:
             DestroyWindow(hwnd);
 			break;
@@ -1615,8 +6960,12 @@ static LRESULT CALLBACK windowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lP
 		eventID = handleEvents(currObject, msg, wParam, lParam);
 		
 		if (msg == WM_PAINT && currObject->handle) {
-			if (!ReleaseDC(currObject->handle, currObject->paintContext))
-				EndPaint(currObject->handle, &(currObject->paintData));
+			/* Windowless children are painted over the GUIObject's own painting */
+			if (!IsRectEmpty(&updateRect))
+				paintWindowless(currObject, &updateRect, NULL);
+
+			if (!ReleaseDC(currObject->handle, currObject->paintContext) && currObject->paintState)
+				EndPaint(currObject->handle, &(currObject->paintState->paintData));
 			currObject->paintContext = NULL;
 
 			return defCallResult;
@@ -1626,26 +6975,27 @@ static LRESULT CALLBACK windowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lP
 	/* Call the window's events */
 	if (currObject){
 		if (eventID >= 0 && (UINT)eventID < currObject->numEvents)
-			interrupt = (currObject->events)[eventID].interrupt;
+			interrupt = (currObject->events)[eventID]->interrupt;
 
-		if (!interrupt){
-			if (currObject->type == WINDOW)
-				return DefWindowProcA(hwnd, msg, wParam, lParam);
-			else /* Resend the messages to the subclassed object's default window proc */
-				return CallWindowProcA((WNDPROC)(currObject->origProcPtr), hwnd, msg, wParam, lParam);
-		}
+		/* Resend the messages to the window's default processing, the subclassed object's original window proc for controls */
+		if (!interrupt)
+			defCallResult = callDefaultProc(currObject, hwnd, msg, wParam, lParam);
 
-		return 0;
+		/* A TextBox reports its edits while processing them, a selection recorded for one is of no use afterwards */
+		if (currObject->type == TEXTBOX)
+			((TextBox)currObject)->snapshotValid = FALSE;
+
+		return interrupt ? 0 : defCallResult;
 	} else
-		return DefWindowProcA(hwnd, msg, wParam, lParam);
+		return callDefaultProc(NULL, hwnd, msg, wParam, lParam);
 }
 
 /* Flushes the current thread's message queue */
 void flushMessageQueue(){
 	MSG msg;
 
-	while (PeekMessageA(&msg,NULL,0,0,PM_REMOVE))
-		GetMessageA(&msg, NULL, 0, 0);
+	while (PeekMessageW(&msg,NULL,0,0,PM_REMOVE))
+		GetMessageW(&msg, NULL, 0, 0);
 }
 
 /* Display a window with the application's command line settings */
@@ -1653,17 +7003,17 @@ BOOL displayWindow(Window mainWindow, int nCmdShow){
     MSG msg;
 	RECT clientRect;
 
-	mainWindow->handle = CreateWindowExA(mainWindow->exStyles,  mainWindow->className,
-																mainWindow->text,
-																mainWindow->styles,
-																mainWindow->x, mainWindow->y, 
-																mainWindow->width,
-																mainWindow->height,
-																NULL, NULL, 
-																mainWindow->moduleInstance, NULL);
+	if (mainWindow->realizeState != UNREALIZED)
+		return FALSE; /* Already displayed */
 
-	if (!mainWindow->handle)
+	mainWindow->realizeState = REALIZING;
+	mainWindow->handle = createObjectWindow((GUIObject)mainWindow, mainWindow->x, mainWindow->y, NULL, NULL);
+
+	if (!mainWindow->handle){
+		mainWindow->realizeState = UNREALIZED;
 		return FALSE;
+	}
+	InterlockedIncrement(&numRealizations);
 
 	/* Set the window handle's additional data to a pointer to its object */
 	SetWindowLongPtrA(mainWindow->handle, GWLP_USERDATA, (LONG)(mainWindow));
@@ -1672,17 +7022,23 @@ BOOL displayWindow(Window mainWindow, int nCmdShow){
 		mainWindow->clientWidth = clientRect.right - clientRect.left;
 		mainWindow->clientHeight = clientRect.bottom - clientRect.top;
 	}
+	mainWindow->layoutWidth = mainWindow->clientWidth;
+	mainWindow->layoutHeight = mainWindow->clientHeight;
 
+	/* The children are realized in one traversal. Those added while it runs are realized by it, those added later as they are added */
 	displayChildren((GUIObject)mainWindow);
+	mainWindow->realizeState = REALIZED;
+	/* Apply the layouts set up before the window existed, before it is first shown */
+	updateLayout((GUIObject)mainWindow);
 
 	ShowWindow(mainWindow->handle, nCmdShow);
     UpdateWindow(mainWindow->handle);
 	EnableWindow(mainWindow->handle, mainWindow->enabled);
 
     /* The message loop */
-    while(GetMessageA(&msg, NULL, 0, 0) > 0){
+    while(GetMessageW(&msg, NULL, 0, 0) > 0){
         TranslateMessage(&msg);
-        DispatchMessageA(&msg);
+        DispatchMessageW(&msg);
     }
 
     return msg.wParam;
@@ -14,6 +14,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <limits.h>
+#include "tinyLayout.h"
+#include "tinySpatial.h"
+#include "tinyText.h"
+#include "tinyAlloc.h"
+#include "tinyUI.h"
 
 /* Static assertion - produces error with a message at compile time */
 #define STATIC_ASSERT(condition, message) extern char STATIC_ASSERTION__##message[1]; \
@@ -28,8 +34,15 @@
 
 #define METHOD(classType, type, name, args) type classType##_##name args
 
-#define MAKE_VIRTUAL_METHOD(classType, type, name, args) type (*name)args
-#define INIT_VIRTUAL_METHOD(classType, type, name, args) thisObject->name = &classType##_##name
+/* Virtual methods are listed in a class's VTABLE_ macro, in the same order as in its base's. The list makes one static const vtable
+   per class, the instances only keep a pointer to it */
+#define MAKE_VIRTUAL_METHOD(classType, type, name, args) type (*name)args;
+#define INIT_VIRTUAL_METHOD(classType, type, name, args) &classType##_##name,
+
+#define MAKE_VTABLE(type) struct type##_vtable { VTABLE_##type }
+#define MAKE_VTABLE_PROTOTYPE(type, baseType) extern const struct baseType##_vtable type##_vtable
+#define MAKE_VTABLE_INSTANCE(type, baseType) const struct baseType##_vtable type##_vtable = { VTABLE_##type }
+#define VTABLE_FIELD(type) FIELD(const struct type##_vtable*, vtable, &type##_vtable)
 
 /* Determine if the compiler uses the regular struct member alignment logic, otherwise, inheritance won't work */
 struct _ASSERTION_TEST_STRUCT { char a; int b; };
@@ -80,7 +93,7 @@ STATIC_ASSERT(offsetof(struct _ASSERTION_TEST_STRUCT, b) == offsetof(struct _ASS
 
 #define CURR_THIS(type) (struct type##_s*)currThis
 #define MAKE_METHOD_ALIAS(type, method) , type##_##method )
-#define MAKE_VIRTUAL_METHOD_ALIAS(method) ->method )
+#define MAKE_VIRTUAL_METHOD_ALIAS(method) ->vtable->method )
 
 
 
@@ -93,14 +106,62 @@ STATIC_ASSERT(offsetof(struct _ASSERTION_TEST_STRUCT, b) == offsetof(struct _ASS
 #define ANCHOR_TOP 0x0F00
 #define ANCHOR_BOTTOM 0x00F0
 
+/* Layout state macros */
+#define LAYOUT_DIRTY 0x1 /* The GUIObject's geometry or children have changed since the last layout pass */
+#define LAYOUT_SUBTREE_DIRTY 0x2 /* One of the GUIObject's descendants has a dirty layout */
+
+/* Grid track macros, for initializing struct _layoutTrack arrays */
+#define GRID_PX(size) { TRACK_FIXED, (float)(size) } /* A track of a fixed size, in pixels */
+#define GRID_FR(weight) { TRACK_FRACTION, (float)(weight) } /* A share of the free space */
+#define GRID_AUTO { TRACK_AUTO, 0.0f } /* A track sized to its content */
+
+/* Flex basis macro */
+#define FLEX_BASIS_AUTO -1 /* The flex item starts at its own size */
+
+/* ListView macros */
+#define LISTVIEW_PAGE_SIZE 64 /* The number of items a ListView fetches from its data source at once */
+#define LISTVIEW_NUM_PAGES 4 /* The number of fetched pages a ListView keeps, the least recently used one is dropped first */
+#define LISTVIEW_NO_ITEM UINT_MAX /* The item of a row that doesn't show one */
+
+/* Plot macros */
+#define PLOT_LEVEL_FACTOR 8 /* The number of blocks of a Plot's min/max pyramid level that make up a block of the next level */
+#define PLOT_MAX_LEVELS 10 /* The number of pyramid levels, the blocks of the last one are PLOT_LEVEL_FACTOR^PLOT_MAX_LEVELS samples long */
+
+/* LogView macros */
+#define LOGVIEW_DEFAULT_MAX_LINES 10000 /* The number of lines a LogView keeps by default, older lines are dropped */
+
+/* ImageView macros */
+#define IMAGEVIEW_TILE_SIZE 256 /* The width and height of an ImageView's tiles, pixels */
+#define IMAGEVIEW_MAX_LOADING 8 /* The number of tiles an ImageView decodes at once */
+#define IMAGEVIEW_DEFAULT_BUDGET (64 * 1024 * 1024) /* The memory an ImageView's tile cache may use by default, bytes */
+#define IMAGEVIEW_HASH_SIZE 1024 /* The number of buckets of an ImageView's tile cache */
+
+/* TreeView macros */
+#define TREEVIEW_ROOT 0 /* The invisible root node, the parent of a TreeView's top level nodes */
+#define TREEVIEW_NO_NODE UINT_MAX /* A node index that doesn't refer to a node */
+#define TREEVIEW_INDENT 16 /* The indentation of each level of a TreeView, pixels */
+
+/* TabContainer macros */
+#define TABCONTAINER_NO_PAGE UINT_MAX /* The active page of a TabContainer without pages */
+#define TABCONTAINER_DEFAULT_HIBERNATE 60000 /* How long a TabContainer's page stays hidden before its windows are released, ms */
+
+/* ScrollPanel macros */
+#define SCROLLPANEL_LINE 20 /* How far a ScrollPanel scrolls for a click on a scroll bar arrow, pixels */
+
 /* Color macros */
 #define COLOR_RED RGB(0xFF, 0, 0)
 #define COLOR_GREEN RGB(0, 0xFF, 0)
 #define COLOR_BLUE RGB(0, 0, 0xFF)
 
+/* GUIObject macros */
+#define GUIOBJECT_INLINE_TEXT 16 /* The size of the texts (with the terminating null) a GUIObject stores without an allocation, bytes */
+
 /* Synchronize access to current object */
-#define startSync(object) EnterCriticalSection(&(object->criticalSection))
-#define endSync(object) LeaveCriticalSection(&(object->criticalSection))
+#define startSync(object) EnterCriticalSection(getObjectLock((Object)(object)))
+#define endSync(object) LeaveCriticalSection(getObjectLock((Object)(object)))
+
+/* Deferred reclamation */
+#define OBJECT_EPOCH_SLOTS 64 /* The number of threads that can be inside an epoch at once, the next ones wait for a free slot */
 
 
 
@@ -118,6 +179,13 @@ enum _objectType {
 	BUTTON,
 	LABEL,
 	TEXTBOX,
+	LISTVIEW,
+	PLOT,
+	LOGVIEW,
+	IMAGEVIEW,
+	TREEVIEW,
+	TABCONTAINER,
+	SCROLLPANEL,
 	/* Event arg types */
 	EVENTARGS,
 	MOUSEEVENTARGS,
@@ -132,6 +200,13 @@ enum _syncMode {
 	ASYNC
 };
 
+/* The realization state of a GUIObject: whether its window was created */
+enum _realizeState {
+	UNREALIZED, /* No window yet, it is created when the GUIObject's parent is realized or, for a window, when it is displayed */
+	REALIZING, /* The window is being created, a child added to the GUIObject meanwhile is realized along with its other children */
+	REALIZED
+};
+
 /* TextBox multiline/singleline */
 enum _textboxtype {
 	MULTILINE = TRUE,
@@ -152,25 +227,86 @@ MAKE_TYPEDEF(Control);
 MAKE_TYPEDEF(Button);
 MAKE_TYPEDEF(TextBox);
 MAKE_TYPEDEF(Label);
+MAKE_TYPEDEF(ListView);
+MAKE_TYPEDEF(Plot);
+MAKE_TYPEDEF(LogView);
+MAKE_TYPEDEF(ImageView);
+MAKE_TYPEDEF(TreeView);
+MAKE_TYPEDEF(TabContainer);
+MAKE_TYPEDEF(ScrollPanel);
 MAKE_TYPEDEF(Pen);
 MAKE_TYPEDEF(Brush);
 
+/* The rarely used state of a GUIObject, kept out of it until it is needed */
+struct _paintState;
+struct _limits;
+
+/* A registered WinAPI window class */
+struct _windowClass;
+
+/* The geometry of a GUIObject's children in structure-of-arrays form, used internally by the anchor layout pass */
+struct _geometryTable;
+
+/* A page of items fetched from a ListView's data source */
+struct _listPage;
+
+/* A level of a Plot's min/max pyramid */
+struct _plotLevel;
+
+/* An ImageView's tile and its memory-mapped bitmap file */
+struct _imageTile;
+struct _bitmapFile;
+
+/* A node of a TreeView, and the children of a node fetched from its data source */
+struct _treeNode;
+struct _treeFetch;
+
+/* A page of a TabContainer */
+struct _tabPage;
+
+/* An ImageView pixel source callback. It fills pixels (0x00RRGGBB, row by row) with the width * height pixels of the image that
+   start at x, y and are step pixels apart, and returns FALSE on failure. It is called on thread pool threads, several at a time */
+typedef BOOL (*ImageReadFunc)(void *context, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+								unsigned int step, DWORD *pixels);
+
+/* ListView data source callbacks. The first one gets the number of items, the second one fills items with the texts of count items
+   starting at first (the texts are copied, so they only have to stay valid until it returns) and returns FALSE on failure */
+typedef unsigned int (*ListCountFunc)(void *context);
+typedef BOOL (*ListFetchFunc)(void *context, unsigned int first, unsigned int count, char **items);
+
+/* A ListView item click callback, gets the ListView, the context and the item */
+typedef void (*ListItemCallback)(ListView, void*, unsigned int);
+
+/* A TreeView data source callback. It is called on a thread pool thread (several at a time) when a node is first expanded, with
+   the data of the node (NULL for the root), and passes each of its children to addTreeChild. It returns FALSE on failure */
+typedef BOOL (*TreeFetchFunc)(void *context, void *data, struct _treeFetch *fetch);
+
+/* A TreeView node click callback, gets the TreeView, the context and the node */
+typedef void (*TreeNodeCallback)(TreeView, void*, unsigned int);
+
+/* TextBox text change callback, called with the TextBox, a context, the offset of the change, the number of characters removed,
+   the inserted characters and their number */
+typedef void (*TextChangeCallback)(TextBox, void*, unsigned int, unsigned int, const char*, unsigned int);
+
 
 
 /* Class Object */
 #define CLASS_Object \
 	FIELD(enum _objectType, type, OBJECT); \
-	DEF_FIELD(CRITICAL_SECTION, criticalSection); \
-	FIELD(BOOL, criticalSectionInitialized, FALSE);
+	FIELD(CRITICAL_SECTION *volatile, lock, NULL); /* The object's lock, created by the first startSync */
 
 
 
 /* Class EventArgs */
 #define CLASS_EventArgs /* inherits from */ CLASS_Object \
+	VTABLE_FIELD(EventArgs); /* The virtual methods of the EventArgs' class */ \
 	DEF_FIELD(UINT, message); \
 	DEF_FIELD(WPARAM, wParam); \
-	DEF_FIELD(LPARAM, lParam); \
-	DEF_FIELD(void, (*updateValue)(MAKE_THIS(EventArgs), UINT message, WPARAM wParam, LPARAM lParam));
+	DEF_FIELD(LPARAM, lParam);
+
+#define VTABLE_EventArgs \
+	/* Updates the EventArgs with the values of a new message */ \
+	VIRTUAL_METHOD(EventArgs, void, updateValue, (MAKE_THIS(EventArgs), UINT message, WPARAM wParam, LPARAM lParam))
 
 
 /* Class MouseEventArgs */
@@ -178,38 +314,53 @@ MAKE_TYPEDEF(Brush);
 	FIELD(int, cursorX, NULL); \
 	FIELD(int, cursorY, NULL);
 
+#define VTABLE_MouseEventArgs /* overrides */ \
+	VIRTUAL_METHOD(MouseEventArgs, void, updateValue, (MAKE_THIS(EventArgs), UINT message, WPARAM wParam, LPARAM lParam))
+
 
 /* Class GUIObject */
 #define CLASS_GUIObject /* inherits from */ CLASS_Object \
+	VTABLE_FIELD(GUIObject); /* The virtual methods of the GUIObject's class */  \
+	FIELD(volatile LONG, refCount, 1); /* The references to the GUIObject, its destructor holds the first one */  \
+	FIELD(Arena, arena, NULL); /* The arena the GUIObject and its fields are allocated in, NULL for the heap */  \
 	FIELD(LONG_PTR, origProcPtr, NULL); /* The pointer to the original window procedure */  \
 	\
 	FIELD(HWND, handle, NULL); /* The handle to the window/control; initialized with a call to CreateWindowEx */  \
+	FIELD(enum _realizeState, realizeState, UNREALIZED); /* Whether the handle was created, so that it is only ever created once */  \
 	FIELD(HINSTANCE, moduleInstance, NULL); /* The current module instance */  \
-	DEF_FIELD(PAINTSTRUCT, paintData); \
 	FIELD(HDC, paintContext, NULL); \
 	FIELD(HDC, offscreenPaintContext, NULL); \
-	FIELD(HBITMAP, offscreenBitmap, NULL); \
+	FIELD(struct _paintState*, paintState, NULL); /* The paint data and offscreen bitmap, created when the GUIObject first needs them */  \
 	FIELD(BOOL, customEraseBG, FALSE); \
 	\
+	/* windowless controls */  \
+	FIELD(BOOL, windowless, FALSE); /* The GUIObject has no window, its host (the closest ancestor with one) draws it and routes its input */  \
+	DEF_FIELD(RECT, paintedRect); /* Where a windowless GUIObject was last painted, in its host's client coordinates */  \
+	FIELD(unsigned int, numWindowless, 0); /* The number of windowless children */  \
+	FIELD(GUIObject, windowlessCapture, NULL); /* The windowless descendant a mouse button was pressed on, for hosts */  \
+	FIELD(GUIObject, windowlessFocus, NULL); /* The windowless descendant that gets the keyboard input, for hosts */  \
+	\
 	FIELD(char*, className, NULL); /* The name of the window/control's WinAPI "class" */  \
 	FIELD(HMENU, ID, 0); /* The child-window/control identifier */  \
 	FIELD(DWORD, styles, 0); /* The window/control styles */  \
 	FIELD(DWORD, exStyles, 0); /* The window/control extended styles */  \
 	\
 	/* events */  \
-	FIELD(struct _event*, events, NULL); \
+	FIELD(struct _event**, events, NULL); /* The event records, allocated one by one so they don't move when events are added */  \
 	FIELD(unsigned int, numEvents, 0); \
 	\
-	FIELD(char*, text, NULL); /* The window/control text */  \
+	FIELD(char*, text, NULL); /* The window/control text in UTF-8, pointing to textInline when it fits there */  \
+	FIELD(unsigned int, textLength, 0); \
+	DEF_FIELD(char, textInline[GUIOBJECT_INLINE_TEXT]); /* The storage of short texts, that need no allocation */  \
+	FIELD(WCHAR*, wideText, NULL); /* The text in UTF-16 for the WinAPI, converted once after each change when it's needed */  \
+	FIELD(unsigned int, wideTextCapacity, 0); \
+	FIELD(BOOL, wideTextStale, TRUE); \
+	FIELD(BOOL, textBorrowed, FALSE); /* The text points to memory the GUIObject doesn't own, like the strings of a UI file */  \
 	\
 	FIELD(int, width, 0); \
 	FIELD(int, height, 0); \
 	\
-	FIELD(int, minWidth, 0); \
-	FIELD(int, minHeight, 0); \
-	\
-	FIELD(int, maxWidth, INT_MAX); \
-	FIELD(int, maxHeight, INT_MAX); \
+	FIELD(struct _limits*, limits, NULL); /* The min and max size and position, created by the first call that sets one of them */  \
 	\
 	FIELD(int, realWidth, 0); /* Used in anchor calculations. Not affected by min and max settings */ \
 	FIELD(int, realHeight, 0); \
@@ -224,14 +375,29 @@ MAKE_TYPEDEF(Brush);
 	\
 	/* links */  \
 	FIELD(GUIObject, parent, NULL); /* A pointer to the parent */  \
-	FIELD(GUIObject*, children, NULL); /* A pointer to the array of children */  \
-	FIELD(unsigned int, numChildren, 0); /* The number of children */  \
+	FIELD(GUIObject*, children, NULL); /* A pointer to the array of children, in z-order (the last one is on top) */  \
+	FIELD(unsigned int, numChildren, 0); /* The number of children slots in use, the slots of removed children are NULL */  \
+	FIELD(unsigned int, childrenCapacity, 0); \
+	FIELD(unsigned int, numRemovedChildren, 0); /* The NULL slots, compacted away when the array gets full */  \
+	FIELD(unsigned int, childIndex, 0); /* The GUIObject's slot in its parent's children */  \
 	\
+	/* layout */  \
+	FIELD(UINT, layoutFlags, 0); /* The layout state, a combination of the LAYOUT_ macro values */  \
+	FIELD(int, layoutWidth, 0); /* The size the children were last aligned to */  \
+	FIELD(int, layoutHeight, 0); \
+	FIELD(LayoutNode, layoutNode, NULL); /* The node in the flex/grid layout tree, created when the GUIObject or its parent opts in */  \
+	FIELD(struct _geometryTable*, childrenGeometry, NULL); /* The children's geometry arrays, created by the first anchor pass */  \
+	FIELD(SpatialIndex, childrenIndex, NULL); /* The spatial index of the children's rectangles, created by enableSpatialIndex */  \
+	FIELD(int, spatialItem, -1); /* The GUIObject's item in its parent's spatial index */
+
+#define VTABLE_GUIObject \
 	/* Moves a GUIObject to a new location specified by x and y */ \
-	VIRTUAL_METHOD(GUIObject, BOOL, setPos, (MAKE_THIS(GUIObject), int x, int y));
+	VIRTUAL_METHOD(GUIObject, BOOL, setPos, (MAKE_THIS(GUIObject), int x, int y))
 
 	/* Adds a child object to a GUIObject */
 	METHOD(GUIObject, BOOL, addChild, (MAKE_THIS(GUIObject), struct GUIObject_s *child));
+	/* Adds children to a GUIObject in one go */
+	METHOD(GUIObject, BOOL, addChildren, (MAKE_THIS(GUIObject), struct GUIObject_s **children, unsigned int numChildren));
 	/* Removes a child object from a GUIObject */
 	METHOD(GUIObject, BOOL, removeChild, (MAKE_THIS(GUIObject), struct GUIObject_s *child));
 	/* Sets an event for a GUIObject by a Windows message */
@@ -252,6 +418,10 @@ MAKE_TYPEDEF(Brush);
 	METHOD(GUIObject, BOOL, setMinSize, (MAKE_THIS(GUIObject), int minWidth, int minHeight));
 	/* Sets a GUIObject's maximum size to a new value specified by maxWidth and maxHeight */
 	METHOD(GUIObject, BOOL, setMaxSize, (MAKE_THIS(GUIObject), int maxWidth, int maxHeight));
+	/* Gets a GUIObject's minimum size, 0, 0 if it has no limits */
+	METHOD(GUIObject, BOOL, getMinSize, (MAKE_THIS(GUIObject), int *minWidth, int *minHeight));
+	/* Gets a GUIObject's maximum size, INT_MAX, INT_MAX if it has no limits */
+	METHOD(GUIObject, BOOL, getMaxSize, (MAKE_THIS(GUIObject), int *maxWidth, int *maxHeight));
 	/* Sets a new text for a GUIObject */
 	METHOD(GUIObject, BOOL, setText, (MAKE_THIS(GUIObject), char *text));
 	/* Sets a GUIObject's enabled state */
@@ -272,15 +442,41 @@ MAKE_TYPEDEF(Brush);
 												int boundX2, int boundY2));
 	/* Draws a polygon in a GUIObject */
 	METHOD(GUIObject, BOOL, drawPolygon, (MAKE_THIS(GUIObject), Pen pen, Brush brush, int numPoints, LONG *coords));
-
-	/* Virtual method prototype */
+	/* Lays out a GUIObject's children in a row or a column, instead of by their anchors */
+	METHOD(GUIObject, BOOL, setFlexLayout, (MAKE_THIS(GUIObject), enum _flexDirection direction, enum _justify justify,
+											enum _align alignItems, int gap));
+	/* Lays out a GUIObject's children in the cells of a grid, instead of by their anchors */
+	METHOD(GUIObject, BOOL, setGridLayout, (MAKE_THIS(GUIObject), unsigned int numColumns, const struct _layoutTrack *columns,
+											unsigned int numRows, const struct _layoutTrack *rows, int gap));
+	/* Sets the space between a flex or grid GUIObject's borders and its children */
+	METHOD(GUIObject, BOOL, setLayoutPadding, (MAKE_THIS(GUIObject), int left, int top, int right, int bottom));
+	/* Sets how a GUIObject grows and shrinks in its parent's flex layout */
+	METHOD(GUIObject, BOOL, setFlexItem, (MAKE_THIS(GUIObject), float grow, float shrink, int basis));
+	/* Places a GUIObject in a cell of its parent's grid layout */
+	METHOD(GUIObject, BOOL, setGridCell, (MAKE_THIS(GUIObject), int column, int row, int columnSpan, int rowSpan));
+	/* Makes a GUIObject windowless (drawn and hit-tested by its host instead of having a window) or not, before it is displayed */
+	METHOD(GUIObject, BOOL, setWindowless, (MAKE_THIS(GUIObject), BOOL windowless));
+	/* Keeps a spatial index of a GUIObject's children, for fast hit-tests and rectangle queries over large numbers of children */
+	METHOD(GUIObject, BOOL, enableSpatialIndex, (MAKE_THIS(GUIObject), int cellSize));
+	/* Gets a GUIObject's topmost child at the point specified by x and y, NULL if there is none */
+	METHOD(GUIObject, GUIObject, getChildAt, (MAKE_THIS(GUIObject), int x, int y));
+	/* Calls callback for each of a GUIObject's children that intersect a rectangle. Returns the number of children found */
+	METHOD(GUIObject, unsigned int, getChildrenInRect, (MAKE_THIS(GUIObject), int left, int top, int right, int bottom,
+														SpatialQueryFunc callback, void *context));
+
+	/* Virtual method prototypes, calling them directly binds the call at compile time */
 	BOOL GUIObject_setPos(GUIObject object, int x, int y);
+	BOOL Control_setPos(GUIObject object, int x, int y);
 
 	/* Self-reference mechanism for methods */
 	/* Moves a GUIObject to a new location specified by x and y */
 	#define _setPos(x, y) MAKE_VIRTUAL_METHOD_ALIAS(setPos(CURR_THIS(GUIObject), x, y))
+	/* Moves a GUIObject whose class is known to be classType, without going through its vtable */
+	#define _setPosAs(classType, x, y) MAKE_METHOD_ALIAS(classType, setPos(CURR_THIS(GUIObject), x, y))
 
 	#define _addChild(child) MAKE_METHOD_ALIAS(GUIObject, addChild(CURR_THIS(GUIObject), child))
+	/* Adds children to a GUIObject in one go */
+	#define _addChildren(children, numChildren) MAKE_METHOD_ALIAS(GUIObject, addChildren(CURR_THIS(GUIObject), children, numChildren))
 	/* Removes a child object from a GUIObject */
 	#define _removeChild(child) MAKE_METHOD_ALIAS(GUIObject, removeChild(CURR_THIS(GUIObject), child))
 	/* Sets an event for a GUIObject by a Windows message */
@@ -299,6 +495,10 @@ MAKE_TYPEDEF(Brush);
 	#define _setMinSize(minWidth, minHeight) MAKE_METHOD_ALIAS(GUIObject, setMinSize(CURR_THIS(GUIObject), minWidth, minHeight))
 	/* Sets a GUIObject's maximum size to a new value specified by maxWidth and maxHeight */
 	#define _setMaxSize(maxWidth, maxHeight) MAKE_METHOD_ALIAS(GUIObject, setMaxSize(CURR_THIS(GUIObject), maxWidth, maxHeight))
+	/* Gets a GUIObject's minimum size, 0, 0 if it has no limits */
+	#define _getMinSize(minWidth, minHeight) MAKE_METHOD_ALIAS(GUIObject, getMinSize(CURR_THIS(GUIObject), minWidth, minHeight))
+	/* Gets a GUIObject's maximum size, INT_MAX, INT_MAX if it has no limits */
+	#define _getMaxSize(maxWidth, maxHeight) MAKE_METHOD_ALIAS(GUIObject, getMaxSize(CURR_THIS(GUIObject), maxWidth, maxHeight))
 	/* Sets a new text for a GUIObject */
 	#define _setText(text) MAKE_METHOD_ALIAS(GUIObject, setText(CURR_THIS(GUIObject), text))
 	/* Sets a GUIObject's enabled state */
@@ -320,6 +520,27 @@ MAKE_TYPEDEF(Brush);
 	/* Draws a polygon in a GUIObject */
 	#define _drawPolygon(pen, brush, numPoints, coords) MAKE_METHOD_ALIAS(GUIObject, \
 																					drawPolygon(CURR_THIS(GUIObject), pen, brush, numPoints, coords))
+	/* Lays out a GUIObject's children in a row or a column, instead of by their anchors */
+	#define _setFlexLayout(direction, justify, alignItems, gap) MAKE_METHOD_ALIAS(GUIObject, \
+																	setFlexLayout(CURR_THIS(GUIObject), direction, justify, alignItems, gap))
+	/* Lays out a GUIObject's children in the cells of a grid, instead of by their anchors */
+	#define _setGridLayout(numColumns, columns, numRows, rows, gap) MAKE_METHOD_ALIAS(GUIObject, \
+																	setGridLayout(CURR_THIS(GUIObject), numColumns, columns, numRows, rows, gap))
+	/* Sets the space between a flex or grid GUIObject's borders and its children */
+	#define _setLayoutPadding(left, top, right, bottom) MAKE_METHOD_ALIAS(GUIObject, setLayoutPadding(CURR_THIS(GUIObject), left, top, right, bottom))
+	/* Sets how a GUIObject grows and shrinks in its parent's flex layout */
+	#define _setFlexItem(grow, shrink, basis) MAKE_METHOD_ALIAS(GUIObject, setFlexItem(CURR_THIS(GUIObject), grow, shrink, basis))
+	/* Places a GUIObject in a cell of its parent's grid layout */
+	#define _setGridCell(column, row, columnSpan, rowSpan) MAKE_METHOD_ALIAS(GUIObject, setGridCell(CURR_THIS(GUIObject), column, row, columnSpan, rowSpan))
+	/* Makes a GUIObject windowless (drawn and hit-tested by its host instead of having a window) or not, before it is displayed */
+	#define _setWindowless(windowless) MAKE_METHOD_ALIAS(GUIObject, setWindowless(CURR_THIS(GUIObject), windowless))
+	/* Keeps a spatial index of a GUIObject's children, for fast hit-tests and rectangle queries over large numbers of children */
+	#define _enableSpatialIndex(cellSize) MAKE_METHOD_ALIAS(GUIObject, enableSpatialIndex(CURR_THIS(GUIObject), cellSize))
+	/* Gets a GUIObject's topmost child at the point specified by x and y, NULL if there is none */
+	#define _getChildAt(x, y) MAKE_METHOD_ALIAS(GUIObject, getChildAt(CURR_THIS(GUIObject), x, y))
+	/* Calls callback for each of a GUIObject's children that intersect a rectangle. Returns the number of children found */
+	#define _getChildrenInRect(left, top, right, bottom, callback, context) MAKE_METHOD_ALIAS(GUIObject, \
+																	getChildrenInRect(CURR_THIS(GUIObject), left, top, right, bottom, callback, context))
 
 
 
@@ -330,7 +551,9 @@ MAKE_TYPEDEF(Brush);
 	FIELD(int, clientHeight, 0); \
 	\
 	FIELD(BOOL, resizable, TRUE); \
-	FIELD(BOOL, maximizeEnabled, TRUE);
+	FIELD(BOOL, maximizeEnabled, TRUE); \
+	\
+	FIELD(struct _windowClass*, windowClass, NULL); /* The registered WinAPI class, shared by the Windows with the same configuration */
 
 	/* methods */
 	METHOD(Window, BOOL, setResizable, (MAKE_THIS(Window), BOOL resizable));
@@ -345,22 +568,25 @@ MAKE_TYPEDEF(Brush);
 /* Class Control */
 #define CLASS_Control /* inherits from */ CLASS_GUIObject \
 	/* fields */ \
-	FIELD(int, minX, INT_MIN); \
-	FIELD(int, minY, INT_MIN); \
-	\
-	FIELD(int, maxX, INT_MAX); \
-	FIELD(int, maxY, INT_MAX); \
-	\
 	FIELD(short, anchor, ANCHOR_TOP | ANCHOR_LEFT);
 
+#define VTABLE_Control /* overrides */ \
+	VIRTUAL_METHOD(Control, BOOL, setPos, (MAKE_THIS(GUIObject), int x, int y))
+
 
 	/* methods */
+	METHOD(Control, BOOL, setAnchor, (MAKE_THIS(Control), short anchor));
 	METHOD(Control, BOOL, setMinPos, (MAKE_THIS(Control), int minX, int minY));
 	METHOD(Control, BOOL, setMaxPos, (MAKE_THIS(Control), int maxX, int maxY));
+	METHOD(Control, BOOL, getMinPos, (MAKE_THIS(Control), int *minX, int *minY));
+	METHOD(Control, BOOL, getMaxPos, (MAKE_THIS(Control), int *maxX, int *maxY));
 
 	/* Self-reference mechanism for methods */
+	#define _setAnchor(anchor) MAKE_METHOD_ALIAS(Control, setAnchor(CURR_THIS(Control), anchor))
 	#define _setMinPos(minX, minY) MAKE_METHOD_ALIAS(Control, setMinPos(CURR_THIS(Control), minX, minY))
 	#define _setMaxPos(maxX, maxY) MAKE_METHOD_ALIAS(Control, setMaxPos(CURR_THIS(Control), maxX, maxY))
+	#define _getMinPos(minX, minY) MAKE_METHOD_ALIAS(Control, getMinPos(CURR_THIS(Control), minX, minY))
+	#define _getMaxPos(maxX, maxY) MAKE_METHOD_ALIAS(Control, getMaxPos(CURR_THIS(Control), maxX, maxY))
 
 
 
@@ -372,11 +598,26 @@ MAKE_TYPEDEF(Brush);
 /* Class TextBox */
 #define CLASS_TextBox /* inherits from */ CLASS_Control \
 	FIELD(BOOL, multiline, FALSE); \
-	FIELD(BOOL, numOnly, FALSE);
+	FIELD(BOOL, numOnly, FALSE); \
+	FIELD(TextBuffer, textBuffer, NULL); /* The TextBox's text, kept up to date edit by edit */ \
+	FIELD(BOOL, textStale, FALSE); /* The text field is behind textBuffer, getText brings it up to date */ \
+	FIELD(BOOL, snapshotValid, FALSE); /* The selection was recorded before a message that may edit the text */ \
+	FIELD(DWORD, snapshotStart, 0); /* The start of the recorded selection, in the window's UTF-16 characters */ \
+	FIELD(volatile LONG, windowBehind, FALSE); /* The text was changed on another thread, an update was posted to the window */ \
+	FIELD(TextChangeCallback, onTextChange, NULL); /* The text change callback */ \
+	FIELD(void*, textChangeContext, NULL); /* The pointer passed to the text change callback */
 
 	METHOD(TextBox, BOOL, setNumOnly, (MAKE_THIS(TextBox), BOOL numOnly));
+	METHOD(TextBox, char*, getText, (MAKE_THIS(TextBox)));
+	METHOD(TextBox, unsigned int, getTextLength, (MAKE_THIS(TextBox)));
+	METHOD(TextBox, BOOL, replaceText, (MAKE_THIS(TextBox), unsigned int offset, unsigned int removed, char *text));
+	METHOD(TextBox, BOOL, setOnTextChange, (MAKE_THIS(TextBox), TextChangeCallback callback, void *context));
 
 	#define _setNumOnly(numOnly) MAKE_METHOD_ALIAS(TextBox, setNumOnly(CURR_THIS(TextBox), numOnly))
+	#define _getText() MAKE_METHOD_ALIAS(TextBox, getText(CURR_THIS(TextBox)))
+	#define _getTextLength() MAKE_METHOD_ALIAS(TextBox, getTextLength(CURR_THIS(TextBox)))
+	#define _replaceText(offset, removed, text) MAKE_METHOD_ALIAS(TextBox, replaceText(CURR_THIS(TextBox), offset, removed, text))
+	#define _setOnTextChange(callback, context) MAKE_METHOD_ALIAS(TextBox, setOnTextChange(CURR_THIS(TextBox), callback, context))
 
 
 
@@ -385,6 +626,247 @@ MAKE_TYPEDEF(Brush);
 
 
 
+/* Class ListView */
+#define CLASS_ListView /* inherits from */ CLASS_Control \
+	/* fields */ \
+	FIELD(ListCountFunc, getItemCount, NULL); /* The data source's item count callback */ \
+	FIELD(ListFetchFunc, fetchItems, NULL); /* The data source's item fetching callback */ \
+	FIELD(void*, dataContext, NULL); /* The pointer passed to the data source callbacks */ \
+	FIELD(unsigned int, numItems, 0); \
+	\
+	FIELD(int, rowHeight, 20); \
+	FIELD(unsigned int, overscan, 4); /* The number of rows realized above and below the visible ones */ \
+	FIELD(int, scrollPos, 0); /* The vertical scroll position, pixels */ \
+	\
+	FIELD(Label*, rows, NULL); /* The recycled row labels, the row of an item is rows[item % numRows] */ \
+	FIELD(unsigned int*, rowItems, NULL); /* The item each row shows, LISTVIEW_NO_ITEM for unused rows */ \
+	FIELD(unsigned int, numRows, 0); \
+	\
+	FIELD(struct _listPage*, pages, NULL); /* The cache of fetched items */ \
+	FIELD(unsigned long, pageClock, 0); /* Incremented on each page access, for picking the least recently used page */ \
+	\
+	FIELD(ListItemCallback, onItemClick, NULL); \
+	FIELD(void*, itemClickContext, NULL);
+
+	/* methods */
+	METHOD(ListView, BOOL, setDataSource, (MAKE_THIS(ListView), ListCountFunc getItemCount, ListFetchFunc fetchItems, void *context));
+	METHOD(ListView, BOOL, refreshItems, (MAKE_THIS(ListView)));
+	METHOD(ListView, BOOL, setRowHeight, (MAKE_THIS(ListView), int rowHeight));
+	METHOD(ListView, BOOL, scrollTo, (MAKE_THIS(ListView), int scrollPos));
+	METHOD(ListView, BOOL, setOnItemClick, (MAKE_THIS(ListView), ListItemCallback callback, void *context));
+
+	/* Self-reference mechanism for methods */
+	#define _setDataSource(getItemCount, fetchItems, context) MAKE_METHOD_ALIAS(ListView, setDataSource(CURR_THIS(ListView), \
+																		getItemCount, fetchItems, context))
+	#define _refreshItems() MAKE_METHOD_ALIAS(ListView, refreshItems(CURR_THIS(ListView)))
+	#define _setRowHeight(rowHeight) MAKE_METHOD_ALIAS(ListView, setRowHeight(CURR_THIS(ListView), rowHeight))
+	#define _scrollTo(scrollPos) MAKE_METHOD_ALIAS(ListView, scrollTo(CURR_THIS(ListView), scrollPos))
+	#define _setOnItemClick(callback, context) MAKE_METHOD_ALIAS(ListView, setOnItemClick(CURR_THIS(ListView), callback, context))
+
+
+
+/* Class Plot */
+#define CLASS_Plot /* inherits from */ CLASS_Control \
+	/* fields */ \
+	FIELD(const float*, samples, NULL); /* The samples, owned by the caller and never copied */ \
+	FIELD(unsigned int, numSamples, 0); \
+	FIELD(struct _plotLevel*, levels, NULL); /* The min/max pyramid over the samples, levels[0] has blocks of PLOT_LEVEL_FACTOR samples */ \
+	FIELD(unsigned int, numLevels, 0); /* The number of levels that have complete blocks */ \
+	\
+	FIELD(unsigned int, samplesPerPixel, 1); /* The number of samples each pixel column shows */ \
+	FIELD(unsigned int, firstColumn, 0); /* The column of samples shown at the left edge, when not following */ \
+	FIELD(BOOL, following, TRUE); /* The Plot keeps the newest samples at its right edge */ \
+	FIELD(float, minValue, -1); /* The value at the bottom edge */ \
+	FIELD(float, maxValue, 1); /* The value at the top edge */ \
+	FIELD(COLORREF, lineColor, RGB(0, 0, 0xFF)); \
+	FIELD(COLORREF, backgroundColor, RGB(0xFF, 0xFF, 0xFF)); \
+	\
+	FIELD(POINT*, points, NULL); /* Scratch space for the column lines */ \
+	FIELD(DWORD*, pointCounts, NULL); \
+	FIELD(unsigned int, pointsCapacity, 0);
+
+	/* methods */
+	METHOD(Plot, BOOL, setSamples, (MAKE_THIS(Plot), const float *samples, unsigned int numSamples));
+	METHOD(Plot, BOOL, appendSamples, (MAKE_THIS(Plot), const float *samples, unsigned int numSamples));
+	METHOD(Plot, BOOL, setView, (MAKE_THIS(Plot), unsigned int firstSample, unsigned int samplesPerPixel));
+	METHOD(Plot, BOOL, setFollowing, (MAKE_THIS(Plot), BOOL following));
+	METHOD(Plot, BOOL, setRange, (MAKE_THIS(Plot), float minValue, float maxValue));
+	METHOD(Plot, BOOL, setColors, (MAKE_THIS(Plot), COLORREF lineColor, COLORREF backgroundColor));
+
+	/* Self-reference mechanism for methods */
+	#define _setSamples(samples, numSamples) MAKE_METHOD_ALIAS(Plot, setSamples(CURR_THIS(Plot), samples, numSamples))
+	#define _appendSamples(samples, numSamples) MAKE_METHOD_ALIAS(Plot, appendSamples(CURR_THIS(Plot), samples, numSamples))
+	#define _setView(firstSample, samplesPerPixel) MAKE_METHOD_ALIAS(Plot, setView(CURR_THIS(Plot), firstSample, samplesPerPixel))
+	#define _setFollowing(following) MAKE_METHOD_ALIAS(Plot, setFollowing(CURR_THIS(Plot), following))
+	#define _setRange(minValue, maxValue) MAKE_METHOD_ALIAS(Plot, setRange(CURR_THIS(Plot), minValue, maxValue))
+	#define _setColors(lineColor, backgroundColor) MAKE_METHOD_ALIAS(Plot, setColors(CURR_THIS(Plot), lineColor, backgroundColor))
+
+
+
+/* Class LogView */
+#define CLASS_LogView /* inherits from */ CLASS_Control \
+	/* fields */ \
+	FIELD(char**, lines, NULL); /* The ring buffer of lines, line number n is stored at lines[n % maxLines] */ \
+	FIELD(unsigned int, maxLines, LOGVIEW_DEFAULT_MAX_LINES); \
+	FIELD(unsigned long long, firstLine, 0); /* The number of the oldest line kept */ \
+	FIELD(unsigned long long, numLines, 0); /* The number of lines ever appended, the newest line's number is numLines - 1 */ \
+	FIELD(unsigned long long, shownLines, 0); /* The number of lines when the LogView was last updated */ \
+	FIELD(volatile LONG, updatePending, FALSE); /* An update message has been posted to the LogView's window */ \
+	\
+	FIELD(int, lineHeight, 16); \
+	FIELD(unsigned long long, topLine, 0); /* The number of the line at the top of the viewport */ \
+	FIELD(BOOL, autoScroll, TRUE); /* The LogView keeps its newest line in view */
+
+	/* methods */
+	METHOD(LogView, BOOL, appendLine, (MAKE_THIS(LogView), const char *text));
+	METHOD(LogView, BOOL, clear, (MAKE_THIS(LogView)));
+	METHOD(LogView, BOOL, setMaxLines, (MAKE_THIS(LogView), unsigned int maxLines));
+	METHOD(LogView, BOOL, setLineHeight, (MAKE_THIS(LogView), int lineHeight));
+	METHOD(LogView, BOOL, scrollToLine, (MAKE_THIS(LogView), unsigned long long line));
+	METHOD(LogView, BOOL, setAutoScroll, (MAKE_THIS(LogView), BOOL autoScroll));
+
+	/* Self-reference mechanism for methods */
+	#define _appendLine(text) MAKE_METHOD_ALIAS(LogView, appendLine(CURR_THIS(LogView), text))
+	#define _clear() MAKE_METHOD_ALIAS(LogView, clear(CURR_THIS(LogView)))
+	#define _setMaxLines(maxLines) MAKE_METHOD_ALIAS(LogView, setMaxLines(CURR_THIS(LogView), maxLines))
+	#define _setLineHeight(lineHeight) MAKE_METHOD_ALIAS(LogView, setLineHeight(CURR_THIS(LogView), lineHeight))
+	#define _scrollToLine(line) MAKE_METHOD_ALIAS(LogView, scrollToLine(CURR_THIS(LogView), line))
+	#define _setAutoScroll(autoScroll) MAKE_METHOD_ALIAS(LogView, setAutoScroll(CURR_THIS(LogView), autoScroll))
+
+
+
+/* Class ImageView */
+#define CLASS_ImageView /* inherits from */ CLASS_Control \
+	/* fields */ \
+	FIELD(ImageReadFunc, readPixels, NULL); /* The pixel source */ \
+	FIELD(void*, readContext, NULL); /* The pointer passed to the pixel source */ \
+	FIELD(struct _bitmapFile*, bitmapFile, NULL); /* The bitmap file opened with openBitmapFile, used as the pixel source */ \
+	FIELD(unsigned int, imageWidth, 0); \
+	FIELD(unsigned int, imageHeight, 0); \
+	FIELD(unsigned int, numLevels, 0); /* The number of mip levels, level n has 1 / 2^n of the image's size */ \
+	\
+	FIELD(float, zoom, 1); /* The number of screen pixels per image pixel */ \
+	FIELD(int, scrollX, 0); /* The position of the viewport in the zoomed image, pixels */ \
+	FIELD(int, scrollY, 0); \
+	\
+	FIELD(struct _imageTile**, tiles, NULL); /* The tile cache, a hash table of IMAGEVIEW_HASH_SIZE buckets */ \
+	FIELD(struct _imageTile*, firstUsed, NULL); /* The most recently used tile */ \
+	FIELD(struct _imageTile*, lastUsed, NULL); /* The least recently used tile, the first one to be dropped */ \
+	FIELD(size_t, cacheSize, 0); /* The memory used by the tiles' pixels, bytes */ \
+	FIELD(size_t, cacheBudget, IMAGEVIEW_DEFAULT_BUDGET); /* The memory the tiles' pixels may use, bytes */ \
+	FIELD(unsigned long, paintClock, 0); /* Counts the paints, the tiles drawn by the current one are never dropped */ \
+	FIELD(volatile LONG, numLoading, 0); /* The number of tiles being decoded */ \
+	FIELD(volatile LONG, updatePending, FALSE); /* A repaint message has been posted for decoded tiles */ \
+	\
+	FIELD(BOOL, dragging, FALSE); /* The image is being dragged with the mouse */ \
+	FIELD(int, dragX, 0); \
+	FIELD(int, dragY, 0);
+
+	/* methods */
+	METHOD(ImageView, BOOL, openBitmapFile, (MAKE_THIS(ImageView), char *path));
+	METHOD(ImageView, BOOL, setImageSource, (MAKE_THIS(ImageView), unsigned int width, unsigned int height, ImageReadFunc readPixels,
+												void *context));
+	METHOD(ImageView, BOOL, setZoom, (MAKE_THIS(ImageView), float zoom, int x, int y));
+	METHOD(ImageView, BOOL, panTo, (MAKE_THIS(ImageView), int scrollX, int scrollY));
+	METHOD(ImageView, BOOL, setCacheBudget, (MAKE_THIS(ImageView), size_t cacheBudget));
+
+	/* Self-reference mechanism for methods */
+	#define _openBitmapFile(path) MAKE_METHOD_ALIAS(ImageView, openBitmapFile(CURR_THIS(ImageView), path))
+	#define _setImageSource(width, height, readPixels, context) MAKE_METHOD_ALIAS(ImageView, setImageSource(CURR_THIS(ImageView), \
+																						width, height, readPixels, context))
+	#define _setZoom(zoom, x, y) MAKE_METHOD_ALIAS(ImageView, setZoom(CURR_THIS(ImageView), zoom, x, y))
+	#define _panTo(scrollX, scrollY) MAKE_METHOD_ALIAS(ImageView, panTo(CURR_THIS(ImageView), scrollX, scrollY))
+	#define _setCacheBudget(cacheBudget) MAKE_METHOD_ALIAS(ImageView, setCacheBudget(CURR_THIS(ImageView), cacheBudget))
+
+
+
+/* Class TreeView */
+#define CLASS_TreeView /* inherits from */ CLASS_Control \
+	/* fields */ \
+	FIELD(TreeFetchFunc, fetchChildren, NULL); /* The data source callback */ \
+	FIELD(void*, dataContext, NULL); /* The pointer passed to the data source callback */ \
+	\
+	FIELD(struct _treeNode*, nodes, NULL); /* The nodes fetched so far, nodes[TREEVIEW_ROOT] is the root */ \
+	FIELD(unsigned int, numNodes, 0); \
+	FIELD(unsigned int, nodesCapacity, 0); \
+	FIELD(char**, textBlocks, NULL); /* The nodes' texts, one block per fetch */ \
+	FIELD(unsigned int, numTextBlocks, 0); \
+	FIELD(unsigned int, textBlocksCapacity, 0); \
+	\
+	FIELD(struct _treeFetch*, fetched, NULL); /* The fetches waiting to be added to the tree, protected by the TreeView's lock */ \
+	FIELD(volatile LONG, numLoading, 0); /* The number of fetches running */ \
+	FIELD(volatile LONG, updatePending, FALSE); /* An update message has been posted for finished fetches */ \
+	\
+	FIELD(int, nodeHeight, 18); /* The height of the rows, pixels */ \
+	FIELD(unsigned int, topRow, 0); /* The row at the top of the viewport */ \
+	FIELD(unsigned int, topNode, TREEVIEW_NO_NODE); /* The node shown in that row */ \
+	FIELD(unsigned int, selectedNode, TREEVIEW_NO_NODE); \
+	\
+	FIELD(TreeNodeCallback, onNodeClick, NULL); \
+	FIELD(void*, nodeClickContext, NULL);
+
+	/* methods */
+	METHOD(TreeView, BOOL, setTreeSource, (MAKE_THIS(TreeView), TreeFetchFunc fetchChildren, void *context));
+	METHOD(TreeView, BOOL, expandNode, (MAKE_THIS(TreeView), unsigned int node, BOOL expand));
+	METHOD(TreeView, BOOL, scrollToRow, (MAKE_THIS(TreeView), unsigned int row));
+	METHOD(TreeView, BOOL, setNodeHeight, (MAKE_THIS(TreeView), int nodeHeight));
+	METHOD(TreeView, BOOL, setOnNodeClick, (MAKE_THIS(TreeView), TreeNodeCallback callback, void *context));
+	METHOD(TreeView, char*, getNodeText, (MAKE_THIS(TreeView), unsigned int node));
+	METHOD(TreeView, void*, getNodeData, (MAKE_THIS(TreeView), unsigned int node));
+
+	/* Self-reference mechanism for methods */
+	#define _setTreeSource(fetchChildren, context) MAKE_METHOD_ALIAS(TreeView, setTreeSource(CURR_THIS(TreeView), fetchChildren, context))
+	#define _expandNode(node, expand) MAKE_METHOD_ALIAS(TreeView, expandNode(CURR_THIS(TreeView), node, expand))
+	#define _scrollToRow(row) MAKE_METHOD_ALIAS(TreeView, scrollToRow(CURR_THIS(TreeView), row))
+	#define _setNodeHeight(nodeHeight) MAKE_METHOD_ALIAS(TreeView, setNodeHeight(CURR_THIS(TreeView), nodeHeight))
+	#define _setOnNodeClick(callback, context) MAKE_METHOD_ALIAS(TreeView, setOnNodeClick(CURR_THIS(TreeView), callback, context))
+	#define _getNodeText(node) MAKE_METHOD_ALIAS(TreeView, getNodeText(CURR_THIS(TreeView), node))
+	#define _getNodeData(node) MAKE_METHOD_ALIAS(TreeView, getNodeData(CURR_THIS(TreeView), node))
+
+
+
+/* Class TabContainer */
+#define CLASS_TabContainer /* inherits from */ CLASS_Control \
+	/* fields */ \
+	FIELD(struct _tabPage*, pages, NULL); \
+	FIELD(unsigned int, numPages, 0); \
+	FIELD(unsigned int, activePage, TABCONTAINER_NO_PAGE); /* The page shown */ \
+	FIELD(int, tabWidth, 100); /* The size of the tabs above the pages, pixels */ \
+	FIELD(int, tabHeight, 24); \
+	FIELD(DWORD, hibernateDelay, TABCONTAINER_DEFAULT_HIBERNATE); /* How long a hidden page keeps its windows, ms. INFINITE for ever */
+
+	/* methods */
+	METHOD(TabContainer, Control, addPage, (MAKE_THIS(TabContainer), char *title));
+	METHOD(TabContainer, BOOL, selectPage, (MAKE_THIS(TabContainer), unsigned int page));
+	METHOD(TabContainer, BOOL, setHibernateDelay, (MAKE_THIS(TabContainer), DWORD hibernateDelay));
+
+	/* Self-reference mechanism for methods */
+	#define _addPage(title) MAKE_METHOD_ALIAS(TabContainer, addPage(CURR_THIS(TabContainer), title))
+	#define _selectPage(page) MAKE_METHOD_ALIAS(TabContainer, selectPage(CURR_THIS(TabContainer), page))
+	#define _setHibernateDelay(hibernateDelay) MAKE_METHOD_ALIAS(TabContainer, setHibernateDelay(CURR_THIS(TabContainer), \
+																	hibernateDelay))
+
+
+
+/* Class ScrollPanel */
+#define CLASS_ScrollPanel /* inherits from */ CLASS_Control \
+	/* fields */ \
+	FIELD(int, contentWidth, 0); /* The size of the area the children are laid out in, pixels */ \
+	FIELD(int, contentHeight, 0); \
+	FIELD(int, scrollX, 0); /* The point of the content shown at the top left corner of the panel */ \
+	FIELD(int, scrollY, 0);
+
+	/* methods */
+	METHOD(ScrollPanel, BOOL, setContentSize, (MAKE_THIS(ScrollPanel), int contentWidth, int contentHeight));
+	METHOD(ScrollPanel, BOOL, scrollContentTo, (MAKE_THIS(ScrollPanel), int x, int y));
+
+	/* Self-reference mechanism for methods */
+	#define _setContentSize(contentWidth, contentHeight) MAKE_METHOD_ALIAS(ScrollPanel, setContentSize(CURR_THIS(ScrollPanel), \
+																			contentWidth, contentHeight))
+	#define _scrollContentTo(x, y) MAKE_METHOD_ALIAS(ScrollPanel, scrollContentTo(CURR_THIS(ScrollPanel), x, y))
+
+
+
 /* Class Pen */
 #define CLASS_Pen /* inherits from */ CLASS_Object \
 	FIELD(HPEN, handle, NULL); \
@@ -418,6 +900,14 @@ MAKE_TYPEDEF(Brush);
 #define DEF_FIELD(type, name) MAKE_FIELD(type, name, )
 #define VIRTUAL_METHOD(classType, type, name, args) MAKE_VIRTUAL_METHOD(classType, type, name, args)
 
+	MAKE_VTABLE(EventArgs);
+	MAKE_VTABLE_PROTOTYPE(EventArgs, EventArgs);
+	MAKE_VTABLE_PROTOTYPE(MouseEventArgs, EventArgs);
+
+	MAKE_VTABLE(GUIObject);
+	MAKE_VTABLE_PROTOTYPE(GUIObject, GUIObject);
+	MAKE_VTABLE_PROTOTYPE(Control, GUIObject);
+
 	MAKE_CLASS(Object);
 	MAKE_DEFAULT_CONSTRUCTOR_PROTOTYPES(Object);
 
@@ -461,6 +951,34 @@ MAKE_TYPEDEF(Brush);
 	void initLabel(Label thisObject, HINSTANCE instance, char *text, int x, int y, int width, int height);
 	Label newLabel(HINSTANCE instance, char *text, int x, int y, int width, int height);
 
+	MAKE_CLASS(ListView);
+	void initListView(ListView thisObject, HINSTANCE instance, int x, int y, int width, int height);
+	ListView newListView(HINSTANCE instance, int x, int y, int width, int height);
+
+	MAKE_CLASS(Plot);
+	void initPlot(Plot thisObject, HINSTANCE instance, int x, int y, int width, int height);
+	Plot newPlot(HINSTANCE instance, int x, int y, int width, int height);
+
+	MAKE_CLASS(LogView);
+	void initLogView(LogView thisObject, HINSTANCE instance, int x, int y, int width, int height);
+	LogView newLogView(HINSTANCE instance, int x, int y, int width, int height);
+
+	MAKE_CLASS(ImageView);
+	void initImageView(ImageView thisObject, HINSTANCE instance, int x, int y, int width, int height);
+	ImageView newImageView(HINSTANCE instance, int x, int y, int width, int height);
+
+	MAKE_CLASS(TreeView);
+	void initTreeView(TreeView thisObject, HINSTANCE instance, int x, int y, int width, int height);
+	TreeView newTreeView(HINSTANCE instance, int x, int y, int width, int height);
+
+	MAKE_CLASS(TabContainer);
+	void initTabContainer(TabContainer thisObject, HINSTANCE instance, int x, int y, int width, int height);
+	TabContainer newTabContainer(HINSTANCE instance, int x, int y, int width, int height);
+
+	MAKE_CLASS(ScrollPanel);
+	void initScrollPanel(ScrollPanel thisObject, HINSTANCE instance, int x, int y, int width, int height);
+	ScrollPanel newScrollPanel(HINSTANCE instance, int x, int y, int width, int height);
+
 
 #undef FIELD
 #undef DEF_FIELD
@@ -480,10 +998,123 @@ struct _event {
 };
 
 
+struct _paintState {
+	PAINTSTRUCT paintData; /* Used when no device context can be gotten for the GUIObject's WM_PAINT processing */
+	HBITMAP offscreenBitmap; /* The bitmap selected into offscreenPaintContext for double-buffered drawing */
+};
+
+
+struct _limits {
+	int minWidth, minHeight;
+	int maxWidth, maxHeight;
+	int minX, minY; /* Only used by Controls */
+	int maxX, maxY;
+};
+
+
+struct _listPage {
+	unsigned int first; /* The first item on the page, LISTVIEW_NO_ITEM for unused pages */
+	unsigned int count; /* The number of items on the page */
+	char *items[LISTVIEW_PAGE_SIZE]; /* The items' texts, pointing into text */
+	char *text; /* The copied texts */
+	unsigned long lastUse; /* The ListView's pageClock value when the page was last used */
+};
+
+
+struct _imageTile {
+	unsigned int level, column, row;
+	unsigned int width, height; /* Tiles at the right and bottom edges are smaller */
+	DWORD *pixels;
+	volatile LONG state; /* Loading, ready or failed */
+	unsigned long lastPaint; /* The last paint that drew the tile */
+	ImageView owner;
+	struct _imageTile *nextInBucket; /* The next tile in the same hash bucket */
+	struct _imageTile *prevUsed, *nextUsed; /* The neighbours in the recently used list */
+};
+
+struct _bitmapFile {
+	HANDLE file, mapping;
+	DWORD dataOffset; /* The offset of the pixels in the file */
+	unsigned int stride; /* The length of a row in the file, bytes */
+	unsigned int bytesPerPixel;
+	BOOL bottomUp; /* The rows are stored from the bottom one up */
+	unsigned int width, height;
+	DWORD granularity; /* The alignment of mapped views */
+};
+
+/* A TreeView node. Nodes are never moved or dropped until the data source is changed, so they are referred to by their index */
+struct _treeNode {
+	char *text; /* Points into one of the TreeView's text blocks */
+	void *data; /* The data source's pointer for the node */
+	unsigned int parent;
+	unsigned int firstChild; /* The children of a node are stored next to each other */
+	unsigned int numChildren;
+	unsigned int numVisible; /* The number of rows below the node when it's expanded */
+	unsigned short depth; /* The root has depth 0, the top level nodes 1 */
+	unsigned short flags;
+};
+
+/* The children of a TreeView node, fetched on a thread pool thread */
+struct _treeFetch {
+	TreeView owner;
+	unsigned int node; /* The node whose children are fetched */
+	void *data; /* Its data */
+	BOOL succeeded;
+
+	struct _treeFetchChild {
+		size_t textOffset; /* The offset of the child's text in text */
+		void *data;
+		BOOL hasChildren;
+	} *children;
+	unsigned int numChildren;
+	unsigned int childrenCapacity;
+	char *text; /* The children's texts, zero-terminated */
+	size_t textLength;
+	size_t textCapacity;
+
+	struct _treeFetch *next; /* The next fetch waiting to be added to the tree */
+};
+
+struct _tabPage {
+	Control control; /* The page, a container for the controls shown on it */
+	char *title; /* The text of its tab */
+	DWORD hiddenSince; /* When the page was last hidden, in GetTickCount time */
+};
+
+struct _plotLevel {
+	float *min; /* The minimum of each block */
+	float *max; /* The maximum of each block */
+	unsigned int numBlocks; /* The number of complete blocks */
+	unsigned int capacity;
+};
+
+
 /* An event handler callback type */
 typedef void(*Callback)(GUIObject, void*, EventArgs);
 
 
+/* A named event handler, the events of a UI file are bound to handlers by their names */
+struct _uiHandler {
+	const char *name;
+	Callback callback;
+	void *context;
+	enum _syncMode mode;
+};
+
+/* A loaded UI file: the mapped file and the GUIObjects built from it, in the file's order */
+struct _uiFile {
+	HANDLE file, mapping;
+	const char *view;
+	const struct _uiObjectRecord *records;
+	const char *strings;
+	GUIObject *objects;
+	unsigned int numObjects;
+	Arena arena; /* The arena the GUIObjects are allocated in */
+};
+
+typedef struct _uiFile *UIFile;
+
+
 
 /* "static" function prototypes */
 static void *getCurrentThis();
@@ -491,7 +1122,32 @@ void setCurrentThis(void *self);
 
 void freeGUIObjectFields(GUIObject object);
 
+CRITICAL_SECTION *getObjectLock(Object object);
+LONG getNumObjectLocks();
+
+Arena useArena(Arena arena);
+void releaseArena(Arena arena);
+void deleteGUIObjectTree(GUIObject root);
+
+void unregisterWindowClasses();
+
+GUIObject retainGUIObject(GUIObject object);
+void releaseGUIObject(GUIObject object);
+int enterObjectEpoch();
+void leaveObjectEpoch(int slot);
+
+void invalidateLayout(GUIObject object);
+BOOL updateLayout(GUIObject object);
+
 void flushMessageQueue();
 
+BOOL addTreeChild(struct _treeFetch *fetch, const char *text, void *data, BOOL hasChildren);
+
 BOOL displayControl(Control control);
+BOOL displayControlTree(Control control);
+LONG getRealizationCount();
+
+UIFile loadUIFile(HINSTANCE instance, const char *path, const struct _uiHandler *handlers, unsigned int numHandlers);
+GUIObject UIFile_getObject(UIFile uiFile, const char *name);
+void deleteUIFile(UIFile uiFile);
 BOOL displayWindow(Window mainWindow, int nCmdShow);
\ No newline at end of file
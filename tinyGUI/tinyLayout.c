@@ -0,0 +1,933 @@
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "tinyLayout.h"
+
+#define LAYOUT_UNDEFINED (-1.0f)
+
+static struct _layoutStats layoutStats;
+
+static float clampSize(float size, float minSize, float maxSize){
+	if (size > maxSize)
+		size = maxSize;
+	if (size < minSize)
+		size = minSize;
+	return size;
+}
+
+static float maxFloat(float a, float b){
+	return a > b ? a : b;
+}
+
+/* Check if a node is laid out along rows (its main axis is horizontal) */
+static int isRow(LayoutNode node){
+	return node->direction == FLEX_ROW;
+}
+
+/* Get the effective alignment of a child in its parent */
+static enum _align getAlign(LayoutNode node, LayoutNode child){
+	if (child->alignSelf != ALIGN_AUTO)
+		return child->alignSelf;
+	return node->alignItems == ALIGN_AUTO ? ALIGN_STRETCH : node->alignItems;
+}
+
+
+
+/* The Constructor */
+LayoutNode newLayoutNode(void *context){
+	LayoutNode node = (LayoutNode)malloc(sizeof(struct _layoutNode));
+
+	if (!node)
+		return NULL;
+
+	memset(node, 0, sizeof(struct _layoutNode));
+
+	node->type = LAYOUT_NONE;
+	node->direction = FLEX_ROW;
+	node->justify = JUSTIFY_START;
+	node->alignItems = ALIGN_STRETCH;
+
+	node->shrink = 1.0f;
+	node->basis = LAYOUT_UNDEFINED;
+	node->alignSelf = ALIGN_AUTO;
+	node->preferredWidth = LAYOUT_UNDEFINED;
+	node->preferredHeight = LAYOUT_UNDEFINED;
+	node->maxWidth = FLT_MAX;
+	node->maxHeight = FLT_MAX;
+	node->column = -1;
+	node->row = -1;
+	node->columnSpan = 1;
+	node->rowSpan = 1;
+
+	node->context = context;
+	node->dirty = 1;
+
+	return node;
+}
+
+/* The Destructor */
+void deleteLayoutNode(LayoutNode node){
+	unsigned int i;
+
+	if (!node)
+		return;
+
+	if (node->parent)
+		LayoutNode_removeChild(node->parent, node);
+
+	for (i = 0; i < node->numChildren; i++)
+		(node->children)[i]->parent = NULL;
+
+	free(node->children);
+	free(node->columns);
+	free(node->rows);
+	free(node);
+}
+
+
+
+/* Tree */
+int LayoutNode_addChild(LayoutNode node, LayoutNode child){
+	LayoutNode *newChildrenPointer;
+	unsigned int newCapacity;
+
+	if (!node || !child)
+		return 0;
+
+	if (child->parent)
+		LayoutNode_removeChild(child->parent, child);
+
+	if (node->numChildren == node->childrenCapacity){
+		newCapacity = node->childrenCapacity ? node->childrenCapacity * 2 : 4;
+		newChildrenPointer = (LayoutNode*)realloc(node->children, newCapacity * sizeof(LayoutNode));
+		if (!newChildrenPointer)
+			return 0;
+		node->children = newChildrenPointer;
+		node->childrenCapacity = newCapacity;
+	}
+
+	(node->children)[(node->numChildren)++] = child;
+	child->parent = node;
+	LayoutNode_markDirty(node);
+
+	return 1;
+}
+
+int LayoutNode_removeChild(LayoutNode node, LayoutNode child){
+	unsigned int i;
+
+	if (!node || !child)
+		return 0;
+
+	for (i = 0; i < node->numChildren; i++)
+		if ((node->children)[i] == child){
+			memmove(node->children + i, node->children + i + 1, (node->numChildren - i - 1) * sizeof(LayoutNode));
+			(node->numChildren)--;
+			child->parent = NULL;
+			LayoutNode_markDirty(node);
+			return 1;
+		}
+
+	return 0;
+}
+
+
+
+/* Container style */
+void LayoutNode_setFlex(LayoutNode node, enum _flexDirection direction, enum _justify justify, enum _align alignItems, float gap){
+	if (!node)
+		return;
+
+	if (node->type == LAYOUT_FLEX && node->direction == direction && node->justify == justify && node->alignItems == alignItems &&
+			node->columnGap == gap && node->rowGap == gap)
+		return;
+
+	node->type = LAYOUT_FLEX;
+	node->direction = direction;
+	node->justify = justify;
+	node->alignItems = alignItems;
+	node->columnGap = gap;
+	node->rowGap = gap;
+	LayoutNode_markDirty(node);
+}
+
+int LayoutNode_setGrid(LayoutNode node, unsigned int numColumns, const struct _layoutTrack *columns,
+						unsigned int numRows, const struct _layoutTrack *rows, float columnGap, float rowGap){
+	struct _layoutTrack *newColumns = NULL, *newRows = NULL;
+
+	if (!node)
+		return 0;
+
+	if (numColumns){
+		newColumns = (struct _layoutTrack*)malloc(numColumns * sizeof(struct _layoutTrack));
+		if (!newColumns)
+			return 0;
+		memcpy(newColumns, columns, numColumns * sizeof(struct _layoutTrack));
+	}
+
+	if (numRows){
+		newRows = (struct _layoutTrack*)malloc(numRows * sizeof(struct _layoutTrack));
+		if (!newRows){
+			free(newColumns);
+			return 0;
+		}
+		memcpy(newRows, rows, numRows * sizeof(struct _layoutTrack));
+	}
+
+	free(node->columns);
+	free(node->rows);
+
+	node->type = LAYOUT_GRID;
+	node->columns = newColumns;
+	node->numColumns = numColumns;
+	node->rows = newRows;
+	node->numRows = numRows;
+	node->columnGap = columnGap;
+	node->rowGap = rowGap;
+	LayoutNode_markDirty(node);
+
+	return 1;
+}
+
+void LayoutNode_setPadding(LayoutNode node, float left, float top, float right, float bottom){
+	if (!node || (node->paddingLeft == left && node->paddingTop == top && node->paddingRight == right && node->paddingBottom == bottom))
+		return;
+
+	node->paddingLeft = left;
+	node->paddingTop = top;
+	node->paddingRight = right;
+	node->paddingBottom = bottom;
+	LayoutNode_markDirty(node);
+}
+
+
+
+/* Item style */
+void LayoutNode_setFlexItem(LayoutNode node, float grow, float shrink, float basis){
+	if (!node || (node->grow == grow && node->shrink == shrink && node->basis == basis))
+		return;
+
+	node->grow = grow;
+	node->shrink = shrink;
+	node->basis = basis;
+	LayoutNode_markDirty(node);
+}
+
+void LayoutNode_setGridCell(LayoutNode node, int column, int row, int columnSpan, int rowSpan){
+	if (!node)
+		return;
+
+	if (columnSpan < 1)
+		columnSpan = 1;
+	if (rowSpan < 1)
+		rowSpan = 1;
+
+	if (node->column == column && node->row == row && node->columnSpan == columnSpan && node->rowSpan == rowSpan)
+		return;
+
+	node->column = column;
+	node->row = row;
+	node->columnSpan = columnSpan;
+	node->rowSpan = rowSpan;
+	LayoutNode_markDirty(node);
+}
+
+void LayoutNode_setAlignSelf(LayoutNode node, enum _align alignSelf){
+	if (!node || node->alignSelf == alignSelf)
+		return;
+
+	node->alignSelf = alignSelf;
+	LayoutNode_markDirty(node);
+}
+
+void LayoutNode_setSize(LayoutNode node, float width, float height){
+	if (!node || (node->preferredWidth == width && node->preferredHeight == height))
+		return;
+
+	node->preferredWidth = width;
+	node->preferredHeight = height;
+	LayoutNode_markDirty(node);
+}
+
+void LayoutNode_setMinSize(LayoutNode node, float minWidth, float minHeight){
+	if (!node || (node->minWidth == minWidth && node->minHeight == minHeight))
+		return;
+
+	node->minWidth = minWidth;
+	node->minHeight = minHeight;
+	LayoutNode_markDirty(node);
+}
+
+void LayoutNode_setMaxSize(LayoutNode node, float maxWidth, float maxHeight){
+	if (!node || (node->maxWidth == maxWidth && node->maxHeight == maxHeight))
+		return;
+
+	node->maxWidth = maxWidth;
+	node->maxHeight = maxHeight;
+	LayoutNode_markDirty(node);
+}
+
+void LayoutNode_setMeasureFunc(LayoutNode node, LayoutMeasureFunc measure){
+	if (!node || node->measure == measure)
+		return;
+
+	node->measure = measure;
+	LayoutNode_markDirty(node);
+}
+
+/* Invalidates the caches of a node and its ancestors. The whole chain is walked even if some ancestors are already dirty,
+   as measurements made since they were marked may have been cached again */
+void LayoutNode_markDirty(LayoutNode node){
+	for (; node; node = node->parent){
+		node->numCacheEntries = 0;
+		node->dirty = 1;
+	}
+}
+
+
+
+/* MEASUREMENT */
+static void measureFlexContent(LayoutNode node, float availableWidth, enum _measureMode widthMode,
+								float availableHeight, enum _measureMode heightMode, float *width, float *height);
+static void measureGridContent(LayoutNode node, float availableWidth, enum _measureMode widthMode,
+								float availableHeight, enum _measureMode heightMode, float *width, float *height);
+
+/* Fits a measured size to its constraint */
+static float constrainSize(float size, float available, enum _measureMode mode){
+	if (mode == MEASURE_EXACTLY)
+		return available;
+	if (mode == MEASURE_AT_MOST && size > available)
+		return available;
+	return size;
+}
+
+void LayoutNode_measure(LayoutNode node, float availableWidth, enum _measureMode widthMode,
+						float availableHeight, enum _measureMode heightMode, float *width, float *height){
+	unsigned int i;
+	struct _layoutCacheEntry *entry;
+	float contentWidth = 0.0f, contentHeight = 0.0f, keyWidth, keyHeight;
+	enum _measureMode keyWidthMode = widthMode, keyHeightMode = heightMode;
+
+	layoutStats.numMeasures++;
+
+	if (widthMode == MEASURE_UNDEFINED)
+		availableWidth = 0.0f;
+	if (heightMode == MEASURE_UNDEFINED)
+		availableHeight = 0.0f;
+	keyWidth = availableWidth;
+	keyHeight = availableHeight;
+
+	/* Look the constraints up in the cache first */
+	for (i = 0; i < node->numCacheEntries; i++){
+		entry = &(node->cache)[i];
+		if (entry->widthMode == widthMode && entry->heightMode == heightMode &&
+				entry->availableWidth == availableWidth && entry->availableHeight == availableHeight){
+			*width = entry->width;
+			*height = entry->height;
+			layoutStats.numCacheHits++;
+			return;
+		}
+	}
+
+	/* A preferred size overrides the content in its dimension */
+	if (node->preferredWidth >= 0.0f && widthMode != MEASURE_EXACTLY){
+		availableWidth = node->preferredWidth;
+		widthMode = MEASURE_EXACTLY;
+	}
+	if (node->preferredHeight >= 0.0f && heightMode != MEASURE_EXACTLY){
+		availableHeight = node->preferredHeight;
+		heightMode = MEASURE_EXACTLY;
+	}
+
+	if (widthMode != MEASURE_EXACTLY || heightMode != MEASURE_EXACTLY){
+		if (node->type == LAYOUT_FLEX)
+			measureFlexContent(node, availableWidth, widthMode, availableHeight, heightMode, &contentWidth, &contentHeight);
+		else if (node->type == LAYOUT_GRID)
+			measureGridContent(node, availableWidth, widthMode, availableHeight, heightMode, &contentWidth, &contentHeight);
+		else if (node->measure)
+			node->measure(node, node->context, availableWidth, widthMode, availableHeight, heightMode, &contentWidth, &contentHeight);
+	}
+
+	contentWidth = clampSize(constrainSize(contentWidth, availableWidth, widthMode), node->minWidth, node->maxWidth);
+	contentHeight = clampSize(constrainSize(contentHeight, availableHeight, heightMode), node->minHeight, node->maxHeight);
+
+	/* Remember the result under the caller's constraints, the preferred size may have replaced them */
+	entry = &(node->cache)[node->nextCacheEntry];
+	entry->availableWidth = keyWidth;
+	entry->availableHeight = keyHeight;
+	entry->widthMode = keyWidthMode;
+	entry->heightMode = keyHeightMode;
+	entry->width = contentWidth;
+	entry->height = contentHeight;
+	node->nextCacheEntry = (node->nextCacheEntry + 1) % LAYOUT_CACHE_SIZE;
+	if (node->numCacheEntries < LAYOUT_CACHE_SIZE)
+		node->numCacheEntries++;
+
+	*width = contentWidth;
+	*height = contentHeight;
+}
+
+/* Gets a child's hypothetical main size in a flex layout, before growing and shrinking */
+static float getFlexBasis(LayoutNode node, LayoutNode child, float innerMain, float innerCross){
+	float width, height, preferredMain;
+
+	if (child->basis >= 0.0f)
+		return child->basis;
+
+	preferredMain = isRow(node) ? child->preferredWidth : child->preferredHeight;
+	if (preferredMain >= 0.0f)
+		return preferredMain;
+
+	if (isRow(node))
+		LayoutNode_measure(child, innerMain, MEASURE_UNDEFINED, innerCross,
+							getAlign(node, child) == ALIGN_STRETCH ? MEASURE_EXACTLY : MEASURE_AT_MOST, &width, &height);
+	else
+		LayoutNode_measure(child, innerCross, getAlign(node, child) == ALIGN_STRETCH ? MEASURE_EXACTLY : MEASURE_AT_MOST,
+							innerMain, MEASURE_UNDEFINED, &width, &height);
+
+	return isRow(node) ? width : height;
+}
+
+static void measureFlexContent(LayoutNode node, float availableWidth, enum _measureMode widthMode,
+								float availableHeight, enum _measureMode heightMode, float *width, float *height){
+	unsigned int i;
+	LayoutNode child;
+	float main = 0.0f, cross = 0.0f, childWidth, childHeight, gap = isRow(node) ? node->columnGap : node->rowGap;
+	float innerWidth = availableWidth - node->paddingLeft - node->paddingRight;
+	float innerHeight = availableHeight - node->paddingTop - node->paddingBottom;
+
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		if (isRow(node)){
+			LayoutNode_measure(child, innerWidth, MEASURE_UNDEFINED, innerHeight,
+								heightMode == MEASURE_UNDEFINED ? MEASURE_UNDEFINED : MEASURE_AT_MOST, &childWidth, &childHeight);
+			main += (child->basis >= 0.0f) ? child->basis : childWidth;
+			cross = maxFloat(cross, childHeight);
+		} else {
+			LayoutNode_measure(child, innerWidth, widthMode == MEASURE_UNDEFINED ? MEASURE_UNDEFINED : MEASURE_AT_MOST,
+								innerHeight, MEASURE_UNDEFINED, &childWidth, &childHeight);
+			main += (child->basis >= 0.0f) ? child->basis : childHeight;
+			cross = maxFloat(cross, childWidth);
+		}
+	}
+
+	if (node->numChildren > 1)
+		main += gap * (node->numChildren - 1);
+
+	*width = (isRow(node) ? main : cross) + node->paddingLeft + node->paddingRight;
+	*height = (isRow(node) ? cross : main) + node->paddingTop + node->paddingBottom;
+}
+
+
+
+/* FLEX LAYOUT */
+static void layoutNode(LayoutNode node, float width, float height);
+
+/* Grows or shrinks the children of a flex layout to fill the available main size, respecting their min and max sizes.
+   The children that hit a limit are frozen at it and the rest of the space is redistributed among the others */
+static void resolveFlexibleLengths(LayoutNode node, float available){
+	unsigned int i, pass;
+	LayoutNode child;
+	float used = 0.0f, remaining, totalFactor, target, clamped, violation, minMain, maxMain;
+	int growing;
+
+	for (i = 0; i < node->numChildren; i++)
+		used += (node->children)[i]->mainSize;
+
+	if (used == available)
+		return;
+	growing = used < available;
+
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		child->frozen = growing ? child->grow <= 0.0f : (child->shrink <= 0.0f || child->flexBasis <= 0.0f);
+	}
+
+	for (pass = 0; pass <= node->numChildren; pass++){
+		remaining = available;
+		totalFactor = 0.0f;
+		for (i = 0; i < node->numChildren; i++){
+			child = (node->children)[i];
+			if (child->frozen)
+				remaining -= child->mainSize;
+			else {
+				remaining -= child->flexBasis;
+				totalFactor += growing ? child->grow : child->shrink * child->flexBasis;
+			}
+		}
+
+		if (totalFactor <= 0.0f)
+			break;
+
+		violation = 0.0f;
+		for (i = 0; i < node->numChildren; i++){
+			child = (node->children)[i];
+			if (child->frozen)
+				continue;
+
+			target = child->flexBasis + remaining * (growing ? child->grow : child->shrink * child->flexBasis) / totalFactor;
+			minMain = isRow(node) ? child->minWidth : child->minHeight;
+			maxMain = isRow(node) ? child->maxWidth : child->maxHeight;
+			clamped = clampSize(target, minMain, maxMain);
+			violation += clamped - target;
+			child->mainSize = clamped;
+		}
+
+		if (violation == 0.0f)
+			break;
+
+		/* Freeze the children that violated their limits in the direction of the total violation, then redistribute */
+		for (i = 0; i < node->numChildren; i++){
+			child = (node->children)[i];
+			if (child->frozen)
+				continue;
+			minMain = isRow(node) ? child->minWidth : child->minHeight;
+			maxMain = isRow(node) ? child->maxWidth : child->maxHeight;
+			if ((violation > 0.0f && child->mainSize <= minMain) || (violation < 0.0f && child->mainSize >= maxMain))
+				child->frozen = 1;
+		}
+	}
+}
+
+static void layoutFlex(LayoutNode node, float width, float height){
+	unsigned int i;
+	LayoutNode child;
+	float innerMain, innerCross, gap, used = 0.0f, leftover, offset, spacing = 0.0f, cross, crossPosition;
+	float childWidth, childHeight, preferredCross, minCross, maxCross;
+	enum _align align;
+
+	if (isRow(node)){
+		innerMain = width - node->paddingLeft - node->paddingRight;
+		innerCross = height - node->paddingTop - node->paddingBottom;
+		gap = node->columnGap;
+	} else {
+		innerMain = height - node->paddingTop - node->paddingBottom;
+		innerCross = width - node->paddingLeft - node->paddingRight;
+		gap = node->rowGap;
+	}
+
+	if (node->numChildren == 0)
+		return;
+
+	/* Hypothetical main sizes */
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		child->flexBasis = getFlexBasis(node, child, innerMain, innerCross);
+		child->mainSize = isRow(node) ? clampSize(child->flexBasis, child->minWidth, child->maxWidth) :
+										clampSize(child->flexBasis, child->minHeight, child->maxHeight);
+	}
+
+	resolveFlexibleLengths(node, innerMain - gap * (node->numChildren - 1));
+
+	for (i = 0; i < node->numChildren; i++)
+		used += (node->children)[i]->mainSize;
+	used += gap * (node->numChildren - 1);
+
+	/* Distribute the leftover space along the main axis */
+	leftover = innerMain - used;
+	offset = 0.0f;
+	if (leftover > 0.0f){
+		switch (node->justify){
+			case JUSTIFY_END:
+				offset = leftover;
+				break;
+			case JUSTIFY_CENTER:
+				offset = leftover / 2.0f;
+				break;
+			case JUSTIFY_SPACE_BETWEEN:
+				spacing = (node->numChildren > 1) ? leftover / (node->numChildren - 1) : 0.0f;
+				break;
+			case JUSTIFY_SPACE_AROUND:
+				spacing = leftover / node->numChildren;
+				offset = spacing / 2.0f;
+				break;
+			case JUSTIFY_SPACE_EVENLY:
+				spacing = leftover / (node->numChildren + 1);
+				offset = spacing;
+				break;
+			default:
+				break;
+		}
+	} else if (node->justify == JUSTIFY_END)
+		offset = leftover;
+	else if (node->justify == JUSTIFY_CENTER)
+		offset = leftover / 2.0f;
+
+	offset += isRow(node) ? node->paddingLeft : node->paddingTop;
+
+	/* Cross sizes and positions */
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		align = getAlign(node, child);
+		preferredCross = isRow(node) ? child->preferredHeight : child->preferredWidth;
+		minCross = isRow(node) ? child->minHeight : child->minWidth;
+		maxCross = isRow(node) ? child->maxHeight : child->maxWidth;
+
+		if (align == ALIGN_STRETCH)
+			cross = clampSize(innerCross, minCross, maxCross);
+		else if (preferredCross >= 0.0f)
+			cross = clampSize(preferredCross, minCross, maxCross);
+		else {
+			if (isRow(node))
+				LayoutNode_measure(child, child->mainSize, MEASURE_EXACTLY, innerCross, MEASURE_AT_MOST, &childWidth, &childHeight);
+			else
+				LayoutNode_measure(child, innerCross, MEASURE_AT_MOST, child->mainSize, MEASURE_EXACTLY, &childWidth, &childHeight);
+			cross = isRow(node) ? childHeight : childWidth;
+		}
+
+		if (align == ALIGN_END)
+			crossPosition = innerCross - cross;
+		else if (align == ALIGN_CENTER)
+			crossPosition = (innerCross - cross) / 2.0f;
+		else
+			crossPosition = 0.0f;
+
+		if (isRow(node)){
+			child->x = offset;
+			child->y = node->paddingTop + crossPosition;
+			child->width = child->mainSize;
+			child->height = cross;
+		} else {
+			child->x = node->paddingLeft + crossPosition;
+			child->y = offset;
+			child->width = cross;
+			child->height = child->mainSize;
+		}
+
+		offset += child->mainSize + gap + spacing;
+		layoutNode(child, child->width, child->height);
+	}
+}
+
+
+
+/* GRID LAYOUT */
+/* Makes the cell occupancy of a grid being placed cover numRows rows of numColumns cells. The new rows are free */
+static int reserveGridRows(unsigned char **cells, unsigned int *capacity, unsigned int numColumns, unsigned int numRows){
+	unsigned char *newCells;
+	unsigned int newCapacity;
+
+	if (numRows <= *capacity)
+		return 1;
+
+	newCapacity = *capacity ? *capacity : 16;
+	while (newCapacity < numRows)
+		newCapacity *= 2;
+
+	newCells = (unsigned char*)realloc(*cells, (size_t)newCapacity * numColumns);
+	if (!newCells)
+		return 0;
+	memset(newCells + (size_t)*capacity * numColumns, 0, (size_t)(newCapacity - *capacity) * numColumns);
+	*cells = newCells;
+	*capacity = newCapacity;
+	return 1;
+}
+
+/* Tells whether the cells an item would cover at its placed cell are all free */
+static int isGridAreaFree(const unsigned char *cells, unsigned int numColumns, LayoutNode child){
+	int column, row;
+
+	for (row = child->placedRow; row < child->placedRow + child->rowSpan; row++)
+		for (column = child->placedColumn; column < child->placedColumn + child->placedColumnSpan; column++)
+			if (cells[(size_t)row * numColumns + column])
+				return 0;
+	return 1;
+}
+
+/* Marks the cells an item covers as taken */
+static void takeGridArea(unsigned char *cells, unsigned int numColumns, LayoutNode child){
+	int row;
+
+	for (row = child->placedRow; row < child->placedRow + child->rowSpan; row++)
+		memset(cells + (size_t)row * numColumns + child->placedColumn, 1, (size_t)child->placedColumnSpan);
+}
+
+/* Places the children of a grid in their cells. The children with a cell set are placed first, then the auto-placed ones fill the
+   cells they left free, row by row. The spans are clamped to the columns in placedColumnSpan, the children's style is left as it
+   was set. Stores the number of rows used, returns 0 if the cell occupancy could not be allocated */
+static int placeGridItems(LayoutNode node, unsigned int numColumns, unsigned int *numRows){
+	unsigned int i, cursorColumn = 0, cursorRow = 0, capacity = 0, numAuto = 0;
+	unsigned char *cells = NULL;
+	LayoutNode child;
+
+	*numRows = node->numRows;
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		child->placedColumnSpan = child->columnSpan < (int)numColumns ? child->columnSpan : (int)numColumns;
+		if (child->column < 0 || child->row < 0){
+			numAuto++;
+			continue;
+		}
+
+		child->placedColumn = child->column < (int)numColumns ? child->column : (int)numColumns - 1;
+		if (child->placedColumn + child->placedColumnSpan > (int)numColumns)
+			child->placedColumn = (int)numColumns - child->placedColumnSpan;
+		child->placedRow = child->row;
+		if ((unsigned int)(child->placedRow + child->rowSpan) > *numRows)
+			*numRows = child->placedRow + child->rowSpan;
+	}
+	if (!numAuto)
+		return 1;
+
+	if (!reserveGridRows(&cells, &capacity, numColumns, *numRows))
+		return 0;
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		if (child->column >= 0 && child->row >= 0)
+			takeGridArea(cells, numColumns, child);
+	}
+
+	/* The cursor only moves forward, an item never goes before the previous auto-placed one */
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		if (child->column >= 0 && child->row >= 0)
+			continue;
+
+		for (;;){
+			if (cursorColumn + child->placedColumnSpan > numColumns){
+				cursorColumn = 0;
+				cursorRow++;
+			}
+			if (!reserveGridRows(&cells, &capacity, numColumns, cursorRow + child->rowSpan)){
+				free(cells);
+				return 0;
+			}
+			child->placedColumn = (int)cursorColumn;
+			child->placedRow = (int)cursorRow;
+			if (isGridAreaFree(cells, numColumns, child))
+				break;
+			cursorColumn++;
+		}
+
+		takeGridArea(cells, numColumns, child);
+		cursorColumn += child->placedColumnSpan;
+		if ((unsigned int)(child->placedRow + child->rowSpan) > *numRows)
+			*numRows = child->placedRow + child->rowSpan;
+	}
+
+	free(cells);
+	return 1;
+}
+
+/* Gets a grid track definition, implicit tracks are auto */
+static struct _layoutTrack getTrack(const struct _layoutTrack *tracks, unsigned int numTracks, unsigned int index){
+	struct _layoutTrack autoTrack;
+
+	if (index < numTracks)
+		return tracks[index];
+
+	autoTrack.type = TRACK_AUTO;
+	autoTrack.value = 0.0f;
+	return autoTrack;
+}
+
+/* Computes the sizes of grid tracks. Fixed tracks get their size, auto tracks the size of their largest single-span item
+   (contentSizes), fraction tracks share what is left of the available size. With no available size, fractions act as auto */
+static void resolveTracks(const struct _layoutTrack *tracks, unsigned int numDefined, unsigned int numTracks, float available,
+							int hasAvailable, float gap, const float *contentSizes, float *sizes){
+	unsigned int i;
+	struct _layoutTrack track;
+	float remaining = available - gap * (numTracks ? numTracks - 1 : 0), totalWeight = 0.0f;
+
+	for (i = 0; i < numTracks; i++){
+		track = getTrack(tracks, numDefined, i);
+		if (track.type == TRACK_FIXED)
+			sizes[i] = track.value;
+		else if (track.type == TRACK_AUTO || !hasAvailable)
+			sizes[i] = contentSizes[i];
+		else {
+			sizes[i] = 0.0f;
+			totalWeight += track.value;
+			continue;
+		}
+		remaining -= sizes[i];
+	}
+
+	if (totalWeight > 0.0f && remaining > 0.0f)
+		for (i = 0; i < numTracks; i++){
+			track = getTrack(tracks, numDefined, i);
+			if (track.type == TRACK_FRACTION)
+				sizes[i] = remaining * track.value / totalWeight;
+		}
+}
+
+/* Sums the sizes of a span of tracks with the gaps between them */
+static float getSpanSize(const float *sizes, int first, int span, float gap){
+	int i;
+	float size = gap * (span - 1);
+
+	for (i = first; i < first + span; i++)
+		size += sizes[i];
+	return size;
+}
+
+/* Resolves the column and row sizes of a grid. Returns FALSE if the track arrays could not be allocated */
+static int resolveGrid(LayoutNode node, float innerWidth, int hasWidth, float innerHeight, int hasHeight,
+						unsigned int *numColumns, unsigned int *numRows, float **columnSizes, float **rowSizes){
+	unsigned int i;
+	LayoutNode child;
+	float *columnContent, *rowContent, childWidth, childHeight;
+
+	*numColumns = node->numColumns ? node->numColumns : 1;
+	if (!placeGridItems(node, *numColumns, numRows))
+		return 0;
+
+	*columnSizes = (float*)malloc((*numColumns + *numRows) * sizeof(float));
+	columnContent = (float*)calloc(*numColumns + *numRows, sizeof(float));
+	if (!*columnSizes || !columnContent){
+		free(*columnSizes);
+		free(columnContent);
+		return 0;
+	}
+	*rowSizes = *columnSizes + *numColumns;
+	rowContent = columnContent + *numColumns;
+
+	/* Columns first, measuring the items with unconstrained widths */
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		if (child->placedColumnSpan == 1 && getTrack(node->columns, node->numColumns, child->placedColumn).type != TRACK_FIXED){
+			LayoutNode_measure(child, 0.0f, MEASURE_UNDEFINED, 0.0f, MEASURE_UNDEFINED, &childWidth, &childHeight);
+			columnContent[child->placedColumn] = maxFloat(columnContent[child->placedColumn], childWidth);
+		}
+	}
+	resolveTracks(node->columns, node->numColumns, *numColumns, innerWidth, hasWidth, node->columnGap, columnContent, *columnSizes);
+
+	/* Then rows, measuring the items with the widths of their columns */
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		if (child->rowSpan == 1 && getTrack(node->rows, node->numRows, child->placedRow).type != TRACK_FIXED){
+			LayoutNode_measure(child, getSpanSize(*columnSizes, child->placedColumn, child->placedColumnSpan, node->columnGap), MEASURE_AT_MOST,
+								0.0f, MEASURE_UNDEFINED, &childWidth, &childHeight);
+			rowContent[child->placedRow] = maxFloat(rowContent[child->placedRow], childHeight);
+		}
+	}
+	resolveTracks(node->rows, node->numRows, *numRows, innerHeight, hasHeight, node->rowGap, rowContent, *rowSizes);
+
+	free(columnContent);
+	return 1;
+}
+
+static void measureGridContent(LayoutNode node, float availableWidth, enum _measureMode widthMode,
+								float availableHeight, enum _measureMode heightMode, float *width, float *height){
+	unsigned int numColumns, numRows;
+	float *columnSizes, *rowSizes;
+
+	*width = node->paddingLeft + node->paddingRight;
+	*height = node->paddingTop + node->paddingBottom;
+
+	if (!resolveGrid(node, availableWidth - *width, widthMode == MEASURE_EXACTLY, availableHeight - *height, heightMode == MEASURE_EXACTLY,
+						&numColumns, &numRows, &columnSizes, &rowSizes))
+		return;
+
+	*width += getSpanSize(columnSizes, 0, (int)numColumns, node->columnGap);
+	if (numRows)
+		*height += getSpanSize(rowSizes, 0, (int)numRows, node->rowGap);
+
+	free(columnSizes);
+}
+
+/* Positions an item inside a grid cell area along one axis */
+static void alignInCell(enum _align align, float cellPosition, float cellSize, float preferredSize, float measuredSize,
+						float minSize, float maxSize, float *position, float *size){
+	if (align == ALIGN_STRETCH)
+		*size = clampSize(cellSize, minSize, maxSize);
+	else
+		*size = clampSize(preferredSize >= 0.0f ? preferredSize : measuredSize, minSize, maxSize);
+
+	if (align == ALIGN_END)
+		*position = cellPosition + cellSize - *size;
+	else if (align == ALIGN_CENTER)
+		*position = cellPosition + (cellSize - *size) / 2.0f;
+	else
+		*position = cellPosition;
+}
+
+static void layoutGrid(LayoutNode node, float width, float height){
+	unsigned int i, numColumns, numRows;
+	LayoutNode child;
+	float *columnSizes, *rowSizes, *columnOffsets, *rowOffsets, cellWidth, cellHeight, childWidth = 0.0f, childHeight = 0.0f;
+	enum _align align;
+
+	if (node->numChildren == 0)
+		return;
+
+	if (!resolveGrid(node, width - node->paddingLeft - node->paddingRight, 1, height - node->paddingTop - node->paddingBottom, 1,
+						&numColumns, &numRows, &columnSizes, &rowSizes))
+		return;
+
+	columnOffsets = (float*)malloc((numColumns + numRows) * sizeof(float));
+	if (!columnOffsets){
+		free(columnSizes);
+		return;
+	}
+	rowOffsets = columnOffsets + numColumns;
+
+	for (i = 0; i < numColumns; i++)
+		columnOffsets[i] = (i == 0) ? node->paddingLeft : columnOffsets[i - 1] + columnSizes[i - 1] + node->columnGap;
+	for (i = 0; i < numRows; i++)
+		rowOffsets[i] = (i == 0) ? node->paddingTop : rowOffsets[i - 1] + rowSizes[i - 1] + node->rowGap;
+
+	for (i = 0; i < node->numChildren; i++){
+		child = (node->children)[i];
+		align = getAlign(node, child);
+		cellWidth = getSpanSize(columnSizes, child->placedColumn, child->placedColumnSpan, node->columnGap);
+		cellHeight = getSpanSize(rowSizes, child->placedRow, child->rowSpan, node->rowGap);
+
+		if (align != ALIGN_STRETCH)
+			LayoutNode_measure(child, cellWidth, MEASURE_AT_MOST, cellHeight, MEASURE_AT_MOST, &childWidth, &childHeight);
+
+		alignInCell(align, columnOffsets[child->placedColumn], cellWidth, child->preferredWidth, childWidth,
+					child->minWidth, child->maxWidth, &(child->x), &(child->width));
+		alignInCell(align, rowOffsets[child->placedRow], cellHeight, child->preferredHeight, childHeight,
+					child->minHeight, child->maxHeight, &(child->y), &(child->height));
+
+		layoutNode(child, child->width, child->height);
+	}
+
+	free(columnOffsets);
+	free(columnSizes);
+}
+
+
+
+/* LAYOUT */
+/* Lays out a node's children for the given size, unless the node is clean and was already laid out for this size */
+static void layoutNode(LayoutNode node, float width, float height){
+	if (node->type == LAYOUT_NONE){
+		node->dirty = 0;
+		return;
+	}
+
+	if (!node->dirty && node->hasLayout && node->layoutWidth == width && node->layoutHeight == height){
+		layoutStats.numLayoutsSkipped++;
+		return;
+	}
+
+	layoutStats.numLayouts++;
+
+	if (node->type == LAYOUT_FLEX)
+		layoutFlex(node, width, height);
+	else
+		layoutGrid(node, width, height);
+
+	node->layoutWidth = width;
+	node->layoutHeight = height;
+	node->hasLayout = 1;
+	node->dirty = 0;
+}
+
+void LayoutNode_calculate(LayoutNode node, float width, float height){
+	if (!node)
+		return;
+
+	node->width = width;
+	node->height = height;
+	layoutNode(node, width, height);
+}
+
+void getLayoutStats(struct _layoutStats *stats, int reset){
+	if (stats)
+		*stats = layoutStats;
+	if (reset)
+		memset(&layoutStats, 0, sizeof(struct _layoutStats));
+}
@@ -0,0 +1,176 @@
+#ifndef TINYLAYOUT_H
+#define TINYLAYOUT_H
+
+/* tinyLayout - the flexbox and grid layout engine of tinyGUI. It doesn't depend on WinAPI, so it can be built, tested and
+   benchmarked on any platform. tinyGUI builds a tree of layout nodes alongside the GUIObjects that opt into it */
+
+/* Layout node container types */
+enum _layoutType {
+	LAYOUT_NONE, /* The node doesn't lay out its children, it is only placed by its parent */
+	LAYOUT_FLEX, /* The children are placed in a single row or column */
+	LAYOUT_GRID /* The children are placed in the cells of a grid */
+};
+
+/* Flex layout directions */
+enum _flexDirection {
+	FLEX_ROW,
+	FLEX_COLUMN
+};
+
+/* Distribution of the free space along the main axis of a flex layout */
+enum _justify {
+	JUSTIFY_START,
+	JUSTIFY_END,
+	JUSTIFY_CENTER,
+	JUSTIFY_SPACE_BETWEEN,
+	JUSTIFY_SPACE_AROUND,
+	JUSTIFY_SPACE_EVENLY
+};
+
+/* Alignment along the cross axis of a flex layout, or inside a grid cell */
+enum _align {
+	ALIGN_AUTO, /* Use the parent's alignItems setting */
+	ALIGN_START,
+	ALIGN_END,
+	ALIGN_CENTER,
+	ALIGN_STRETCH
+};
+
+/* Grid column and row sizing */
+enum _trackType {
+	TRACK_FIXED, /* A fixed size, in pixels */
+	TRACK_FRACTION, /* A share of the space left after the other tracks, proportional to the value */
+	TRACK_AUTO /* The size of the largest item in the track */
+};
+
+/* Measurement constraint modes */
+enum _measureMode {
+	MEASURE_UNDEFINED, /* There is no constraint on the size */
+	MEASURE_EXACTLY, /* The size must be the available size */
+	MEASURE_AT_MOST /* The size can't exceed the available size */
+};
+
+/* A grid column or row */
+struct _layoutTrack {
+	enum _trackType type;
+	float value; /* The size for fixed tracks, the weight for fraction tracks */
+};
+
+/* A cached measurement, keyed by the constraints it was made under */
+struct _layoutCacheEntry {
+	float availableWidth;
+	float availableHeight;
+	enum _measureMode widthMode;
+	enum _measureMode heightMode;
+	float width;
+	float height;
+};
+
+#define LAYOUT_CACHE_SIZE 4
+
+typedef struct _layoutNode *LayoutNode;
+
+/* A callback that measures the content of a leaf node (like the text of a label) under the given constraints */
+typedef void (*LayoutMeasureFunc)(LayoutNode node, void *context, float availableWidth, enum _measureMode widthMode,
+									float availableHeight, enum _measureMode heightMode, float *width, float *height);
+
+struct _layoutNode {
+	/* container style */
+	enum _layoutType type; /* How the node lays out its children */
+	enum _flexDirection direction; /* The main axis of a flex layout */
+	enum _justify justify; /* The distribution of free space along the main axis of a flex layout */
+	enum _align alignItems; /* The default alignment of the children */
+	float columnGap; /* The space between columns (and between the children of a row flex layout) */
+	float rowGap; /* The space between rows (and between the children of a column flex layout) */
+	float paddingLeft, paddingTop, paddingRight, paddingBottom;
+	struct _layoutTrack *columns; /* The grid columns */
+	unsigned int numColumns;
+	struct _layoutTrack *rows; /* The grid rows. Items placed below the last row get implicit auto rows */
+	unsigned int numRows;
+
+	/* item style */
+	float grow; /* The share of the free space the node gets in a flex layout */
+	float shrink; /* The share of the overflow the node gives up in a flex layout */
+	float basis; /* The initial main size in a flex layout, negative for the preferred or measured size */
+	enum _align alignSelf; /* The node's alignment, overrides the parent's alignItems */
+	float preferredWidth, preferredHeight; /* The preferred size, negative if it should be measured. Stretched nodes ignore it
+											   along the cross axis of a flex layout and in grid cells */
+	float minWidth, minHeight;
+	float maxWidth, maxHeight;
+	int column, row; /* The grid cell, negative for automatic placement */
+	int columnSpan, rowSpan;
+
+	LayoutMeasureFunc measure; /* Measures the content of a leaf node */
+	void *context; /* A pointer passed to the measure callback, tinyGUI stores the GUIObject here */
+
+	/* links */
+	LayoutNode parent;
+	LayoutNode *children;
+	unsigned int numChildren;
+	unsigned int childrenCapacity;
+
+	/* results, relative to the parent */
+	float x, y;
+	float width, height;
+
+	/* caches */
+	int dirty; /* The node or one of its descendants changed since it was last laid out */
+	int hasLayout; /* The node's children have been laid out */
+	float layoutWidth, layoutHeight; /* The size the node's children were last laid out for */
+	struct _layoutCacheEntry cache[LAYOUT_CACHE_SIZE];
+	unsigned int numCacheEntries;
+	unsigned int nextCacheEntry;
+
+	/* scratch values used while the parent lays the node out */
+	float flexBasis, mainSize;
+	int frozen;
+	int placedColumn, placedRow;
+	int placedColumnSpan; /* columnSpan, clamped to the grid's columns */
+};
+
+/* Layout statistics, useful to check the effectiveness of the caches */
+struct _layoutStats {
+	unsigned long numMeasures; /* Calls to measure, including the cached ones */
+	unsigned long numCacheHits; /* Measures answered from the cache */
+	unsigned long numLayouts; /* Containers whose children were laid out */
+	unsigned long numLayoutsSkipped; /* Containers that were clean and kept their previous layout */
+};
+
+/* Constructor and destructor. Deleting a node detaches it from its parent and detaches its children */
+LayoutNode newLayoutNode(void *context);
+void deleteLayoutNode(LayoutNode node);
+
+/* Tree */
+int LayoutNode_addChild(LayoutNode node, LayoutNode child);
+int LayoutNode_removeChild(LayoutNode node, LayoutNode child);
+
+/* Container style */
+void LayoutNode_setFlex(LayoutNode node, enum _flexDirection direction, enum _justify justify, enum _align alignItems, float gap);
+int LayoutNode_setGrid(LayoutNode node, unsigned int numColumns, const struct _layoutTrack *columns,
+						unsigned int numRows, const struct _layoutTrack *rows, float columnGap, float rowGap);
+void LayoutNode_setPadding(LayoutNode node, float left, float top, float right, float bottom);
+
+/* Item style */
+void LayoutNode_setFlexItem(LayoutNode node, float grow, float shrink, float basis);
+void LayoutNode_setGridCell(LayoutNode node, int column, int row, int columnSpan, int rowSpan);
+void LayoutNode_setAlignSelf(LayoutNode node, enum _align alignSelf);
+void LayoutNode_setSize(LayoutNode node, float width, float height);
+void LayoutNode_setMinSize(LayoutNode node, float minWidth, float minHeight);
+void LayoutNode_setMaxSize(LayoutNode node, float maxWidth, float maxHeight);
+void LayoutNode_setMeasureFunc(LayoutNode node, LayoutMeasureFunc measure);
+
+/* Invalidates a node's cached measurements and layout, along with its ancestors'. The setters above do this automatically when
+   a value changes, call it when a measure callback would return a different result */
+void LayoutNode_markDirty(LayoutNode node);
+
+/* Measures a node under the given constraints. The result is cached until the node is marked dirty */
+void LayoutNode_measure(LayoutNode node, float availableWidth, enum _measureMode widthMode,
+						float availableHeight, enum _measureMode heightMode, float *width, float *height);
+
+/* Lays out a node's subtree for the given size of the node. Clean subtrees that keep their size are skipped */
+void LayoutNode_calculate(LayoutNode node, float width, float height);
+
+/* Gets and resets the layout statistics */
+void getLayoutStats(struct _layoutStats *stats, int reset);
+
+#endif
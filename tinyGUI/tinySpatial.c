@@ -0,0 +1,386 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tinySpatial.h"
+
+#define SPATIAL_ITEM_LIVE (-2) /* The nextFree value of items in use */
+#define SPATIAL_MAX_CELLS (1 << 20) /* The grid doesn't grow beyond this, items outside it are kept in its edge cells */
+
+/* Divides rounding towards negative infinity, so that negative coordinates get their own cells */
+static int floorDiv(int value, int divisor){
+	return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+/* Gets the column of a coordinate, clamped to the grid */
+static int getColumn(SpatialIndex index, int x){
+	int column = floorDiv(x - index->originX, index->cellSize);
+	return column < 0 ? 0 : (column >= index->numColumns ? index->numColumns - 1 : column);
+}
+
+/* Gets the row of a coordinate, clamped to the grid */
+static int getRow(SpatialIndex index, int y){
+	int row = floorDiv(y - index->originY, index->cellSize);
+	return row < 0 ? 0 : (row >= index->numRows ? index->numRows - 1 : row);
+}
+
+/* Computes the range of cells an item is stored in */
+static void getCellRange(SpatialIndex index, struct _spatialItem *item){
+	item->cellLeft = getColumn(index, item->left);
+	item->cellTop = getRow(index, item->top);
+	item->cellRight = getColumn(index, item->right > item->left ? item->right - 1 : item->left);
+	item->cellBottom = getRow(index, item->bottom > item->top ? item->bottom - 1 : item->top);
+}
+
+static int addToCell(struct _spatialCell *cell, int item){
+	int *newItems;
+	unsigned int newCapacity;
+
+	if (cell->numItems == cell->capacity){
+		newCapacity = cell->capacity ? cell->capacity * 2 : 4;
+		newItems = (int*)realloc(cell->items, newCapacity * sizeof(int));
+		if (!newItems)
+			return 0;
+		cell->items = newItems;
+		cell->capacity = newCapacity;
+	}
+
+	(cell->items)[(cell->numItems)++] = item;
+	return 1;
+}
+
+static void removeFromCell(struct _spatialCell *cell, int item){
+	unsigned int i;
+
+	for (i = 0; i < cell->numItems; i++)
+		if ((cell->items)[i] == item){
+			(cell->items)[i] = (cell->items)[--(cell->numItems)];
+			return;
+		}
+}
+
+/* Adds an item to the cells in its cell range */
+static int addToCells(SpatialIndex index, int item){
+	struct _spatialItem *currItem = &(index->items)[item];
+	int column, row, result = 1;
+
+	for (row = currItem->cellTop; row <= currItem->cellBottom; row++)
+		for (column = currItem->cellLeft; column <= currItem->cellRight; column++)
+			if (!addToCell(&(index->cells)[row * index->numColumns + column], item))
+				result = 0;
+
+	return result;
+}
+
+/* Removes an item from the cells in its cell range */
+static void removeFromCells(SpatialIndex index, int item){
+	struct _spatialItem *currItem = &(index->items)[item];
+	int column, row;
+
+	for (row = currItem->cellTop; row <= currItem->cellBottom; row++)
+		for (column = currItem->cellLeft; column <= currItem->cellRight; column++)
+			removeFromCell(&(index->cells)[row * index->numColumns + column], item);
+}
+
+/* Puts an item on the free list */
+static void freeItem(SpatialIndex index, int item){
+	(index->items)[item].data = NULL;
+	(index->items)[item].nextFree = index->firstFree;
+	index->firstFree = item;
+	(index->count)--;
+}
+
+static void freeCells(SpatialIndex index){
+	int i;
+
+	for (i = 0; i < index->numColumns * index->numRows; i++)
+		free((index->cells)[i].items);
+	free(index->cells);
+	index->cells = NULL;
+}
+
+/* Grows the grid to cover a rectangle, if it doesn't already and the grid isn't at its maximum size. The grid grows by at least half
+   of its size on the sides it grows on, and all the items are redistributed. Returns 1 if the grid was rebuilt, -1 if there was no
+   grid and it couldn't be allocated */
+static int coverRect(SpatialIndex index, int left, int top, int right, int bottom){
+	int firstColumn, firstRow, lastColumn, lastRow, oldLastColumn, oldLastRow, numColumns, numRows;
+	struct _spatialCell *newCells;
+	unsigned int i;
+
+	if (right <= left)
+		right = left + 1;
+	if (bottom <= top)
+		bottom = top + 1;
+
+	firstColumn = floorDiv(left - index->originX, index->cellSize);
+	firstRow = floorDiv(top - index->originY, index->cellSize);
+	lastColumn = floorDiv(right - 1 - index->originX, index->cellSize);
+	lastRow = floorDiv(bottom - 1 - index->originY, index->cellSize);
+
+	if (index->cells && firstColumn >= 0 && firstRow >= 0 && lastColumn < index->numColumns && lastRow < index->numRows)
+		return 0;
+
+	if (index->cells){
+		oldLastColumn = index->numColumns - 1;
+		oldLastRow = index->numRows - 1;
+		if (firstColumn < 0)
+			firstColumn = (firstColumn < -index->numColumns / 2) ? firstColumn : -index->numColumns / 2;
+		else
+			firstColumn = 0;
+		if (firstRow < 0)
+			firstRow = (firstRow < -index->numRows / 2) ? firstRow : -index->numRows / 2;
+		else
+			firstRow = 0;
+		if (lastColumn > oldLastColumn)
+			lastColumn = (lastColumn > oldLastColumn + index->numColumns / 2) ? lastColumn : oldLastColumn + index->numColumns / 2;
+		else
+			lastColumn = oldLastColumn;
+		if (lastRow > oldLastRow)
+			lastRow = (lastRow > oldLastRow + index->numRows / 2) ? lastRow : oldLastRow + index->numRows / 2;
+		else
+			lastRow = oldLastRow;
+	}
+
+	numColumns = lastColumn - firstColumn + 1;
+	numRows = lastRow - firstRow + 1;
+	if (numColumns <= 0 || numRows <= 0 || (double)numColumns * numRows > SPATIAL_MAX_CELLS){
+		if (index->cells)
+			return 0; /* Keep the grid, the items beyond it go to its edge cells */
+		numColumns = numColumns <= 0 ? 1 : (numColumns > 1024 ? 1024 : numColumns);
+		numRows = numRows <= 0 ? 1 : (numRows > 1024 ? 1024 : numRows);
+	}
+
+	newCells = (struct _spatialCell*)calloc((size_t)numColumns * numRows, sizeof(struct _spatialCell));
+	if (!newCells)
+		return index->cells ? 0 : -1; /* A grid that can't grow is kept, like one at its maximum size */
+
+	freeCells(index);
+	index->originX += firstColumn * index->cellSize;
+	index->originY += firstRow * index->cellSize;
+	index->numColumns = numColumns;
+	index->numRows = numRows;
+	index->cells = newCells;
+
+	for (i = 0; i < index->numItems; i++)
+		if ((index->items)[i].nextFree == SPATIAL_ITEM_LIVE){
+			getCellRange(index, &(index->items)[i]);
+			addToCells(index, (int)i);
+		}
+
+	return 1;
+}
+
+
+
+/* The Constructor */
+SpatialIndex newSpatialIndex(int cellSize){
+	SpatialIndex index = (SpatialIndex)malloc(sizeof(struct _spatialIndex));
+
+	if (!index)
+		return NULL;
+
+	memset(index, 0, sizeof(struct _spatialIndex));
+	index->cellSize = cellSize > 0 ? cellSize : 64;
+	index->firstFree = -1;
+
+	return index;
+}
+
+/* The Destructor */
+void deleteSpatialIndex(SpatialIndex index){
+	if (!index)
+		return;
+
+	freeCells(index);
+	free(index->items);
+	free(index);
+}
+
+
+
+/* Items */
+int SpatialIndex_insert(SpatialIndex index, void *data, int left, int top, int right, int bottom){
+	struct _spatialItem *newItems, *currItem;
+	unsigned int newCapacity;
+	int item, rebuilt;
+
+	if (!index)
+		return -1;
+
+	if (index->firstFree >= 0){
+		item = index->firstFree;
+		index->firstFree = (index->items)[item].nextFree;
+	} else {
+		if (index->numItems == index->capacity){
+			newCapacity = index->capacity ? index->capacity * 2 : 16;
+			newItems = (struct _spatialItem*)realloc(index->items, newCapacity * sizeof(struct _spatialItem));
+			if (!newItems)
+				return -1;
+			index->items = newItems;
+			index->capacity = newCapacity;
+		}
+		item = (int)(index->numItems)++;
+	}
+
+	currItem = &(index->items)[item];
+	currItem->left = left; currItem->top = top;
+	currItem->right = right; currItem->bottom = bottom;
+	currItem->data = data;
+	currItem->order = (index->nextOrder)++;
+	currItem->stamp = index->queryStamp;
+	currItem->nextFree = SPATIAL_ITEM_LIVE;
+	(index->count)++;
+
+	/* A rebuilt grid already holds the new item. Without a grid, the item can't be stored */
+	rebuilt = coverRect(index, left, top, right, bottom);
+	if (rebuilt < 0){
+		freeItem(index, item);
+		return -1;
+	}
+	if (!rebuilt){
+		getCellRange(index, currItem);
+		if (!addToCells(index, item)){
+			SpatialIndex_remove(index, item);
+			return -1;
+		}
+	}
+
+	return item;
+}
+
+int SpatialIndex_update(SpatialIndex index, int item, int left, int top, int right, int bottom){
+	struct _spatialItem *currItem, newRange;
+
+	if (!index || item < 0 || (unsigned int)item >= index->numItems || (index->items)[item].nextFree != SPATIAL_ITEM_LIVE)
+		return 0;
+
+	currItem = &(index->items)[item];
+	if (currItem->left == left && currItem->top == top && currItem->right == right && currItem->bottom == bottom)
+		return 1;
+
+	newRange.left = left; newRange.top = top;
+	newRange.right = right; newRange.bottom = bottom;
+	getCellRange(index, &newRange);
+
+	if (newRange.cellLeft == currItem->cellLeft && newRange.cellTop == currItem->cellTop &&
+			newRange.cellRight == currItem->cellRight && newRange.cellBottom == currItem->cellBottom){
+		/* Still in the same cells, which is the common case for small moves */
+		currItem->left = left; currItem->top = top;
+		currItem->right = right; currItem->bottom = bottom;
+		coverRect(index, left, top, right, bottom); /* The range may have been clamped to the grid's edge cells */
+		return 1;
+	}
+
+	removeFromCells(index, item);
+	currItem->left = left; currItem->top = top;
+	currItem->right = right; currItem->bottom = bottom;
+
+	if (coverRect(index, left, top, right, bottom) > 0)
+		return 1;
+
+	getCellRange(index, currItem);
+	return addToCells(index, item);
+}
+
+int SpatialIndex_remove(SpatialIndex index, int item){
+	if (!index || item < 0 || (unsigned int)item >= index->numItems || (index->items)[item].nextFree != SPATIAL_ITEM_LIVE)
+		return 0;
+
+	removeFromCells(index, item);
+	freeItem(index, item);
+
+	return 1;
+}
+
+void SpatialIndex_clear(SpatialIndex index){
+	if (!index)
+		return;
+
+	freeCells(index);
+	index->numColumns = index->numRows = 0;
+	index->originX = index->originY = 0;
+	index->numItems = 0;
+	index->firstFree = -1;
+	index->count = 0;
+}
+
+
+
+/* Queries */
+void *SpatialIndex_hitTest(SpatialIndex index, int x, int y){
+	struct _spatialCell *cell;
+	struct _spatialItem *currItem, *topItem = NULL;
+	unsigned int i;
+
+	if (!index || !index->cells)
+		return NULL;
+
+	cell = &(index->cells)[getRow(index, y) * index->numColumns + getColumn(index, x)];
+	for (i = 0; i < cell->numItems; i++){
+		currItem = &(index->items)[(cell->items)[i]];
+		if (x >= currItem->left && x < currItem->right && y >= currItem->top && y < currItem->bottom &&
+				(!topItem || currItem->order > topItem->order))
+			topItem = currItem;
+	}
+
+	return topItem ? topItem->data : NULL;
+}
+
+unsigned int SpatialIndex_queryPoint(SpatialIndex index, int x, int y, SpatialQueryFunc callback, void *context){
+	struct _spatialCell *cell;
+	struct _spatialItem *currItem;
+	unsigned int i, numFound = 0;
+
+	if (!index || !index->cells)
+		return 0;
+
+	cell = &(index->cells)[getRow(index, y) * index->numColumns + getColumn(index, x)];
+	for (i = 0; i < cell->numItems; i++){
+		currItem = &(index->items)[(cell->items)[i]];
+		if (x >= currItem->left && x < currItem->right && y >= currItem->top && y < currItem->bottom){
+			numFound++;
+			if (callback && !callback(currItem->data, context))
+				break;
+		}
+	}
+
+	return numFound;
+}
+
+unsigned int SpatialIndex_queryRect(SpatialIndex index, int left, int top, int right, int bottom, SpatialQueryFunc callback,
+									void *context){
+	struct _spatialCell *cell;
+	struct _spatialItem *currItem;
+	int column, row, firstColumn, lastColumn, firstRow, lastRow;
+	unsigned int i, numFound = 0;
+
+	if (!index || !index->cells || right <= left || bottom <= top)
+		return 0;
+
+	/* A new stamp for this query. When the stamps wrap around, the old ones are cleared */
+	if (++(index->queryStamp) == 0){
+		for (i = 0; i < index->numItems; i++)
+			(index->items)[i].stamp = 0;
+		index->queryStamp = 1;
+	}
+
+	firstColumn = getColumn(index, left); lastColumn = getColumn(index, right - 1);
+	firstRow = getRow(index, top); lastRow = getRow(index, bottom - 1);
+
+	for (row = firstRow; row <= lastRow; row++)
+		for (column = firstColumn; column <= lastColumn; column++){
+			cell = &(index->cells)[row * index->numColumns + column];
+			for (i = 0; i < cell->numItems; i++){
+				currItem = &(index->items)[(cell->items)[i]];
+				if (currItem->stamp == index->queryStamp)
+					continue;
+				currItem->stamp = index->queryStamp;
+
+				if (currItem->left < right && currItem->right > left && currItem->top < bottom && currItem->bottom > top){
+					numFound++;
+					if (callback && !callback(currItem->data, context))
+						return numFound;
+				}
+			}
+		}
+
+	return numFound;
+}
@@ -0,0 +1,66 @@
+#ifndef TINYSPATIAL_H
+#define TINYSPATIAL_H
+
+/* tinySpatial - a uniform grid spatial index over rectangles, used by tinyGUI for hit-testing and rectangle queries over large
+   sets of children or custom-drawn shapes. Like tinyLayout, it doesn't depend on WinAPI */
+
+/* An item stored in the index */
+struct _spatialItem {
+	int left, top, right, bottom; /* The item's rectangle, right and bottom are exclusive */
+	int cellLeft, cellTop, cellRight, cellBottom; /* The range of cells the item is stored in */
+	void *data; /* The pointer returned by the queries */
+	unsigned long order; /* The insertion order, later items are on top */
+	unsigned int stamp; /* The last query that reported the item, so that items spanning several cells are reported once */
+	int nextFree; /* The next free item, for removed items */
+};
+
+/* A grid cell, holding the handles of the items that overlap it */
+struct _spatialCell {
+	int *items;
+	unsigned int numItems;
+	unsigned int capacity;
+};
+
+typedef struct _spatialIndex *SpatialIndex;
+
+struct _spatialIndex {
+	int cellSize; /* The width and height of the grid cells */
+	int originX, originY; /* The top left corner of the grid */
+	int numColumns, numRows;
+	struct _spatialCell *cells; /* Items beyond the grid are stored in its edge cells */
+
+	struct _spatialItem *items;
+	unsigned int numItems; /* The number of item slots in use, including the removed ones */
+	unsigned int capacity;
+	int firstFree; /* The first removed item slot, -1 if none */
+	unsigned int count; /* The number of items in the index */
+
+	unsigned long nextOrder;
+	unsigned int queryStamp;
+};
+
+/* A query callback, called with each item's data. Returning 0 stops the query */
+typedef int (*SpatialQueryFunc)(void *data, void *context);
+
+/* Constructor and destructor. The cell size should be around the size of a typical item */
+SpatialIndex newSpatialIndex(int cellSize);
+void deleteSpatialIndex(SpatialIndex index);
+
+/* Adds an item with a rectangle to the index. Returns the item's handle, or -1 on failure */
+int SpatialIndex_insert(SpatialIndex index, void *data, int left, int top, int right, int bottom);
+/* Moves or resizes an item. Returns 0 on failure */
+int SpatialIndex_update(SpatialIndex index, int item, int left, int top, int right, int bottom);
+/* Removes an item. Its handle may be reused by later insertions */
+int SpatialIndex_remove(SpatialIndex index, int item);
+/* Removes all the items */
+void SpatialIndex_clear(SpatialIndex index);
+
+/* Gets the data of the topmost (last inserted) item containing a point, NULL if there is none */
+void *SpatialIndex_hitTest(SpatialIndex index, int x, int y);
+/* Calls callback for every item containing a point. Returns the number of items reported */
+unsigned int SpatialIndex_queryPoint(SpatialIndex index, int x, int y, SpatialQueryFunc callback, void *context);
+/* Calls callback for every item intersecting a rectangle. Returns the number of items reported */
+unsigned int SpatialIndex_queryRect(SpatialIndex index, int left, int top, int right, int bottom, SpatialQueryFunc callback,
+									void *context);
+
+#endif
@@ -0,0 +1,352 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tinyText.h"
+
+/* Makes room for at least numPieces pieces */
+static int reservePieces(TextBuffer buffer, unsigned int numPieces){
+	struct _textPiece *newPieces;
+	unsigned int newCapacity;
+
+	if (numPieces <= buffer->capacity)
+		return 1;
+
+	newCapacity = buffer->capacity ? buffer->capacity : 16;
+	while (newCapacity < numPieces)
+		newCapacity *= 2;
+
+	newPieces = (struct _textPiece*)realloc(buffer->pieces, newCapacity * sizeof(struct _textPiece));
+	if (!newPieces)
+		return 0;
+	buffer->pieces = newPieces;
+	buffer->capacity = newCapacity;
+	return 1;
+}
+
+/* Appends text to the added text */
+static int addText(TextBuffer buffer, const char *text, unsigned int length){
+	char *newAdded;
+	unsigned int newCapacity;
+
+	if (buffer->addedLength + length > buffer->addedCapacity){
+		newCapacity = buffer->addedCapacity ? buffer->addedCapacity : 256;
+		while (newCapacity < buffer->addedLength + length)
+			newCapacity *= 2;
+
+		newAdded = (char*)realloc(buffer->added, newCapacity);
+		if (!newAdded)
+			return 0;
+		buffer->added = newAdded;
+		buffer->addedCapacity = newCapacity;
+	}
+
+	memcpy(buffer->added + buffer->addedLength, text, length);
+	buffer->addedLength += length;
+	return 1;
+}
+
+/* Counts the UTF-16 characters of a UTF-8 text. Only the first byte of a character counts, four-byte characters are surrogate pairs
+   in UTF-16. A text cut inside a character counts it where its first byte is */
+static unsigned int countWide(const char *text, unsigned int length){
+	unsigned int count = 0, i;
+
+	for (i = 0; i < length; i++)
+		if (((unsigned char)text[i] & 0xC0) != 0x80)
+			count += (unsigned char)text[i] >= 0xF0 ? 2 : 1;
+	return count;
+}
+
+/* Gets the number of pieces a text of a given length is cut into */
+static unsigned int countPieces(unsigned int length){
+	return length / TEXTBUFFER_PIECE_LENGTH + (length % TEXTBUFFER_PIECE_LENGTH ? 1 : 0);
+}
+
+/* Gets the text of a piece */
+static const char *getPieceText(TextBuffer buffer, struct _textPiece *piece){
+	return (piece->added ? buffer->added : buffer->original) + piece->start;
+}
+
+/* Sets the pieces from index on to a text of the original or the added text, cut into pieces of at most TEXTBUFFER_PIECE_LENGTH.
+   The room for them has to be reserved. Returns their length in UTF-16 characters */
+static unsigned int setPieces(TextBuffer buffer, unsigned int index, int added, unsigned int start, unsigned int length){
+	struct _textPiece *currPiece;
+	unsigned int wideLength = 0;
+
+	for (currPiece = buffer->pieces + index; length; currPiece++){
+		currPiece->added = added;
+		currPiece->start = start;
+		currPiece->length = length < TEXTBUFFER_PIECE_LENGTH ? length : TEXTBUFFER_PIECE_LENGTH;
+		currPiece->wideLength = countWide(getPieceText(buffer, currPiece), currPiece->length);
+		wideLength += currPiece->wideLength;
+		start += currPiece->length;
+		length -= currPiece->length;
+	}
+	return wideLength;
+}
+
+/* Finds the piece containing an offset, in bytes or in UTF-16 characters if wide is set, walking from the last piece found. Stores
+   the piece's offset in both. Returns numPieces for the end of the text */
+static unsigned int findPiece(TextBuffer buffer, unsigned int offset, int wide, unsigned int *pieceOffset,
+								unsigned int *pieceWideOffset){
+	unsigned int piece = buffer->hintPiece, currOffset = buffer->hintOffset, currWideOffset = buffer->hintWideOffset;
+
+	if (piece >= buffer->numPieces){
+		piece = 0;
+		currOffset = 0;
+		currWideOffset = 0;
+	}
+
+	while (offset < (wide ? currWideOffset : currOffset)){
+		piece--;
+		currOffset -= (buffer->pieces)[piece].length;
+		currWideOffset -= (buffer->pieces)[piece].wideLength;
+	}
+	while (piece < buffer->numPieces && offset >= (wide ? currWideOffset + (buffer->pieces)[piece].wideLength :
+																currOffset + (buffer->pieces)[piece].length)){
+		currOffset += (buffer->pieces)[piece].length;
+		currWideOffset += (buffer->pieces)[piece].wideLength;
+		piece++;
+	}
+
+	if (piece < buffer->numPieces){
+		buffer->hintPiece = piece;
+		buffer->hintOffset = currOffset;
+		buffer->hintWideOffset = currWideOffset;
+	}
+	*pieceOffset = currOffset;
+	*pieceWideOffset = currWideOffset;
+	return piece;
+}
+
+/* Splits the piece containing an offset so that a piece starts there, and stores the offset in UTF-16 characters. Returns that piece,
+   numPieces for the end of the text, or -1 on failure */
+static int splitAt(TextBuffer buffer, unsigned int offset, unsigned int *wideOffset){
+	struct _textPiece *currPiece;
+	unsigned int piece, pieceOffset, pieceWideOffset, leftWideLength;
+
+	piece = findPiece(buffer, offset, 0, &pieceOffset, &pieceWideOffset);
+	*wideOffset = pieceWideOffset;
+	if (piece == buffer->numPieces || pieceOffset == offset)
+		return (int)piece;
+
+	if (!reservePieces(buffer, buffer->numPieces + 1))
+		return -1;
+
+	memmove(buffer->pieces + piece + 2, buffer->pieces + piece + 1, (buffer->numPieces - piece - 1) * sizeof(struct _textPiece));
+	buffer->numPieces++;
+
+	currPiece = buffer->pieces + piece;
+	currPiece[1].added = currPiece->added;
+	currPiece[1].start = currPiece->start + (offset - pieceOffset);
+	currPiece[1].length = currPiece->length - (offset - pieceOffset);
+	currPiece->length = offset - pieceOffset;
+	leftWideLength = countWide(getPieceText(buffer, currPiece), currPiece->length);
+	currPiece[1].wideLength = currPiece->wideLength - leftWideLength;
+	currPiece->wideLength = leftWideLength;
+
+	*wideOffset = pieceWideOffset + leftWideLength;
+	buffer->hintPiece = piece + 1;
+	buffer->hintOffset = offset;
+	buffer->hintWideOffset = *wideOffset;
+	return (int)piece + 1;
+}
+
+/* Merges all the pieces into a new original text. There are more pieces than it needs, so they have the room */
+static int compact(TextBuffer buffer){
+	char *newOriginal = (char*)malloc(buffer->length ? buffer->length : 1);
+
+	if (!newOriginal)
+		return 0;
+
+	TextBuffer_copy(buffer, 0, buffer->length, newOriginal);
+	free(buffer->original);
+	buffer->original = newOriginal;
+	buffer->originalLength = buffer->length;
+	buffer->addedLength = 0;
+
+	buffer->numPieces = countPieces(buffer->length);
+	setPieces(buffer, 0, 0, 0, buffer->length);
+	buffer->hintPiece = 0;
+	buffer->hintOffset = 0;
+	buffer->hintWideOffset = 0;
+	return 1;
+}
+
+
+
+TextBuffer newTextBuffer(const char *text, unsigned int length){
+	TextBuffer buffer = (TextBuffer)calloc(1, sizeof(struct _textBuffer));
+
+	if (!buffer)
+		return NULL;
+
+	if (!reservePieces(buffer, 1) || !TextBuffer_setText(buffer, text, length)){
+		deleteTextBuffer(buffer);
+		return NULL;
+	}
+
+	return buffer;
+}
+
+void deleteTextBuffer(TextBuffer buffer){
+	if (!buffer)
+		return;
+
+	free(buffer->original);
+	free(buffer->added);
+	free(buffer->pieces);
+	free(buffer);
+}
+
+int TextBuffer_setText(TextBuffer buffer, const char *text, unsigned int length){
+	char *newOriginal;
+
+	if (!reservePieces(buffer, countPieces(length)))
+		return 0;
+	newOriginal = (char*)malloc(length ? length : 1);
+	if (!newOriginal)
+		return 0;
+
+	if (length)
+		memcpy(newOriginal, text, length);
+	free(buffer->original);
+	buffer->original = newOriginal;
+	buffer->originalLength = length;
+	buffer->addedLength = 0;
+
+	buffer->numPieces = countPieces(length);
+	buffer->wideLength = setPieces(buffer, 0, 0, 0, length);
+	buffer->length = length;
+	buffer->hintPiece = 0;
+	buffer->hintOffset = 0;
+	buffer->hintWideOffset = 0;
+	return 1;
+}
+
+int TextBuffer_replace(TextBuffer buffer, unsigned int offset, unsigned int removed, const char *inserted,
+						unsigned int insertedLength){
+	struct _textPiece *currPiece;
+	unsigned int piece, pieceOffset, pieceWideOffset, firstWideOffset, lastWideOffset, insertedWideLength,
+				numInserted = countPieces(insertedLength), addedStart = buffer->addedLength;
+	int first, last;
+
+	if (offset > buffer->length || removed > buffer->length - offset)
+		return 0;
+	if (!removed && !insertedLength)
+		return 1;
+
+	if (insertedLength && !addText(buffer, inserted, insertedLength))
+		return 0;
+
+	/* Typing: the insertion continues the last added piece, which just grows while it's short enough */
+	if (!removed && offset){
+		piece = findPiece(buffer, offset - 1, 0, &pieceOffset, &pieceWideOffset);
+		currPiece = buffer->pieces + piece;
+		if (currPiece->added && currPiece->start + currPiece->length == addedStart && pieceOffset + currPiece->length == offset &&
+				currPiece->length + insertedLength <= TEXTBUFFER_PIECE_LENGTH){
+			insertedWideLength = countWide(inserted, insertedLength);
+			currPiece->length += insertedLength;
+			currPiece->wideLength += insertedWideLength;
+			buffer->length += insertedLength;
+			buffer->wideLength += insertedWideLength;
+			return 1;
+		}
+	}
+
+	first = splitAt(buffer, offset, &firstWideOffset);
+	if (first < 0)
+		return 0;
+	last = splitAt(buffer, offset + removed, &lastWideOffset); /* Splitting after first doesn't move it */
+	if (last < 0 || !reservePieces(buffer, buffer->numPieces + numInserted))
+		return 0;
+
+	/* Replace the pieces in [first, last) with the pieces of the inserted text */
+	if (numInserted != (unsigned int)(last - first)){
+		memmove(buffer->pieces + first + numInserted, buffer->pieces + last, (buffer->numPieces - last) * sizeof(struct _textPiece));
+		buffer->numPieces = buffer->numPieces - (last - first) + numInserted;
+	}
+	insertedWideLength = setPieces(buffer, first, 1, addedStart, insertedLength);
+	buffer->length = buffer->length - removed + insertedLength;
+	buffer->wideLength = buffer->wideLength - (lastWideOffset - firstWideOffset) + insertedWideLength;
+
+	if ((unsigned int)first < buffer->numPieces){
+		buffer->hintPiece = first;
+		buffer->hintOffset = offset;
+		buffer->hintWideOffset = firstWideOffset;
+	} else {
+		buffer->hintPiece = 0;
+		buffer->hintOffset = 0;
+		buffer->hintWideOffset = 0;
+	}
+
+	if (buffer->numPieces > TEXTBUFFER_MAX_PIECES + countPieces(buffer->length))
+		compact(buffer); /* Still correct if this fails, just slower */
+
+	return 1;
+}
+
+unsigned int TextBuffer_getLength(TextBuffer buffer){
+	return buffer->length;
+}
+
+unsigned int TextBuffer_copy(TextBuffer buffer, unsigned int offset, unsigned int count, char *dest){
+	struct _textPiece *currPiece;
+	unsigned int piece, pieceOffset, pieceWideOffset, skip, length, copied = 0;
+
+	if (offset >= buffer->length)
+		return 0;
+	if (count > buffer->length - offset)
+		count = buffer->length - offset;
+
+	piece = findPiece(buffer, offset, 0, &pieceOffset, &pieceWideOffset);
+	skip = offset - pieceOffset;
+	for (; copied < count; piece++){
+		currPiece = buffer->pieces + piece;
+		length = currPiece->length - skip;
+		if (length > count - copied)
+			length = count - copied;
+
+		memcpy(dest + copied, getPieceText(buffer, currPiece) + skip, length);
+		copied += length;
+		skip = 0;
+	}
+
+	return copied;
+}
+
+unsigned int TextBuffer_getWideLength(TextBuffer buffer){
+	return buffer->wideLength;
+}
+
+unsigned int TextBuffer_toWideOffset(TextBuffer buffer, unsigned int offset){
+	unsigned int piece, pieceOffset, pieceWideOffset;
+
+	if (offset >= buffer->length)
+		return buffer->wideLength;
+
+	piece = findPiece(buffer, offset, 0, &pieceOffset, &pieceWideOffset);
+	return pieceWideOffset + countWide(getPieceText(buffer, buffer->pieces + piece), offset - pieceOffset);
+}
+
+unsigned int TextBuffer_fromWideOffset(TextBuffer buffer, unsigned int wideOffset){
+	struct _textPiece *currPiece;
+	const char *text;
+	unsigned int piece, pieceOffset, currWideOffset, i;
+
+	if (wideOffset >= buffer->wideLength)
+		return buffer->length;
+
+	/* The character starting at or after the offset is usually in its piece, but a surrogate pair split there ends past it */
+	for (piece = findPiece(buffer, wideOffset, 1, &pieceOffset, &currWideOffset); piece < buffer->numPieces; piece++){
+		currPiece = buffer->pieces + piece;
+		text = getPieceText(buffer, currPiece);
+		for (i = 0; i < currPiece->length; i++){
+			if (((unsigned char)text[i] & 0xC0) == 0x80)
+				continue;
+			if (currWideOffset >= wideOffset)
+				return pieceOffset + i;
+			currWideOffset += (unsigned char)text[i] >= 0xF0 ? 2 : 1;
+		}
+		pieceOffset += currPiece->length;
+	}
+	return buffer->length;
+}
@@ -0,0 +1,61 @@
+#ifndef TINYTEXT_H
+#define TINYTEXT_H
+
+/* tinyText - a piece table text buffer, used by tinyGUI to keep the text of TextBoxes. An edit only touches the pieces around it
+   and appends the inserted text to a buffer, so its cost doesn't depend on the length of the text. The text is UTF-8, and every
+   piece knows its length in UTF-16 characters too, so offsets can be converted for a UTF-16 window without walking the whole text.
+   Like tinyLayout, it doesn't depend on WinAPI */
+
+#define TEXTBUFFER_MAX_PIECES 4096 /* When a buffer gets this many more pieces than its text needs, they are merged back */
+#define TEXTBUFFER_PIECE_LENGTH 4096 /* The longest piece, so that an offset is converted within this many bytes */
+
+/* A piece of the text, a range of either the original text or the added text */
+struct _textPiece {
+	int added; /* The piece is in the added text */
+	unsigned int start;
+	unsigned int length;
+	unsigned int wideLength; /* The length in UTF-16 characters */
+};
+
+typedef struct _textBuffer *TextBuffer;
+
+struct _textBuffer {
+	char *original; /* The text the buffer was created or last compacted with */
+	unsigned int originalLength;
+	char *added; /* All the text inserted since, in the order it was inserted */
+	unsigned int addedLength;
+	unsigned int addedCapacity;
+
+	struct _textPiece *pieces; /* The pieces making up the text, in order */
+	unsigned int numPieces;
+	unsigned int capacity;
+	unsigned int length; /* The length of the text */
+	unsigned int wideLength; /* The length of the text in UTF-16 characters */
+
+	unsigned int hintPiece; /* The piece found by the last lookup, edits are usually close to each other */
+	unsigned int hintOffset; /* The offset of that piece in the text */
+	unsigned int hintWideOffset; /* And in UTF-16 characters */
+};
+
+/* Constructor and destructor. The text is copied */
+TextBuffer newTextBuffer(const char *text, unsigned int length);
+void deleteTextBuffer(TextBuffer buffer);
+
+/* Replaces the whole text. Returns 0 on failure */
+int TextBuffer_setText(TextBuffer buffer, const char *text, unsigned int length);
+/* Replaces removed characters at offset with insertedLength characters of inserted. Returns 0 on failure */
+int TextBuffer_replace(TextBuffer buffer, unsigned int offset, unsigned int removed, const char *inserted,
+						unsigned int insertedLength);
+/* Gets the length of the text */
+unsigned int TextBuffer_getLength(TextBuffer buffer);
+/* Copies up to count characters from offset to dest, without a terminating zero. Returns the number of characters copied */
+unsigned int TextBuffer_copy(TextBuffer buffer, unsigned int offset, unsigned int count, char *dest);
+
+/* Gets the length of the text in UTF-16 characters */
+unsigned int TextBuffer_getWideLength(TextBuffer buffer);
+/* Converts an offset in bytes to one in UTF-16 characters and back. An offset inside a character is moved to the end of it, one
+   past the end of the text to the end of it */
+unsigned int TextBuffer_toWideOffset(TextBuffer buffer, unsigned int offset);
+unsigned int TextBuffer_fromWideOffset(TextBuffer buffer, unsigned int wideOffset);
+
+#endif
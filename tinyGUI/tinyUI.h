@@ -0,0 +1,57 @@
+#ifndef TINYUI_H
+#define TINYUI_H
+
+/* tinyUI - the compact binary UI description format. A UI file describes GUIObject trees: the objects in preorder (each one after
+   its parent), the events bound to named handlers and a pool of null-terminated strings. loadUIFile memory-maps a UI file and builds
+   the trees in one pass over it, the texts of the objects point into the mapped pool instead of being copied. UI files are compiled
+   from text descriptions by tools/uic.c. Like tinyLayout, it doesn't depend on WinAPI.
+
+   A UI file is the header, the object records, the event records and the string pool, in that order. The numbers are stored in the
+   byte order of the machine it is compiled for (little-endian on Windows) */
+
+#define UI_MAGIC 0x31495554 /* "TUI1" */
+#define UI_VERSION 1
+
+#define UI_NO_PARENT 0xFFFFFFFF /* The parent of the objects at the roots of the trees */
+
+/* The object types */
+enum _uiObjectType { UI_WINDOW = 1, UI_BUTTON, UI_LABEL, UI_TEXTBOX, UI_LISTVIEW, UI_PLOT, UI_LOGVIEW, UI_IMAGEVIEW, UI_TREEVIEW,
+					UI_SCROLLPANEL, UI_NUM_TYPES };
+
+/* The object flags */
+#define UI_FLAG_DISABLED 0x1
+#define UI_FLAG_MULTILINE 0x2 /* TextBoxes only */
+#define UI_FLAG_NUMONLY 0x4 /* TextBoxes only */
+#define UI_FLAG_FIXEDSIZE 0x8 /* Windows only, they can't be resized or maximized */
+
+/* The anchors, a combination of the sides of the parent an object keeps its distance to */
+#define UI_ANCHOR_LEFT 0x1
+#define UI_ANCHOR_TOP 0x2
+#define UI_ANCHOR_RIGHT 0x4
+#define UI_ANCHOR_BOTTOM 0x8
+
+struct _uiFileHeader {
+	unsigned int magic; /* UI_MAGIC */
+	unsigned int version; /* UI_VERSION */
+	unsigned int numObjects;
+	unsigned int numEvents;
+	unsigned int stringsSize; /* The size of the string pool, bytes. It starts with the empty string and ends with a null */
+};
+
+struct _uiObjectRecord {
+	unsigned short type; /* One of the _uiObjectType values */
+	unsigned short flags; /* A combination of the UI_FLAG_ macro values */
+	unsigned int parent; /* The index of the parent object, lower than the object's own, or UI_NO_PARENT */
+	int x, y, width, height; /* The x and y of windows are ignored */
+	unsigned int anchor; /* A combination of the UI_ANCHOR_ macro values, 0 for the default (left and top) */
+	unsigned int text; /* The offsets of the object's text and name in the string pool, 0 for none */
+	unsigned int name;
+};
+
+struct _uiEventRecord {
+	unsigned int object; /* The index of the object */
+	unsigned int message; /* The Windows message, or WM_COMMAND notification code, of the event */
+	unsigned int handler; /* The offset of the handler's name in the string pool */
+};
+
+#endif
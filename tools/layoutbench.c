@@ -0,0 +1,126 @@
+/* layoutbench - compares the layout passes over 10k children: the anchor pass, a flex layout of 100 rows of 100 growing items and
+   a grid of 100x100 fraction tracks, each resized a number of times. It also times a pass after one leaf of the flex layout changed,
+   which only lays out its row again, and a clean pass. The layout statistics show how many measures the caches answered.
+
+   Usage: layoutbench [numResizes]
+
+   Build it with tinyGUI, like the demo: cl /O2 tools\layoutbench.c tinyGUI\*.c user32.lib gdi32.lib */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../tinyGUI/tinyGUI.h"
+
+#define SIDE 100 /* The benchmarks lay out SIDE * SIDE children */
+#define DEFAULT_RESIZES 50
+
+static LARGE_INTEGER frequency;
+
+static double now(){
+	LARGE_INTEGER counter;
+
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart * 1000.0 / frequency.QuadPart;
+}
+
+/* Resizes a window that isn't displayed and runs the layout pass over it */
+static void resize(Window window, int width, int height){
+	window->clientWidth = width;
+	window->clientHeight = height;
+	invalidateLayout((GUIObject)window);
+	updateLayout((GUIObject)window);
+}
+
+/* Resizes a window numResizes times, returns the average time of a pass */
+static double timeResizes(Window window, int numResizes){
+	double start = now();
+	int i;
+
+	for (i = 0; i < numResizes; i++)
+		resize(window, 1000 + (i % 2 ? i : -i), 800 + (i % 2 ? -i : i));
+	return (now() - start) / numResizes;
+}
+
+static void printStats(const char *name, double time){
+	struct _layoutStats stats;
+
+	getLayoutStats(&stats, 1);
+	printf("%s: %.3f ms/pass, %lu measures, %lu from the caches, %lu layouts, %lu skipped\n", name, time, stats.numMeasures,
+		stats.numCacheHits, stats.numLayouts, stats.numLayoutsSkipped);
+}
+
+int main(int argc, char **argv){
+	int numResizes = argc > 1 ? atoi(argv[1]) : DEFAULT_RESIZES, i, j;
+	struct _layoutTrack tracks[SIDE];
+	Window window;
+	Control row, item, leaf = NULL;
+	double start;
+
+	QueryPerformanceFrequency(&frequency);
+	if (numResizes < 1)
+		numResizes = 1;
+
+	/* The anchor pass, children stretched with their parent */
+	window = newWindow(NULL, "anchors", 1000, 800);
+	for (i = 0; i < SIDE * SIDE; i++){
+		item = newControl(NULL, NULL, 0, 0, 10, 10);
+		item->anchor = ANCHOR_LEFT | ANCHOR_RIGHT | ANCHOR_TOP | ANCHOR_BOTTOM;
+		GUIObject_addChild((GUIObject)window, (GUIObject)item);
+	}
+	resize(window, 1000, 800);
+	getLayoutStats(NULL, 1);
+	printStats("anchors", timeResizes(window, numResizes));
+	deleteGUIObjectTree((GUIObject)window);
+
+	/* Flex rows of growing items */
+	window = newWindow(NULL, "flex", 1000, 800);
+	GUIObject_setFlexLayout((GUIObject)window, FLEX_COLUMN, JUSTIFY_START, ALIGN_STRETCH, 0);
+	for (i = 0; i < SIDE; i++){
+		row = newControl(NULL, NULL, 0, 0, 10, 10);
+		GUIObject_addChild((GUIObject)window, (GUIObject)row);
+		GUIObject_setFlexLayout((GUIObject)row, FLEX_ROW, JUSTIFY_START, ALIGN_STRETCH, 1);
+		GUIObject_setFlexItem((GUIObject)row, 1.0f, 1.0f, 0);
+		for (j = 0; j < SIDE; j++){
+			item = newControl(NULL, NULL, 0, 0, 10, 10);
+			GUIObject_addChild((GUIObject)row, (GUIObject)item);
+			GUIObject_setFlexItem((GUIObject)item, 1.0f, 1.0f, 0);
+			leaf = item;
+		}
+	}
+	getLayoutStats(NULL, 1);
+	start = now();
+	resize(window, 1000, 800);
+	printStats("flex, first layout", now() - start);
+	printStats("flex", timeResizes(window, numResizes));
+
+	start = now();
+	for (i = 0; i < numResizes; i++){
+		GUIObject_setFlexItem((GUIObject)leaf, 1.0f + i % 2, 1.0f, 0);
+		updateLayout((GUIObject)window);
+	}
+	printStats("flex, one leaf changed", (now() - start) / numResizes);
+
+	start = now();
+	for (i = 0; i < numResizes; i++)
+		updateLayout((GUIObject)window);
+	printStats("flex, clean", (now() - start) / numResizes);
+	deleteGUIObjectTree((GUIObject)window);
+
+	/* A grid of fraction tracks */
+	for (i = 0; i < SIDE; i++){
+		tracks[i].type = TRACK_FRACTION;
+		tracks[i].value = 1.0f;
+	}
+	window = newWindow(NULL, "grid", 1000, 800);
+	GUIObject_setGridLayout((GUIObject)window, SIDE, tracks, SIDE, tracks, 0);
+	for (i = 0; i < SIDE * SIDE; i++){
+		item = newControl(NULL, NULL, 0, 0, 10, 10);
+		GUIObject_addChild((GUIObject)window, (GUIObject)item);
+		GUIObject_setGridCell((GUIObject)item, i % SIDE, i / SIDE, 1, 1);
+	}
+	resize(window, 1000, 800);
+	getLayoutStats(NULL, 1);
+	printStats("grid", timeResizes(window, numResizes));
+	deleteGUIObjectTree((GUIObject)window);
+
+	return 0;
+}
@@ -0,0 +1,164 @@
+/* layoutnodebench - the layout passes of layoutbench, run on tinyLayout's nodes directly, so they can be timed on any platform: a
+   flex layout of 100 rows of 100 growing items and a grid of 100x100 fraction tracks, each resized a number of times, a pass after
+   one leaf of the flex layout changed, a clean pass, and a column of measured leaves, like wrapping labels, whose measures the
+   caches answer when only the height changes. The layout statistics show how many measures the caches answered.
+
+   Usage: layoutnodebench [numResizes]
+
+   Build it with tinyLayout alone, with any C compiler: cc -O2 -o layoutnodebench tools/layoutnodebench.c tinyGUI/tinyLayout.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../tinyGUI/tinyLayout.h"
+
+#define SIDE 100 /* The benchmarks lay out SIDE * SIDE nodes */
+#define DEFAULT_RESIZES 50
+#define CHAR_WIDTH 7.0f /* The measured leaves hold text of this many pixels per character */
+#define LINE_HEIGHT 16.0f
+
+/* Milliseconds from a monotonic clock, or from the processor time where there is none */
+static double now(){
+#ifdef CLOCK_MONOTONIC
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+#else
+	return clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+}
+
+/* Measures a leaf holding a text of (int)context characters, wrapped to the available width */
+static void measureText(LayoutNode node, void *context, float availableWidth, enum _measureMode widthMode,
+						float availableHeight, enum _measureMode heightMode, float *width, float *height){
+	float textWidth = (float)(size_t)context * CHAR_WIDTH;
+	int numLines = 1;
+
+	(void)node; (void)availableHeight; (void)heightMode;
+	if (widthMode != MEASURE_UNDEFINED && textWidth > availableWidth && availableWidth >= CHAR_WIDTH){
+		numLines = (int)(textWidth / availableWidth) + 1;
+		textWidth = availableWidth;
+	}
+	*width = textWidth;
+	*height = numLines * LINE_HEIGHT;
+}
+
+/* Lays out a root node at sizes around 1000x800, numResizes times, returns the average time of a pass */
+static double timeResizes(LayoutNode root, int numResizes){
+	double start = now();
+	int i;
+
+	for (i = 0; i < numResizes; i++)
+		LayoutNode_calculate(root, (float)(1000 + (i % 2 ? i : -i)), (float)(800 + (i % 2 ? -i : i)));
+	return (now() - start) / numResizes;
+}
+
+static void printStats(const char *name, double time){
+	struct _layoutStats stats;
+
+	getLayoutStats(&stats, 1);
+	printf("%s: %.3f ms/pass, %lu measures, %lu from the caches, %lu layouts, %lu skipped\n", name, time, stats.numMeasures,
+		stats.numCacheHits, stats.numLayouts, stats.numLayoutsSkipped);
+}
+
+/* Creates a node and adds it to a parent, exits if there is no memory left */
+static LayoutNode addNode(LayoutNode parent){
+	LayoutNode node = newLayoutNode(NULL);
+
+	if (!node || (parent && !LayoutNode_addChild(parent, node))){
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	return node;
+}
+
+/* Deletes a node and its subtree */
+static void deleteTree(LayoutNode node){
+	while (node->numChildren)
+		deleteTree((node->children)[node->numChildren - 1]);
+	deleteLayoutNode(node);
+}
+
+int main(int argc, char **argv){
+	int numResizes = argc > 1 ? atoi(argv[1]) : DEFAULT_RESIZES, i, j;
+	struct _layoutTrack tracks[SIDE];
+	LayoutNode root, row, item, leaf = NULL;
+	double start;
+
+	if (numResizes < 1)
+		numResizes = 1;
+
+	/* Flex rows of growing items */
+	root = addNode(NULL);
+	LayoutNode_setFlex(root, FLEX_COLUMN, JUSTIFY_START, ALIGN_STRETCH, 0);
+	for (i = 0; i < SIDE; i++){
+		row = addNode(root);
+		LayoutNode_setFlex(row, FLEX_ROW, JUSTIFY_START, ALIGN_STRETCH, 1);
+		LayoutNode_setFlexItem(row, 1.0f, 1.0f, 0);
+		for (j = 0; j < SIDE; j++){
+			item = addNode(row);
+			LayoutNode_setFlexItem(item, 1.0f, 1.0f, 0);
+			leaf = item;
+		}
+	}
+	getLayoutStats(NULL, 1);
+	start = now();
+	LayoutNode_calculate(root, 1000, 800);
+	printStats("flex, first layout", now() - start);
+	printStats("flex", timeResizes(root, numResizes));
+
+	start = now();
+	for (i = 0; i < numResizes; i++){
+		LayoutNode_setFlexItem(leaf, 1.0f + i % 2, 1.0f, 0);
+		LayoutNode_calculate(root, 1000, 800);
+	}
+	printStats("flex, one leaf changed", (now() - start) / numResizes);
+
+	start = now();
+	for (i = 0; i < numResizes; i++)
+		LayoutNode_calculate(root, 1000, 800);
+	printStats("flex, clean", (now() - start) / numResizes);
+	deleteTree(root);
+
+	/* A grid of fraction tracks */
+	for (i = 0; i < SIDE; i++){
+		tracks[i].type = TRACK_FRACTION;
+		tracks[i].value = 1.0f;
+	}
+	root = addNode(NULL);
+	if (!LayoutNode_setGrid(root, SIDE, tracks, SIDE, tracks, 0, 0)){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < SIDE * SIDE; i++){
+		item = addNode(root);
+		LayoutNode_setGridCell(item, i % SIDE, i / SIDE, 1, 1);
+	}
+	LayoutNode_calculate(root, 1000, 800);
+	getLayoutStats(NULL, 1);
+	printStats("grid", timeResizes(root, numResizes));
+	deleteTree(root);
+
+	/* A column of measured leaves: a width change measures them again, a height change is answered by the caches */
+	root = addNode(NULL);
+	LayoutNode_setFlex(root, FLEX_COLUMN, JUSTIFY_START, ALIGN_STRETCH, 0);
+	for (i = 0; i < SIDE * SIDE; i++){
+		item = newLayoutNode((void*)(size_t)(10 + i % 200));
+		if (!item || !LayoutNode_addChild(root, item)){
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+		LayoutNode_setMeasureFunc(item, measureText);
+	}
+	getLayoutStats(NULL, 1);
+	printStats("measured leaves", timeResizes(root, numResizes));
+
+	start = now();
+	for (i = 0; i < numResizes; i++)
+		LayoutNode_calculate(root, 1000, (float)(800 + i));
+	printStats("measured leaves, height only", (now() - start) / numResizes);
+	deleteTree(root);
+
+	return 0;
+}
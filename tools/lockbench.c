@@ -0,0 +1,123 @@
+/* lockbench - measures the cost of the objects' locks: the size they add to the objects, building GUIObjects that don't use them,
+   taking them for the first time (when they are created) and afterwards, and taking them while another thread holds the lock of an
+   unrelated object, which must not wait for it. It also counts the locks after a layout pass over the objects, which creates none.
+
+   Usage: lockbench [numObjects]
+
+   Build it with tinyGUI, like the demo: cl /O2 tools\lockbench.c tinyGUI\*.c user32.lib gdi32.lib
+   or on other platforms, with the Win32 stand-ins of tools/winstub, whose critical sections are POSIX recursive mutexes:
+   cc -O2 -Itools/winstub -o lockbench tools/lockbench.c tinyGUI/tiny*.c tools/winstub/winstub.c -lpthread */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../tinyGUI/tinyGUI.h"
+
+#define DEFAULT_OBJECTS 100000
+
+static LARGE_INTEGER frequency;
+
+static double now(){
+	LARGE_INTEGER counter;
+
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart * 1000.0 / frequency.QuadPart;
+}
+
+/* Takes and releases the locks of the objects */
+static double syncAll(Label *labels, int numObjects){
+	double start = now();
+	int i;
+
+	for (i = 0; i < numObjects; i++){
+		startSync(labels[i]);
+		endSync(labels[i]);
+	}
+	return now() - start;
+}
+
+struct _syncJob {
+	Label *labels;
+	int numObjects;
+	double time;
+};
+
+static DWORD WINAPI syncProc(LPVOID param){
+	struct _syncJob *job = (struct _syncJob*)param;
+
+	job->time = syncAll(job->labels, job->numObjects);
+	return 0;
+}
+
+int main(int argc, char **argv){
+	int numObjects = argc > 1 ? atoi(argv[1]) : DEFAULT_OBJECTS, i;
+	Label *labels;
+	Window window;
+	Arena arena, prevArena;
+	struct _syncJob job;
+	HANDLE thread;
+	double start;
+
+	QueryPerformanceFrequency(&frequency);
+	if (numObjects < 2)
+		numObjects = 2;
+	labels = (Label*)malloc(numObjects * sizeof(Label));
+	arena = newArena(0);
+	if (!labels || !arena){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	printf("sizeof: Object %u, EventArgs %u, Pen %u, Label %u bytes\n", (unsigned int)sizeof(val_Object),
+		(unsigned int)sizeof(val_EventArgs), (unsigned int)sizeof(val_Pen), (unsigned int)sizeof(val_Label));
+
+	prevArena = useArena(arena);
+	start = now();
+	for (i = 0; i < numObjects; i++)
+		labels[i] = newLabel(NULL, "label", 0, i, 100, 20);
+	printf("build %d Labels in an arena: %.2f ms\n", numObjects, now() - start);
+	useArena(prevArena);
+
+	/* The Labels are stretched with a window that isn't displayed, which is resized once */
+	window = newWindow(NULL, "lockbench", 1000, 800);
+	if (!window){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < numObjects; i++){
+		labels[i]->anchor = ANCHOR_LEFT | ANCHOR_RIGHT;
+		GUIObject_addChild((GUIObject)window, (GUIObject)labels[i]);
+	}
+	updateLayout((GUIObject)window);
+	window->clientWidth += 100;
+	invalidateLayout((GUIObject)window);
+	start = now();
+	updateLayout((GUIObject)window);
+	printf("layout pass over the Labels: %.2f ms, %ld locks allocated\n", now() - start, (long)getNumObjectLocks());
+
+	printf("first sync of each Label: %.2f ms", syncAll(labels, numObjects));
+	printf(", %ld locks allocated\n", (long)getNumObjectLocks());
+	printf("next sync of each Label: %.2f ms\n", syncAll(labels, numObjects));
+
+	/* The first Label stays locked while another thread syncs the others */
+	job.labels = labels + 1;
+	job.numObjects = numObjects - 1;
+	startSync(labels[0]);
+	thread = CreateThread(NULL, 0, syncProc, &job, 0, NULL);
+	if (!thread || WaitForSingleObject(thread, 10000) != WAIT_OBJECT_0){
+		fprintf(stderr, "The other thread waited for an unrelated lock\n");
+		return 1;
+	}
+	endSync(labels[0]);
+	CloseHandle(thread);
+	printf("sync of the other Labels while one is held: %.2f ms\n", job.time);
+
+	for (i = numObjects - 1; i >= 0; i--)
+		GUIObject_removeChild((GUIObject)window, (GUIObject)labels[i]);
+	deleteWindow(window);
+	for (i = 0; i < numObjects; i++)
+		deleteLabel(labels[i]);
+	releaseArena(arena);
+	free(labels);
+
+	return 0;
+}
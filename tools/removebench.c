@@ -0,0 +1,138 @@
+/* removebench - measures the children array at 10k children: appending them, removing them from the front, from the back and in a
+   random order, walking the array while half of the slots are removed, and the churn of a board whose tiles are removed and added
+   all the time, which compacts the removed slots away as the array fills up.
+
+   Usage: removebench [numChildren]
+
+   Build it with tinyGUI, like the demo: cl /O2 tools\removebench.c tinyGUI\*.c user32.lib gdi32.lib
+   or on other platforms, with the Win32 stand-ins of tools/winstub, which create no windows and draw nothing:
+   cc -O2 -Itools/winstub -o removebench tools/removebench.c tinyGUI/tiny*.c tools/winstub/winstub.c -lpthread */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../tinyGUI/tinyGUI.h"
+
+#define DEFAULT_CHILDREN 10000
+#define NUM_WALKS 100 /* The walks over the array are repeated, one is too short to time */
+
+static LARGE_INTEGER frequency;
+
+static double now(){
+	LARGE_INTEGER counter;
+
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart * 1000.0 / frequency.QuadPart;
+}
+
+static void printTime(const char *name, double time, int numOps){
+	printf("%s: %.2f ms, %.3f us each\n", name, time, time * 1000.0 / numOps);
+}
+
+/* Adds the children to a window that isn't displayed, one by one */
+static double addAll(Window window, Control *children, int numChildren){
+	double start = now();
+	int i;
+
+	for (i = 0; i < numChildren; i++)
+		GUIObject_addChild((GUIObject)window, (GUIObject)children[i]);
+	return now() - start;
+}
+
+/* Removes the children in the order given */
+static double removeAll(Window window, Control *children, int *order, int numChildren){
+	double start = now();
+	int i;
+
+	for (i = 0; i < numChildren; i++)
+		GUIObject_removeChild((GUIObject)window, (GUIObject)children[order[i]]);
+	return now() - start;
+}
+
+/* Walks a window's children the way the traversals do, skipping the removed slots */
+static double walk(Window window, int *numFound){
+	double start = now();
+	unsigned int i;
+	int found = 0, j;
+
+	for (j = 0; j < NUM_WALKS; j++)
+		for (i = 0; i < window->numChildren; i++)
+			if ((window->children)[i])
+				found++;
+	*numFound = found / NUM_WALKS;
+	return (now() - start) / NUM_WALKS;
+}
+
+int main(int argc, char **argv){
+	int numChildren = argc > 1 ? atoi(argv[1]) : DEFAULT_CHILDREN, numFound, i, j, swap;
+	Control *children;
+	int *order;
+	Window window;
+	double time;
+
+	QueryPerformanceFrequency(&frequency);
+	if (numChildren < 2)
+		numChildren = 2;
+	children = (Control*)malloc(numChildren * sizeof(Control));
+	order = (int*)malloc(numChildren * sizeof(int));
+	window = newWindow(NULL, "removebench", 1000, 800);
+	if (!children || !order || !window){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < numChildren; i++){
+		children[i] = newControl(NULL, NULL, i % 100 * 10, i / 100 * 10, 10, 10);
+		if (!children[i]){
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+	}
+	srand(1);
+
+	/* Removal from the back drops the slots right away, removal from the front leaves every one of them removed */
+	printTime("add", addAll(window, children, numChildren), numChildren);
+	for (i = 0; i < numChildren; i++)
+		order[i] = numChildren - 1 - i;
+	printTime("remove from the back", removeAll(window, children, order, numChildren), numChildren);
+
+	addAll(window, children, numChildren);
+	for (i = 0; i < numChildren; i++)
+		order[i] = i;
+	printTime("remove from the front", removeAll(window, children, order, numChildren), numChildren);
+
+	addAll(window, children, numChildren);
+	for (i = numChildren - 1; i > 0; i--){
+		j = rand() % (i + 1);
+		swap = order[i];
+		order[i] = order[j];
+		order[j] = swap;
+	}
+	printTime("remove in a random order", removeAll(window, children, order, numChildren), numChildren);
+
+	/* Half of the slots removed, every other one */
+	addAll(window, children, numChildren);
+	time = walk(window, &numFound);
+	printf("walk %u slots, %d children: %.3f ms\n", window->numChildren, numFound, time);
+	for (i = 0; i < numChildren; i += 2)
+		GUIObject_removeChild((GUIObject)window, (GUIObject)children[i]);
+	time = walk(window, &numFound);
+	printf("walk %u slots, %d children: %.3f ms\n", window->numChildren, numFound, time);
+
+	/* Churn: a random child is removed and added back on top, numChildren times */
+	for (i = 0; i < numChildren; i += 2)
+		GUIObject_addChild((GUIObject)window, (GUIObject)children[i]);
+	time = now();
+	for (i = 0; i < numChildren; i++){
+		j = rand() % numChildren;
+		GUIObject_removeChild((GUIObject)window, (GUIObject)children[j]);
+		GUIObject_addChild((GUIObject)window, (GUIObject)children[j]);
+	}
+	printTime("remove and add back", now() - time, numChildren);
+	printf("after the churn: %u slots, %u removed, capacity %u\n", window->numChildren, window->numRemovedChildren,
+		window->childrenCapacity);
+
+	deleteGUIObjectTree((GUIObject)window);
+	free(children);
+	free(order);
+
+	return 0;
+}
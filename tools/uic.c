@@ -0,0 +1,401 @@
+/* uic - the tinyGUI UI compiler. Compiles a text UI description to the binary UI file format of tinyUI.h, for loadUIFile.
+
+   Usage: uic input.ui output.tui
+
+   A description is a list of objects, each one followed by its properties and children in braces:
+
+	# A comment
+	window main "Learn the Multiplication Table!" 440 200 {
+		fixedsize
+		label header "Can you calculate this?" 10 10 400 20
+		textbox answer "" 240 32 102 25 { numonly }
+		button check "Check answer" 10 110 400 25 {
+			anchor left right bottom
+			on click checkAnswer
+		}
+	}
+
+   An object is its type, an optional name (to find it with UIFile_getObject), its text for the types that have one (window, button,
+   label and textbox) and its geometry: x, y, width and height, just width and height for windows. The properties are:
+	anchor <left|top|right|bottom>...   the sides of the parent the object keeps its distance to
+	on <event> <handler>                binds an event, by its name or Windows message number, to the handler of that name
+	disabled, multiline, numonly, fixedsize
+   The texts are UTF-8, with the \", \\, \n and \t escapes. Like tinyUI.h, it doesn't depend on WinAPI */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../tinyGUI/tinyUI.h"
+
+#define MAX_TOKEN 4096 /* The maximum length of a token, bytes */
+#define MAX_DEPTH 64 /* The maximum nesting of objects */
+
+enum _tokenType { TOKEN_END, TOKEN_WORD, TOKEN_STRING, TOKEN_NUMBER, TOKEN_OPEN, TOKEN_CLOSE };
+
+/* The object types, in _uiObjectType order */
+static const char *typeNames[UI_NUM_TYPES] = { NULL, "window", "button", "label", "textbox", "listview", "plot", "logview",
+												"imageview", "treeview", "scrollpanel" };
+
+/* The events that can be bound by name */
+static const struct { const char *name; unsigned int message; } eventNames[] = {
+	{ "click", 0x0202 }, /* WM_LBUTTONUP */
+	{ "mousedown", 0x0201 }, /* WM_LBUTTONDOWN */
+	{ "mouseup", 0x0202 }, /* WM_LBUTTONUP */
+	{ "doubleclick", 0x0203 }, /* WM_LBUTTONDBLCLK */
+	{ "rightclick", 0x0205 }, /* WM_RBUTTONUP */
+	{ "mousemove", 0x0200 }, /* WM_MOUSEMOVE */
+	{ "keydown", 0x0100 }, /* WM_KEYDOWN */
+	{ "keyup", 0x0101 }, /* WM_KEYUP */
+	{ "paint", 0x000F }, /* WM_PAINT */
+	{ "size", 0x0005 }, /* WM_SIZE */
+	{ "change", 0x0300 } /* EN_CHANGE */
+};
+
+/* The parser state */
+static FILE *input;
+static const char *inputPath;
+static int line = 1;
+static int peeked = 0; /* The token read ahead, TOKEN_END if none */
+static enum _tokenType tokenType;
+static char token[MAX_TOKEN];
+static long tokenNumber;
+
+/* The compiled file */
+static struct _uiObjectRecord *objects;
+static unsigned int numObjects, objectsCapacity;
+static struct _uiEventRecord *events;
+static unsigned int numEvents, eventsCapacity;
+static char *strings;
+static unsigned int stringsSize, stringsCapacity;
+
+/* The offsets of the pooled strings, hashed to find equal strings while compiling. The table size is a power of two, kept at least
+   twice the number of strings; 0 marks an empty slot, as the empty string at offset 0 isn't hashed */
+static unsigned int *stringTable;
+static unsigned int stringTableSize, numStrings;
+
+static void fail(const char *message){
+	fprintf(stderr, "%s:%d: %s\n", inputPath, line, message);
+	exit(1);
+}
+
+/* Grows an array to hold count + 1 elements of size bytes */
+static void *reserve(void *array, unsigned int *capacity, unsigned int count, size_t size){
+	if (count < *capacity)
+		return array;
+
+	*capacity = *capacity ? *capacity * 2 : 16;
+	array = realloc(array, *capacity * size);
+	if (!array)
+		fail("out of memory");
+	return array;
+}
+
+/* Reads the next token */
+static void readToken(){
+	int c, length = 0;
+	char *end;
+
+	if (peeked){
+		peeked = 0;
+		return;
+	}
+
+	/* Skip the whitespace and the comments */
+	for (;;){
+		c = fgetc(input);
+		if (c == '\n')
+			line++;
+		else if (c == '#'){
+			while ((c = fgetc(input)) != EOF && c != '\n');
+			line++;
+		} else if (c == EOF || !isspace(c))
+			break;
+	}
+
+	if (c == EOF){
+		tokenType = TOKEN_END;
+		return;
+	}
+	if (c == '{' || c == '}'){
+		tokenType = c == '{' ? TOKEN_OPEN : TOKEN_CLOSE;
+		return;
+	}
+
+	if (c == '"'){
+		while ((c = fgetc(input)) != '"'){
+			if (c == EOF || c == '\n')
+				fail("unterminated string");
+			if (c == '\\'){
+				c = fgetc(input);
+				if (c == 'n')
+					c = '\n';
+				else if (c == 't')
+					c = '\t';
+				else if (c != '"' && c != '\\')
+					fail("unknown escape sequence");
+			}
+			if (length == MAX_TOKEN - 1)
+				fail("string too long");
+			token[length++] = (char)c;
+		}
+		token[length] = '\0';
+		tokenType = TOKEN_STRING;
+		return;
+	}
+
+	do {
+		if (length == MAX_TOKEN - 1)
+			fail("token too long");
+		token[length++] = (char)c;
+		c = fgetc(input);
+	} while (c != EOF && !isspace(c) && c != '{' && c != '}' && c != '"' && c != '#');
+	if (c != EOF)
+		ungetc(c, input);
+	token[length] = '\0';
+
+	tokenNumber = strtol(token, &end, 0);
+	tokenType = (isdigit((unsigned char)token[0]) || (token[0] == '-' && isdigit((unsigned char)token[1]))) && !*end ?
+				TOKEN_NUMBER : TOKEN_WORD;
+	if (tokenType == TOKEN_WORD && !isalpha((unsigned char)token[0]) && token[0] != '_')
+		fail("unexpected character");
+}
+
+/* Reads the next token without consuming it */
+static enum _tokenType peekToken(){
+	readToken();
+	peeked = 1;
+	return tokenType;
+}
+
+static long readNumber(){
+	readToken();
+	if (tokenType != TOKEN_NUMBER)
+		fail("number expected");
+	return tokenNumber;
+}
+
+/* The FNV-1a hash of a string */
+static unsigned int hashString(const char *string){
+	unsigned int hash = 2166136261u;
+
+	for (; *string; string++)
+		hash = (hash ^ (unsigned char)*string) * 16777619u;
+	return hash;
+}
+
+/* Finds the slot of a string in the table: the slot that holds it, or the empty slot it goes to */
+static unsigned int findStringSlot(const char *string, unsigned int hash){
+	unsigned int slot = hash & (stringTableSize - 1);
+
+	while (stringTable[slot] && strcmp(strings + stringTable[slot], string))
+		slot = (slot + 1) & (stringTableSize - 1);
+	return slot;
+}
+
+/* Doubles the string table, rehashing the strings in it */
+static void growStringTable(){
+	unsigned int *oldTable = stringTable, oldSize = stringTableSize, i;
+
+	stringTableSize = oldSize ? oldSize * 2 : 64;
+	stringTable = (unsigned int*)calloc(stringTableSize, sizeof(unsigned int));
+	if (!stringTable)
+		fail("out of memory");
+
+	for (i = 0; i < oldSize; i++)
+		if (oldTable[i])
+			stringTable[findStringSlot(strings + oldTable[i], hashString(strings + oldTable[i]))] = oldTable[i];
+	free(oldTable);
+}
+
+/* Adds a string to the pool, reusing an equal string already there. Returns its offset */
+static unsigned int addString(const char *string){
+	unsigned int offset, slot, hash, length = (unsigned int)strlen(string);
+
+	if (!length)
+		return 0;
+	if (2 * (numStrings + 1) > stringTableSize)
+		growStringTable();
+	hash = hashString(string);
+	slot = findStringSlot(string, hash);
+	if (stringTable[slot])
+		return stringTable[slot];
+
+	while (stringsSize + length + 1 > stringsCapacity){
+		stringsCapacity *= 2;
+		strings = (char*)realloc(strings, stringsCapacity);
+		if (!strings)
+			fail("out of memory");
+	}
+	offset = stringsSize;
+	memcpy(strings + offset, string, length + 1);
+	stringsSize += length + 1;
+
+	stringTable[slot] = offset;
+	numStrings++;
+	return offset;
+}
+
+static int findType(const char *name){
+	int i;
+
+	for (i = 1; i < UI_NUM_TYPES; i++)
+		if (!strcmp(typeNames[i], name))
+			return i;
+	return 0;
+}
+
+/* Parses an object's property. Returns 0 if the word isn't one */
+static int parseProperty(unsigned int object, const char *word){
+	unsigned int i;
+
+	if (!strcmp(word, "anchor")){
+		while (peekToken() == TOKEN_WORD && (!strcmp(token, "left") || !strcmp(token, "top") || !strcmp(token, "right") ||
+				!strcmp(token, "bottom"))){
+			readToken();
+			objects[object].anchor |= !strcmp(token, "left") ? UI_ANCHOR_LEFT : !strcmp(token, "top") ? UI_ANCHOR_TOP :
+										!strcmp(token, "right") ? UI_ANCHOR_RIGHT : UI_ANCHOR_BOTTOM;
+		}
+		if (!objects[object].anchor)
+			fail("anchor side expected");
+	} else if (!strcmp(word, "on")){
+		events = (struct _uiEventRecord*)reserve(events, &eventsCapacity, numEvents, sizeof(struct _uiEventRecord));
+		events[numEvents].object = object;
+
+		readToken();
+		if (tokenType == TOKEN_NUMBER)
+			events[numEvents].message = (unsigned int)tokenNumber;
+		else if (tokenType == TOKEN_WORD){
+			for (i = 0; i < sizeof(eventNames) / sizeof(eventNames[0]) && strcmp(eventNames[i].name, token); i++);
+			if (i == sizeof(eventNames) / sizeof(eventNames[0]))
+				fail("unknown event");
+			events[numEvents].message = eventNames[i].message;
+		} else
+			fail("event expected");
+
+		readToken();
+		if (tokenType != TOKEN_WORD)
+			fail("handler name expected");
+		events[numEvents].handler = addString(token);
+		numEvents++;
+	} else if (!strcmp(word, "disabled"))
+		objects[object].flags |= UI_FLAG_DISABLED;
+	else if (!strcmp(word, "multiline"))
+		objects[object].flags |= UI_FLAG_MULTILINE;
+	else if (!strcmp(word, "numonly"))
+		objects[object].flags |= UI_FLAG_NUMONLY;
+	else if (!strcmp(word, "fixedsize"))
+		objects[object].flags |= UI_FLAG_FIXEDSIZE;
+	else
+		return 0;
+
+	return 1;
+}
+
+/* Parses an object, its type was just read. Its children are parsed recursively */
+static void parseObject(unsigned int parent, int type, int depth){
+	struct _uiObjectRecord *record;
+	unsigned int object = numObjects;
+	int childType;
+
+	if (depth == MAX_DEPTH)
+		fail("objects nested too deep");
+
+	objects = (struct _uiObjectRecord*)reserve(objects, &objectsCapacity, numObjects, sizeof(struct _uiObjectRecord));
+	record = &(objects[numObjects++]);
+	memset(record, 0, sizeof(struct _uiObjectRecord));
+	record->type = (unsigned short)type;
+	record->parent = parent;
+
+	if (peekToken() == TOKEN_WORD){
+		readToken();
+		record->name = addString(token);
+	}
+	if (type == UI_WINDOW || type == UI_BUTTON || type == UI_LABEL || type == UI_TEXTBOX){
+		readToken();
+		if (tokenType != TOKEN_STRING)
+			fail("text expected");
+		record->text = addString(token);
+	}
+	if (type != UI_WINDOW){
+		record->x = (int)readNumber();
+		record->y = (int)readNumber();
+	}
+	record->width = (int)readNumber();
+	record->height = (int)readNumber();
+
+	if (peekToken() != TOKEN_OPEN)
+		return;
+	readToken();
+
+	for (;;){
+		readToken();
+		if (tokenType == TOKEN_CLOSE)
+			return;
+		if (tokenType != TOKEN_WORD)
+			fail("property or object expected");
+
+		/* The record may move as children are added, so it's found by its index */
+		if ((childType = findType(token)) != 0)
+			parseObject(object, childType, depth + 1);
+		else if (!parseProperty(object, token))
+			fail("unknown property or object type");
+	}
+}
+
+int main(int argc, char **argv){
+	struct _uiFileHeader header;
+	FILE *output;
+	int type;
+
+	if (argc != 3){
+		fprintf(stderr, "Usage: uic input.ui output.tui\n");
+		return 1;
+	}
+
+	inputPath = argv[1];
+	input = fopen(inputPath, "r");
+	if (!input){
+		fprintf(stderr, "Can't open %s\n", inputPath);
+		return 1;
+	}
+
+	/* The pool starts with the empty string */
+	stringsCapacity = 256;
+	strings = (char*)malloc(stringsCapacity);
+	if (!strings)
+		fail("out of memory");
+	strings[0] = '\0';
+	stringsSize = 1;
+
+	for (readToken(); tokenType != TOKEN_END; readToken()){
+		if (tokenType != TOKEN_WORD || !(type = findType(token)))
+			fail("object type expected");
+		parseObject(UI_NO_PARENT, type, 0);
+	}
+	fclose(input);
+
+	header.magic = UI_MAGIC;
+	header.version = UI_VERSION;
+	header.numObjects = numObjects;
+	header.numEvents = numEvents;
+	header.stringsSize = stringsSize;
+
+	output = fopen(argv[2], "wb");
+	if (!output){
+		fprintf(stderr, "Can't create %s\n", argv[2]);
+		return 1;
+	}
+	if (fwrite(&header, sizeof(header), 1, output) != 1 ||
+			(numObjects && fwrite(objects, sizeof(struct _uiObjectRecord), numObjects, output) != numObjects) ||
+			(numEvents && fwrite(events, sizeof(struct _uiEventRecord), numEvents, output) != numEvents) ||
+			fwrite(strings, 1, stringsSize, output) != stringsSize){
+		fprintf(stderr, "Can't write %s\n", argv[2]);
+		fclose(output);
+		return 1;
+	}
+	fclose(output);
+	free(stringTable);
+
+	return 0;
+}
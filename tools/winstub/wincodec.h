@@ -0,0 +1 @@
+/* Nothing of the Windows Imaging Component is used by the benchmarks */
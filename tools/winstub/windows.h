@@ -0,0 +1,458 @@
+/* The Win32 declarations tinyGUI uses, for building the benchmarks in tools on other platforms against winstub.c. Only the types,
+   constants and functions tinyGUI needs are declared, see winstub.c for what the functions do */
+#ifndef WINSTUB_WINDOWS_H
+#define WINSTUB_WINDOWS_H
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <string.h>
+#include <wchar.h>
+#include <pthread.h>
+#define WINAPI
+#define CALLBACK
+#define APIENTRY
+#define TRUE 1
+#define FALSE 0
+typedef int BOOL; typedef unsigned int UINT; typedef int INT; typedef long LONG; typedef unsigned long ULONG; /* As wide as the long tinyGUI passes for LONG */ typedef unsigned int DWORD;
+typedef unsigned short WORD; typedef unsigned char BYTE; typedef short SHORT; typedef unsigned short USHORT; typedef char CHAR; typedef unsigned short WCHAR; /* UTF-16, like on Windows */
+typedef intptr_t LONG_PTR; typedef uintptr_t ULONG_PTR; typedef uintptr_t UINT_PTR; typedef intptr_t INT_PTR; typedef ULONG_PTR DWORD_PTR; typedef ULONG_PTR SIZE_T;
+typedef UINT_PTR WPARAM; typedef LONG_PTR LPARAM; typedef LONG_PTR LRESULT; typedef long long LONGLONG; typedef unsigned long long ULONGLONG; typedef unsigned long long DWORD64;
+typedef void *LPVOID; typedef const void *LPCVOID; typedef void *HANDLE; typedef char *LPSTR; typedef const char *LPCSTR; typedef WCHAR *LPWSTR; typedef const WCHAR *LPCWSTR;
+typedef DWORD *LPDWORD; typedef LONG HRESULT; typedef LONG volatile *LPLONG_VOLATILE; typedef DWORD COLORREF; typedef WORD ATOM; typedef BYTE BOOLEAN;
+#define DECLARE_HANDLE(n) typedef struct n##__ { int unused; } *n
+DECLARE_HANDLE(HWND); DECLARE_HANDLE(HINSTANCE); DECLARE_HANDLE(HDC); DECLARE_HANDLE(HBITMAP); DECLARE_HANDLE(HBRUSH); DECLARE_HANDLE(HPEN); DECLARE_HANDLE(HFONT);
+DECLARE_HANDLE(HMENU); DECLARE_HANDLE(HICON); DECLARE_HANDLE(HCURSOR); DECLARE_HANDLE(HRGN); DECLARE_HANDLE(HDWP); DECLARE_HANDLE(HLOCAL); DECLARE_HANDLE(HMONITOR);
+typedef void *HGDIOBJ; typedef HINSTANCE HMODULE; typedef HANDLE HGLOBAL;
+typedef struct { LONG left, top, right, bottom; } RECT, *LPRECT; typedef const RECT *LPCRECT;
+typedef struct { LONG x, y; } POINT, *LPPOINT; typedef struct { LONG cx, cy; } SIZE, *LPSIZE;
+typedef struct { HDC hdc; BOOL fErase; RECT rcPaint; BOOL fRestore; BOOL fIncUpdate; BYTE rgbReserved[32]; } PAINTSTRUCT;
+typedef struct { HWND hwnd; UINT message; WPARAM wParam; LPARAM lParam; DWORD time; POINT pt; } MSG;
+typedef struct { POINT ptReserved, ptMaxSize, ptMaxPosition, ptMinTrackSize, ptMaxTrackSize; } MINMAXINFO;
+typedef struct { HWND hwnd; HWND hwndInsertAfter; int x, y, cx, cy; UINT flags; } WINDOWPOS;
+typedef struct { pthread_mutex_t mutex; } CRITICAL_SECTION, *LPCRITICAL_SECTION; /* A recursive mutex */
+typedef struct { void *Ptr; } SRWLOCK, *PSRWLOCK; typedef struct { void *Ptr; } INIT_ONCE, *PINIT_ONCE; typedef struct { void *Ptr; } CONDITION_VARIABLE;
+#define SRWLOCK_INIT {0}
+#define INIT_ONCE_STATIC_INIT {0}
+typedef LRESULT (CALLBACK *WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+typedef DWORD (WINAPI *LPTHREAD_START_ROUTINE)(LPVOID);
+typedef struct { UINT cbSize; UINT style; WNDPROC lpfnWndProc; int cbClsExtra; int cbWndExtra; HINSTANCE hInstance; HICON hIcon; HCURSOR hCursor; HBRUSH hbrBackground; LPCSTR lpszMenuName; LPCSTR lpszClassName; HICON hIconSm; } WNDCLASSEXA;
+typedef struct { UINT cbSize; UINT style; WNDPROC lpfnWndProc; int cbClsExtra; int cbWndExtra; HINSTANCE hInstance; HICON hIcon; HCURSOR hCursor; HBRUSH hbrBackground; LPCWSTR lpszMenuName; LPCWSTR lpszClassName; HICON hIconSm; } WNDCLASSEXW;
+typedef struct { LONG lfHeight, lfWidth, lfEscapement, lfOrientation, lfWeight; BYTE lfItalic, lfUnderline, lfStrikeOut, lfCharSet, lfOutPrecision, lfClipPrecision, lfQuality, lfPitchAndFamily; CHAR lfFaceName[32]; } LOGFONT, LOGFONTA;
+typedef struct { UINT lbStyle; COLORREF lbColor; ULONG_PTR lbHatch; } LOGBRUSH;
+typedef struct { LONG tmHeight, tmAscent, tmDescent, tmInternalLeading, tmExternalLeading, tmAveCharWidth, tmMaxCharWidth, tmWeight, tmOverhang, tmDigitizedAspectX, tmDigitizedAspectY; BYTE tmFirstChar, tmLastChar, tmDefaultChar, tmBreakChar, tmItalic, tmUnderlined, tmStruckOut, tmPitchAndFamily, tmCharSet; } TEXTMETRICA, TEXTMETRIC;
+typedef struct { UINT cbSize; UINT fMask; int nMin; int nMax; UINT nPage; int nPos; int nTrackPos; } SCROLLINFO, *LPSCROLLINFO; typedef const SCROLLINFO *LPCSCROLLINFO;
+typedef struct { DWORD biSize; LONG biWidth; LONG biHeight; WORD biPlanes; WORD biBitCount; DWORD biCompression; DWORD biSizeImage; LONG biXPelsPerMeter; LONG biYPelsPerMeter; DWORD biClrUsed; DWORD biClrImportant; } BITMAPINFOHEADER;
+typedef struct { BYTE rgbBlue, rgbGreen, rgbRed, rgbReserved; } RGBQUAD;
+typedef struct { BITMAPINFOHEADER bmiHeader; RGBQUAD bmiColors[1]; } BITMAPINFO;
+typedef struct { DWORD LowPart; LONG HighPart; } LARGE_INTEGER_PARTS;
+typedef union { struct { DWORD LowPart; LONG HighPart; } u; LONGLONG QuadPart; } LARGE_INTEGER;
+typedef struct { DWORD nLength; LPVOID lpSecurityDescriptor; BOOL bInheritHandle; } SECURITY_ATTRIBUTES, *LPSECURITY_ATTRIBUTES;
+typedef struct { UINT mask; DWORD dwStateMask; DWORD dwState; LPSTR pszText; int cchTextMax; int iImage; LPARAM lParam; } TCITEMA;
+typedef struct { HWND hwndFrom; UINT_PTR idFrom; UINT code; } NMHDR;
+typedef struct { DWORD dwSize; DWORD dwICC; } INITCOMMONCONTROLSEX;
+#define MAKEINTRESOURCE(i) ((LPSTR)(ULONG_PTR)(i))
+#define LOWORD(l) ((WORD)((DWORD_PTR)(l) & 0xffff))
+#define HIWORD(l) ((WORD)(((DWORD_PTR)(l) >> 16) & 0xffff))
+#define MAKELONG(a, b) ((LONG)(((WORD)(a)) | ((DWORD)((WORD)(b))) << 16))
+#define MAKELPARAM(l, h) ((LPARAM)(DWORD)MAKELONG(l, h))
+#define RGB(r,g,b) ((COLORREF)(((BYTE)(r)|((WORD)((BYTE)(g))<<8))|(((DWORD)(BYTE)(b))<<16)))
+#define GetRValue(c) ((BYTE)(c))
+#define GetGValue(c) ((BYTE)(((WORD)(c)) >> 8))
+#define GetBValue(c) ((BYTE)((c)>>16))
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define S_OK ((HRESULT)0)
+#define INFINITE 0xFFFFFFFF
+#define WAIT_OBJECT_0 0
+#define WAIT_ABANDONED 0x80
+#define WAIT_TIMEOUT 258
+#define INVALID_HANDLE_VALUE ((HANDLE)(LONG_PTR)-1)
+#define CW_USEDEFAULT ((int)0x80000000)
+#define GWLP_USERDATA (-21)
+#define GWLP_WNDPROC (-4)
+#define GWL_STYLE (-16)
+#define GWL_EXSTYLE (-20)
+/* messages */
+enum { WM_NULL=0, WM_CREATE=1, WM_DESTROY=2, WM_MOVE=3, WM_SIZE=5, WM_SETFOCUS=7, WM_KILLFOCUS=8, WM_ENABLE=10, WM_SETREDRAW=11, WM_SETTEXT=12, WM_GETTEXT=13, WM_GETTEXTLENGTH=14, WM_PAINT=15, WM_CLOSE=16, WM_ERASEBKGND=20,
+ WM_SHOWWINDOW=24, WM_SETCURSOR=32, WM_GETMINMAXINFO=36, WM_SETFONT=48, WM_GETFONT=49, WM_WINDOWPOSCHANGING=70, WM_WINDOWPOSCHANGED=71, WM_NOTIFY=78, WM_NCDESTROY=130, WM_GETDLGCODE=135,
+ WM_KEYDOWN=256, WM_KEYUP=257, WM_CHAR=258, WM_COMMAND=273, WM_TIMER=275, WM_HSCROLL=276, WM_VSCROLL=277, WM_CTLCOLORSTATIC=312,
+ WM_MOUSEMOVE=512, WM_LBUTTONDOWN=513, WM_LBUTTONUP=514, WM_LBUTTONDBLCLK=515, WM_RBUTTONDOWN=516, WM_RBUTTONUP=517, WM_RBUTTONDBLCLK=518, WM_MOUSEWHEEL=522, WM_MOUSEHWHEEL=526,
+ WM_CUT=768, WM_COPY=769, WM_PASTE=770, WM_CLEAR=771, WM_UNDO=772, WM_MOUSEHOVER=0x2A1, WM_MOUSELEAVE=0x2A3, WM_APP=0x8000, WM_USER=0x400 };
+enum { EN_CHANGE=0x300, EN_UPDATE=0x400, BN_CLICKED=0, EM_GETSEL=0xB0, EM_SETSEL=0xB1, EM_REPLACESEL=0xC2, EM_GETHANDLE=0xBD, EM_LIMITTEXT=0xC5, EM_SETLIMITTEXT=0xC5, EM_LINESCROLL=0xB6, EM_SCROLLCARET=0xB7, EM_UNDO=0xC7 };
+/* styles */
+#define WS_OVERLAPPEDWINDOW 0x00CF0000L
+#define WS_CHILD 0x40000000L
+#define WS_VISIBLE 0x10000000L
+#define WS_BORDER 0x00800000L
+#define WS_THICKFRAME 0x00040000L
+#define WS_MAXIMIZEBOX 0x00010000L
+#define WS_VSCROLL 0x00200000L
+#define WS_HSCROLL 0x00100000L
+#define WS_CLIPCHILDREN 0x02000000L
+#define WS_CLIPSIBLINGS 0x04000000L
+#define WS_TABSTOP 0x00010000L
+#define WS_POPUP 0x80000000L
+#define WS_EX_WINDOWEDGE 0x100L
+#define WS_EX_CLIENTEDGE 0x200L
+#define WS_EX_COMPOSITED 0x02000000L
+#define BS_TEXT 0
+#define BS_PUSHBUTTON 0
+#define SS_NOTIFY 0x100
+#define SS_CENTER 1
+#define SS_CENTERIMAGE 0x200
+#define SS_LEFT 0
+#define SS_LEFTNOWORDWRAP 0xC
+#define ES_MULTILINE 4
+#define ES_WANTRETURN 0x1000
+#define ES_NUMBER 0x2000
+#define ES_AUTOVSCROLL 0x40
+#define ES_READONLY 0x800
+#define CS_HREDRAW 2
+#define CS_VREDRAW 1
+#define CS_DBLCLKS 8
+#define COLOR_WINDOW 5
+#define COLOR_WINDOWTEXT 8
+#define COLOR_BTNFACE 15
+#define COLOR_BTNSHADOW 16
+#define COLOR_HIGHLIGHT 13
+#define COLOR_HIGHLIGHTTEXT 14
+#define COLOR_GRAYTEXT 17
+#define COLOR_BTNTEXT 18
+#define IDC_ARROW MAKEINTRESOURCE(32512)
+#define IMAGE_ICON 1
+#define SW_SHOWDEFAULT 10
+#define SW_SHOW 5
+#define SW_HIDE 0
+#define SW_SHOWNA 8
+#define SWP_NOSIZE 1
+#define SWP_NOMOVE 2
+#define SWP_NOZORDER 4
+#define SWP_NOREDRAW 8
+#define SWP_NOACTIVATE 0x10
+#define SWP_DRAWFRAME 0x20
+#define SWP_FRAMECHANGED 0x20
+#define SWP_SHOWWINDOW 0x40
+#define SWP_HIDEWINDOW 0x80
+#define SWP_NOCOPYBITS 0x100
+#define SWP_NOOWNERZORDER 0x200
+#define SWP_ASYNCWINDOWPOS 0x4000
+#define RDW_INVALIDATE 1
+#define RDW_ERASE 4
+#define RDW_FRAME 0x400
+#define RDW_ALLCHILDREN 0x80
+#define RDW_UPDATENOW 0x100
+#define RDW_NOCHILDREN 0x40
+#define SW_INVALIDATE 2
+#define SW_ERASE 4
+#define SW_SCROLLCHILDREN 1
+#define SB_VERT 1
+#define SB_HORZ 0
+#define SB_LINEUP 0
+#define SB_LINEDOWN 1
+#define SB_PAGEUP 2
+#define SB_PAGEDOWN 3
+#define SB_THUMBPOSITION 4
+#define SB_THUMBTRACK 5
+#define SB_TOP 6
+#define SB_BOTTOM 7
+#define SB_LINELEFT 0
+#define SB_LINERIGHT 1
+#define SB_PAGELEFT 2
+#define SB_PAGERIGHT 3
+#define SIF_RANGE 1
+#define SIF_PAGE 2
+#define SIF_POS 4
+#define SIF_TRACKPOS 0x10
+#define SIF_ALL 0x17
+#define WHEEL_DELTA 120
+#define GET_WHEEL_DELTA_WPARAM(w) ((short)HIWORD(w))
+#define DT_CENTER 1
+#define DT_VCENTER 4
+#define DT_SINGLELINE 0x20
+#define DT_LEFT 0
+#define DT_RIGHT 2
+#define DT_WORDBREAK 0x10
+#define SS_RIGHT 2
+#define BLACK_BRUSH 4
+#define DT_END_ELLIPSIS 0x8000
+#define DT_NOPREFIX 0x800
+#define DFC_BUTTON 4
+#define DFCS_BUTTONPUSH 0x10
+#define DFCS_PUSHED 0x200
+#define DFCS_INACTIVE 0x100
+#define TRANSPARENT 1
+#define OPAQUE 2
+#define SRCCOPY 0xCC0020
+#define NULL_PEN 8
+#define HOLLOW_BRUSH 5
+#define NULL_BRUSH 5
+#define DEFAULT_GUI_FONT 17
+#define BS_SOLID 0
+#define PS_SOLID 0
+#define DIB_RGB_COLORS 0
+#define BI_RGB 0
+#define HALFTONE 4
+#define COLORONCOLOR 3
+#define VK_LEFT 0x25
+#define VK_UP 0x26
+#define VK_RIGHT 0x27
+#define VK_DOWN 0x28
+#define VK_SPACE 0x20
+#define VK_RETURN 0x0D
+#define VK_TAB 0x09
+#define VK_PRIOR 0x21
+#define VK_NEXT 0x22
+#define VK_HOME 0x24
+#define VK_END 0x23
+#define MK_LBUTTON 1
+#define MB_OK 0
+#define PM_REMOVE 1
+#define PM_NOREMOVE 0
+#define GENERIC_READ 0x80000000
+#define FILE_SHARE_READ 1
+#define OPEN_EXISTING 3
+#define FILE_ATTRIBUTE_NORMAL 0x80
+#define PAGE_READONLY 2
+#define FILE_MAP_READ 4
+#define CP_UTF8 65001
+#define CP_ACP 0
+#define MEM_COMMIT 0x1000
+#define MEM_RESERVE 0x2000
+#define MEM_RELEASE 0x8000
+#define PAGE_READWRITE 4
+#define WT_EXECUTEDEFAULT 0
+#define WT_EXECUTELONGFUNCTION 0x10
+#define COINIT_MULTITHREADED 0
+#define CLSCTX_INPROC_SERVER 1
+#define GMEM_MOVEABLE 2
+#define ICC_TAB_CLASSES 8
+#define TCIF_TEXT 1
+#define TCM_FIRST 0x1300
+#define TCM_INSERTITEMA (TCM_FIRST + 7)
+#define TCM_GETCURSEL (TCM_FIRST + 11)
+#define TCM_SETCURSEL (TCM_FIRST + 12)
+#define TCM_ADJUSTRECT (TCM_FIRST + 40)
+#define TCM_DELETEITEM (TCM_FIRST + 8)
+#define TCN_FIRST (0U-550U)
+#define TCN_SELCHANGE (TCN_FIRST - 1)
+#define WC_TABCONTROLA "SysTabControl32"
+#define DLGC_WANTARROWS 1
+#define DLGC_WANTCHARS 0x80
+#define HTCLIENT 1
+#define MAX_PATH 260
+#define ERROR_SUCCESS 0
+#define SM_CXVSCROLL 2
+#define IDI_APPLICATION MAKEINTRESOURCE(32512)
+#define LR_DEFAULTCOLOR 0
+#define LR_SHARED 0x8000
+#define FW_NORMAL 400
+/* functions */
+#define WINFN(ret, name, args) ret WINAPI name args;
+WINFN(HANDLE, CreateMutexA, (LPSECURITY_ATTRIBUTES, BOOL, LPCSTR))
+WINFN(DWORD, WaitForSingleObject, (HANDLE, DWORD))
+WINFN(BOOL, ReleaseMutex, (HANDLE))
+WINFN(BOOL, CloseHandle, (HANDLE))
+WINFN(HICON, LoadIcon, (HINSTANCE, LPCSTR))
+WINFN(HCURSOR, LoadCursor, (HINSTANCE, LPCSTR))
+WINFN(HANDLE, LoadImage, (HINSTANCE, LPCSTR, UINT, int, int, UINT))
+WINFN(HMODULE, GetModuleHandle, (LPCSTR))
+WINFN(ATOM, RegisterClassExA, (const WNDCLASSEXA*))
+WINFN(BOOL, IsWindowUnicode, (HWND))
+WINFN(ATOM, RegisterClassExW, (const WNDCLASSEXW*))
+WINFN(BOOL, UnregisterClassA, (LPCSTR, HINSTANCE))
+WINFN(BOOL, UnregisterClassW, (LPCWSTR, HINSTANCE))
+WINFN(void, InitializeCriticalSection, (LPCRITICAL_SECTION))
+WINFN(BOOL, InitializeCriticalSectionAndSpinCount, (LPCRITICAL_SECTION, DWORD))
+WINFN(void, DeleteCriticalSection, (LPCRITICAL_SECTION))
+WINFN(void, EnterCriticalSection, (LPCRITICAL_SECTION))
+WINFN(void, LeaveCriticalSection, (LPCRITICAL_SECTION))
+WINFN(BOOL, TryEnterCriticalSection, (LPCRITICAL_SECTION))
+WINFN(void, InitializeSRWLock, (PSRWLOCK))
+WINFN(void, AcquireSRWLockExclusive, (PSRWLOCK))
+WINFN(void, ReleaseSRWLockExclusive, (PSRWLOCK))
+WINFN(void, AcquireSRWLockShared, (PSRWLOCK))
+WINFN(void, ReleaseSRWLockShared, (PSRWLOCK))
+typedef BOOL (CALLBACK *PINIT_ONCE_FN)(PINIT_ONCE, void*, void**);
+WINFN(BOOL, InitOnceExecuteOnce, (PINIT_ONCE, PINIT_ONCE_FN, void*, void**))
+WINFN(BOOL, SetWindowPos, (HWND, HWND, int, int, int, int, UINT))
+WINFN(BOOL, InvalidateRect, (HWND, const RECT*, BOOL))
+WINFN(BOOL, ValidateRect, (HWND, const RECT*))
+WINFN(BOOL, RedrawWindow, (HWND, const RECT*, HRGN, UINT))
+WINFN(BOOL, SetWindowTextA, (HWND, LPCSTR))
+WINFN(BOOL, SetWindowTextW, (HWND, LPCWSTR))
+WINFN(BOOL, EnableWindow, (HWND, BOOL))
+WINFN(BOOL, GetClientRect, (HWND, LPRECT))
+WINFN(BOOL, GetWindowRect, (HWND, LPRECT))
+WINFN(HDC, CreateCompatibleDC, (HDC))
+WINFN(HBITMAP, CreateCompatibleBitmap, (HDC, int, int))
+WINFN(HBITMAP, CreateDIBSection, (HDC, const BITMAPINFO*, UINT, void**, HANDLE, DWORD))
+WINFN(BOOL, DeleteObject, (HGDIOBJ))
+WINFN(BOOL, DeleteDC, (HDC))
+WINFN(HGDIOBJ, SelectObject, (HDC, HGDIOBJ))
+WINFN(HGDIOBJ, GetStockObject, (int))
+WINFN(int, GetObject, (HANDLE, int, LPVOID))
+WINFN(HPEN, CreatePen, (int, int, COLORREF))
+WINFN(HBRUSH, CreateBrushIndirect, (const LOGBRUSH*))
+WINFN(HBRUSH, CreateSolidBrush, (COLORREF))
+WINFN(HBRUSH, GetSysColorBrush, (int))
+WINFN(DWORD, GetSysColor, (int))
+WINFN(int, GetSystemMetrics, (int))
+WINFN(int, FillRect, (HDC, const RECT*, HBRUSH))
+WINFN(int, FrameRect, (HDC, const RECT*, HBRUSH))
+WINFN(int, SetBkMode, (HDC, int))
+WINFN(COLORREF, SetBkColor, (HDC, COLORREF))
+WINFN(COLORREF, SetTextColor, (HDC, COLORREF))
+WINFN(BOOL, BitBlt, (HDC, int, int, int, int, HDC, int, int, DWORD))
+WINFN(BOOL, StretchBlt, (HDC, int, int, int, int, HDC, int, int, int, int, DWORD))
+WINFN(int, SetStretchBltMode, (HDC, int))
+WINFN(HDC, GetDC, (HWND))
+WINFN(int, ReleaseDC, (HWND, HDC))
+WINFN(HDC, BeginPaint, (HWND, PAINTSTRUCT*))
+WINFN(BOOL, EndPaint, (HWND, const PAINTSTRUCT*))
+WINFN(BOOL, MoveToEx, (HDC, int, int, LPPOINT))
+WINFN(BOOL, LineTo, (HDC, int, int))
+WINFN(BOOL, Polyline, (HDC, const POINT*, int))
+WINFN(BOOL, PolyPolyline, (HDC, const POINT*, const DWORD*, DWORD))
+WINFN(BOOL, Arc, (HDC, int, int, int, int, int, int, int, int))
+WINFN(BOOL, Rectangle, (HDC, int, int, int, int))
+WINFN(BOOL, RoundRect, (HDC, int, int, int, int, int, int))
+WINFN(BOOL, Ellipse, (HDC, int, int, int, int))
+WINFN(BOOL, Polygon, (HDC, const POINT*, int))
+WINFN(int, DrawTextA, (HDC, LPCSTR, int, LPRECT, UINT))
+WINFN(int, DrawTextW, (HDC, LPCWSTR, int, LPRECT, UINT))
+WINFN(BOOL, TextOutA, (HDC, int, int, LPCSTR, int))
+WINFN(BOOL, ExtTextOutA, (HDC, int, int, UINT, const RECT*, LPCSTR, UINT, const INT*))
+WINFN(BOOL, GetTextMetricsA, (HDC, TEXTMETRICA*))
+WINFN(BOOL, DrawFrameControl, (HDC, LPRECT, UINT, UINT))
+WINFN(BOOL, DrawFocusRect, (HDC, const RECT*))
+WINFN(BOOL, SetViewportOrgEx, (HDC, int, int, LPPOINT))
+WINFN(BOOL, OffsetViewportOrgEx, (HDC, int, int, LPPOINT))
+WINFN(int, SaveDC, (HDC))
+WINFN(BOOL, RestoreDC, (HDC, int))
+WINFN(int, IntersectClipRect, (HDC, int, int, int, int))
+WINFN(BOOL, RectVisible, (HDC, const RECT*))
+WINFN(int, GetClipBox, (HDC, LPRECT))
+WINFN(BOOL, IntersectRect, (LPRECT, const RECT*, const RECT*))
+WINFN(BOOL, UnionRect, (LPRECT, const RECT*, const RECT*))
+WINFN(BOOL, PtInRect, (const RECT*, POINT))
+WINFN(BOOL, SetRect, (LPRECT, int, int, int, int))
+WINFN(BOOL, OffsetRect, (LPRECT, int, int))
+WINFN(BOOL, IsRectEmpty, (const RECT*))
+WINFN(BOOL, SetRectEmpty, (LPRECT))
+WINFN(BOOL, InflateRect, (LPRECT, int, int))
+WINFN(BOOL, GetUpdateRect, (HWND, LPRECT, BOOL))
+WINFN(HWND, CreateWindowExA, (DWORD, LPCSTR, LPCSTR, DWORD, int, int, int, int, HWND, HMENU, HINSTANCE, LPVOID))
+WINFN(HWND, CreateWindowExW, (DWORD, LPCWSTR, LPCWSTR, DWORD, int, int, int, int, HWND, HMENU, HINSTANCE, LPVOID))
+WINFN(BOOL, DestroyWindow, (HWND))
+WINFN(BOOL, ShowWindow, (HWND, int))
+WINFN(BOOL, UpdateWindow, (HWND))
+WINFN(BOOL, IsWindow, (HWND))
+WINFN(BOOL, IsWindowVisible, (HWND))
+WINFN(HWND, SetFocus, (HWND))
+WINFN(HWND, GetFocus, (void))
+WINFN(HWND, SetCapture, (HWND))
+WINFN(BOOL, ReleaseCapture, (void))
+WINFN(HWND, GetParent, (HWND))
+WINFN(LRESULT, SendMessageA, (HWND, UINT, WPARAM, LPARAM))
+WINFN(LRESULT, SendMessageW, (HWND, UINT, WPARAM, LPARAM))
+WINFN(BOOL, PostMessageA, (HWND, UINT, WPARAM, LPARAM))
+WINFN(BOOL, PostMessageW, (HWND, UINT, WPARAM, LPARAM))
+WINFN(LONG_PTR, SetWindowLongPtrA, (HWND, int, LONG_PTR))
+WINFN(LONG_PTR, GetWindowLongPtrA, (HWND, int))
+WINFN(LONG_PTR, SetWindowLongPtrW, (HWND, int, LONG_PTR))
+WINFN(LONG_PTR, GetWindowLongPtrW, (HWND, int))
+WINFN(LRESULT, DefWindowProcA, (HWND, UINT, WPARAM, LPARAM))
+WINFN(LRESULT, DefWindowProcW, (HWND, UINT, WPARAM, LPARAM))
+WINFN(LRESULT, CallWindowProcA, (WNDPROC, HWND, UINT, WPARAM, LPARAM))
+WINFN(LRESULT, CallWindowProcW, (WNDPROC, HWND, UINT, WPARAM, LPARAM))
+WINFN(void, PostQuitMessage, (int))
+WINFN(BOOL, PeekMessageA, (MSG*, HWND, UINT, UINT, UINT))
+WINFN(BOOL, GetMessageA, (MSG*, HWND, UINT, UINT))
+WINFN(BOOL, PeekMessageW, (MSG*, HWND, UINT, UINT, UINT))
+WINFN(BOOL, GetMessageW, (MSG*, HWND, UINT, UINT))
+WINFN(BOOL, TranslateMessage, (const MSG*))
+WINFN(LRESULT, DispatchMessageA, (const MSG*))
+WINFN(LRESULT, DispatchMessageW, (const MSG*))
+WINFN(int, GetWindowTextLengthA, (HWND))
+WINFN(int, GetWindowTextA, (HWND, LPSTR, int))
+WINFN(int, GetWindowTextLengthW, (HWND))
+WINFN(int, GetWindowTextW, (HWND, LPWSTR, int))
+WINFN(HANDLE, CreateThread, (LPSECURITY_ATTRIBUTES, SIZE_T, LPTHREAD_START_ROUTINE, LPVOID, DWORD, LPDWORD))
+WINFN(BOOL, QueueUserWorkItem, (LPTHREAD_START_ROUTINE, LPVOID, ULONG))
+WINFN(DWORD, GetTickCount, (void))
+WINFN(ULONGLONG, GetTickCount64, (void))
+WINFN(void, Sleep, (DWORD))
+WINFN(DWORD, GetCurrentThreadId, (void))
+WINFN(HDWP, BeginDeferWindowPos, (int))
+WINFN(HDWP, DeferWindowPos, (HDWP, HWND, HWND, int, int, int, int, UINT))
+WINFN(BOOL, EndDeferWindowPos, (HDWP))
+WINFN(int, ScrollWindowEx, (HWND, int, int, const RECT*, const RECT*, HRGN, LPRECT, UINT))
+WINFN(int, SetScrollInfo, (HWND, int, LPCSCROLLINFO, BOOL))
+WINFN(BOOL, GetScrollInfo, (HWND, int, LPSCROLLINFO))
+WINFN(UINT_PTR, SetTimer, (HWND, UINT_PTR, UINT, void*))
+WINFN(BOOL, KillTimer, (HWND, UINT_PTR))
+WINFN(LONG, InterlockedIncrement, (LONG volatile*))
+WINFN(LONG, InterlockedDecrement, (LONG volatile*))
+WINFN(LONG, InterlockedExchange, (LONG volatile*, LONG))
+WINFN(LONG, InterlockedCompareExchange, (LONG volatile*, LONG, LONG))
+WINFN(LONG, InterlockedExchangeAdd, (LONG volatile*, LONG))
+WINFN(void*, InterlockedExchangePointer, (void* volatile*, void*))
+WINFN(void*, InterlockedCompareExchangePointer, (void* volatile*, void*, void*))
+WINFN(LONGLONG, InterlockedIncrement64, (LONGLONG volatile*))
+WINFN(LONGLONG, InterlockedExchangeAdd64, (LONGLONG volatile*, LONGLONG))
+WINFN(LONGLONG, InterlockedCompareExchange64, (LONGLONG volatile*, LONGLONG, LONGLONG))
+WINFN(void, MemoryBarrier, (void))
+WINFN(HANDLE, CreateFileA, (LPCSTR, DWORD, DWORD, LPSECURITY_ATTRIBUTES, DWORD, DWORD, HANDLE))
+WINFN(HANDLE, CreateFileW, (LPCWSTR, DWORD, DWORD, LPSECURITY_ATTRIBUTES, DWORD, DWORD, HANDLE))
+WINFN(BOOL, GetFileSizeEx, (HANDLE, LARGE_INTEGER*))
+WINFN(HANDLE, CreateFileMappingA, (HANDLE, LPSECURITY_ATTRIBUTES, DWORD, DWORD, DWORD, LPCSTR))
+WINFN(LPVOID, MapViewOfFile, (HANDLE, DWORD, DWORD, DWORD, SIZE_T))
+WINFN(BOOL, UnmapViewOfFile, (LPCVOID))
+WINFN(int, MultiByteToWideChar, (UINT, DWORD, LPCSTR, int, LPWSTR, int))
+WINFN(int, WideCharToMultiByte, (UINT, DWORD, LPCWSTR, int, LPSTR, int, LPCSTR, BOOL*))
+WINFN(LPVOID, LocalLock, (HLOCAL))
+WINFN(BOOL, LocalUnlock, (HLOCAL))
+WINFN(LPVOID, VirtualAlloc, (LPVOID, SIZE_T, DWORD, DWORD))
+WINFN(BOOL, VirtualFree, (LPVOID, SIZE_T, DWORD))
+WINFN(HRESULT, CoInitializeEx, (LPVOID, DWORD))
+WINFN(void, CoUninitialize, (void))
+WINFN(int, MessageBoxA, (HWND, LPCSTR, LPCSTR, UINT))
+WINFN(HWND, WindowFromPoint, (POINT))
+WINFN(BOOL, ScreenToClient, (HWND, LPPOINT))
+WINFN(BOOL, ClientToScreen, (HWND, LPPOINT))
+WINFN(BOOL, GetCursorPos, (LPPOINT))
+WINFN(BOOL, QueryPerformanceCounter, (LARGE_INTEGER*))
+WINFN(BOOL, QueryPerformanceFrequency, (LARGE_INTEGER*))
+WINFN(BOOL, InitCommonControlsEx, (const INITCOMMONCONTROLSEX*))
+WINFN(void, OutputDebugStringA, (LPCSTR))
+/* MS CRT secure functions */
+int sprintf_s(char*, size_t, const char*, ...);
+#define _TRUNCATE ((size_t)-1)
+#define ETO_OPAQUE 0x2
+#define EM_LINEFROMCHAR 0xC9
+#define EM_LINEINDEX 0xBB
+#define EM_LINELENGTH 0xC1
+#define EM_GETLINE 0xC4
+#define WM_IME_CHAR 0x286
+#define WM_IME_COMPOSITION 0x10F
+#define ETO_CLIPPED 0x4
+
+#define COLOR_APPWORKSPACE 12
+#define BI_BITFIELDS 3
+#pragma pack(push, 2)
+typedef struct { WORD bfType; DWORD bfSize; WORD bfReserved1; WORD bfReserved2; DWORD bfOffBits; } BITMAPFILEHEADER;
+#pragma pack(pop)
+typedef struct { WORD wProcessorArchitecture; WORD wReserved; DWORD dwPageSize; LPVOID lpMinimumApplicationAddress; LPVOID lpMaximumApplicationAddress; DWORD_PTR dwActiveProcessorMask; DWORD dwNumberOfProcessors; DWORD dwProcessorType; DWORD dwAllocationGranularity; WORD wProcessorLevel; WORD wProcessorRevision; } SYSTEM_INFO;
+WINFN(void, GetSystemInfo, (SYSTEM_INFO*))
+typedef struct _OVERLAPPED OVERLAPPED, *LPOVERLAPPED;
+WINFN(BOOL, ReadFile, (HANDLE, LPVOID, DWORD, LPDWORD, LPOVERLAPPED))
+WINFN(int, StretchDIBits, (HDC, int, int, int, int, int, int, int, int, const void*, const BITMAPINFO*, UINT, DWORD))
+#define MAXLONG 0x7fffffff
+#define __declspec(x) __declspec_##x
+#define __declspec_thread __thread
+WINFN(DWORD, GetWindowThreadProcessId, (HWND, LPDWORD))
+#define UNREFERENCED_PARAMETER(P) (void)(P)
+#define WM_PRINTCLIENT 0x318
+#define PRF_CLIENT 4
+WINFN(UINT, RegisterWindowMessageA, (LPCSTR))
+#endif
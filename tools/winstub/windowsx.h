@@ -0,0 +1,8 @@
+/* The windowsx.h macros tinyGUI uses */
+#define GET_X_LPARAM(lp) ((int)(short)LOWORD(lp))
+#define GET_Y_LPARAM(lp) ((int)(short)HIWORD(lp))
+#define SelectBitmap(hdc, hbm) ((HBITMAP)SelectObject((hdc), (HGDIOBJ)(HBITMAP)(hbm)))
+#define GetStockPen(i) ((HPEN)GetStockObject(i))
+#define GetStockBrush(i) ((HBRUSH)GetStockObject(i))
+#define GetStockFont(i) ((HFONT)GetStockObject(i))
+#define SelectFont(hdc, f) ((HFONT)SelectObject((hdc), (HGDIOBJ)(HFONT)(f)))
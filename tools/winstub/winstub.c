@@ -0,0 +1,695 @@
+/* winstub - the Win32 functions tinyGUI calls, for running the benchmarks in tools on other platforms. The functions the benchmarks
+   time do their real work: the critical sections are recursive mutexes, the threads, the interlocked operations, the clocks, the
+   UTF-8 conversions and the file mappings are those of the platform. There is no window system under them: the windows, the device
+   contexts and the GDI objects are handles that draw nothing, and the messages are sent nowhere, so the benchmarks time tinyGUI's
+   own work and none of the system's.
+
+   Build a benchmark with it, with a C99 compiler and POSIX threads:
+   cc -O2 -Itools/winstub -o removebench tools/removebench.c tinyGUI/tiny*.c tools/winstub/winstub.c -lpthread */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "windows.h"
+
+#define STUB_HANDLE ((HANDLE)(ULONG_PTR)0x1000) /* The handle of the objects there are none of, any non-NULL value */
+
+enum _handleType {
+	HANDLE_FILE, /* An opened file or a mapping of it */
+	HANDLE_THREAD
+};
+
+/* Opened files and threads, the handles of the rest are STUB_HANDLE */
+typedef struct {
+	enum _handleType type;
+	int fd;
+	long long size;
+} FileHandle;
+
+/* A thread, freed when it has ended and its handle is closed */
+typedef struct {
+	enum _handleType type;
+	LPTHREAD_START_ROUTINE routine;
+	LPVOID parameter;
+	pthread_mutex_t mutex;
+	pthread_cond_t ended;
+	BOOL hasEnded;
+	int numReferences; /* The thread itself and its handle */
+} ThreadHandle;
+
+/* Synchronization */
+
+HANDLE WINAPI CreateMutexA(LPSECURITY_ATTRIBUTES attributes, BOOL initialOwner, LPCSTR name){ return STUB_HANDLE; }
+
+/* Waits for a thread to end, the other objects are always signaled */
+DWORD WINAPI WaitForSingleObject(HANDLE handle, DWORD milliseconds){
+	ThreadHandle *thread = (ThreadHandle*)handle;
+	struct timespec deadline;
+	int error = 0;
+
+	if (handle == STUB_HANDLE || thread->type != HANDLE_THREAD)
+		return WAIT_OBJECT_0;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += milliseconds / 1000;
+	deadline.tv_nsec += (long)(milliseconds % 1000) * 1000000;
+	if (deadline.tv_nsec >= 1000000000){
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
+	}
+	pthread_mutex_lock(&(thread->mutex));
+	while (!thread->hasEnded && !error)
+		error = milliseconds == INFINITE ? pthread_cond_wait(&(thread->ended), &(thread->mutex)) :
+			pthread_cond_timedwait(&(thread->ended), &(thread->mutex), &deadline);
+	pthread_mutex_unlock(&(thread->mutex));
+	return thread->hasEnded ? WAIT_OBJECT_0 : WAIT_TIMEOUT;
+}
+BOOL WINAPI ReleaseMutex(HANDLE mutex){ return TRUE; }
+
+void WINAPI InitializeCriticalSection(LPCRITICAL_SECTION criticalSection){
+	pthread_mutexattr_t attributes;
+
+	pthread_mutexattr_init(&attributes);
+	pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&(criticalSection->mutex), &attributes);
+	pthread_mutexattr_destroy(&attributes);
+}
+
+BOOL WINAPI InitializeCriticalSectionAndSpinCount(LPCRITICAL_SECTION criticalSection, DWORD spinCount){
+	InitializeCriticalSection(criticalSection);
+	return TRUE;
+}
+
+void WINAPI DeleteCriticalSection(LPCRITICAL_SECTION criticalSection){ pthread_mutex_destroy(&(criticalSection->mutex)); }
+void WINAPI EnterCriticalSection(LPCRITICAL_SECTION criticalSection){ pthread_mutex_lock(&(criticalSection->mutex)); }
+void WINAPI LeaveCriticalSection(LPCRITICAL_SECTION criticalSection){ pthread_mutex_unlock(&(criticalSection->mutex)); }
+BOOL WINAPI TryEnterCriticalSection(LPCRITICAL_SECTION criticalSection){ return !pthread_mutex_trylock(&(criticalSection->mutex)); }
+
+/* The slim locks spin on their pointer: 0 is free, -1 held exclusively, n > 0 held by n readers */
+void WINAPI InitializeSRWLock(PSRWLOCK lock){ lock->Ptr = NULL; }
+
+void WINAPI AcquireSRWLockExclusive(PSRWLOCK lock){
+	while (!__sync_bool_compare_and_swap(&(lock->Ptr), NULL, (void*)(LONG_PTR)-1))
+		sched_yield();
+}
+
+void WINAPI ReleaseSRWLockExclusive(PSRWLOCK lock){ __sync_lock_release(&(lock->Ptr)); }
+
+void WINAPI AcquireSRWLockShared(PSRWLOCK lock){
+	void *readers;
+
+	for (;;){
+		readers = lock->Ptr;
+		if ((LONG_PTR)readers >= 0 && __sync_bool_compare_and_swap(&(lock->Ptr), readers, (void*)((LONG_PTR)readers + 1)))
+			return;
+		sched_yield();
+	}
+}
+
+void WINAPI ReleaseSRWLockShared(PSRWLOCK lock){ __sync_fetch_and_sub((LONG_PTR*)&(lock->Ptr), 1); }
+
+static pthread_mutex_t initOnceMutex = PTHREAD_MUTEX_INITIALIZER;
+
+BOOL WINAPI InitOnceExecuteOnce(PINIT_ONCE initOnce, PINIT_ONCE_FN function, void *parameter, void **context){
+	BOOL success = TRUE;
+
+	pthread_mutex_lock(&initOnceMutex);
+	if (!initOnce->Ptr && (success = function(initOnce, parameter, context)))
+		initOnce->Ptr = (void*)1;
+	pthread_mutex_unlock(&initOnceMutex);
+	return success;
+}
+
+LONG WINAPI InterlockedIncrement(LONG volatile *value){ return __sync_add_and_fetch(value, 1); }
+LONG WINAPI InterlockedDecrement(LONG volatile *value){ return __sync_sub_and_fetch(value, 1); }
+LONG WINAPI InterlockedExchange(LONG volatile *target, LONG value){ return __sync_lock_test_and_set(target, value); }
+LONG WINAPI InterlockedCompareExchange(LONG volatile *target, LONG exchange, LONG comparand){
+	return __sync_val_compare_and_swap(target, comparand, exchange);
+}
+LONG WINAPI InterlockedExchangeAdd(LONG volatile *target, LONG value){ return __sync_fetch_and_add(target, value); }
+void* WINAPI InterlockedExchangePointer(void* volatile *target, void *value){ return __sync_lock_test_and_set(target, value); }
+void* WINAPI InterlockedCompareExchangePointer(void* volatile *target, void *exchange, void *comparand){
+	return __sync_val_compare_and_swap(target, comparand, exchange);
+}
+LONGLONG WINAPI InterlockedIncrement64(LONGLONG volatile *value){ return __sync_add_and_fetch(value, 1); }
+LONGLONG WINAPI InterlockedExchangeAdd64(LONGLONG volatile *target, LONGLONG value){ return __sync_fetch_and_add(target, value); }
+LONGLONG WINAPI InterlockedCompareExchange64(LONGLONG volatile *target, LONGLONG exchange, LONGLONG comparand){
+	return __sync_val_compare_and_swap(target, comparand, exchange);
+}
+void WINAPI MemoryBarrier(void){ __sync_synchronize(); }
+
+/* Threads */
+
+/* Drops a reference to a thread, frees it after the last one */
+static void releaseThread(ThreadHandle *thread){
+	int numReferences;
+
+	pthread_mutex_lock(&(thread->mutex));
+	numReferences = --thread->numReferences;
+	pthread_mutex_unlock(&(thread->mutex));
+	if (numReferences)
+		return;
+	pthread_mutex_destroy(&(thread->mutex));
+	pthread_cond_destroy(&(thread->ended));
+	free(thread);
+}
+
+static void *threadProc(void *param){
+	ThreadHandle *thread = (ThreadHandle*)param;
+
+	thread->routine(thread->parameter);
+	pthread_mutex_lock(&(thread->mutex));
+	thread->hasEnded = TRUE;
+	pthread_cond_broadcast(&(thread->ended));
+	pthread_mutex_unlock(&(thread->mutex));
+	releaseThread(thread);
+	return NULL;
+}
+
+/* Starts a detached thread, with a handle to wait on it if numReferences is 2 */
+static ThreadHandle *startThread(LPTHREAD_START_ROUTINE routine, LPVOID parameter, int numReferences){
+	ThreadHandle *thread = (ThreadHandle*)malloc(sizeof(ThreadHandle));
+	pthread_t threadID;
+
+	if (!thread)
+		return NULL;
+	thread->type = HANDLE_THREAD;
+	thread->routine = routine;
+	thread->parameter = parameter;
+	thread->hasEnded = FALSE;
+	thread->numReferences = numReferences;
+	pthread_mutex_init(&(thread->mutex), NULL);
+	pthread_cond_init(&(thread->ended), NULL);
+	if (pthread_create(&threadID, NULL, threadProc, thread)){
+		pthread_mutex_destroy(&(thread->mutex));
+		pthread_cond_destroy(&(thread->ended));
+		free(thread);
+		return NULL;
+	}
+	pthread_detach(threadID);
+	return thread;
+}
+
+HANDLE WINAPI CreateThread(LPSECURITY_ATTRIBUTES attributes, SIZE_T stackSize, LPTHREAD_START_ROUTINE routine, LPVOID parameter,
+						   DWORD flags, LPDWORD threadId){
+	return (HANDLE)startThread(routine, parameter, 2);
+}
+
+BOOL WINAPI QueueUserWorkItem(LPTHREAD_START_ROUTINE routine, LPVOID parameter, ULONG flags){
+	return startThread(routine, parameter, 1) != NULL;
+}
+
+static DWORD volatile numThreadIds;
+static __thread DWORD threadId;
+
+DWORD WINAPI GetCurrentThreadId(void){
+	if (!threadId)
+		threadId = __sync_add_and_fetch(&numThreadIds, 1);
+	return threadId;
+}
+
+/* Every window belongs to the first thread that asks, the one the benchmarks create them on */
+DWORD WINAPI GetWindowThreadProcessId(HWND window, LPDWORD processId){
+	static DWORD volatile windowThreadId;
+
+	if (processId)
+		*processId = 1;
+	__sync_bool_compare_and_swap(&windowThreadId, 0, GetCurrentThreadId());
+	return windowThreadId;
+}
+
+void WINAPI Sleep(DWORD milliseconds){
+	struct timespec time;
+
+	time.tv_sec = milliseconds / 1000;
+	time.tv_nsec = (long)(milliseconds % 1000) * 1000000;
+	nanosleep(&time, NULL);
+}
+
+/* Clocks */
+
+static long long monotonicNanoseconds(){
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+BOOL WINAPI QueryPerformanceFrequency(LARGE_INTEGER *frequency){
+	frequency->QuadPart = 1000000000;
+	return TRUE;
+}
+
+BOOL WINAPI QueryPerformanceCounter(LARGE_INTEGER *counter){
+	counter->QuadPart = monotonicNanoseconds();
+	return TRUE;
+}
+
+DWORD WINAPI GetTickCount(void){ return (DWORD)(monotonicNanoseconds() / 1000000); }
+ULONGLONG WINAPI GetTickCount64(void){ return (ULONGLONG)(monotonicNanoseconds() / 1000000); }
+
+/* Files, opened read-only and mapped whole */
+
+HANDLE WINAPI CreateFileA(LPCSTR path, DWORD access, DWORD shareMode, LPSECURITY_ATTRIBUTES attributes, DWORD creation, DWORD flags,
+						  HANDLE templateFile){
+	FileHandle *file = (FileHandle*)malloc(sizeof(FileHandle));
+	struct stat fileStat;
+
+	if (!file)
+		return INVALID_HANDLE_VALUE;
+	if ((file->fd = open(path, O_RDONLY)) < 0 || fstat(file->fd, &fileStat)){
+		if (file->fd >= 0)
+			close(file->fd);
+		free(file);
+		return INVALID_HANDLE_VALUE;
+	}
+	file->size = fileStat.st_size;
+	file->type = HANDLE_FILE;
+	return (HANDLE)file;
+}
+
+HANDLE WINAPI CreateFileW(LPCWSTR path, DWORD access, DWORD shareMode, LPSECURITY_ATTRIBUTES attributes, DWORD creation, DWORD flags,
+						  HANDLE templateFile){
+	char utf8Path[4096];
+
+	if (!WideCharToMultiByte(CP_UTF8, 0, path, -1, utf8Path, sizeof(utf8Path), NULL, NULL))
+		return INVALID_HANDLE_VALUE;
+	return CreateFileA(utf8Path, access, shareMode, attributes, creation, flags, templateFile);
+}
+
+BOOL WINAPI ReadFile(HANDLE handle, LPVOID buffer, DWORD numBytes, LPDWORD numRead, LPOVERLAPPED overlapped){
+	ssize_t result = read(((FileHandle*)handle)->fd, buffer, numBytes);
+
+	if (result < 0)
+		return FALSE;
+	if (numRead)
+		*numRead = (DWORD)result;
+	return TRUE;
+}
+
+BOOL WINAPI GetFileSizeEx(HANDLE handle, LARGE_INTEGER *size){
+	size->QuadPart = ((FileHandle*)handle)->size;
+	return TRUE;
+}
+
+/* A mapping is the file's handle again, duplicated so that both can be closed */
+HANDLE WINAPI CreateFileMappingA(HANDLE handle, LPSECURITY_ATTRIBUTES attributes, DWORD protection, DWORD maximumSizeHigh,
+								 DWORD maximumSizeLow, LPCSTR name){
+	FileHandle *mapping = (FileHandle*)malloc(sizeof(FileHandle));
+
+	if (!mapping)
+		return NULL;
+	*mapping = *(FileHandle*)handle;
+	if ((mapping->fd = dup(mapping->fd)) < 0){
+		free(mapping);
+		return NULL;
+	}
+	return (HANDLE)mapping;
+}
+
+/* The views are mapped after a page of their own that records their length, the file is mapped from the page its offset is in */
+static size_t getViewHeaderLength(){
+	return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+LPVOID WINAPI MapViewOfFile(HANDLE handle, DWORD access, DWORD offsetHigh, DWORD offsetLow, SIZE_T numBytes){
+	FileHandle *mapping = (FileHandle*)handle;
+	long long offset = ((long long)offsetHigh << 32) | offsetLow, base;
+	size_t headerLength = getViewHeaderLength(), length;
+	char *reserved;
+
+	base = offset / (long long)headerLength * (long long)headerLength;
+	if (!numBytes)
+		numBytes = (SIZE_T)(mapping->size - offset);
+	length = (size_t)(offset - base) + numBytes;
+	reserved = (char*)mmap(NULL, headerLength + length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (reserved == MAP_FAILED)
+		return NULL;
+	if (mmap(reserved + headerLength, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, mapping->fd, (off_t)base) == MAP_FAILED){
+		munmap(reserved, headerLength + length);
+		return NULL;
+	}
+	*(size_t*)reserved = headerLength + length;
+	return reserved + headerLength + (offset - base);
+}
+
+BOOL WINAPI UnmapViewOfFile(LPCVOID address){
+	size_t headerLength = getViewHeaderLength();
+	char *reserved = (char*)((ULONG_PTR)address / headerLength * headerLength) - headerLength;
+
+	return !munmap(reserved, *(size_t*)reserved);
+}
+
+BOOL WINAPI CloseHandle(HANDLE handle){
+	if (handle == STUB_HANDLE)
+		return TRUE;
+	if (((FileHandle*)handle)->type == HANDLE_THREAD)
+		releaseThread((ThreadHandle*)handle);
+	else {
+		close(((FileHandle*)handle)->fd);
+		free(handle);
+	}
+	return TRUE;
+}
+
+void WINAPI GetSystemInfo(SYSTEM_INFO *systemInfo){
+	memset(systemInfo, 0, sizeof(SYSTEM_INFO));
+	systemInfo->dwPageSize = (DWORD)sysconf(_SC_PAGESIZE);
+	systemInfo->dwAllocationGranularity = systemInfo->dwPageSize;
+	systemInfo->dwNumberOfProcessors = (DWORD)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+LPVOID WINAPI VirtualAlloc(LPVOID address, SIZE_T size, DWORD allocationType, DWORD protection){
+	void *memory = mmap(address, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	return memory == MAP_FAILED ? NULL : memory;
+}
+
+BOOL WINAPI VirtualFree(LPVOID address, SIZE_T size, DWORD freeType){ return TRUE; }
+LPVOID WINAPI LocalLock(HLOCAL memory){ return (LPVOID)memory; }
+BOOL WINAPI LocalUnlock(HLOCAL memory){ return TRUE; }
+
+/* Text */
+
+int WINAPI MultiByteToWideChar(UINT codePage, DWORD flags, LPCSTR string, int numBytes, LPWSTR wideString, int numWide){
+	const unsigned char *byte = (const unsigned char*)string, *end;
+	unsigned int codePoint;
+	int length = 0, numTrailing;
+
+	end = byte + (numBytes < 0 ? strlen(string) + 1 : (size_t)numBytes);
+	while (byte < end){
+		codePoint = *byte++;
+		numTrailing = codePoint >= 0xF0 ? 3 : codePoint >= 0xE0 ? 2 : codePoint >= 0xC0 ? 1 : 0;
+		if (numTrailing)
+			codePoint &= 0x3F >> numTrailing;
+		for (; numTrailing && byte < end && (*byte & 0xC0) == 0x80; numTrailing--)
+			codePoint = (codePoint << 6) | (*byte++ & 0x3F);
+		if (codePoint >= 0x10000){
+			if (numWide && length + 2 > numWide)
+				return 0;
+			if (numWide){
+				wideString[length] = (WCHAR)(0xD800 + ((codePoint - 0x10000) >> 10));
+				wideString[length + 1] = (WCHAR)(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+			}
+			length += 2;
+		} else {
+			if (numWide && length + 1 > numWide)
+				return 0;
+			if (numWide)
+				wideString[length] = (WCHAR)codePoint;
+			length++;
+		}
+	}
+	return length;
+}
+
+int WINAPI WideCharToMultiByte(UINT codePage, DWORD flags, LPCWSTR wideString, int numWide, LPSTR string, int numBytes,
+							   LPCSTR defaultChar, BOOL *usedDefaultChar){
+	unsigned char encoded[4];
+	unsigned int codePoint;
+	int length = 0, i, j, numEncoded;
+
+	if (numWide < 0)
+		for (numWide = 1; wideString[numWide - 1]; numWide++);
+	for (i = 0; i < numWide; i++){
+		codePoint = wideString[i];
+		if (codePoint >= 0xD800 && codePoint < 0xDC00 && i + 1 < numWide && wideString[i + 1] >= 0xDC00 && wideString[i + 1] < 0xE000)
+			codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (wideString[++i] - 0xDC00);
+		if (codePoint < 0x80){
+			encoded[0] = (unsigned char)codePoint;
+			numEncoded = 1;
+		} else if (codePoint < 0x800){
+			encoded[0] = (unsigned char)(0xC0 | (codePoint >> 6));
+			encoded[1] = (unsigned char)(0x80 | (codePoint & 0x3F));
+			numEncoded = 2;
+		} else if (codePoint < 0x10000){
+			encoded[0] = (unsigned char)(0xE0 | (codePoint >> 12));
+			encoded[1] = (unsigned char)(0x80 | ((codePoint >> 6) & 0x3F));
+			encoded[2] = (unsigned char)(0x80 | (codePoint & 0x3F));
+			numEncoded = 3;
+		} else {
+			encoded[0] = (unsigned char)(0xF0 | (codePoint >> 18));
+			encoded[1] = (unsigned char)(0x80 | ((codePoint >> 12) & 0x3F));
+			encoded[2] = (unsigned char)(0x80 | ((codePoint >> 6) & 0x3F));
+			encoded[3] = (unsigned char)(0x80 | (codePoint & 0x3F));
+			numEncoded = 4;
+		}
+		if (numBytes && length + numEncoded > numBytes)
+			return 0;
+		if (numBytes)
+			for (j = 0; j < numEncoded; j++)
+				string[length + j] = (char)encoded[j];
+		length += numEncoded;
+	}
+	return length;
+}
+
+int sprintf_s(char *buffer, size_t size, const char *format, ...){
+	va_list arguments;
+	int length;
+
+	va_start(arguments, format);
+	length = vsnprintf(buffer, size, format, arguments);
+	va_end(arguments);
+	return length;
+}
+
+/* Rectangles */
+
+BOOL WINAPI SetRect(LPRECT rect, int left, int top, int right, int bottom){
+	rect->left = left;
+	rect->top = top;
+	rect->right = right;
+	rect->bottom = bottom;
+	return TRUE;
+}
+
+BOOL WINAPI SetRectEmpty(LPRECT rect){ return SetRect(rect, 0, 0, 0, 0); }
+BOOL WINAPI IsRectEmpty(const RECT *rect){ return rect->right <= rect->left || rect->bottom <= rect->top; }
+
+BOOL WINAPI OffsetRect(LPRECT rect, int dx, int dy){
+	return SetRect(rect, rect->left + dx, rect->top + dy, rect->right + dx, rect->bottom + dy);
+}
+
+BOOL WINAPI InflateRect(LPRECT rect, int dx, int dy){
+	return SetRect(rect, rect->left - dx, rect->top - dy, rect->right + dx, rect->bottom + dy);
+}
+
+BOOL WINAPI IntersectRect(LPRECT destination, const RECT *rect1, const RECT *rect2){
+	RECT intersection;
+
+	intersection.left = rect1->left > rect2->left ? rect1->left : rect2->left;
+	intersection.top = rect1->top > rect2->top ? rect1->top : rect2->top;
+	intersection.right = rect1->right < rect2->right ? rect1->right : rect2->right;
+	intersection.bottom = rect1->bottom < rect2->bottom ? rect1->bottom : rect2->bottom;
+	if (IsRectEmpty(&intersection)){
+		SetRectEmpty(destination);
+		return FALSE;
+	}
+	*destination = intersection;
+	return TRUE;
+}
+
+BOOL WINAPI UnionRect(LPRECT destination, const RECT *rect1, const RECT *rect2){
+	if (IsRectEmpty(rect1))
+		*destination = *rect2;
+	else if (IsRectEmpty(rect2))
+		*destination = *rect1;
+	else
+		SetRect(destination, rect1->left < rect2->left ? rect1->left : rect2->left, rect1->top < rect2->top ? rect1->top : rect2->top,
+			rect1->right > rect2->right ? rect1->right : rect2->right, rect1->bottom > rect2->bottom ? rect1->bottom : rect2->bottom);
+	return !IsRectEmpty(destination);
+}
+
+BOOL WINAPI PtInRect(const RECT *rect, POINT point){
+	return point.x >= rect->left && point.x < rect->right && point.y >= rect->top && point.y < rect->bottom;
+}
+
+/* Windows, there is no window system: the windows are created and never shown, and the messages go nowhere */
+
+HICON WINAPI LoadIcon(HINSTANCE instance, LPCSTR name){ return (HICON)STUB_HANDLE; }
+HCURSOR WINAPI LoadCursor(HINSTANCE instance, LPCSTR name){ return (HCURSOR)STUB_HANDLE; }
+HANDLE WINAPI LoadImage(HINSTANCE instance, LPCSTR name, UINT type, int width, int height, UINT flags){ return NULL; }
+HMODULE WINAPI GetModuleHandle(LPCSTR name){ return (HMODULE)STUB_HANDLE; }
+ATOM WINAPI RegisterClassExA(const WNDCLASSEXA *windowClass){ return 1; }
+ATOM WINAPI RegisterClassExW(const WNDCLASSEXW *windowClass){ return 1; }
+BOOL WINAPI UnregisterClassA(LPCSTR name, HINSTANCE instance){ return TRUE; }
+BOOL WINAPI UnregisterClassW(LPCWSTR name, HINSTANCE instance){ return TRUE; }
+BOOL WINAPI IsWindowUnicode(HWND window){ return TRUE; }
+HWND WINAPI CreateWindowExA(DWORD exStyle, LPCSTR className, LPCSTR title, DWORD style, int x, int y, int width, int height, HWND parent,
+							HMENU menu, HINSTANCE instance, LPVOID parameter){
+	return (HWND)STUB_HANDLE;
+}
+HWND WINAPI CreateWindowExW(DWORD exStyle, LPCWSTR className, LPCWSTR title, DWORD style, int x, int y, int width, int height,
+							HWND parent, HMENU menu, HINSTANCE instance, LPVOID parameter){
+	return (HWND)STUB_HANDLE;
+}
+BOOL WINAPI DestroyWindow(HWND window){ return TRUE; }
+BOOL WINAPI ShowWindow(HWND window, int command){ return FALSE; }
+BOOL WINAPI UpdateWindow(HWND window){ return TRUE; }
+BOOL WINAPI IsWindow(HWND window){ return FALSE; }
+BOOL WINAPI IsWindowVisible(HWND window){ return FALSE; }
+BOOL WINAPI EnableWindow(HWND window, BOOL enable){ return FALSE; }
+BOOL WINAPI SetWindowPos(HWND window, HWND insertAfter, int x, int y, int width, int height, UINT flags){ return TRUE; }
+HDWP WINAPI BeginDeferWindowPos(int numWindows){ return (HDWP)STUB_HANDLE; }
+HDWP WINAPI DeferWindowPos(HDWP positions, HWND window, HWND insertAfter, int x, int y, int width, int height, UINT flags){
+	return positions;
+}
+BOOL WINAPI EndDeferWindowPos(HDWP positions){ return TRUE; }
+BOOL WINAPI InvalidateRect(HWND window, const RECT *rect, BOOL erase){ return TRUE; }
+BOOL WINAPI ValidateRect(HWND window, const RECT *rect){ return TRUE; }
+BOOL WINAPI RedrawWindow(HWND window, const RECT *rect, HRGN region, UINT flags){ return TRUE; }
+BOOL WINAPI GetUpdateRect(HWND window, LPRECT rect, BOOL erase){
+	if (rect)
+		SetRectEmpty(rect);
+	return FALSE;
+}
+BOOL WINAPI GetClientRect(HWND window, LPRECT rect){ return SetRectEmpty(rect); }
+BOOL WINAPI GetWindowRect(HWND window, LPRECT rect){ return SetRectEmpty(rect); }
+int WINAPI ScrollWindowEx(HWND window, int dx, int dy, const RECT *scroll, const RECT *clip, HRGN update, LPRECT updateRect, UINT flags){
+	return 1;
+}
+int WINAPI SetScrollInfo(HWND window, int bar, LPCSCROLLINFO scrollInfo, BOOL redraw){ return 0; }
+BOOL WINAPI GetScrollInfo(HWND window, int bar, LPSCROLLINFO scrollInfo){ return FALSE; }
+BOOL WINAPI SetWindowTextA(HWND window, LPCSTR text){ return TRUE; }
+BOOL WINAPI SetWindowTextW(HWND window, LPCWSTR text){ return TRUE; }
+int WINAPI GetWindowTextLengthA(HWND window){ return 0; }
+int WINAPI GetWindowTextLengthW(HWND window){ return 0; }
+int WINAPI GetWindowTextA(HWND window, LPSTR text, int size){
+	if (size > 0)
+		*text = '\0';
+	return 0;
+}
+int WINAPI GetWindowTextW(HWND window, LPWSTR text, int size){
+	if (size > 0)
+		*text = 0;
+	return 0;
+}
+HWND WINAPI SetFocus(HWND window){ return NULL; }
+HWND WINAPI GetFocus(void){ return NULL; }
+HWND WINAPI SetCapture(HWND window){ return NULL; }
+BOOL WINAPI ReleaseCapture(void){ return TRUE; }
+HWND WINAPI GetParent(HWND window){ return NULL; }
+HWND WINAPI WindowFromPoint(POINT point){ return NULL; }
+BOOL WINAPI ScreenToClient(HWND window, LPPOINT point){ return TRUE; }
+BOOL WINAPI ClientToScreen(HWND window, LPPOINT point){ return TRUE; }
+BOOL WINAPI GetCursorPos(LPPOINT point){
+	point->x = point->y = 0;
+	return TRUE;
+}
+UINT_PTR WINAPI SetTimer(HWND window, UINT_PTR id, UINT milliseconds, void *timerProc){ return id ? id : 1; }
+BOOL WINAPI KillTimer(HWND window, UINT_PTR id){ return TRUE; }
+UINT WINAPI RegisterWindowMessageA(LPCSTR name){ return 0xC000; }
+
+/* The window data isn't kept, tinyGUI finds its objects from their handles when the messages come, and none do */
+LONG_PTR WINAPI SetWindowLongPtrA(HWND window, int index, LONG_PTR value){ return 1; }
+LONG_PTR WINAPI SetWindowLongPtrW(HWND window, int index, LONG_PTR value){ return 1; }
+LONG_PTR WINAPI GetWindowLongPtrA(HWND window, int index){ return 0; }
+LONG_PTR WINAPI GetWindowLongPtrW(HWND window, int index){ return 0; }
+
+LRESULT WINAPI SendMessageA(HWND window, UINT message, WPARAM wParam, LPARAM lParam){ return 0; }
+LRESULT WINAPI SendMessageW(HWND window, UINT message, WPARAM wParam, LPARAM lParam){ return 0; }
+BOOL WINAPI PostMessageA(HWND window, UINT message, WPARAM wParam, LPARAM lParam){ return TRUE; }
+BOOL WINAPI PostMessageW(HWND window, UINT message, WPARAM wParam, LPARAM lParam){ return TRUE; }
+LRESULT WINAPI DefWindowProcA(HWND window, UINT message, WPARAM wParam, LPARAM lParam){ return 0; }
+LRESULT WINAPI DefWindowProcW(HWND window, UINT message, WPARAM wParam, LPARAM lParam){ return 0; }
+LRESULT WINAPI CallWindowProcA(WNDPROC windowProc, HWND window, UINT message, WPARAM wParam, LPARAM lParam){ return 0; }
+LRESULT WINAPI CallWindowProcW(WNDPROC windowProc, HWND window, UINT message, WPARAM wParam, LPARAM lParam){ return 0; }
+void WINAPI PostQuitMessage(int exitCode){}
+BOOL WINAPI PeekMessageA(MSG *message, HWND window, UINT first, UINT last, UINT remove){ return FALSE; }
+BOOL WINAPI PeekMessageW(MSG *message, HWND window, UINT first, UINT last, UINT remove){ return FALSE; }
+BOOL WINAPI GetMessageA(MSG *message, HWND window, UINT first, UINT last){ return FALSE; }
+BOOL WINAPI GetMessageW(MSG *message, HWND window, UINT first, UINT last){ return FALSE; }
+BOOL WINAPI TranslateMessage(const MSG *message){ return FALSE; }
+LRESULT WINAPI DispatchMessageA(const MSG *message){ return 0; }
+LRESULT WINAPI DispatchMessageW(const MSG *message){ return 0; }
+
+int WINAPI MessageBoxA(HWND window, LPCSTR text, LPCSTR caption, UINT type){
+	fprintf(stderr, "%s: %s\n", caption ? caption : "", text ? text : "");
+	return 1;
+}
+void WINAPI OutputDebugStringA(LPCSTR text){ fputs(text, stderr); }
+BOOL WINAPI InitCommonControlsEx(const INITCOMMONCONTROLSEX *controls){ return TRUE; }
+HRESULT WINAPI CoInitializeEx(LPVOID reserved, DWORD flags){ return 0; }
+void WINAPI CoUninitialize(void){}
+int WINAPI GetSystemMetrics(int index){ return 0; }
+DWORD WINAPI GetSysColor(int index){ return 0; }
+HBRUSH WINAPI GetSysColorBrush(int index){ return (HBRUSH)STUB_HANDLE; }
+
+/* GDI, the device contexts and the objects draw nothing */
+
+HDC WINAPI GetDC(HWND window){ return (HDC)STUB_HANDLE; }
+int WINAPI ReleaseDC(HWND window, HDC dc){ return 1; }
+HDC WINAPI BeginPaint(HWND window, PAINTSTRUCT *paint){
+	memset(paint, 0, sizeof(PAINTSTRUCT));
+	paint->hdc = (HDC)STUB_HANDLE;
+	return paint->hdc;
+}
+BOOL WINAPI EndPaint(HWND window, const PAINTSTRUCT *paint){ return TRUE; }
+HDC WINAPI CreateCompatibleDC(HDC dc){ return (HDC)STUB_HANDLE; }
+HBITMAP WINAPI CreateCompatibleBitmap(HDC dc, int width, int height){ return (HBITMAP)STUB_HANDLE; }
+HBITMAP WINAPI CreateDIBSection(HDC dc, const BITMAPINFO *info, UINT usage, void **bits, HANDLE section, DWORD offset){
+	if (bits)
+		*bits = NULL;
+	return NULL;
+}
+BOOL WINAPI DeleteObject(HGDIOBJ object){ return TRUE; }
+BOOL WINAPI DeleteDC(HDC dc){ return TRUE; }
+HGDIOBJ WINAPI SelectObject(HDC dc, HGDIOBJ object){ return STUB_HANDLE; }
+HGDIOBJ WINAPI GetStockObject(int index){ return STUB_HANDLE; }
+int WINAPI GetObject(HANDLE object, int size, LPVOID buffer){
+	memset(buffer, 0, size);
+	return 0;
+}
+HPEN WINAPI CreatePen(int style, int width, COLORREF color){ return (HPEN)STUB_HANDLE; }
+HBRUSH WINAPI CreateBrushIndirect(const LOGBRUSH *brush){ return (HBRUSH)STUB_HANDLE; }
+HBRUSH WINAPI CreateSolidBrush(COLORREF color){ return (HBRUSH)STUB_HANDLE; }
+int WINAPI FillRect(HDC dc, const RECT *rect, HBRUSH brush){ return 1; }
+int WINAPI FrameRect(HDC dc, const RECT *rect, HBRUSH brush){ return 1; }
+int WINAPI SetBkMode(HDC dc, int mode){ return 1; }
+COLORREF WINAPI SetBkColor(HDC dc, COLORREF color){ return 0; }
+COLORREF WINAPI SetTextColor(HDC dc, COLORREF color){ return 0; }
+BOOL WINAPI BitBlt(HDC dc, int x, int y, int width, int height, HDC source, int sourceX, int sourceY, DWORD rop){ return TRUE; }
+BOOL WINAPI StretchBlt(HDC dc, int x, int y, int width, int height, HDC source, int sourceX, int sourceY, int sourceWidth,
+					   int sourceHeight, DWORD rop){
+	return TRUE;
+}
+int WINAPI StretchDIBits(HDC dc, int x, int y, int width, int height, int sourceX, int sourceY, int sourceWidth, int sourceHeight,
+						 const void *bits, const BITMAPINFO *info, UINT usage, DWORD rop){
+	return height;
+}
+int WINAPI SetStretchBltMode(HDC dc, int mode){ return 1; }
+BOOL WINAPI MoveToEx(HDC dc, int x, int y, LPPOINT previous){ return TRUE; }
+BOOL WINAPI LineTo(HDC dc, int x, int y){ return TRUE; }
+BOOL WINAPI Polyline(HDC dc, const POINT *points, int numPoints){ return TRUE; }
+BOOL WINAPI PolyPolyline(HDC dc, const POINT *points, const DWORD *numPoints, DWORD numPolylines){ return TRUE; }
+BOOL WINAPI Arc(HDC dc, int left, int top, int right, int bottom, int startX, int startY, int endX, int endY){ return TRUE; }
+BOOL WINAPI Rectangle(HDC dc, int left, int top, int right, int bottom){ return TRUE; }
+BOOL WINAPI RoundRect(HDC dc, int left, int top, int right, int bottom, int width, int height){ return TRUE; }
+BOOL WINAPI Ellipse(HDC dc, int left, int top, int right, int bottom){ return TRUE; }
+BOOL WINAPI Polygon(HDC dc, const POINT *points, int numPoints){ return TRUE; }
+int WINAPI DrawTextA(HDC dc, LPCSTR text, int length, LPRECT rect, UINT format){ return 0; }
+int WINAPI DrawTextW(HDC dc, LPCWSTR text, int length, LPRECT rect, UINT format){ return 0; }
+BOOL WINAPI TextOutA(HDC dc, int x, int y, LPCSTR text, int length){ return TRUE; }
+BOOL WINAPI ExtTextOutA(HDC dc, int x, int y, UINT options, const RECT *rect, LPCSTR text, UINT length, const INT *dx){ return TRUE; }
+BOOL WINAPI GetTextMetricsA(HDC dc, TEXTMETRICA *metrics){
+	memset(metrics, 0, sizeof(TEXTMETRICA));
+	return FALSE;
+}
+BOOL WINAPI DrawFrameControl(HDC dc, LPRECT rect, UINT type, UINT state){ return TRUE; }
+BOOL WINAPI DrawFocusRect(HDC dc, const RECT *rect){ return TRUE; }
+BOOL WINAPI SetViewportOrgEx(HDC dc, int x, int y, LPPOINT previous){ return TRUE; }
+BOOL WINAPI OffsetViewportOrgEx(HDC dc, int x, int y, LPPOINT previous){ return TRUE; }
+int WINAPI SaveDC(HDC dc){ return 1; }
+BOOL WINAPI RestoreDC(HDC dc, int savedDC){ return TRUE; }
+int WINAPI IntersectClipRect(HDC dc, int left, int top, int right, int bottom){ return 1; }
+BOOL WINAPI RectVisible(HDC dc, const RECT *rect){ return FALSE; }
+int WINAPI GetClipBox(HDC dc, LPRECT rect){
+	SetRectEmpty(rect);
+	return 1;
+}